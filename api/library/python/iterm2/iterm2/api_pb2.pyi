@@ -2287,6 +2287,17 @@ class PromptMonitorRequest(google___protobuf___message___Message):
     def MergeFrom(self, other_msg: google___protobuf___message___Message) -> None: ...
     def CopyFrom(self, other_msg: google___protobuf___message___Message) -> None: ...
 
+class ScreenUpdateRequest(google___protobuf___message___Message):
+    include_contents = ... # type: bool
+
+    def __init__(self,
+        include_contents : typing___Optional[bool] = None,
+        ) -> None: ...
+    @classmethod
+    def FromString(cls, s: bytes) -> ScreenUpdateRequest: ...
+    def MergeFrom(self, other_msg: google___protobuf___message___Message) -> None: ...
+    def CopyFrom(self, other_msg: google___protobuf___message___Message) -> None: ...
+
 class NotificationRequest(google___protobuf___message___Message):
     session = ... # type: typing___Text
     subscribe = ... # type: bool
@@ -2310,6 +2321,9 @@ class NotificationRequest(google___protobuf___message___Message):
     @property
     def prompt_monitor_request(self) -> PromptMonitorRequest: ...
 
+    @property
+    def screen_update_request(self) -> ScreenUpdateRequest: ...
+
     def __init__(self,
         session : typing___Optional[typing___Text] = None,
         subscribe : typing___Optional[bool] = None,
@@ -2320,6 +2334,7 @@ class NotificationRequest(google___protobuf___message___Message):
         profile_change_request : typing___Optional[ProfileChangeRequest] = None,
         keystroke_filter_request : typing___Optional[KeystrokeFilterRequest] = None,
         prompt_monitor_request : typing___Optional[PromptMonitorRequest] = None,
+        screen_update_request : typing___Optional[ScreenUpdateRequest] = None,
         ) -> None: ...
     @classmethod
     def FromString(cls, s: bytes) -> NotificationRequest: ...
@@ -2523,15 +2538,42 @@ class KeystrokeNotification(google___protobuf___message___Message):
 
 class ScreenUpdateNotification(google___protobuf___message___Message):
     session = ... # type: typing___Text
+    generation = ... # type: int
+    first_line_on_screen = ... # type: int
+
+    @property
+    def lines(self) -> google___protobuf___internal___containers___RepeatedCompositeFieldContainer[ScreenUpdateLine]: ...
+
+    @property
+    def cursor(self) -> Coord: ...
 
     def __init__(self,
         session : typing___Optional[typing___Text] = None,
+        generation : typing___Optional[int] = None,
+        lines : typing___Optional[typing___Iterable[ScreenUpdateLine]] = None,
+        cursor : typing___Optional[Coord] = None,
+        first_line_on_screen : typing___Optional[int] = None,
         ) -> None: ...
     @classmethod
     def FromString(cls, s: bytes) -> ScreenUpdateNotification: ...
     def MergeFrom(self, other_msg: google___protobuf___message___Message) -> None: ...
     def CopyFrom(self, other_msg: google___protobuf___message___Message) -> None: ...
 
+class ScreenUpdateLine(google___protobuf___message___Message):
+    line_number = ... # type: int
+
+    @property
+    def contents(self) -> LineContents: ...
+
+    def __init__(self,
+        line_number : typing___Optional[int] = None,
+        contents : typing___Optional[LineContents] = None,
+        ) -> None: ...
+    @classmethod
+    def FromString(cls, s: bytes) -> ScreenUpdateLine: ...
+    def MergeFrom(self, other_msg: google___protobuf___message___Message) -> None: ...
+    def CopyFrom(self, other_msg: google___protobuf___message___Message) -> None: ...
+
 class PromptNotificationPrompt(google___protobuf___message___Message):
     placeholder = ... # type: typing___Text
 
@@ -123,7 +123,7 @@ async def async_filter_keystrokes(connection, patterns_to_ignore, session=None):
         session=session,
         keystroke_monitor_request=kmr)
 
-async def async_subscribe_to_screen_update_notification(connection, callback, session=None):
+async def async_subscribe_to_screen_update_notification(connection, callback, session=None, include_contents=False):
     """
     Registers a callback to be run when the screen contents change.
 
@@ -131,6 +131,9 @@ async def async_subscribe_to_screen_update_notification(connection, callback, se
     :param callback: A coroutine taking two arguments: an :class:`Connection` and
       iterm2.api_pb2.ScreenUpdateNotification..
     :param session: The session to monitor, or None.
+    :param include_contents: If True, each notification carries the lines that changed (at most one
+      notification per frame) along with a generation number that increases by one per
+      notification, so there is no need to fetch the screen contents separately.
 
     :returns: A token that can be passed to unsubscribe.
     """
@@ -139,7 +142,8 @@ async def async_subscribe_to_screen_update_notification(connection, callback, se
         True,
         iterm2.api_pb2.NOTIFY_ON_SCREEN_UPDATE,
         callback,
-        session=session)
+        session=session,
+        include_screen_contents=include_contents)
 
 async def async_subscribe_to_prompt_notification(connection, callback, session, modes):
     """
@@ -374,7 +378,7 @@ def _string_rpc_registration_request(rpc):
     args = sorted(map(lambda x: x.name, rpc.arguments))
     return rpc.name + "(" + ",".join(args) + ")"
 
-async def _async_subscribe(connection, subscribe, notification_type, callback, session=None, rpc_registration_request=None, keystroke_monitor_request=None, variable_monitor_request=None, key=None, profile_change_request=None, prompt_monitor_modes=None):
+async def _async_subscribe(connection, subscribe, notification_type, callback, session=None, rpc_registration_request=None, keystroke_monitor_request=None, variable_monitor_request=None, key=None, profile_change_request=None, prompt_monitor_modes=None, include_screen_contents=False):
     """Note: session argument is ignored for variable-change notifications."""
     _register_helper_if_needed()
     transformed_session = session if session is not None else "all"
@@ -400,7 +404,8 @@ async def _async_subscribe(connection, subscribe, notification_type, callback, s
         keystroke_monitor_request,
         variable_monitor_request,
         profile_change_request,
-        prompt_monitor_modes)
+        prompt_monitor_modes,
+        include_screen_contents)
     status = response.notification_response.status
     status_ok = (status == iterm2.api_pb2.NotificationResponse.Status.Value("OK"))
 
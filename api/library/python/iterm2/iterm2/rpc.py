@@ -27,7 +27,7 @@ async def async_list_sessions(connection):
     request.list_sessions_request.SetInParent()
     return await _async_call(connection, request)
 
-async def async_notification_request(connection, subscribe, notification_type, session=None, rpc_registration_request=None, keystroke_monitor_request=None, variable_monitor_request=None, profile_change_request=None, prompt_monitor_modes=None):
+async def async_notification_request(connection, subscribe, notification_type, session=None, rpc_registration_request=None, keystroke_monitor_request=None, variable_monitor_request=None, profile_change_request=None, prompt_monitor_modes=None, include_screen_contents=False):
     """
     Requests a change to a notification subscription.
 
@@ -40,6 +40,7 @@ async def async_notification_request(connection, subscribe, notification_type, s
     variable_monitor_request: The variable monitor request (only for registering a variable monitor) or None.
     profile_change_request: The profile monitor request (only for registering a profile change monitor) or None.
     prompt_monitor_modes: The prompt monitor modes (only for registering a prompt monitor) or None.
+    include_screen_contents: Whether screen update notifications should carry the changed lines (only for registering a screen update monitor).
 
     Returns: iterm2.api_pb2.ServerOriginatedMessage
     """
@@ -59,6 +60,8 @@ async def async_notification_request(connection, subscribe, notification_type, s
     if prompt_monitor_modes:
         for mode in prompt_monitor_modes:
             request.notification_request.prompt_monitor_request.modes.append(mode)
+    if include_screen_contents:
+        request.notification_request.screen_update_request.include_contents = True
     request.notification_request.subscribe = subscribe
     request.notification_request.notification_type = notification_type
     return await _async_call(connection, request)
@@ -0,0 +1,240 @@
+//
+//  DVRTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DVR.h"
+#import "DVRDecoder.h"
+#import "ScreenChar.h"
+#import "iTermAdvancedSettingsModel.h"
+#import "iTermBenchmarkTesting.h"
+
+@interface DVRTest : XCTestCase
+@end
+
+@implementation DVRTest {
+    int _width;
+    int _height;
+    // Rows of the screen being recorded, each width + 1 characters.
+    NSMutableArray<NSMutableData *> *_rows;
+    int _nextLine;
+}
+
+- (void)setUp {
+    [super setUp];
+    _rows = [[NSMutableArray alloc] init];
+}
+
+- (void)tearDown {
+    [_rows release];
+    [super tearDown];
+}
+
+- (NSMutableData *)rowWithText:(NSString *)text {
+    NSMutableData *data = [NSMutableData dataWithLength:(_width + 1) * sizeof(screen_char_t)];
+    screen_char_t *line = data.mutableBytes;
+    for (int i = 0; i < _width && i < text.length; i++) {
+        line[i].code = [text characterAtIndex:i];
+        line[i].foregroundColor = (i / 8) % 8;
+    }
+    line[_width].code = EOL_HARD;
+    return data;
+}
+
+- (void)resetScreenWithWidth:(int)width height:(int)height {
+    _width = width;
+    _height = height;
+    _nextLine = 0;
+    [_rows removeAllObjects];
+    for (int i = 0; i < height; i++) {
+        [_rows addObject:[self rowWithText:@""]];
+    }
+}
+
+// Prints a line at the bottom of the screen, scrolling it up.
+- (void)scroll {
+    [_rows removeObjectAtIndex:0];
+    [_rows addObject:[self rowWithText:[NSString stringWithFormat:@"%d: the quick brown fox jumps over the lazy dog", _nextLine++]]];
+}
+
+// Changes one character, like typing or a clock ticking.
+- (void)editRow:(int)y {
+    screen_char_t *line = _rows[y].mutableBytes;
+    line[_nextLine % _width].code = 'a' + _nextLine % 26;
+    _nextLine++;
+}
+
+- (NSData *)appendFrameToDVR:(DVR *)dvr {
+    NSMutableData *frame = [NSMutableData data];
+    NSMutableArray *lines = [NSMutableArray array];
+    for (NSData *row in _rows) {
+        [frame appendData:row];
+        [lines addObject:[[row mutableCopy] autorelease]];
+    }
+    DVRFrameInfo info = {
+        .width = _width,
+        .height = _height,
+        .cursorX = _nextLine % _width,
+        .cursorY = _height - 1
+    };
+    [dvr appendFrame:lines length:frame.length info:&info];
+    return frame;
+}
+
+// Records a session that mostly scrolls with some edits in between.
+- (NSArray<NSData *> *)recordFrames:(int)count intoDVR:(DVR *)dvr {
+    NSMutableArray<NSData *> *frames = [NSMutableArray array];
+    for (int i = 0; i < count; i++) {
+        switch (i % 5) {
+            case 0:
+            case 1:
+                [self scroll];
+                break;
+            case 2:
+                [self scroll];
+                [self scroll];
+                [self scroll];
+                break;
+            case 3:
+                [self editRow:_height - 1];
+                break;
+            case 4:
+                [self editRow:i % _height];
+                [_rows exchangeObjectAtIndex:0 withObjectAtIndex:_height / 2];
+                break;
+        }
+        [frames addObject:[self appendFrameToDVR:dvr]];
+    }
+    return frames;
+}
+
+- (void)assertDecoder:(DVRDecoder *)decoder hasFrame:(NSData *)frame {
+    XCTAssertEqual(decoder.length, (int)frame.length);
+    XCTAssertEqual(memcmp(decoder.decodedFrame, frame.bytes, frame.length), 0);
+    XCTAssertEqual(decoder.info.width, _width);
+    XCTAssertEqual(decoder.info.height, _height);
+}
+
+- (void)testFramesDecodeToWhatWasRecorded {
+    [self resetScreenWithWidth:80 height:25];
+    DVR *dvr = [[[DVR alloc] initWithBufferCapacity:4 * 1024 * 1024] autorelease];
+    NSArray<NSData *> *frames = [self recordFrames:350 intoDVR:dvr];
+
+    DVRDecoder *decoder = [dvr getDecoder];
+    NSMutableArray<NSNumber *> *timestamps = [NSMutableArray array];
+    for (NSData *frame in frames) {
+        XCTAssertTrue([decoder next]);
+        [self assertDecoder:decoder hasFrame:frame];
+        [timestamps addObject:@(decoder.timestamp)];
+    }
+    XCTAssertFalse([decoder next]);
+
+    for (NSInteger i = (NSInteger)frames.count - 2; i >= (NSInteger)frames.count - 120; i--) {
+        XCTAssertTrue([decoder prev]);
+        [self assertDecoder:decoder hasFrame:frames[i]];
+    }
+
+    // Seeking finds the first frame with the timestamp.
+    srand(1);
+    for (int i = 0; i < 100; i++) {
+        const NSUInteger index = rand() % frames.count;
+        const NSUInteger expected = [timestamps indexOfObject:timestamps[index]];
+        XCTAssertTrue([decoder seek:timestamps[index].longLongValue]);
+        [self assertDecoder:decoder hasFrame:frames[expected]];
+    }
+    XCTAssertFalse([decoder seek:timestamps.lastObject.longLongValue + 1]);
+    [dvr releaseDecoder:decoder];
+
+    // Frames survive saving and restoring.
+    DVR *restored = [[[DVR alloc] initWithBufferCapacity:1] autorelease];
+    XCTAssertTrue([restored loadDictionary:dvr.dictionaryValue]);
+    decoder = [restored getDecoder];
+    for (NSData *frame in frames) {
+        XCTAssertTrue([decoder next]);
+        [self assertDecoder:decoder hasFrame:frame];
+    }
+    [restored releaseDecoder:decoder];
+}
+
+- (void)testWrappingBufferKeepsDecodableFrames {
+    [self resetScreenWithWidth:80 height:25];
+    DVR *dvr = [[[DVR alloc] initWithBufferCapacity:256 * 1024] autorelease];
+    NSArray<NSData *> *frames = [self recordFrames:2000 intoDVR:dvr];
+
+    DVRDecoder *decoder = [dvr getDecoder];
+    NSInteger count = 0;
+    while ([decoder next]) {
+        count++;
+    }
+    XCTAssertGreaterThan(count, 0);
+    XCTAssertLessThan(count, (NSInteger)frames.count);
+
+    // Walk back from the last frame to the first one that's still in the buffer.
+    [self assertDecoder:decoder hasFrame:frames.lastObject];
+    for (NSInteger i = 1; i < count; i++) {
+        XCTAssertTrue([decoder prev]);
+        [self assertDecoder:decoder hasFrame:frames[frames.count - 1 - i]];
+    }
+    XCTAssertFalse([decoder prev]);
+    [dvr releaseDecoder:decoder];
+}
+
+// Logs frames encoded per second, bytes stored per frame, and the time to seek to a random frame
+// for a 200x60 screen.
+- (void)testEncodeAndSeekPerformance {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    [self resetScreenWithWidth:200 height:60];
+    const int count = 5000;
+    DVR *dvr = [[[DVR alloc] initWithBufferCapacity:64 * 1024 * 1024] autorelease];
+
+    // Build the frames first so only encoding is timed.
+    NSMutableArray<NSArray *> *frameLines = [NSMutableArray array];
+    for (int i = 0; i < count; i++) {
+        if (i % 4) {
+            [self scroll];
+        } else {
+            [self editRow:_height - 1];
+        }
+        NSMutableArray *lines = [NSMutableArray array];
+        for (NSData *row in _rows) {
+            [lines addObject:[[row mutableCopy] autorelease]];
+        }
+        [frameLines addObject:lines];
+    }
+    const int length = _width * _height + _height;
+    DVRFrameInfo info = { .width = _width, .height = _height };
+
+    NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    for (NSArray *lines in frameLines) {
+        [dvr appendFrame:lines length:length * sizeof(screen_char_t) info:&info];
+    }
+    const NSTimeInterval encodeTime = [NSDate timeIntervalSinceReferenceDate] - start;
+    NSDictionary *dictionary = dvr.dictionaryValue;
+    NSDictionary *index = dictionary[@"buffer"][@"index"];
+    long long storedBytes = 0;
+    for (NSDictionary *entry in index.allValues) {
+        storedBytes += [entry[@"frameLength"] longLongValue];
+    }
+    NSLog(@"Encoded %d frames at %.0f frames/sec, %.0f bytes/frame (a frame is %d bytes), compression %@",
+          count, count / encodeTime, (double)storedBytes / index.count, (int)(length * sizeof(screen_char_t)),
+          [iTermAdvancedSettingsModel compressInstantReplay] ? @"on" : @"off");
+    XCTAssertEqual(index.count, (NSUInteger)count);
+
+    DVRDecoder *decoder = [dvr getDecoder];
+    const long long first = dvr.firstTimeStamp;
+    const long long last = dvr.lastTimeStamp;
+    srand(2);
+    start = [NSDate timeIntervalSinceReferenceDate];
+    const int seeks = 1000;
+    for (int i = 0; i < seeks; i++) {
+        XCTAssertTrue([decoder seek:first + rand() % MAX(1, last - first)]);
+    }
+    NSLog(@"Random seek: %.3f ms", ([NSDate timeIntervalSinceReferenceDate] - start) * 1000 / seeks);
+    [dvr releaseDecoder:decoder];
+}
+
+@end
@@ -0,0 +1,198 @@
+//
+//  LineBlockCompactStorageTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "iTermBenchmarkTesting.h"
+#import "LineBlock.h"
+#import "LineBuffer+Testing.h"
+#import "LineBufferHelpers.h"
+
+static const int kWidth = 80;
+
+@interface LineBlockCompactStorageTest : XCTestCase
+@end
+
+@implementation LineBlockCompactStorageTest
+
+- (void)tearDown {
+    LineBlockDiscardDecodedCharacters(0);
+    [super tearDown];
+}
+
+- (LineBuffer *)lineBufferStoringCompactly:(BOOL)compact {
+    LineBuffer *lineBuffer = [[[LineBuffer alloc] initWithBlockSize:1000] autorelease];
+    lineBuffer.storesFullBlocksCompactly = compact;
+    lineBuffer.residentBytesLimit = 0;
+    return lineBuffer;
+}
+
+// Appends a line that looks like log output: a dim timestamp, a colored level, and a plain message.
+- (void)appendLogLine:(int)i toLineBuffer:(LineBuffer *)lineBuffer {
+    NSString *level = (i % 10 == 0) ? @"ERROR" : @"INFO";
+    NSString *message = (i % 7 == 0) ? @"naïve café → ok" : @"GET /api/items 200 OK";
+    NSString *string = [NSString stringWithFormat:@"2020-01-01 12:%02d:%02d %@ request=%d %@",
+                        (i / 60) % 60, i % 60, level, i, message];
+    const int length = (int)string.length;
+    screen_char_t *line = (screen_char_t *)calloc(length, sizeof(screen_char_t));
+    for (int j = 0; j < length; j++) {
+        line[j].code = [string characterAtIndex:j];
+        line[j].foregroundColor = 7;
+        line[j].backgroundColor = ALTSEM_DEFAULT;
+        line[j].backgroundColorMode = ColorModeAlternate;
+        if (j < 19) {
+            line[j].faint = YES;
+        } else if (j >= 20 && j < 20 + (int)level.length) {
+            line[j].foregroundColor = (i % 10 == 0) ? 1 : 2;
+            line[j].bold = YES;
+        }
+    }
+    screen_char_t continuation = line[length - 1];
+    continuation.code = EOL_HARD;
+    [lineBuffer appendLine:line
+                    length:length
+                   partial:NO
+                     width:kWidth
+                 timestamp:i
+              continuation:continuation];
+    free(line);
+}
+
+- (void)assertLineBuffer:(LineBuffer *)actual isIdenticalTo:(LineBuffer *)expected {
+    const int n = [expected numLinesWithWidth:kWidth];
+    XCTAssertEqual([actual numLinesWithWidth:kWidth], n);
+    for (int i = 0; i < n; i++) {
+        ScreenCharArray *a = [actual wrappedLineAtIndex:i width:kWidth continuation:NULL];
+        ScreenCharArray *e = [expected wrappedLineAtIndex:i width:kWidth continuation:NULL];
+        XCTAssertEqual(a.length, e.length);
+        XCTAssertEqual(a.eol, e.eol);
+        XCTAssertEqual(memcmp(a.line, e.line, sizeof(screen_char_t) * e.length), 0, @"Line %d differs", i);
+    }
+}
+
+- (void)testCompactBlocksDecodeExactly {
+    LineBuffer *plain = [self lineBufferStoringCompactly:NO];
+    LineBuffer *compact = [self lineBufferStoringCompactly:YES];
+    for (int i = 0; i < 3000; i++) {
+        [self appendLogLine:i toLineBuffer:plain];
+        [self appendLogLine:i toLineBuffer:compact];
+    }
+    XCTAssertLessThan(compact.residentBytes, plain.residentBytes / 2);
+    [self assertLineBuffer:compact isIdenticalTo:plain];
+    XCTAssertEqualObjects([compact positionsOf:@"café"], [plain positionsOf:@"café"]);
+    XCTAssertEqualObjects([compact positionsOf:@"request=1234 "], [plain positionsOf:@"request=1234 "]);
+
+    // Decoded characters can be freed and decoded again.
+    LineBlockDiscardDecodedCharacters(0);
+    [self assertLineBuffer:compact isIdenticalTo:plain];
+
+    // Popping lines into a compact block and appending to it turns it back into an ordinary block.
+    screen_char_t line[kWidth];
+    int includesEndOfLine;
+    for (LineBuffer *lineBuffer in @[ plain, compact ]) {
+        while ([lineBuffer numLinesWithWidth:kWidth] > 1000) {
+            XCTAssertTrue([lineBuffer popAndCopyLastLineInto:line
+                                                       width:kWidth
+                                           includesEndOfLine:&includesEndOfLine
+                                                   timestamp:NULL
+                                                continuation:NULL]);
+        }
+        for (int i = 1000; i < 2000; i++) {
+            [self appendLogLine:i toLineBuffer:lineBuffer];
+        }
+    }
+    LineBlockDiscardDecodedCharacters(0);
+    [self assertLineBuffer:compact isIdenticalTo:plain];
+}
+
+- (LineBlock *)compactBlockWithLines:(int)count {
+    LineBuffer *lineBuffer = [self lineBufferStoringCompactly:NO];
+    LineBlock *block = [[[LineBlock alloc] initWithRawBufferSize:100000] autorelease];
+    for (int i = 0; i < count; i++) {
+        [self appendLogLine:i toLineBuffer:lineBuffer];
+    }
+    for (int i = 0; i < count; i++) {
+        ScreenCharArray *line = [lineBuffer wrappedLineAtIndex:i width:kWidth continuation:NULL];
+        XCTAssertTrue([block appendLine:line.line
+                                 length:line.length
+                                partial:NO
+                                  width:kWidth
+                              timestamp:i
+                           continuation:line.continuation]);
+    }
+    XCTAssertTrue([block storeCompactly]);
+    return block;
+}
+
+- (void)testReturnedCharactersOutliveDiscard {
+    LineBlock *block = [self compactBlockWithLines:100];
+    @autoreleasepool {
+        screen_char_t *first = [block rawLine:0];
+        const int length = [block getRawLineLength:0];
+        NSMutableData *expected = [NSMutableData dataWithBytes:first length:length * sizeof(screen_char_t)];
+        LineBlockDiscardDecodedCharacters(0);
+        XCTAssertEqual(memcmp(first, expected.bytes, expected.length), 0);
+        XCTAssertEqual(memcmp([block rawLine:0], expected.bytes, expected.length), 0);
+    }
+}
+
+- (void)testCopyOfCompactBlockStaysCompact {
+    LineBlock *block = [self compactBlockWithLines:100];
+    LineBlockDiscardDecodedCharacters(0);
+    const long long residentBytes = block.residentBytes;
+    LineBlock *copy = [[block copy] autorelease];
+    XCTAssertTrue(copy.isCompact);
+    XCTAssertEqual(copy.residentBytes, residentBytes);
+    for (int i = 0; i < 100; i++) {
+        const int length = [block getRawLineLength:i];
+        XCTAssertEqual([copy getRawLineLength:i], length);
+        XCTAssertEqual(memcmp([copy rawLine:i], [block rawLine:i], length * sizeof(screen_char_t)), 0);
+    }
+}
+
+// Logs the bytes of characters per line with and without compact storage and the cost of decoding
+// them again.
+- (void)testBytesPerLineAndDecodeCost {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    const int numberOfLines = 200000;
+    LineBuffer *plain = [[[LineBuffer alloc] init] autorelease];
+    plain.storesFullBlocksCompactly = NO;
+    plain.residentBytesLimit = 0;
+    LineBuffer *compact = [[[LineBuffer alloc] init] autorelease];
+    compact.storesFullBlocksCompactly = YES;
+    compact.residentBytesLimit = 0;
+    for (int i = 0; i < numberOfLines; i++) {
+        [self appendLogLine:i toLineBuffer:plain];
+        [self appendLogLine:i toLineBuffer:compact];
+    }
+    LineBlockDiscardDecodedCharacters(0);
+    const double plainBytesPerLine = (double)plain.residentBytes / numberOfLines;
+    const double compactBytesPerLine = (double)compact.residentBytes / numberOfLines;
+    NSLog(@"Bytes of characters per line: %.1f plain, %.1f compact (%.1fx smaller)",
+          plainBytesPerLine, compactBytesPerLine, plainBytesPerLine / compactBytesPerLine);
+    XCTAssertGreaterThanOrEqual(plainBytesPerLine / compactBytesPerLine, 4);
+
+    const int n = [compact numLinesWithWidth:kWidth];
+    for (LineBuffer *lineBuffer in @[ plain, compact ]) {
+        NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+        unsigned long long sum = 0;
+        for (int i = 0; i < n; i++) {
+            @autoreleasepool {
+                ScreenCharArray *line = [lineBuffer wrappedLineAtIndex:i width:kWidth continuation:NULL];
+                sum += line.line[0].code;
+            }
+            if (i % 1000 == 0) {
+                LineBlockDiscardDecodedCharacters(0);
+            }
+        }
+        NSLog(@"Read %d lines %@: %.1f ms (checksum %llu)",
+              n, lineBuffer == plain ? @"from plain blocks" : @"decoding compact blocks",
+              ([NSDate timeIntervalSinceReferenceDate] - start) * 1000, sum);
+    }
+}
+
+@end
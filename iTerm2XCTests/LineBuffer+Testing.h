@@ -0,0 +1,28 @@
+//
+//  LineBuffer+Testing.h
+//  iTerm2XCTests
+//
+
+#import "LineBuffer.h"
+
+// Helpers shared by the LineBuffer tests.
+@interface LineBuffer (Testing)
+
+// Appends one line per number from first to first + count - 1. Each line holds its number as
+// eight zero-padded digits in one of eight foreground colors, and is timestamped with its number.
+- (void)appendNumberedLines:(int)count startingAt:(int)first width:(int)width;
+
+// The whole buffer wrapped to width, with continuation marks.
+- (NSString *)compactLineDumpWithWidth:(int)width;
+
+// Returns the positions of all matches of needle, first to last. Without a mode, the search is
+// case-sensitive.
+- (NSArray<NSNumber *> *)positionsOf:(NSString *)needle;
+- (NSArray<NSNumber *> *)positionsOf:(NSString *)needle mode:(iTermFindMode)mode;
+
+// Returns the positions of all matches in the order they are found.
+- (NSArray<NSNumber *> *)positionsOf:(NSString *)needle
+                                mode:(iTermFindMode)mode
+                           backwards:(BOOL)backwards;
+
+@end
@@ -0,0 +1,70 @@
+//
+//  LineBuffer+Testing.m
+//  iTerm2XCTests
+//
+
+#import "LineBuffer+Testing.h"
+
+#import "FindContext.h"
+#import "LineBufferPosition.h"
+
+@implementation LineBuffer (Testing)
+
+- (void)appendNumberedLines:(int)count startingAt:(int)first width:(int)width {
+    screen_char_t line[16];
+    memset(line, 0, sizeof(line));
+    screen_char_t continuation = { 0 };
+    continuation.code = EOL_HARD;
+    for (int i = first; i < first + count; i++) {
+        char digits[16];
+        const int length = snprintf(digits, sizeof(digits), "%08d", i);
+        for (int j = 0; j < length; j++) {
+            line[j].code = digits[j];
+            line[j].foregroundColor = i % 8;
+        }
+        [self appendLine:line
+                  length:length
+                 partial:NO
+                   width:width
+               timestamp:i
+            continuation:continuation];
+    }
+}
+
+- (NSString *)compactLineDumpWithWidth:(int)width {
+    return [self compactLineDumpWithWidth:width andContinuationMarks:YES];
+}
+
+- (NSArray<NSNumber *> *)positionsOf:(NSString *)needle {
+    return [self positionsOf:needle mode:iTermFindModeCaseSensitiveSubstring];
+}
+
+- (NSArray<NSNumber *> *)positionsOf:(NSString *)needle mode:(iTermFindMode)mode {
+    return [self positionsOf:needle mode:mode backwards:NO];
+}
+
+- (NSArray<NSNumber *> *)positionsOf:(NSString *)needle
+                                mode:(iTermFindMode)mode
+                           backwards:(BOOL)backwards {
+    FindContext *context = [[[FindContext alloc] init] autorelease];
+    [self prepareToSearchFor:needle
+                  startingAt:backwards ? [[self lastPosition] predecessor] : [self firstPosition]
+                     options:FindMultipleResults | (backwards ? FindOptBackwards : 0)
+                        mode:mode
+                 withContext:context];
+    NSMutableArray<NSNumber *> *positions = [NSMutableArray array];
+    LineBufferPosition *stopAt = backwards ? [self firstPosition] : [self lastPosition];
+    while (context.status != NotFound) {
+        [self findSubstring:context stopAt:stopAt];
+        for (ResultRange *range in context.results) {
+            [positions addObject:@(range->position)];
+        }
+        [context.results removeAllObjects];
+        if (context.status == Matched) {
+            context.status = Searching;
+        }
+    }
+    return positions;
+}
+
+@end
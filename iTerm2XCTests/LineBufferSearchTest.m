@@ -0,0 +1,215 @@
+//
+//  LineBufferSearchTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "FindContext.h"
+#import "iTermBenchmarkTesting.h"
+#import "LineBlock.h"
+#import "LineBuffer+Testing.h"
+#import "LineBufferHelpers.h"
+#import "LineBufferPosition.h"
+
+static const int kWidth = 80;
+
+@interface LineBufferSearchTest : XCTestCase
+@end
+
+@implementation LineBufferSearchTest
+
+- (void)tearDown {
+    LineBlockSetSearchIndexEnabled(YES);
+    [super tearDown];
+}
+
+- (void)appendString:(NSString *)string toLineBuffer:(LineBuffer *)lineBuffer partial:(BOOL)partial {
+    const int length = (int)string.length;
+    screen_char_t *line = (screen_char_t *)calloc(MAX(1, length), sizeof(screen_char_t));
+    for (int i = 0; i < length; i++) {
+        line[i].code = [string characterAtIndex:i];
+    }
+    screen_char_t continuation = { 0 };
+    continuation.code = partial ? EOL_SOFT : EOL_HARD;
+    [lineBuffer appendLine:line
+                    length:length
+                   partial:partial
+                     width:kWidth
+                 timestamp:0
+              continuation:continuation];
+    free(line);
+}
+
+- (LineBuffer *)lineBufferWithLines:(int)count blockSize:(int)blockSize needleAtLine:(int)needleLine {
+    LineBuffer *lineBuffer = [[[LineBuffer alloc] initWithBlockSize:blockSize] autorelease];
+    for (int i = 0; i < count; i++) {
+        @autoreleasepool {
+            NSString *line;
+            if (i == needleLine) {
+                line = [NSString stringWithFormat:@"%07d GET /api/items/%d needle in the haystack", i, i];
+            } else {
+                line = [NSString stringWithFormat:@"%07d GET /api/items/%d 200 OK", i, i];
+            }
+            [self appendString:line toLineBuffer:lineBuffer partial:NO];
+        }
+    }
+    return lineBuffer;
+}
+
+// Builds the same history with and without the index and checks that every search agrees,
+// including after lines are dropped from the top and popped from the bottom.
+- (void)testIndexedSearchFindsTheSameMatches {
+    NSArray<NSString *> *words = @[ @"alpha", @"Bravo", @"charlie", @"DELTA", @"echo", @"für", @"x" ];
+    LineBuffer *buffers[2];
+    for (int indexed = 0; indexed < 2; indexed++) {
+        LineBlockSetSearchIndexEnabled(indexed);
+        LineBuffer *lineBuffer = [[[LineBuffer alloc] initWithBlockSize:200] autorelease];
+        [lineBuffer setMaxLines:300];
+        unsigned int seed = 1;
+        for (int i = 0; i < 500; i++) {
+            NSMutableString *line = [NSMutableString string];
+            const int count = rand_r(&seed) % 6;
+            for (int j = 0; j < count; j++) {
+                [line appendFormat:@"%@ ", words[rand_r(&seed) % words.count]];
+            }
+            // Wrapped lines arrive in pieces, so trigrams can straddle appends.
+            [self appendString:line toLineBuffer:lineBuffer partial:(rand_r(&seed) % 4 == 0)];
+            [lineBuffer dropExcessLinesWithWidth:kWidth];
+        }
+        screen_char_t popped[kWidth];
+        int eol;
+        [lineBuffer popAndCopyLastLineInto:popped
+                                     width:kWidth
+                         includesEndOfLine:&eol
+                                 timestamp:NULL
+                              continuation:NULL];
+        buffers[indexed] = lineBuffer;
+    }
+
+    NSArray<NSString *> *needles = @[ @"alpha bravo", @"o c", @"echo DEL", @"lta", @"für", @"zulu", @"a x" ];
+    const iTermFindMode modes[] = {
+        iTermFindModeSmartCaseSensitivity,
+        iTermFindModeCaseSensitiveSubstring,
+        iTermFindModeCaseInsensitiveSubstring,
+        iTermFindModeCaseSensitiveRegex
+    };
+    for (NSString *needle in needles) {
+        for (size_t i = 0; i < sizeof(modes) / sizeof(*modes); i++) {
+            XCTAssertEqualObjects([buffers[1] positionsOf:needle mode:modes[i]],
+                                  [buffers[0] positionsOf:needle mode:modes[i]],
+                                  @"needle=%@ mode=%@", needle, @(modes[i]));
+        }
+    }
+}
+
+- (void)testConcurrentSearchFindsTheSameMatches {
+    LineBuffer *lineBuffer = [[[LineBuffer alloc] initWithBlockSize:300] autorelease];
+    for (int i = 0; i < 2000; i++) {
+        [self appendString:[NSString stringWithFormat:@"line %d %@", i, (i % 7) ? @"foo" : @"foobar"]
+              toLineBuffer:lineBuffer
+                   partial:NO];
+    }
+    for (NSString *needle in @[ @"foobar", @"foo", @"line 1", @"[0-9]+3 f" ]) {
+        const iTermFindMode mode = [needle hasPrefix:@"["] ? iTermFindModeCaseSensitiveRegex : iTermFindModeCaseSensitiveSubstring;
+        for (int backwards = 0; backwards < 2; backwards++) {
+            lineBuffer.searchesBlocksConcurrently = NO;
+            NSArray *expected = [lineBuffer positionsOf:needle mode:mode backwards:backwards];
+            lineBuffer.searchesBlocksConcurrently = YES;
+            NSArray *actual = [lineBuffer positionsOf:needle mode:mode backwards:backwards];
+            XCTAssertGreaterThan(expected.count, 0);
+            XCTAssertEqualObjects(actual, expected, @"needle=%@ backwards=%@", needle, @(backwards));
+        }
+    }
+}
+
+// Finds all matches in 2 GB of scrollback (about 180M cells) with one thread and then with one
+// per core. Logs the wall-clock time of each.
+- (void)testConcurrentSearchBenchmark {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    const long long kScrollbackBytes = 2LL << 30;
+    const int kLineLength = 200;
+    const long long kLines = kScrollbackBytes / (kLineLength * (long long)sizeof(screen_char_t));
+    LineBuffer *lineBuffer = [[[LineBuffer alloc] init] autorelease];
+    screen_char_t line[kLineLength];
+    memset(line, 0, sizeof(line));
+    screen_char_t continuation = { 0 };
+    continuation.code = EOL_HARD;
+    for (long long i = 0; i < kLines; i++) {
+        for (int j = 0; j < kLineLength; j++) {
+            line[j].code = 'a' + (i * 31 + j * 7) % 26;
+        }
+        if (i % 1000 == 0) {
+            const char *needle = "needle";
+            for (int j = 0; needle[j]; j++) {
+                line[50 + j].code = needle[j];
+            }
+        }
+        [lineBuffer appendLine:line
+                        length:kLineLength
+                       partial:NO
+                         width:kWidth
+                     timestamp:0
+                  continuation:continuation];
+    }
+
+    NSUInteger counts[2];
+    for (int concurrent = 0; concurrent < 2; concurrent++) {
+        lineBuffer.searchesBlocksConcurrently = concurrent;
+        const NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+        counts[concurrent] = [[lineBuffer positionsOf:@"needle" mode:iTermFindModeCaseSensitiveSubstring] count];
+        const NSTimeInterval elapsed = [NSDate timeIntervalSinceReferenceDate] - start;
+        NSLog(@"%@: found %@ matches in %lld lines in %.2f s",
+              concurrent ? @"Concurrent" : @"Serial",
+              @(counts[concurrent]),
+              kLines,
+              elapsed);
+    }
+    XCTAssertEqual(counts[0], (NSUInteger)((kLines + 999) / 1000));
+    XCTAssertEqual(counts[1], counts[0]);
+}
+
+// Compares scanning a synthetic 1M-line history with and without the index. Logs the latency to
+// the first result for a needle near the bottom and the time to scan everything for an absent
+// needle.
+- (void)testSearchIndexBenchmark {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    const int kLines = 1000000;
+    for (int indexed = 0; indexed < 2; indexed++) {
+        LineBlockSetSearchIndexEnabled(indexed);
+        LineBuffer *lineBuffer = [self lineBufferWithLines:kLines
+                                                 blockSize:8192
+                                              needleAtLine:kLines - 1000];
+
+        NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+        FindContext *context = [[[FindContext alloc] init] autorelease];
+        [lineBuffer prepareToSearchFor:@"needle"
+                            startingAt:[lineBuffer firstPosition]
+                               options:0
+                                  mode:iTermFindModeSmartCaseSensitivity
+                           withContext:context];
+        LineBufferPosition *stopAt = [lineBuffer lastPosition];
+        while (context.status == Searching) {
+            [lineBuffer findSubstring:context stopAt:stopAt];
+        }
+        const NSTimeInterval firstResult = [NSDate timeIntervalSinceReferenceDate] - start;
+        XCTAssertEqual(context.status, Matched);
+
+        start = [NSDate timeIntervalSinceReferenceDate];
+        NSArray *positions = [lineBuffer positionsOf:@"not there" mode:iTermFindModeSmartCaseSensitivity];
+        const NSTimeInterval fullScan = [NSDate timeIntervalSinceReferenceDate] - start;
+        XCTAssertEqual(positions.count, 0);
+
+        NSLog(@"%@: first result after %.1f ms, full scan of %d lines in %.1f ms",
+              indexed ? @"Indexed" : @"Unindexed",
+              firstResult * 1000,
+              kLines,
+              fullScan * 1000);
+    }
+}
+
+@end
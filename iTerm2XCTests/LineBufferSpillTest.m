@@ -0,0 +1,111 @@
+//
+//  LineBufferSpillTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+#include <mach/mach.h>
+
+#import "iTermBenchmarkTesting.h"
+#import "LineBlock.h"
+#import "LineBuffer+Testing.h"
+#import "LineBufferHelpers.h"
+
+static const int kWidth = 80;
+static const int kBlockSize = 1000;
+
+@interface LineBufferSpillTest : XCTestCase
+@end
+
+@implementation LineBufferSpillTest
+
+- (long long)residentSize {
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+        return -1;
+    }
+    return info.resident_size;
+}
+
+// Builds the same history with and without a resident limit and checks that reading, searching,
+// popping, and dropping lines can't tell the difference.
+- (void)testSpilledBlocksBehaveLikeResidentBlocks {
+    const long long limit = 10 * kBlockSize * sizeof(screen_char_t);
+    LineBuffer *resident = [[[LineBuffer alloc] initWithBlockSize:kBlockSize] autorelease];
+    resident.residentBytesLimit = 0;
+    LineBuffer *spilled = [[[LineBuffer alloc] initWithBlockSize:kBlockSize] autorelease];
+    spilled.residentBytesLimit = limit;
+    for (LineBuffer *lineBuffer in @[ resident, spilled ]) {
+        [lineBuffer appendNumberedLines:20000 startingAt:0 width:kWidth];
+    }
+
+    XCTAssertEqual(resident.spilledBytes, 0);
+    XCTAssertGreaterThan(spilled.spilledBytes, 0);
+    // The last block and the one that pushed the total over the limit may be resident too.
+    XCTAssertLessThanOrEqual(spilled.residentBytes, limit + 2 * kBlockSize * (long long)sizeof(screen_char_t));
+    XCTAssertEqualObjects([spilled compactLineDumpWithWidth:kWidth], [resident compactLineDumpWithWidth:kWidth]);
+    XCTAssertEqualObjects([spilled positionsOf:@"00000123"], [resident positionsOf:@"00000123"]);
+    XCTAssertEqualObjects([spilled positionsOf:@"0001999"], [resident positionsOf:@"0001999"]);
+
+    // Pop back into spilled blocks, then append to them.
+    screen_char_t line[kWidth];
+    int includesEndOfLine;
+    for (LineBuffer *lineBuffer in @[ resident, spilled ]) {
+        while ([lineBuffer numLinesWithWidth:kWidth] > 1000) {
+            XCTAssertTrue([lineBuffer popAndCopyLastLineInto:line
+                                                       width:kWidth
+                                           includesEndOfLine:&includesEndOfLine
+                                                   timestamp:NULL
+                                                continuation:NULL]);
+        }
+        [lineBuffer appendNumberedLines:5000 startingAt:1000 width:kWidth];
+    }
+    XCTAssertEqualObjects([spilled compactLineDumpWithWidth:kWidth], [resident compactLineDumpWithWidth:kWidth]);
+
+    // Dropping spilled blocks gives their space back.
+    const long long spilledBefore = spilled.spilledBytes;
+    for (LineBuffer *lineBuffer in @[ resident, spilled ]) {
+        [lineBuffer setMaxLines:2000];
+        [lineBuffer dropExcessLinesWithWidth:kWidth];
+    }
+    XCTAssertLessThan(spilled.spilledBytes, spilledBefore);
+    XCTAssertEqualObjects([spilled compactLineDumpWithWidth:kWidth], [resident compactLineDumpWithWidth:kWidth]);
+}
+
+// Logs the process's resident memory and the buffer's resident and spilled bytes while appending
+// 20M lines with the default resident limit.
+- (void)testResidentMemoryFor20MLines {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    const int numberOfLines = 20000000;
+    const int step = 2000000;
+    const long long initialResidentSize = [self residentSize];
+    LineBuffer *lineBuffer = [[[LineBuffer alloc] init] autorelease];
+    NSLog(@"Resident limit: %@ bytes", @(lineBuffer.residentBytesLimit));
+    NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    for (int i = 0; i < numberOfLines; i += step) {
+        @autoreleasepool {
+            [lineBuffer appendNumberedLines:step startingAt:i width:kWidth];
+        }
+        NSLog(@"%d lines: RSS grew by %.1f MB, %.1f MB of characters resident, %.1f MB spilled",
+              i + step,
+              ([self residentSize] - initialResidentSize) / 1048576.0,
+              lineBuffer.residentBytes / 1048576.0,
+              lineBuffer.spilledBytes / 1048576.0);
+    }
+    NSLog(@"Appended %d lines in %.1f s", numberOfLines, [NSDate timeIntervalSinceReferenceDate] - start);
+
+    start = [NSDate timeIntervalSinceReferenceDate];
+    NSArray<NSNumber *> *positions = [lineBuffer positionsOf:@"00000042"];
+    NSLog(@"Searched all lines in %.1f s", [NSDate timeIntervalSinceReferenceDate] - start);
+    XCTAssertEqual(positions.count, 1);
+
+    ScreenCharArray *first = [lineBuffer wrappedLineAtIndex:0 width:kWidth continuation:NULL];
+    XCTAssertEqual(first.line[7].code, '0');
+    XCTAssertLessThanOrEqual(lineBuffer.residentBytes,
+                             lineBuffer.residentBytesLimit + 2 * 8192 * (long long)sizeof(screen_char_t));
+}
+
+@end
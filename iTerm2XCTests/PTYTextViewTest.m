@@ -2655,7 +2655,7 @@ static NSString *const kDiffScriptPath = @"/tmp/diffs";
     [self registerCall:_cmd];
 }
 
-- (void)textViewDidFindDirtyRects {
+- (void)textViewDidFindDirtyRectsOnLines:(NSIndexSet *)lines {
 }
 
 - (iTermBackgroundImageMode)backgroundImageMode {
@@ -0,0 +1,170 @@
+//
+//  TmuxGatewayTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "TmuxController.h"
+#import "TmuxGateway.h"
+#import "VT100Token.h"
+
+// Stands in for the PTYSession of a pane and records what it's given.
+@interface TmuxGatewayTestSession : NSObject
+@property (nonatomic) int windowPane;
+@property (nonatomic, assign) NSMutableArray<NSString *> *events;
+@end
+
+@implementation TmuxGatewayTestSession
+
+- (void)tmuxReadTask:(NSData *)data {
+    // Latin-1 maps every byte to one character, so the events show exactly what was delivered.
+    NSString *string = [[[NSString alloc] initWithData:data encoding:NSISOLatin1StringEncoding] autorelease];
+    [self.events addObject:[NSString stringWithFormat:@"%%%d %@", self.windowPane, string]];
+}
+
+@end
+
+// Stands in for both the TmuxController and the gateway's delegate.
+@interface TmuxGatewayTestDelegate : NSObject
+@property (nonatomic, readonly) NSMutableArray<NSString *> *events;
+@end
+
+@implementation TmuxGatewayTestDelegate {
+    NSMutableDictionary<NSNumber *, TmuxGatewayTestSession *> *_sessions;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _events = [[NSMutableArray alloc] init];
+        _sessions = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_events release];
+    [_sessions release];
+    [super dealloc];
+}
+
+- (TmuxController *)tmuxController {
+    return (TmuxController *)self;
+}
+
+- (PTYSession *)sessionForWindowPane:(int)windowPane {
+    TmuxGatewayTestSession *session = _sessions[@(windowPane)];
+    if (!session) {
+        session = [[[TmuxGatewayTestSession alloc] init] autorelease];
+        session.windowPane = windowPane;
+        session.events = _events;
+        _sessions[@(windowPane)] = session;
+    }
+    return (PTYSession *)session;
+}
+
+- (void)tmuxUpdateLayoutForWindow:(int)windowId layout:(NSString *)layout zoomed:(NSNumber *)zoomed {
+    [_events addObject:[NSString stringWithFormat:@"layout @%d %@", windowId, layout]];
+}
+
+- (void)tmuxHostDisconnected:(NSString *)dcsID {
+    [_events addObject:@"disconnected"];
+}
+
+- (void)tmuxPrintLine:(NSString *)line {
+}
+
+@end
+
+@interface TmuxGatewayTest : XCTestCase
+@end
+
+@implementation TmuxGatewayTest {
+    TmuxGatewayTestDelegate *_delegate;
+    TmuxGateway *_gateway;
+}
+
+- (void)setUp {
+    [super setUp];
+    _delegate = [[TmuxGatewayTestDelegate alloc] init];
+    _gateway = [[TmuxGateway alloc] initWithDelegate:(id<TmuxGatewayDelegate>)_delegate dcsID:@"1000"];
+    _gateway.acceptNotifications = YES;
+}
+
+- (void)tearDown {
+    [_gateway release];
+    [_delegate release];
+    [super tearDown];
+}
+
+- (void)executeLine:(const char *)line {
+    VT100Token *token = [VT100Token token];
+    token->type = TMUX_LINE;
+    token.savedData = [NSData dataWithBytes:line length:strlen(line)];
+    token.string = [[[NSString alloc] initWithData:token.savedData encoding:NSISOLatin1StringEncoding] autorelease];
+    [_gateway executeToken:token];
+}
+
+- (NSString *)outputForData:(const char *)data {
+    [self executeLine:[[NSString stringWithFormat:@"%%output %%1 %s", data] UTF8String]];
+    [_gateway flushPendingOutput];
+    NSString *event = _delegate.events.lastObject;
+    [_delegate.events removeAllObjects];
+    XCTAssertTrue([event hasPrefix:@"%1 "], @"%@", event);
+    return [event substringFromIndex:3];
+}
+
+- (void)testOctalEscapes {
+    XCTAssertEqualObjects([self outputForData:"plain text"], @"plain text");
+    XCTAssertEqualObjects([self outputForData:"a\\015\\012b"], @"a\r\nb");
+    XCTAssertEqualObjects([self outputForData:"\\033[1mbold"], @"\033[1mbold");
+    XCTAssertEqualObjects([self outputForData:"back\\134slash"], @"back\\slash");
+    // Unescaped control characters are dropped.
+    XCTAssertEqualObjects([self outputForData:"a\rb"], @"ab");
+}
+
+- (void)testMalformedEscapes {
+    // An escape that isn't followed by three octal digits becomes ? and the rest is kept as data.
+    XCTAssertEqualObjects([self outputForData:"a\\9bc"], @"a?9bc");
+    XCTAssertEqualObjects([self outputForData:"a\\01x"], @"a?x");
+    // A trailing escape, complete or not.
+    XCTAssertEqualObjects([self outputForData:"a\\"], @"a?");
+    XCTAssertEqualObjects([self outputForData:"a\\01"], @"a?");
+    XCTAssertEqualObjects([self outputForData:"a\\101"], @"aA");
+}
+
+- (void)testConsecutiveOutputForOnePaneIsMerged {
+    [self executeLine:"%output %1 one"];
+    [self executeLine:"%output %1 \\015\\012"];
+    [self executeLine:"%output %1 two"];
+    XCTAssertEqualObjects(_delegate.events, @[]);
+    [_gateway flushPendingOutput];
+    XCTAssertEqualObjects(_delegate.events, @[ @"%1 one\r\ntwo" ]);
+
+    // Nothing is left to deliver.
+    [_gateway flushPendingOutput];
+    XCTAssertEqual(_delegate.events.count, (NSUInteger)1);
+}
+
+- (void)testSwitchingPanesKeepsOrder {
+    [self executeLine:"%output %1 a"];
+    [self executeLine:"%output %1 b"];
+    [self executeLine:"%output %2 c"];
+    [self executeLine:"%output %1 d"];
+    [_gateway flushPendingOutput];
+    XCTAssertEqualObjects(_delegate.events, (@[ @"%1 ab", @"%2 c", @"%1 d" ]));
+}
+
+- (void)testOutputIsDeliveredBeforeOtherNotifications {
+    [self executeLine:"%output %1 before layout"];
+    [self executeLine:"%layout-change @3 b65d,80x25,0,0,0"];
+    [self executeLine:"%output %2 before exit"];
+    [self executeLine:"%exit"];
+    XCTAssertEqualObjects(_delegate.events, (@[ @"%1 before layout",
+                                                @"layout @3 b65d,80x25,0,0,0",
+                                                @"%2 before exit",
+                                                @"disconnected" ]));
+}
+
+@end
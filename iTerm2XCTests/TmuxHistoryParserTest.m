@@ -0,0 +1,106 @@
+//
+//  TmuxHistoryParserTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "iTermBenchmarkTesting.h"
+#import "ScreenChar.h"
+#import "TmuxHistoryParser.h"
+
+@interface TmuxHistoryParserTest : XCTestCase
+@end
+
+@implementation TmuxHistoryParserTest
+
+// Makes history like capture-pane -e produces, where attributes set on one line carry over to the
+// lines after it until they're reset.
+- (NSString *)historyWithNumberOfLines:(int)numberOfLines {
+    NSMutableString *history = [NSMutableString string];
+    for (int i = 0; i < numberOfLines; i++) {
+        if (i % 7 == 0) {
+            [history appendFormat:@"\e[38;5;%dm", i % 256];
+        }
+        if (i % 11 == 0) {
+            [history appendString:@"\e[1;4m"];
+        }
+        if (i % 13 == 0) {
+            [history appendString:@"\e[0m"];
+        }
+        [history appendFormat:@"line %06d: the quick brown fox jumps over the lazy dog", i];
+        if (i % 5 == 0) {
+            [history appendString:@" 日本語"];
+        }
+        if (i % 17 == 0) {
+            [history appendString:@"\016qqq"];
+        }
+        if (i % 19 == 0) {
+            [history appendString:@"\017xyz"];
+        }
+        if (i + 1 < numberOfLines) {
+            [history appendString:@"\n"];
+        }
+    }
+    return history;
+}
+
+- (NSArray<NSData *> *)parse:(NSString *)history bytesPerChunk:(NSUInteger)bytesPerChunk {
+    TmuxHistoryParser *parser = [[[TmuxHistoryParser alloc] init] autorelease];
+    parser.bytesPerChunk = bytesPerChunk;
+    return [parser parseDumpHistoryResponse:history ambiguousIsDoubleWidth:NO unicodeVersion:9];
+}
+
+- (void)testChunksParseLikeWholeHistory {
+    NSString *history = [self historyWithNumberOfLines:1000];
+    NSArray<NSData *> *expected = [self parse:history bytesPerChunk:NSUIntegerMax];
+    XCTAssertEqual(expected.count, 1000);
+
+    // Lines with attributes and the line drawing character set carried over from earlier chunks.
+    screen_char_t *line12 = (screen_char_t *)expected[12].bytes;
+    XCTAssertEqual(line12[0].foregroundColor, 7);
+    XCTAssertTrue(line12[0].bold);
+    screen_char_t *line18 = (screen_char_t *)expected[18].bytes;
+    XCTAssertEqual(line18[0].code, 0x250c);  // 'l' of "line" in the line drawing character set
+
+    for (NSNumber *bytesPerChunk in @[ @1, @100, @4096 ]) {
+        XCTAssertEqualObjects([self parse:history bytesPerChunk:bytesPerChunk.unsignedIntegerValue], expected);
+    }
+}
+
+- (void)testEmptyLines {
+    NSArray<NSData *> *lines = [self parse:@"\na\n\n" bytesPerChunk:1];
+    XCTAssertEqual(lines.count, 4);
+    XCTAssertEqual(lines[0].length, 0);
+    XCTAssertEqual(lines[1].length, sizeof(screen_char_t));
+    XCTAssertEqual(lines[2].length, 0);
+    XCTAssertEqual(lines[3].length, 0);
+    XCTAssertEqualObjects([self parse:@"" bytesPerChunk:1], @[]);
+}
+
+// Logs the time to parse the history of every pane when attaching, for various numbers of panes
+// and lines of history, parsing each pane's history serially and in chunks.
+- (void)testAttachTime {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    for (NSNumber *depth in @[ @1000, @10000, @50000 ]) {
+        NSString *history = [self historyWithNumberOfLines:depth.intValue];
+        for (NSNumber *panes in @[ @1, @10, @50 ]) {
+            for (NSNumber *bytesPerChunk in @[ @(NSUIntegerMax), @(128 * 1024) ]) {
+                const NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+                for (int i = 0; i < panes.intValue; i++) {
+                    @autoreleasepool {
+                        [self parse:history bytesPerChunk:bytesPerChunk.unsignedIntegerValue];
+                    }
+                }
+                NSLog(@"%@ panes of %@ lines, %@: %.0f ms",
+                      panes, depth,
+                      bytesPerChunk.unsignedIntegerValue == NSUIntegerMax ? @"serial" : @"chunked",
+                      ([NSDate timeIntervalSinceReferenceDate] - start) * 1000);
+            }
+        }
+    }
+}
+
+@end
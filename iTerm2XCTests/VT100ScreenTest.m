@@ -14,6 +14,7 @@
 #import "SearchResult.h"
 #import "TmuxStateParser.h"
 #import "VT100Screen.h"
+#import "VT100TokenPool.h"
 #import "iTermSelection.h"
 
 static const NSInteger kUnicodeVersion = 9;
@@ -1962,6 +1963,81 @@ NSLog(@"Known bug: %s should be true, but %s is.", #expressionThatShouldBeTrue,
     XCTAssert(line[i++].code == 0);
 }
 
+// Parses |string| and executes its tokens one at a time or, if |coalesce| is set, with each run of
+// string tokens appended together. Returns the screen contents followed by the text reported to
+// the trigger line.
+- (NSString *)lineDumpAfterExecutingString:(NSString *)string coalesce:(BOOL)coalesce {
+    terminal_ = [[[VT100Terminal alloc] init] autorelease];
+    triggerLine_ = [NSMutableString string];
+    VT100Screen *screen = [self screenWithWidth:5 height:4];
+    screen.delegate = (id<VT100ScreenDelegate>)self;
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+    [terminal_.parser putStreamData:data.bytes length:data.length];
+    CVector vector;
+    CVectorCreate(&vector, 1);
+    [terminal_.parser addParsedTokensToVector:&vector];
+    BOOL merged = NO;
+    int i = 0;
+    while (i < CVectorCount(&vector)) {
+        if (coalesce) {
+            const int executed = [terminal_ executeTokensInVector:&vector startingAtIndex:i];
+            merged = merged || executed > 1;
+            i += executed;
+        } else {
+            [terminal_ executeToken:CVectorGetObject(&vector, i)];
+            i++;
+        }
+    }
+    if (coalesce) {
+        XCTAssertTrue(merged, @"No string tokens were appended together for %@", string);
+    }
+    [terminal_.parser.tokenPool recycleTokensInVector:&vector];
+    CVectorDestroy(&vector);
+    return [NSString stringWithFormat:@"%@\n%@", [screen compactLineDump], triggerLine_];
+}
+
+- (void)assertCoalescedStringTokensAppendLikeSeparateTokens:(NSString *)string {
+    NSString *expected = [self lineDumpAfterExecutingString:string coalesce:NO];
+    NSString *actual = [self lineDumpAfterExecutingString:string coalesce:YES];
+    XCTAssertEqualObjects(actual, expected, @"for %@", string);
+}
+
+- (void)testCoalescedStringTokensAppendLikeSeparateTokens {
+    // The parser emits ASCII and non-ASCII text as separate tokens. These mix the two, wrap, and
+    // end a run with a double-width character that doesn't fit on the line.
+    [self assertCoalescedStringTokensAppendLikeSeparateTokens:@"ab\u00e9cd\uff25fgh\u00e9ijklm\uff25"];
+    // A combining mark joins the ASCII character before it, which is in the same run.
+    [self assertCoalescedStringTokensAppendLikeSeparateTokens:@"abcde\u0301fg\u0301hi"];
+    // A combining mark at the start of a run joins the character before the cursor.
+    [self assertCoalescedStringTokensAppendLikeSeparateTokens:@"abc\033[D\u0301d\u00e9fghij"];
+    // Only the ASCII text is drawn with the graphics character set.
+    [self assertCoalescedStringTokensAppendLikeSeparateTokens:@"\033(0lqq\u00e9qqk\033(Bxy"];
+    // Without wraparound, the last column is overwritten.
+    [self assertCoalescedStringTokensAppendLikeSeparateTokens:@"\033[?7labcdefg\u0301h\u00e9i"];
+}
+
+- (void)testMixedStringRunIsExecutedTogether {
+    terminal_ = [[[VT100Terminal alloc] init] autorelease];
+    VT100Screen *screen = [self screenWithWidth:20 height:4];
+    screen.delegate = (id<VT100ScreenDelegate>)self;
+    NSData *data = [@"ab\u00e9cd\uff25f\r\ng" dataUsingEncoding:NSUTF8StringEncoding];
+    [terminal_.parser putStreamData:data.bytes length:data.length];
+    CVector vector;
+    CVectorCreate(&vector, 1);
+    [terminal_.parser addParsedTokensToVector:&vector];
+
+    // ab, \u00e9, cd, \uff25, and f are appended together; the CR stops the run.
+    XCTAssertEqual([terminal_ executeTokensInVector:&vector startingAtIndex:0], 5);
+    XCTAssertEqualObjects([screen compactLineDump],
+                          @"ab?cd?-f............\n"
+                          @"....................\n"
+                          @"....................\n"
+                          @"....................");
+    XCTAssertEqual([terminal_ executeTokensInVector:&vector startingAtIndex:5], 1);
+    [terminal_.parser.tokenPool recycleTokensInVector:&vector];
+    CVectorDestroy(&vector);
+}
+
 - (void)testLinefeed {
     // The guts of linefeed is tested in VT100GridTest.
     VT100Screen *screen = [self screenWithWidth:5 height:5];
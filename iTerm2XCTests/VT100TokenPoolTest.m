@@ -0,0 +1,93 @@
+//
+//  VT100TokenPoolTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "iTermBenchmarkTesting.h"
+#import "VT100Parser.h"
+#import "VT100TokenPool.h"
+
+@interface VT100TokenPoolTest : XCTestCase
+@end
+
+@implementation VT100TokenPoolTest
+
+- (void)testRecycledTokenIsReset {
+    VT100TokenPool *pool = [[[VT100TokenPool alloc] init] autorelease];
+    VT100Token *token = [pool newToken];
+    token->type = VT100_ASCIISTRING;
+    [token setAsciiBytes:"hello world hello world" length:23];
+    token.string = @"x";
+    token.csi->count = 2;
+    [pool recycleToken:token];
+
+    VT100Token *reused = [pool newToken];
+    XCTAssertEqual(reused, token);
+    XCTAssertEqual(reused->type, 0);
+    XCTAssertNil(reused.string);
+    XCTAssertEqual(reused.csi->count, 0);
+    XCTAssertTrue(reused.asciiData->buffer == NULL);
+    XCTAssertEqual(reused.asciiData->length, 0);
+
+    // setAsciiBytes asserts the buffer is unset, so this also checks the reset.
+    [reused setAsciiBytes:"abc" length:3];
+    XCTAssertEqualObjects([reused stringForAsciiData], @"abc");
+    [reused release];
+}
+
+- (void)testCopyOutlivesRecycling {
+    VT100TokenPool *pool = [[[VT100TokenPool alloc] init] autorelease];
+    VT100Token *token = [pool newToken];
+    token->type = VT100_ASCIISTRING;
+    [token setAsciiBytes:"kept" length:4];
+    token.string = @"kept";
+    token.csi->count = 1;
+    token.csi->p[0] = 42;
+    VT100Token *copy = [[token copy] autorelease];
+    [pool recycleToken:token];
+
+    VT100Token *reused = [pool newToken];
+    XCTAssertEqual(reused, token);
+    XCTAssertNotEqual(copy, token);
+    XCTAssertEqual(copy->type, VT100_ASCIISTRING);
+    XCTAssertEqualObjects([copy stringForAsciiData], @"kept");
+    XCTAssertEqualObjects(copy.string, @"kept");
+    XCTAssertEqual(copy.csi->count, 1);
+    XCTAssertEqual(copy.csi->p[0], 42);
+    [reused release];
+}
+
+// Parses typical shell output and recycles the tokens the way PTYSession does. Logs tokens/sec.
+- (void)testParseAndRecycleThroughput {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    NSMutableData *data = [NSMutableData data];
+    for (int i = 0; i < 2000; i++) {
+        NSString *line = [NSString stringWithFormat:@"\e[1;32mdrwxr-xr-x\e[0m  %4d staff  \e[34mfile%d.txt\e[m\r\n", i, i];
+        [data appendData:[line dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+    VT100Parser *parser = [[[VT100Parser alloc] init] autorelease];
+    parser.encoding = NSUTF8StringEncoding;
+
+    __block long long tokenCount = 0;
+    const NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    [self measureBlock:^{
+        for (int round = 0; round < 20; round++) {
+            [parser putStreamData:data.bytes length:data.length];
+            CVector vector;
+            CVectorCreate(&vector, 100);
+            [parser addParsedTokensToVector:&vector];
+            tokenCount += CVectorCount(&vector);
+            [parser.tokenPool recycleTokensInVector:&vector];
+            CVectorDestroy(&vector);
+        }
+    }];
+    const NSTimeInterval elapsed = [NSDate timeIntervalSinceReferenceDate] - start;
+    NSLog(@"Parsed and recycled %lld tokens at %.0f tokens/sec", tokenCount, tokenCount / elapsed);
+    XCTAssertGreaterThan(tokenCount, 0);
+}
+
+@end
@@ -0,0 +1,344 @@
+//
+//  iTermAdaptivePasteTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "PTYTask.h"
+#import "PasteContext.h"
+#import "PasteboardHistory.h"
+#import "TaskNotifier.h"
+#import "iTermBenchmarkTesting.h"
+#import "iTermPasteHelper.h"
+
+#include <fcntl.h>
+#include <util.h>
+
+// Pastes into a PTYTask. It can't measure back-pressure, so pastes get fixed pacing.
+@interface iTermPasteBenchmarkDelegate : NSObject<iTermPasteHelperDelegate>
+- (instancetype)initWithTask:(PTYTask *)task bracket:(BOOL)bracket;
+@end
+
+@implementation iTermPasteBenchmarkDelegate {
+@protected
+    PTYTask *_task;
+    BOOL _bracket;
+}
+
+- (instancetype)initWithTask:(PTYTask *)task bracket:(BOOL)bracket {
+    self = [super init];
+    if (self) {
+        _task = [task retain];
+        _bracket = bracket;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_task release];
+    [super dealloc];
+}
+
+- (void)pasteHelperWriteString:(NSString *)string {
+    [_task writeTask:[string dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+- (void)pasteHelperKeyDown:(NSEvent *)event {
+}
+
+- (BOOL)pasteHelperShouldBracket {
+    return _bracket;
+}
+
+- (NSStringEncoding)pasteHelperEncoding {
+    return NSUTF8StringEncoding;
+}
+
+- (NSView *)pasteHelperViewForIndicator {
+    return nil;
+}
+
+- (iTermStatusBarViewController *)pasteHelperStatusBarViewController {
+    return nil;
+}
+
+- (BOOL)pasteHelperIsAtShellPrompt {
+    return NO;
+}
+
+- (BOOL)pasteHelperShouldWaitForPrompt {
+    return NO;
+}
+
+- (BOOL)pasteHelperCanWaitForPrompt {
+    return NO;
+}
+
+- (void)pasteHelperPasteViewVisibilityDidChange {
+}
+
+- (iTermVariableScope *)pasteHelperScope {
+    return nil;
+}
+
+@end
+
+// Also reports back-pressure, so pastes are adaptive.
+@interface iTermAdaptivePasteBenchmarkDelegate : iTermPasteBenchmarkDelegate
+@end
+
+@implementation iTermAdaptivePasteBenchmarkDelegate
+
+- (NSUInteger)pasteHelperNumberOfBytesQueuedForWriting {
+    return _task.numberOfBytesQueuedForWriting;
+}
+
+- (long long)pasteHelperNumberOfBytesRead {
+    return _task.numberOfBytesRead;
+}
+
+- (BOOL)pasteHelperCanWriteData {
+    return YES;
+}
+
+- (void)pasteHelperWriteData:(NSData *)data {
+    [_task writeTask:data];
+}
+
+@end
+
+// Like a tmux client or a session broadcasting input: it reports back-pressure, but its input
+// doesn't pass through a task it can measure, so the counters never move.
+@interface iTermUnmeasurablePasteDelegate : iTermAdaptivePasteBenchmarkDelegate
+@property (nonatomic, readonly) NSMutableArray<NSNumber *> *chunkLengths;
+@end
+
+@implementation iTermUnmeasurablePasteDelegate
+
+- (instancetype)initWithTask:(PTYTask *)task bracket:(BOOL)bracket {
+    self = [super initWithTask:task bracket:bracket];
+    if (self) {
+        _chunkLengths = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_chunkLengths release];
+    [super dealloc];
+}
+
+- (void)pasteHelperWriteString:(NSString *)string {
+    [_chunkLengths addObject:@(string.length)];
+}
+
+- (NSUInteger)pasteHelperNumberOfBytesQueuedForWriting {
+    return 0;
+}
+
+- (long long)pasteHelperNumberOfBytesRead {
+    return 0;
+}
+
+- (BOOL)pasteHelperCanWriteData {
+    return NO;
+}
+
+@end
+
+@interface iTermAdaptivePasteTest : XCTestCase
+@end
+
+@implementation iTermAdaptivePasteTest
+
+- (void)tearDown {
+    [[PasteboardHistory sharedInstance] clear];
+    [super tearDown];
+}
+
+- (PasteContext *)adaptiveContext {
+    PasteContext *context = [[[PasteContext alloc] initWithBytesPerCallPrefKey:nil
+                                                                  defaultValue:768
+                                                      delayBetweenCallsPrefKey:nil
+                                                                  defaultValue:0.01] autorelease];
+    context.adaptive = YES;
+    return context;
+}
+
+- (void)testGrowsWhileEverythingIsTaken {
+    PasteContext *context = [self adaptiveContext];
+    NSInteger previous = 0;
+    for (int i = 0; i < 20; i++) {
+        const NSInteger length = [context numberOfBytesToWriteWithBytesQueued:0 bytesRead:0];
+        XCTAssertGreaterThanOrEqual(length, previous);
+        context.bytesWritten = context.bytesWritten + length;
+        previous = length;
+    }
+    XCTAssertEqual(previous, 1024 * 1024);
+    XCTAssertEqualWithAccuracy(context.delayBetweenCalls, 0.001, 0.0001);
+
+    // Preferences don't apply.
+    [context updateValues];
+    XCTAssertEqual(context.bytesPerCall, 1024 * 1024);
+}
+
+- (void)testBacksOffWhileInputPilesUp {
+    PasteContext *context = [self adaptiveContext];
+    for (int i = 0; i < 5; i++) {
+        context.bytesWritten = context.bytesWritten + [context numberOfBytesToWriteWithBytesQueued:0 bytesRead:0];
+    }
+    const int bytesPerCall = context.bytesPerCall;
+    XCTAssertEqual([context numberOfBytesToWriteWithBytesQueued:bytesPerCall bytesRead:0], 0);
+    XCTAssertEqual(context.bytesPerCall, bytesPerCall / 2);
+    XCTAssertGreaterThan(context.delayBetweenCalls, 0.001);
+
+    // No more than bytesPerCall is in flight.
+    XCTAssertEqual([context numberOfBytesToWriteWithBytesQueued:100 bytesRead:0], bytesPerCall / 2 - 100);
+
+    for (int i = 0; i < 20; i++) {
+        XCTAssertEqual([context numberOfBytesToWriteWithBytesQueued:1024 * 1024 bytesRead:0], 0);
+    }
+    XCTAssertEqual(context.bytesPerCall, 1024);
+    XCTAssertEqualWithAccuracy(context.delayBetweenCalls, 0.05, 0.0001);
+}
+
+- (void)testWaitsForEcho {
+    PasteContext *context = [self adaptiveContext];
+    // Output from before the paste doesn't count as echo.
+    long long bytesRead = 1000;
+    [context numberOfBytesToWriteWithBytesQueued:0 bytesRead:bytesRead];
+    context.bytesWritten = 200 * 1024;
+    bytesRead += 1;
+    XCTAssertEqual([context numberOfBytesToWriteWithBytesQueued:0 bytesRead:bytesRead], 0);
+
+    bytesRead = 1000 + 150 * 1024;
+    XCTAssertGreaterThan([context numberOfBytesToWriteWithBytesQueued:0 bytesRead:bytesRead], 0);
+
+    // A session that stops echoing stops pacing the paste.
+    context.bytesWritten = 400 * 1024;
+    XCTAssertEqual([context numberOfBytesToWriteWithBytesQueued:0 bytesRead:bytesRead], 0);
+    usleep(300000);
+    XCTAssertGreaterThan([context numberOfBytesToWriteWithBytesQueued:0 bytesRead:bytesRead], 0);
+    context.bytesWritten = 800 * 1024;
+    XCTAssertGreaterThan([context numberOfBytesToWriteWithBytesQueued:0 bytesRead:bytesRead], 0);
+}
+
+- (void)testPasteThatBypassesTheTaskUsesFixedPacing {
+    iTermUnmeasurablePasteDelegate *delegate =
+        [[[iTermUnmeasurablePasteDelegate alloc] initWithTask:nil bracket:NO] autorelease];
+    iTermPasteHelper *helper = [[[iTermPasteHelper alloc] init] autorelease];
+    helper.delegate = delegate;
+    [helper pasteString:[self stringOfLength:1024 * 1024]
+                 slowly:NO
+       escapeShellChars:NO
+               isUpload:NO
+           tabTransform:kTabTransformNone
+           spacesPerTab:0];
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:10];
+    while (helper.isPasting && delegate.chunkLengths.count < 20 && [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode
+                                 beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    [helper abort];
+    helper.delegate = nil;
+
+    // Adaptive pacing would see everything taken at once and grow the chunks toward 1 MB.
+    XCTAssertGreaterThanOrEqual(delegate.chunkLengths.count, 20);
+    for (NSNumber *length in delegate.chunkLengths) {
+        XCTAssertLessThanOrEqual(length.integerValue, 64 * 1024);
+    }
+}
+
+#pragma mark - Benchmark
+
+- (NSString *)stringOfLength:(NSUInteger)length {
+    NSMutableString *string = [NSMutableString stringWithCapacity:length];
+    NSString *line = [[@"" stringByPaddingToLength:79 withString:@"0123456789abcdef" startingAtIndex:0]
+                         stringByAppendingString:@"\n"];
+    while (string.length + line.length <= length) {
+        [string appendString:line];
+    }
+    return string;
+}
+
+// Pastes |string| into `cat > /dev/null` running in a pty that echoes its input and returns the
+// number of seconds until the pty has taken and echoed all of it.
+- (NSTimeInterval)timeToPasteString:(NSString *)string adaptive:(BOOL)adaptive bracket:(BOOL)bracket {
+    int master;
+    int slave;
+    XCTAssertEqual(openpty(&master, &slave, NULL, NULL, NULL), 0);
+    fcntl(master, F_SETFL, O_NONBLOCK);
+    NSTask *cat = [[[NSTask alloc] init] autorelease];
+    cat.launchPath = @"/bin/sh";
+    cat.arguments = @[ @"-c", @"cat > /dev/null" ];
+    cat.standardInput = [[[NSFileHandle alloc] initWithFileDescriptor:slave closeOnDealloc:YES] autorelease];
+    [cat launch];
+
+    // No server or child process, so nothing gets signaled when the task goes away.
+    PTYTask *task = [[PTYTask alloc] init];
+    iTermFileDescriptorServerConnection connection = {
+        .ok = 1,
+        .ptyMasterFd = master,
+        .childPid = 0,
+        .socketFd = -1,
+        .serverPid = -1
+    };
+    [task attachToServer:connection];
+
+    Class delegateClass = adaptive ? [iTermAdaptivePasteBenchmarkDelegate class] : [iTermPasteBenchmarkDelegate class];
+    iTermPasteBenchmarkDelegate *delegate = [[[delegateClass alloc] initWithTask:task bracket:bracket] autorelease];
+    iTermPasteHelper *helper = [[[iTermPasteHelper alloc] init] autorelease];
+    helper.delegate = delegate;
+
+    const NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    [helper pasteString:string
+                 slowly:NO
+       escapeShellChars:NO
+               isUpload:NO
+           tabTransform:kTabTransformNone
+           spacesPerTab:0];
+    // Newlines are echoed as two bytes, so there's at least as much echo as input.
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:300];
+    while ((helper.isPasting ||
+            task.numberOfBytesQueuedForWriting > 0 ||
+            task.numberOfBytesRead < (long long)string.length) &&
+           [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode
+                                 beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    const NSTimeInterval duration = [NSDate timeIntervalSinceReferenceDate] - start;
+    XCTAssertFalse(helper.isPasting);
+    XCTAssertGreaterThanOrEqual(task.numberOfBytesRead, (long long)string.length);
+
+    helper.delegate = nil;
+    [[TaskNotifier sharedInstance] deregisterTask:task];
+    [task release];
+    [cat terminate];
+    [cat waitUntilExit];
+    return duration;
+}
+
+// Logs how fast 50 MB is pasted into `cat > /dev/null` with fixed chunks, adaptively, and
+// adaptively with bracketed paste. Fixed chunks are measured on less data because they're so slow.
+- (void)testPaste50MBIntoCat {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    const NSUInteger total = 50 * 1024 * 1024;
+    const NSUInteger fixedTotal = 256 * 1024;
+    const double mb = 1024 * 1024;
+
+    NSTimeInterval duration = [self timeToPasteString:[self stringOfLength:fixedTotal] adaptive:NO bracket:NO];
+    NSLog(@"Fixed chunks: %.2f MB/s (measured on %@ KB, so 50 MB would take %.0f s)",
+          fixedTotal / duration / mb, @(fixedTotal / 1024), duration * total / fixedTotal);
+
+    NSString *string = [self stringOfLength:total];
+    duration = [self timeToPasteString:string adaptive:YES bracket:NO];
+    NSLog(@"Adaptive: %.1f MB/s, %.2f s", total / duration / mb, duration);
+
+    duration = [self timeToPasteString:string adaptive:YES bracket:YES];
+    NSLog(@"Adaptive, bracketed: %.1f MB/s, %.2f s", total / duration / mb, duration);
+}
+
+@end
@@ -0,0 +1,137 @@
+//
+//  iTermBase64DecoderTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "RegexKitLite.h"
+#import "iTermBase64Decoder.h"
+#import "iTermBenchmarkTesting.h"
+#import <apr-1/apr_base64.h>
+
+@interface iTermBase64DecoderTest : XCTestCase
+@end
+
+@implementation iTermBase64DecoderTest
+
+- (NSData *)randomDataOfLength:(NSUInteger)length {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    arc4random_buf(data.mutableBytes, length);
+    return data;
+}
+
+- (NSData *)dataByDecodingString:(NSString *)string inChunksOfSize:(NSUInteger)size {
+    iTermBase64Decoder *decoder = [[[iTermBase64Decoder alloc] init] autorelease];
+    for (NSUInteger i = 0; i < string.length; i += size) {
+        [decoder appendString:[string substringWithRange:NSMakeRange(i, MIN(size, string.length - i))]];
+    }
+    XCTAssertTrue([decoder finish]);
+    return decoder.data;
+}
+
+- (void)testChunksMayEndAnywhere {
+    for (NSUInteger length = 0; length < 200; length += 7) {
+        NSData *expected = [self randomDataOfLength:length];
+        // Long enough to reach the vectorized path, with line breaks in the middle of it.
+        NSString *wrapped = [expected base64EncodedStringWithOptions:NSDataBase64Encoding64CharacterLineLength | NSDataBase64EncodingEndLineWithCarriageReturn | NSDataBase64EncodingEndLineWithLineFeed];
+        NSString *unpadded = [[expected base64EncodedStringWithOptions:0] stringByReplacingOccurrencesOfString:@"=" withString:@""];
+        for (NSUInteger size = 1; size <= 70; size++) {
+            XCTAssertEqualObjects([self dataByDecodingString:wrapped inChunksOfSize:size], expected);
+            XCTAssertEqualObjects([self dataByDecodingString:unpadded inChunksOfSize:size], expected);
+        }
+    }
+}
+
+- (void)testStopsAtEndOfData {
+    NSData *hello = [@"hello" dataUsingEncoding:NSASCIIStringEncoding];
+    XCTAssertEqualObjects([iTermBase64Decoder dataByDecodingString:@"aGVsbG8=aGVsbG8="], hello);
+    XCTAssertEqualObjects([iTermBase64Decoder dataByDecodingString:@"aGVs bG8\t"], hello);
+    XCTAssertEqualObjects([iTermBase64Decoder dataByDecodingString:@"aGVs*bG8"],
+                          [@"hel" dataUsingEncoding:NSASCIIStringEncoding]);
+    XCTAssertEqualObjects([iTermBase64Decoder dataByDecodingString:@"aGVsébG8"],
+                          [@"hel" dataUsingEncoding:NSASCIIStringEncoding]);
+    XCTAssertNil([iTermBase64Decoder dataByDecodingString:@""]);
+    XCTAssertNil([iTermBase64Decoder dataByDecodingString:@"\r\n"]);
+
+    iTermBase64Decoder *decoder = [[[iTermBase64Decoder alloc] init] autorelease];
+    [decoder appendString:@"aGVsbG8="];
+    XCTAssertTrue(decoder.isFinished);
+    [decoder appendString:@"aGVsbG8="];
+    [decoder finish];
+    XCTAssertEqual(decoder.numberOfBytesDecoded, 5);
+}
+
+- (void)testDecodesToFile {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    NSData *expected = [self randomDataOfLength:3 * 1024 * 1024 + 1];
+    NSString *base64 = [expected base64EncodedStringWithOptions:NSDataBase64Encoding76CharacterLineLength];
+
+    iTermBase64Decoder *decoder = [[[iTermBase64Decoder alloc] initWithOutputPath:path] autorelease];
+    XCTAssertNotNil(decoder);
+    for (NSUInteger i = 0; i < base64.length; i += 100000) {
+        [decoder appendString:[base64 substringWithRange:NSMakeRange(i, MIN(100000, base64.length - i))]];
+    }
+    XCTAssertTrue([decoder finish]);
+    XCTAssertEqual(decoder.numberOfBytesDecoded, (long long)expected.length);
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:path], expected);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+
+    XCTAssertNil([[[iTermBase64Decoder alloc] initWithOutputPath:@"/nonexistent/file"] autorelease]);
+}
+
+// Logs the throughput of decoding a 64 MB transfer that arrives 4 KB at a time, as it would from
+// imgcat, the way it used to be done (accumulate, strip line breaks, then decode) and with the
+// streaming decoder.
+- (void)testThroughput {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    NSData *payload = [self randomDataOfLength:64 * 1024 * 1024];
+    const NSUInteger chunkSize = 4096;
+    NSDictionary<NSString *, NSString *> *encodings =
+        @{ @"unwrapped": [payload base64EncodedStringWithOptions:0],
+           @"wrapped at 76": [payload base64EncodedStringWithOptions:NSDataBase64Encoding76CharacterLineLength] };
+    for (NSString *name in encodings) {
+        NSString *base64 = encodings[name];
+        NSMutableArray<NSString *> *chunks = [NSMutableArray array];
+        for (NSUInteger i = 0; i < base64.length; i += chunkSize) {
+            [chunks addObject:[base64 substringWithRange:NSMakeRange(i, MIN(chunkSize, base64.length - i))]];
+        }
+        const double megabytes = base64.length / 1000000.0;
+
+        NSTimeInterval best = INFINITY;
+        for (int trial = 0; trial < 3; trial++) {
+            @autoreleasepool {
+                const NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+                NSMutableString *accumulated = [NSMutableString string];
+                for (NSString *chunk in chunks) {
+                    [accumulated appendString:[chunk stringByReplacingOccurrencesOfRegex:@"[\r\n]" withString:@""]];
+                }
+                const char *buffer = accumulated.UTF8String;
+                NSMutableData *data = [NSMutableData dataWithLength:apr_base64_decode_len(buffer)];
+                data.length = apr_base64_decode(data.mutableBytes, buffer);
+                best = MIN(best, [NSDate timeIntervalSinceReferenceDate] - start);
+                XCTAssertEqualObjects(data, payload);
+            }
+        }
+        NSLog(@"%@, accumulate and decode: %.0f MB/s", name, megabytes / best);
+
+        best = INFINITY;
+        for (int trial = 0; trial < 3; trial++) {
+            @autoreleasepool {
+                const NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+                iTermBase64Decoder *decoder = [[[iTermBase64Decoder alloc] init] autorelease];
+                for (NSString *chunk in chunks) {
+                    [decoder appendString:chunk];
+                }
+                [decoder finish];
+                best = MIN(best, [NSDate timeIntervalSinceReferenceDate] - start);
+                XCTAssertEqualObjects(decoder.data, payload);
+            }
+        }
+        NSLog(@"%@, streaming decoder: %.0f MB/s", name, megabytes / best);
+    }
+}
+
+@end
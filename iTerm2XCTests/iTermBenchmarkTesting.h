@@ -0,0 +1,13 @@
+//
+//  iTermBenchmarkTesting.h
+//  iTerm2XCTests
+//
+
+#import <Foundation/Foundation.h>
+
+// Benchmarks are slow and log numbers rather than check behavior, so they're skipped unless
+// ITERM_RUN_BENCHMARKS is set in the test scheme's environment. Call this at the start of a
+// benchmark and return if it says no.
+NS_INLINE BOOL iTermShouldRunBenchmarks(void) {
+    return [[[NSProcessInfo processInfo] environment][@"ITERM_RUN_BENCHMARKS"] boolValue];
+}
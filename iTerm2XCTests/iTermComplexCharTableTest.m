@@ -0,0 +1,67 @@
+//
+//  iTermComplexCharTableTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ScreenChar.h"
+
+@interface iTermComplexCharTableTest : XCTestCase
+@end
+
+@implementation iTermComplexCharTableTest
+
+- (void)testSameStringGetsSameCode {
+    NSString *string = @"ȩ́";
+    const int code = GetOrSetComplexChar(string, iTermTriStateFalse);
+    XCTAssertEqualObjects(ComplexCharToStr(code), string);
+    XCTAssertEqual(GetOrSetComplexChar([[string mutableCopy] autorelease], iTermTriStateFalse), code);
+    XCTAssertNotEqual(GetOrSetComplexChar(@"é", iTermTriStateFalse), code);
+}
+
+- (void)testLongStringsAreInterned {
+    NSMutableString *string = [NSMutableString stringWithString:@"a"];
+    for (int i = 0; i < 80; i++) {
+        [string appendString:@"́"];
+    }
+    const int code = GetOrSetComplexChar(string, iTermTriStateFalse);
+    XCTAssertEqualObjects(ComplexCharToStr(code), string);
+    XCTAssertEqual(GetOrSetComplexChar([[string copy] autorelease], iTermTriStateFalse), code);
+}
+
+- (void)testAppendToComplexChar {
+    const int code = GetOrSetComplexChar(@"ö", iTermTriStateFalse);
+    const int appended = AppendToComplexChar(code, 0x0323);
+    XCTAssertEqualObjects(ComplexCharToStr(appended), @"ọ̈");
+}
+
+- (void)testCodesAreReusedAfterWrapping {
+    NSString *first = @"x́̂̃";
+    const int code = GetOrSetComplexChar(first, iTermTriStateFalse);
+    // A string that was looked up stays valid after its code is reused.
+    NSString *lookedUp = ComplexCharToStr(code);
+
+    // Enough new strings to use every code at least once more.
+    for (int i = 0; i < 0x10000; i++) {
+        NSString *string = [NSString stringWithFormat:@"%d́", i];
+        const int other = GetOrSetComplexChar(string, iTermTriStateFalse);
+        XCTAssertEqualObjects(ComplexCharToStr(other), string);
+    }
+
+    XCTAssertEqualObjects(lookedUp, first);
+
+    // The first string's code was recycled, so it gets a new one that maps back to it.
+    const int newCode = GetOrSetComplexChar(first, iTermTriStateFalse);
+    XCTAssertEqualObjects(ComplexCharToStr(newCode), first);
+}
+
+- (void)testRestorableStateRoundTrip {
+    const int code = GetOrSetComplexChar(@"कि", iTermTriStateTrue);
+    NSDictionary *state = ScreenCharEncodedRestorableState();
+    ScreenCharDecodeRestorableState(state);
+    XCTAssertEqualObjects(ComplexCharToStr(code), @"कि");
+    XCTAssertTrue(ComplexCharCodeIsSpacingCombiningMark(code));
+}
+
+@end
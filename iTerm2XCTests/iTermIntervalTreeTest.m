@@ -1,5 +1,6 @@
 #import <XCTest/XCTest.h>
 #import "IntervalTree.h"
+#import "iTermBenchmarkTesting.h"
 
 @interface ITObject : NSObject <IntervalTreeObject>
 @end
@@ -362,4 +363,148 @@ static Interval *MakeInterval(long long location, long long length) {
     [tree_ removeObject:obj3_];
     [tree_ sanityCheck];
 }
+
+- (void)testEnumerateObjectsInRange {
+    tree_ = [[[IntervalTree alloc] init] autorelease];
+    [tree_ addObject:obj1_ withInterval:MakeInterval(20, 5)];
+    [tree_ addObject:obj2_ withInterval:MakeInterval(10, 20)];
+    [tree_ addObject:obj3_ withInterval:MakeInterval(40, 5)];
+    [tree_ addObject:obj4_ withInterval:MakeInterval(22, 0)];
+
+    NSMutableArray *objects = [NSMutableArray array];
+    [tree_ enumerateObjectsFromLocation:0 limit:41 block:^(id<IntervalTreeObject> object, BOOL *stop) {
+        [objects addObject:object];
+    }];
+    XCTAssertEqualObjects(objects, (@[ obj2_, obj1_, obj3_ ]));
+
+    [objects removeAllObjects];
+    [tree_ enumerateObjectsFromLocation:0 limit:100 block:^(id<IntervalTreeObject> object, BOOL *stop) {
+        [objects addObject:object];
+        *stop = (objects.count == 2);
+    }];
+    XCTAssertEqualObjects(objects, (@[ obj2_, obj1_ ]));
+}
+
+- (void)testRemoveObjectsWithLimitAtMost {
+    tree_ = [[[IntervalTree alloc] init] autorelease];
+    [tree_ addObject:obj1_ withInterval:MakeInterval(0, 10)];
+    [tree_ addObject:obj2_ withInterval:MakeInterval(5, 10)];
+    [tree_ addObject:obj3_ withInterval:MakeInterval(5, 5)];
+    [tree_ addObject:obj4_ withInterval:MakeInterval(12, 0)];
+    [tree_ addObject:obj5_ withInterval:MakeInterval(20, 10)];
+
+    NSMutableArray *removed = [NSMutableArray array];
+    [tree_ removeObjectsWithLimitAtMost:12 block:^(id<IntervalTreeObject> object) {
+        XCTAssertNotNil(object.entry);
+        [removed addObject:object];
+    }];
+    XCTAssertEqualObjects(removed, (@[ obj1_, obj3_, obj4_ ]));
+    XCTAssertNil(obj1_.entry);
+    XCTAssertFalse([tree_ containsObject:obj1_]);
+    XCTAssertEqual(tree_.count, 2);
+    XCTAssertEqualObjects([tree_ allObjects], (@[ obj2_, obj5_ ]));
+    [tree_ sanityCheck];
+
+    // Removed objects can go in another tree.
+    IntervalTree *other = [[[IntervalTree alloc] init] autorelease];
+    [other addObject:obj1_ withInterval:MakeInterval(0, 10)];
+    XCTAssertFalse([tree_ containsObject:obj1_]);
+    [tree_ removeObject:obj1_];
+    XCTAssertTrue([other containsObject:obj1_]);
+}
+
+- (void)testSerialization {
+    tree_ = [[[IntervalTree alloc] init] autorelease];
+    for (int i = 0; i < 100; i++) {
+        [tree_ addObject:[[[ITObject alloc] init] autorelease] withInterval:MakeInterval((i * 37) % 100, i % 7 + 1)];
+    }
+    IntervalTree *copy = [[[IntervalTree alloc] initWithDictionary:[tree_ dictionaryValueWithOffset:10]] autorelease];
+    [copy sanityCheck];
+    XCTAssertEqual(copy.count, 100);
+    NSArray *expected = [tree_ allObjects];
+    NSArray *actual = [copy allObjects];
+    XCTAssertEqual(actual.count, expected.count);
+    for (NSInteger i = 0; i < actual.count; i++) {
+        id<IntervalTreeObject> a = actual[i];
+        id<IntervalTreeObject> e = expected[i];
+        XCTAssertEqual(a.entry.interval.location, e.entry.interval.location + 10);
+        XCTAssertEqual(a.entry.interval.length, e.entry.interval.length);
+    }
+}
+
+#pragma mark - Benchmark
+
+// Logs the time to add 1M marks one line apart, to find the marks on each line of a 50-line
+// screen the way drawing does, to save and restore them, and to drop half of them as scrollback
+// overflows.
+- (void)testOneMillionMarks {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    const int count = 1000000;
+    const int width = 80;
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:count];
+    for (int i = 0; i < count; i++) {
+        [objects addObject:[[[ITObject alloc] init] autorelease]];
+    }
+
+    tree_ = [[[IntervalTree alloc] init] autorelease];
+    NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    for (int i = 0; i < count; i++) {
+        [tree_ addObject:objects[i] withInterval:MakeInterval((long long)i * (width + 1), width)];
+    }
+    NSLog(@"Add %d marks: %.0f ms", count, ([NSDate timeIntervalSinceReferenceDate] - start) * 1000);
+    XCTAssertEqual(tree_.count, count);
+
+    const int frames = 1000;
+    const int linesPerFrame = 50;
+    __block long long found = 0;
+    start = [NSDate timeIntervalSinceReferenceDate];
+    for (int frame = 0; frame < frames; frame++) {
+        const long long firstLine = (frame * 7919LL) % (count - linesPerFrame);
+        for (int line = 0; line < linesPerFrame; line++) {
+            const long long location = (firstLine + line) * (width + 1);
+            [tree_ enumerateObjectsFromLocation:location
+                                          limit:location + width + 1
+                                          block:^(id<IntervalTreeObject> object, BOOL *stop) {
+                found++;
+            }];
+        }
+    }
+    NSLog(@"Find marks on a %d-line screen: %.1f us per frame",
+          linesPerFrame, ([NSDate timeIntervalSinceReferenceDate] - start) * 1000000 / frames);
+    XCTAssertEqual(found, frames * linesPerFrame);
+
+    start = [NSDate timeIntervalSinceReferenceDate];
+    for (int frame = 0; frame < frames; frame++) {
+        const long long firstLine = (frame * 7919LL) % (count - linesPerFrame);
+        for (int line = 0; line < linesPerFrame; line++) {
+            const long long location = (firstLine + line) * (width + 1);
+            [tree_ objectsInInterval:MakeInterval(location, width + 1)];
+        }
+    }
+    NSLog(@"Same with -objectsInInterval: %.1f us per frame",
+          ([NSDate timeIntervalSinceReferenceDate] - start) * 1000000 / frames);
+
+    start = [NSDate timeIntervalSinceReferenceDate];
+    NSDictionary *dictionary = [tree_ dictionaryValueWithOffset:0];
+    NSLog(@"Save: %.0f ms", ([NSDate timeIntervalSinceReferenceDate] - start) * 1000);
+
+    start = [NSDate timeIntervalSinceReferenceDate];
+    IntervalTree *restored = [[[IntervalTree alloc] initWithDictionary:dictionary] autorelease];
+    NSLog(@"Restore: %.0f ms", ([NSDate timeIntervalSinceReferenceDate] - start) * 1000);
+    XCTAssertEqual(restored.count, count);
+
+    start = [NSDate timeIntervalSinceReferenceDate];
+    __block int removed = 0;
+    [tree_ removeObjectsWithLimitAtMost:(long long)(count / 2) * (width + 1)
+                                  block:^(id<IntervalTreeObject> object) {
+        removed++;
+    }];
+    NSLog(@"Drop %d marks: %.0f ms", removed, ([NSDate timeIntervalSinceReferenceDate] - start) * 1000);
+    XCTAssertEqual(removed, count / 2);
+    XCTAssertEqual(tree_.count, count - count / 2);
+    [tree_ sanityCheck];
+}
+
 @end
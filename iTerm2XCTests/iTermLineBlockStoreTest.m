@@ -0,0 +1,139 @@
+//
+//  iTermLineBlockStoreTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "LineBlock.h"
+#import "LineBuffer+Testing.h"
+#import "iTermBenchmarkTesting.h"
+#import "iTermLineBlockStore.h"
+
+static const int kWidth = 80;
+
+@interface iTermLineBlockStoreTest : XCTestCase
+@end
+
+@implementation iTermLineBlockStoreTest {
+    NSString *_path;
+}
+
+- (void)setUp {
+    [super setUp];
+    _path = [[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]] retain];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:_path error:nil];
+    [_path release];
+    [super tearDown];
+}
+
+- (void)testRoundTrip {
+    LineBuffer *lineBuffer = [[[LineBuffer alloc] initWithBlockSize:1000] autorelease];
+    [lineBuffer appendNumberedLines:5000 startingAt:0 width:kWidth];
+    iTermLineBlockStore *store = [[[iTermLineBlockStore alloc] initWithPath:_path] autorelease];
+    NSDictionary *dictionary = [lineBuffer dictionaryWithBlockStore:store];
+    XCTAssertEqualObjects([LineBuffer blockStorePathInDictionary:dictionary], _path);
+
+    // The file is still open for appending, so this one is read-only.
+    iTermLineBlockStore *reader = [iTermLineBlockStore storeWithContentsOfFile:_path];
+    XCTAssertNotNil(reader);
+    XCTAssertFalse(reader.isWritable);
+    LineBuffer *restored = [[[LineBuffer alloc] initWithDictionary:dictionary blockStore:reader] autorelease];
+    XCTAssertNotNil(restored);
+    XCTAssertEqualObjects([restored compactLineDumpWithWidth:kWidth], [lineBuffer compactLineDumpWithWidth:kWidth]);
+
+    // Restored blocks that are mapped from the file copy their contents before they change.
+    screen_char_t line[kWidth];
+    int includesEndOfLine;
+    while ([restored numLinesWithWidth:kWidth] > 1000) {
+        XCTAssertTrue([restored popAndCopyLastLineInto:line
+                                                 width:kWidth
+                                     includesEndOfLine:&includesEndOfLine
+                                             timestamp:NULL
+                                          continuation:NULL]);
+    }
+    [restored appendNumberedLines:2000 startingAt:1000 width:kWidth];
+    LineBuffer *expected = [[[LineBuffer alloc] initWithBlockSize:1000] autorelease];
+    [expected appendNumberedLines:3000 startingAt:0 width:kWidth];
+    XCTAssertEqualObjects([restored compactLineDumpWithWidth:kWidth], [expected compactLineDumpWithWidth:kWidth]);
+
+    // A missing file can't be restored from.
+    XCTAssertNil([LineBuffer blockStorePathInDictionary:[lineBuffer dictionary]]);
+    XCTAssertNil([iTermLineBlockStore storeWithContentsOfFile:[_path stringByAppendingString:@".missing"]]);
+}
+
+- (void)testSavingAgainWritesOnlyNewBlocks {
+    LineBuffer *lineBuffer = [[[LineBuffer alloc] initWithBlockSize:1000] autorelease];
+    [lineBuffer appendNumberedLines:5000 startingAt:0 width:kWidth];
+    iTermLineBlockStore *store = [[[iTermLineBlockStore alloc] initWithPath:_path] autorelease];
+    [lineBuffer dictionaryWithBlockStore:store];
+    const long long initialSize = store.fileSize;
+    XCTAssertGreaterThan(initialSize, 4000 * 8 * (long long)sizeof(screen_char_t));
+    XCTAssertGreaterThan(store.liveBytes, 0);
+    XCTAssertLessThanOrEqual(store.liveBytes, initialSize);
+
+    // Nothing but the last block changed.
+    [lineBuffer appendNumberedLines:1 startingAt:5000 width:kWidth];
+    [lineBuffer dictionaryWithBlockStore:store];
+    XCTAssertEqual(store.fileSize, initialSize);
+
+    // Blocks that filled up are written, but not the ones before them.
+    [lineBuffer appendNumberedLines:1000 startingAt:5001 width:kWidth];
+    [lineBuffer dictionaryWithBlockStore:store];
+    XCTAssertGreaterThan(store.fileSize, initialSize);
+    XCTAssertLessThan(store.fileSize - initialSize, initialSize / 2);
+
+    // A copy of the buffer shares its blocks' records.
+    LineBuffer *copy = [[lineBuffer newAppendOnlyCopy] autorelease];
+    const long long size = store.fileSize;
+    [copy dictionaryWithBlockStore:store];
+    XCTAssertEqual(store.fileSize, size);
+}
+
+// Logs the time to save and restore a 5M-line session, the number of bytes written to the
+// restorable state, and the number of bytes added to the block store by each save.
+- (void)testSaveAndRestoreTimeFor5MLines {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    const int numberOfLines = 5000000;
+    LineBuffer *lineBuffer = [[[LineBuffer alloc] init] autorelease];
+    [lineBuffer appendNumberedLines:numberOfLines startingAt:0 width:kWidth];
+
+    NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    NSData *legacy = [NSKeyedArchiver archivedDataWithRootObject:[lineBuffer dictionary]];
+    NSLog(@"Legacy save of the last 10k lines: %.1f ms, %@ bytes of state",
+          ([NSDate timeIntervalSinceReferenceDate] - start) * 1000, @(legacy.length));
+
+    iTermLineBlockStore *store = [[[iTermLineBlockStore alloc] initWithPath:_path] autorelease];
+    NSDictionary *dictionary = nil;
+    for (int i = 0; i < 3; i++) {
+        const long long sizeBefore = store.fileSize;
+        start = [NSDate timeIntervalSinceReferenceDate];
+        dictionary = [lineBuffer dictionaryWithBlockStore:store];
+        NSData *state = [NSKeyedArchiver archivedDataWithRootObject:dictionary];
+        NSLog(@"Save %d of all %d lines: %.1f ms, %@ bytes of state, %@ bytes written to the store",
+              i + 1, numberOfLines, ([NSDate timeIntervalSinceReferenceDate] - start) * 1000,
+              @(state.length), @(store.fileSize - sizeBefore));
+        [lineBuffer appendNumberedLines:100 startingAt:numberOfLines + i * 100 width:kWidth];
+    }
+
+    start = [NSDate timeIntervalSinceReferenceDate];
+    iTermLineBlockStore *reader = [iTermLineBlockStore storeWithContentsOfFile:_path];
+    LineBuffer *restored = [[[LineBuffer alloc] initWithDictionary:dictionary blockStore:reader] autorelease];
+    const int numberOfWrappedLines = [restored numLinesWithWidth:kWidth];
+    NSLog(@"Restore: %.1f ms", ([NSDate timeIntervalSinceReferenceDate] - start) * 1000);
+    XCTAssertEqual(numberOfWrappedLines, numberOfLines + 200);
+
+    start = [NSDate timeIntervalSinceReferenceDate];
+    ScreenCharArray *first = [restored wrappedLineAtIndex:0 width:kWidth continuation:NULL];
+    ScreenCharArray *last = [restored wrappedLineAtIndex:numberOfWrappedLines - 1 width:kWidth continuation:NULL];
+    NSLog(@"Read first and last lines: %.3f ms", ([NSDate timeIntervalSinceReferenceDate] - start) * 1000);
+    XCTAssertEqual(first.line[6].code, '0');
+    XCTAssertEqual(last.line[6].code, '9');
+}
+
+@end
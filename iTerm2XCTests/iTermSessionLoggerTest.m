@@ -0,0 +1,324 @@
+//
+//  iTermSessionLoggerTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "iTermBenchmarkTesting.h"
+#import "iTermSessionLogger.h"
+
+#include <termios.h>
+#include <util.h>
+#include <zlib.h>
+
+@interface iTermSessionLoggerTest : XCTestCase
+@end
+
+@implementation iTermSessionLoggerTest {
+    NSString *_directory;
+}
+
+- (void)setUp {
+    [super setUp];
+    _directory = [[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]] retain];
+    [[NSFileManager defaultManager] createDirectoryAtPath:_directory
+                              withIntermediateDirectories:YES
+                                               attributes:nil
+                                                    error:nil];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:_directory error:nil];
+    [_directory release];
+    [super tearDown];
+}
+
+// Bytes that look like terminal output, with each chunk different from the last.
+- (NSData *)outputOfLength:(NSUInteger)length seed:(int)seed {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    char *bytes = data.mutableBytes;
+    for (NSUInteger i = 0; i < length; i++) {
+        bytes[i] = (i % 80 == 79) ? '\n' : 'a' + (seed + i / 7) % 26;
+    }
+    return data;
+}
+
+- (NSData *)inflate:(NSData *)data {
+    NSMutableData *result = [NSMutableData data];
+    z_stream stream = { 0 };
+    // 32 more window bits accepts a gzip header. Concatenated members are inflated one by one.
+    XCTAssertEqual(inflateInit2(&stream, MAX_WBITS + 32), Z_OK);
+    stream.next_in = (Bytef *)data.bytes;
+    stream.avail_in = (uInt)data.length;
+    char buffer[65536];
+    while (stream.avail_in > 0) {
+        stream.next_out = (Bytef *)buffer;
+        stream.avail_out = sizeof(buffer);
+        const int status = inflate(&stream, Z_NO_FLUSH);
+        XCTAssertTrue(status == Z_OK || status == Z_STREAM_END);
+        [result appendBytes:buffer length:sizeof(buffer) - stream.avail_out];
+        if (status == Z_STREAM_END) {
+            inflateReset(&stream);
+        } else if (status != Z_OK) {
+            break;
+        }
+    }
+    inflateEnd(&stream);
+    return result;
+}
+
+- (void)testLogsEverythingInOrder {
+    NSString *path = [_directory stringByAppendingPathComponent:@"log.txt"];
+    [@"existing\n" writeToFile:path atomically:NO encoding:NSUTF8StringEncoding error:nil];
+    iTermSessionLogger *logger = [[[iTermSessionLogger alloc] initWithPath:path
+                                                                    append:YES
+                                                                  compress:NO
+                                                                bufferSize:16 * 1024 * 1024] autorelease];
+    NSMutableData *expected = [[[@"existing\n" dataUsingEncoding:NSUTF8StringEncoding] mutableCopy] autorelease];
+    for (int i = 0; i < 2000; i++) {
+        NSData *chunk = [self outputOfLength:1 + (i * 37) % 3000 seed:i];
+        [logger logBytes:chunk.bytes length:chunk.length];
+        [expected appendData:chunk];
+    }
+    [logger flush];
+    XCTAssertEqual(logger.numberOfBytesLogged, (long long)expected.length - 9);
+    [logger close];
+
+    XCTAssertEqual(logger.numberOfBytesDropped, 0);
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:path], expected);
+
+    // Nothing is logged after closing.
+    [logger logBytes:"x" length:1];
+    XCTAssertEqual(logger.numberOfBytesLogged, (long long)expected.length - 9);
+}
+
+- (void)testCompressedLogInflatesToOutput {
+    NSString *path = [_directory stringByAppendingPathComponent:@"log.txt.gz"];
+    NSMutableData *expected = [NSMutableData data];
+    for (int session = 0; session < 2; session++) {
+        // The second logger appends another gzip member.
+        iTermSessionLogger *logger = [[[iTermSessionLogger alloc] initWithPath:path
+                                                                        append:YES
+                                                                      compress:YES
+                                                                    bufferSize:1024 * 1024] autorelease];
+        for (int i = 0; i < 500; i++) {
+            NSData *chunk = [self outputOfLength:1000 seed:i + session];
+            [logger logBytes:chunk.bytes length:chunk.length];
+            [expected appendData:chunk];
+        }
+        [logger flush];
+        // A flushed log can be read before it's closed.
+        if (session == 0) {
+            XCTAssertEqualObjects([self inflate:[NSData dataWithContentsOfFile:path]], expected);
+        }
+        [logger close];
+    }
+    NSData *compressed = [NSData dataWithContentsOfFile:path];
+    XCTAssertLessThan(compressed.length, expected.length / 4);
+    XCTAssertEqualObjects([self inflate:compressed], expected);
+}
+
+- (void)testRotation {
+    NSString *path = [_directory stringByAppendingPathComponent:@"log.txt"];
+    iTermSessionLogger *logger = [[[iTermSessionLogger alloc] initWithPath:path
+                                                                    append:NO
+                                                                  compress:NO
+                                                                bufferSize:1024 * 1024] autorelease];
+    logger.maximumFileSize = 64 * 1024;
+    logger.numberOfOldFilesToKeep = 2;
+    NSMutableData *expected = [NSMutableData data];
+    for (int i = 0; i < 100; i++) {
+        NSData *chunk = [self outputOfLength:10000 seed:i];
+        [logger logBytes:chunk.bytes length:chunk.length];
+        [expected appendData:chunk];
+        if (i % 10 == 0) {
+            [logger flush];
+        }
+    }
+    [logger close];
+    XCTAssertEqual(logger.numberOfBytesLogged, (long long)expected.length);
+
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSString *first = [_directory stringByAppendingPathComponent:@"log.1.txt"];
+    NSString *second = [_directory stringByAppendingPathComponent:@"log.2.txt"];
+    XCTAssertTrue([fileManager fileExistsAtPath:first]);
+    XCTAssertTrue([fileManager fileExistsAtPath:second]);
+    XCTAssertFalse([fileManager fileExistsAtPath:[_directory stringByAppendingPathComponent:@"log.3.txt"]]);
+
+    // The files kept are the end of the output, oldest first.
+    NSMutableData *kept = [NSMutableData dataWithContentsOfFile:second];
+    [kept appendData:[NSData dataWithContentsOfFile:first]];
+    [kept appendData:[NSData dataWithContentsOfFile:path]];
+    XCTAssertLessThan(kept.length, expected.length);
+    XCTAssertEqualObjects(kept, [expected subdataWithRange:NSMakeRange(expected.length - kept.length, kept.length)]);
+}
+
+- (void)testNoRotationWithoutOldFilesToKeep {
+    NSString *path = [_directory stringByAppendingPathComponent:@"log.txt"];
+    iTermSessionLogger *logger = [[[iTermSessionLogger alloc] initWithPath:path
+                                                                    append:NO
+                                                                  compress:NO
+                                                                bufferSize:1024 * 1024] autorelease];
+    logger.maximumFileSize = 64 * 1024;
+    logger.numberOfOldFilesToKeep = 0;
+    NSMutableData *expected = [NSMutableData data];
+    for (int i = 0; i < 20; i++) {
+        NSData *chunk = [self outputOfLength:10000 seed:i];
+        [logger logBytes:chunk.bytes length:chunk.length];
+        [expected appendData:chunk];
+        [logger flush];
+    }
+    [logger close];
+
+    // Everything stays in the one file rather than being thrown away at each limit.
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:path], expected);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:[_directory stringByAppendingPathComponent:@"log.1.txt"]]);
+}
+
+- (void)testFullBufferKeepsOutputAndReportsBehind {
+    NSString *path = [_directory stringByAppendingPathComponent:@"log.txt"];
+    iTermSessionLogger *logger = [[[iTermSessionLogger alloc] initWithPath:path
+                                                                    append:NO
+                                                                  compress:NO
+                                                                bufferSize:4096] autorelease];
+    __block int catchUps = 0;
+    logger.didCatchUp = ^{
+        catchUps++;
+    };
+    const int chunkLength = 3000;
+    const int count = 5000;
+    NSMutableData *expected = [NSMutableData data];
+    BOOL wasBehind = NO;
+    for (int i = 0; i < count; i++) {
+        NSData *chunk = [self outputOfLength:chunkLength seed:i];
+        [expected appendData:chunk];
+        [logger logBytes:chunk.bytes length:chunk.length];
+        wasBehind = wasBehind || logger.isBehind;
+    }
+    [logger flush];
+    XCTAssertTrue(wasBehind);
+    XCTAssertFalse(logger.isBehind);
+    XCTAssertGreaterThan(catchUps, 0);
+    [logger close];
+
+    XCTAssertEqual(logger.numberOfBytesDropped, 0);
+    XCTAssertEqual(logger.numberOfBytesLogged, (long long)chunkLength * count);
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:path], expected);
+}
+
+- (void)testFullBufferDropsWholeChunksWhenAsked {
+    NSString *path = [_directory stringByAppendingPathComponent:@"log.txt"];
+    iTermSessionLogger *logger = [[[iTermSessionLogger alloc] initWithPath:path
+                                                                    append:NO
+                                                                  compress:NO
+                                                                bufferSize:4096] autorelease];
+    logger.dropsBytesWhenFull = YES;
+    __block int reports = 0;
+    logger.didDropBytes = ^{
+        reports++;
+    };
+    const int chunkLength = 3000;
+    const int count = 5000;
+    NSData *chunk = [self outputOfLength:chunkLength seed:0];
+    for (int i = 0; i < count; i++) {
+        [logger logBytes:chunk.bytes length:chunk.length];
+        XCTAssertFalse(logger.isBehind);
+    }
+    [logger close];
+
+    XCTAssertGreaterThan(logger.numberOfBytesLogged, 0);
+    XCTAssertEqual(reports, logger.numberOfBytesDropped > 0 ? 1 : 0);
+    XCTAssertEqual(logger.numberOfBytesLogged + logger.numberOfBytesDropped, (long long)chunkLength * count);
+    XCTAssertEqual(logger.numberOfBytesLogged % chunkLength, 0);
+    NSData *contents = [NSData dataWithContentsOfFile:path];
+    XCTAssertEqual((long long)contents.length, logger.numberOfBytesLogged);
+}
+
+#pragma mark - Benchmark
+
+// Reads |total| bytes written to a pty by another thread, passing each read to |logBlock|, and
+// returns the throughput in MB/s.
+- (double)ptyThroughputForBytes:(NSUInteger)total logBlock:(void (^)(const char *, int))logBlock {
+    int master;
+    int slave;
+    XCTAssertEqual(openpty(&master, &slave, NULL, NULL, NULL), 0);
+    struct termios term;
+    tcgetattr(slave, &term);
+    cfmakeraw(&term);
+    tcsetattr(slave, TCSANOW, &term);
+
+    NSData *output = [self outputOfLength:65536 seed:0];
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSUInteger written = 0;
+        while (written < total) {
+            const ssize_t n = write(slave, output.bytes, MIN(output.length, total - written));
+            if (n <= 0) {
+                break;
+            }
+            written += n;
+        }
+    });
+
+    char buffer[65536];
+    NSUInteger bytesRead = 0;
+    const NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    while (bytesRead < total) {
+        const ssize_t n = read(master, buffer, sizeof(buffer));
+        if (n <= 0) {
+            break;
+        }
+        logBlock(buffer, (int)n);
+        bytesRead += n;
+    }
+    const NSTimeInterval duration = [NSDate timeIntervalSinceReferenceDate] - start;
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    dispatch_release(group);
+    close(master);
+    close(slave);
+    XCTAssertEqual(bytesRead, total);
+    return total / duration / (1024 * 1024);
+}
+
+// Logs PTY read throughput without logging, with the old synchronous NSFileHandle writes, and
+// with iTermSessionLogger (plain and compressed).
+- (void)testPTYThroughputWithLogging {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    const NSUInteger total = 256 * 1024 * 1024;
+    NSLog(@"No logging: %.0f MB/s", [self ptyThroughputForBytes:total logBlock:^(const char *bytes, int length) {}]);
+
+    NSString *path = [_directory stringByAppendingPathComponent:@"sync.txt"];
+    [[NSFileManager defaultManager] createFileAtPath:path contents:nil attributes:nil];
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingAtPath:path];
+    NSObject *lock = [[[NSObject alloc] init] autorelease];
+    NSLog(@"Synchronous NSFileHandle: %.0f MB/s", [self ptyThroughputForBytes:total logBlock:^(const char *bytes, int length) {
+        @synchronized(lock) {
+            [fileHandle writeData:[NSData dataWithBytes:bytes length:length]];
+        }
+    }]);
+    [fileHandle closeFile];
+
+    for (int compress = 0; compress < 2; compress++) {
+        path = [_directory stringByAppendingPathComponent:compress ? @"async.txt.gz" : @"async.txt"];
+        iTermSessionLogger *logger = [[[iTermSessionLogger alloc] initWithPath:path
+                                                                        append:NO
+                                                                      compress:compress
+                                                                    bufferSize:4 * 1024 * 1024] autorelease];
+        const double throughput = [self ptyThroughputForBytes:total logBlock:^(const char *bytes, int length) {
+            [logger logBytes:bytes length:length];
+            // PTYTask stops reading while the logger is behind.
+            while (logger.isBehind) {
+                usleep(100);
+            }
+        }];
+        [logger close];
+        NSLog(@"iTermSessionLogger%@: %.0f MB/s, %lld bytes logged, %lld dropped",
+              compress ? @" (compressed)" : @"", throughput, logger.numberOfBytesLogged, logger.numberOfBytesDropped);
+        XCTAssertEqual(logger.numberOfBytesLogged + logger.numberOfBytesDropped, (long long)total);
+    }
+}
+
+@end
@@ -8,6 +8,7 @@
 
 #import <XCTest/XCTest.h>
 #import "iTermAdvancedSettingsModel.h"
+#import "iTermBenchmarkTesting.h"
 #import "iTermFakeUserDefaults.h"
 #import "iTermMalloc.h"
 #import "iTermPreferences.h"
@@ -17,6 +18,9 @@
 #import "ScreenChar.h"
 #import "SmartSelectionController.h"
 
+#define STRINGIFY(s) #s
+#define STRINGIFY_MACRO(m) STRINGIFY(m)
+
 static const NSInteger kUnicodeVersion = 9;
 
 @interface iTermTextExtractorTest : XCTestCase<iTermTextDataSource>
@@ -164,6 +168,83 @@ static const NSInteger kUnicodeVersion = 9;
     XCTAssertEqual(match.absEndY, 0);
 }
 
+- (NSString *)smartSelectionInLine:(NSString *)line at:(int)x rules:(NSArray *)rules match:(SmartMatch **)matchPtr {
+    _lines = nil;
+    [self appendWrappedLine:line width:200 eol:EOL_HARD];
+    iTermTextExtractor *extractor = [iTermTextExtractor textExtractorWithDataSource:self];
+    VT100GridWindowedRange range;
+    SmartMatch *match = [extractor smartSelectionAt:VT100GridCoordMake(x, 0)
+                                          withRules:rules
+                                     actionRequired:NO
+                                              range:&range
+                                   ignoringNewlines:NO];
+    if (matchPtr) {
+        *matchPtr = match;
+    }
+    return match ? [line substringWithRange:NSMakeRange(match.startX, match.endX - match.startX)] : nil;
+}
+
+// A quote that ends before the click mustn't hide a quoted string that starts after it.
+- (void)testSmartSelectionFindsMatchAfterOneEndingBeforeClick {
+    NSString *line = @"Here's a fake quote \\\" and \"a quoted string\" fake quote \\\"";
+    const int x = [line rangeOfString:@"quoted"].location;
+    XCTAssertEqualObjects([self smartSelectionInLine:line at:x rules:nil match:NULL], @"\"a quoted string\"");
+}
+
+- (void)testSmartSelectionComponents {
+    NSDictionary *rule = @{ kRegexKey: @"(\\w+)@(\\w+)(:\\d+)?",
+                            kPrecisionKey: kVeryHighPrecision };
+    SmartMatch *match = nil;
+    XCTAssertEqualObjects([self smartSelectionInLine:@"ssh root@host now" at:6 rules:@[ rule ] match:&match],
+                          @"root@host");
+    XCTAssertEqualObjects(match.components, (@[ @"root@host", @"root", @"host", @"" ]));
+}
+
+// Logs how long smart selection with the default rules takes for a click on every character of
+// every line in tests/smart_selection_cases.txt.
+- (void)testSmartSelectionSpeedOnCases {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    NSString *projectDir = [NSString stringWithUTF8String:STRINGIFY_MACRO(PROJECT_DIR)];
+    NSString *path = [projectDir stringByAppendingPathComponent:@"tests/smart_selection_cases.txt"];
+    NSString *contents = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:nil];
+    XCTAssertNotNil(contents);
+
+    // Pad lines to the width of a wide pane.
+    const int width = 200;
+    NSMutableArray<NSString *> *lines = [NSMutableArray array];
+    for (NSString *line in [contents componentsSeparatedByString:@"\n"]) {
+        if (line.length) {
+            [lines addObject:[line stringByPaddingToLength:width withString:@" " startingAtIndex:0]];
+        }
+    }
+    int clicks = 0;
+    int matches = 0;
+    const NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    for (NSString *line in lines) {
+        _lines = nil;
+        [self appendWrappedLine:line width:width eol:EOL_HARD];
+        iTermTextExtractor *extractor = [iTermTextExtractor textExtractorWithDataSource:self];
+        for (int x = 0; x < width; x += 2) {
+            VT100GridWindowedRange range;
+            SmartMatch *match = [extractor smartSelectionAt:VT100GridCoordMake(x, 0)
+                                                  withRules:nil
+                                             actionRequired:NO
+                                                      range:&range
+                                           ignoringNewlines:NO];
+            clicks++;
+            if (match) {
+                matches++;
+            }
+        }
+    }
+    const NSTimeInterval duration = [NSDate timeIntervalSinceReferenceDate] - start;
+    NSLog(@"Smart selection: %d clicks on %@ lines (%d matched) in %.0f ms, %.1f us per click",
+          clicks, @(lines.count), matches, duration * 1000, duration * 1000000 / clicks);
+    XCTAssertGreaterThan(matches, 0);
+}
+
 // TODO(georgen): Support windowed ranges.
 - (NSString *)stringForRange:(VT100GridWindowedRange)range {
     NSMutableString *string = [NSMutableString string];
@@ -0,0 +1,123 @@
+//
+//  iTermTriggerEvaluatorTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ScreenChar.h"
+#import "Trigger.h"
+#import "iTermTriggerEvaluator.h"
+#import "iTermTriggerMatcher.h"
+
+@interface iTermTriggerEvaluatorTest : XCTestCase<iTermTriggerEvaluatorDelegate>
+@end
+
+@implementation iTermTriggerEvaluatorTest {
+    NSMutableArray<iTermTriggerEvaluation *> *_evaluations;
+    NSMutableArray<NSNumber *> *_backlogChanges;
+}
+
+- (void)setUp {
+    [super setUp];
+    _evaluations = [[NSMutableArray alloc] init];
+    _backlogChanges = [[NSMutableArray alloc] init];
+}
+
+- (void)tearDown {
+    [_evaluations release];
+    [_backlogChanges release];
+    [super tearDown];
+}
+
+- (iTermTriggerEvaluator *)evaluatorWithRegexes:(NSArray<NSString *> *)regexes {
+    NSMutableArray<Trigger *> *triggers = [NSMutableArray array];
+    for (NSString *regex in regexes) {
+        [triggers addObject:[Trigger triggerFromDict:@{ kTriggerActionKey: @"BellTrigger",
+                                                        kTriggerRegexKey: regex }]];
+    }
+    iTermTriggerEvaluator *evaluator = [[[iTermTriggerEvaluator alloc] init] autorelease];
+    evaluator.matcher = [[[iTermTriggerMatcher alloc] initWithTriggers:triggers] autorelease];
+    evaluator.delegate = self;
+    return evaluator;
+}
+
+- (void)waitForEvaluator:(iTermTriggerEvaluator *)evaluator {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:10];
+    while (evaluator.queueDepth > 0 && [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode
+                                 beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    XCTAssertEqual(evaluator.queueDepth, 0);
+}
+
+- (void)testEvaluationsAreDeliveredInOrder {
+    iTermTriggerEvaluator *evaluator = [self evaluatorWithRegexes:@[ @"error (\\d+)", @"never" ]];
+    for (int i = 0; i < 200; i++) {
+        NSString *string = (i % 3) ? @"ok" : [NSString stringWithFormat:@"error %d, error %d", i, i + 1];
+        [evaluator evaluateStringLine:[iTermStringLine stringLineWithString:string]
+                           lineNumber:i
+                          partialLine:NO];
+    }
+    [self waitForEvaluator:evaluator];
+
+    XCTAssertEqual(evaluator.numberOfLinesEvaluated, 200);
+    XCTAssertEqual(_evaluations.count, 200);
+    [_evaluations enumerateObjectsUsingBlock:^(iTermTriggerEvaluation *evaluation, NSUInteger i, BOOL *stop) {
+        XCTAssertEqual(evaluation.lineNumber, (long long)i);
+        XCTAssertEqual(evaluation.matches.count, 2);
+        XCTAssertEqual(evaluation.matches[0].count, (i % 3) ? 0 : 2);
+        XCTAssertEqual(evaluation.matches[0].firstObject.captureCount, (i % 3) ? 0 : 2);
+        XCTAssertEqual(evaluation.matches[1].count, 0);
+    }];
+}
+
+- (void)testBacklogDefersPartialLinesAndRecovers {
+    iTermTriggerEvaluator *evaluator = [self evaluatorWithRegexes:@[ @"x" ]];
+    evaluator.highWaterMark = 10;
+    evaluator.lowWaterMark = 2;
+    iTermStringLine *stringLine = [iTermStringLine stringLineWithString:@"xyz"];
+    for (int i = 0; i < 20; i++) {
+        [evaluator evaluateStringLine:stringLine lineNumber:i partialLine:NO];
+    }
+    XCTAssertTrue(evaluator.backlogged);
+    [evaluator evaluateStringLine:stringLine lineNumber:20 partialLine:YES];
+    XCTAssertEqual(evaluator.numberOfPartialLinesDropped, 1);
+
+    [self waitForEvaluator:evaluator];
+    XCTAssertFalse(evaluator.backlogged);
+    XCTAssertEqual(evaluator.maximumQueueDepth, 20);
+    // The deferred partial line is evaluated after the backlog clears.
+    XCTAssertEqual(evaluator.numberOfLinesEvaluated, 21);
+    XCTAssertTrue(_evaluations.lastObject.partialLine);
+    XCTAssertEqual(_evaluations.lastObject.lineNumber, 20);
+    XCTAssertEqualObjects(_backlogChanges, (@[ @YES, @NO ]));
+}
+
+- (void)testCompleteLineSupersedesDeferredPartialLine {
+    iTermTriggerEvaluator *evaluator = [self evaluatorWithRegexes:@[ @"x" ]];
+    evaluator.highWaterMark = 10;
+    evaluator.lowWaterMark = 2;
+    iTermStringLine *stringLine = [iTermStringLine stringLineWithString:@"xyz"];
+    for (int i = 0; i < 20; i++) {
+        [evaluator evaluateStringLine:stringLine lineNumber:i partialLine:NO];
+    }
+    [evaluator evaluateStringLine:stringLine lineNumber:20 partialLine:YES];
+    [evaluator evaluateStringLine:stringLine lineNumber:20 partialLine:NO];
+
+    [self waitForEvaluator:evaluator];
+    XCTAssertEqual(evaluator.numberOfLinesEvaluated, 21);
+    XCTAssertFalse(_evaluations.lastObject.partialLine);
+}
+
+#pragma mark - iTermTriggerEvaluatorDelegate
+
+- (void)triggerEvaluator:(iTermTriggerEvaluator *)evaluator didEvaluate:(iTermTriggerEvaluation *)evaluation {
+    [_evaluations addObject:evaluation];
+}
+
+- (void)triggerEvaluator:(iTermTriggerEvaluator *)evaluator didChangeBacklogged:(BOOL)backlogged {
+    [_backlogChanges addObject:@(backlogged)];
+}
+
+@end
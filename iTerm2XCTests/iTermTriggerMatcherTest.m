@@ -0,0 +1,123 @@
+//
+//  iTermTriggerMatcherTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "RegexKitLite.h"
+#import "Trigger.h"
+#import "iTermBenchmarkTesting.h"
+#import "iTermTriggerMatcher.h"
+
+@interface iTermTriggerMatcherTest : XCTestCase
+@end
+
+@implementation iTermTriggerMatcherTest
+
+- (void)assertRegex:(NSString *)regex requiresLiteral:(NSString *)expected caseInsensitive:(BOOL)expectedCaseInsensitive {
+    BOOL caseInsensitive = NO;
+    NSString *literal = [iTermTriggerMatcher requiredLiteralInRegex:regex caseInsensitive:&caseInsensitive];
+    XCTAssertEqualObjects(literal, expected, @"regex=%@", regex);
+    if (literal) {
+        XCTAssertEqual(caseInsensitive, expectedCaseInsensitive, @"regex=%@", regex);
+    }
+}
+
+- (void)testRequiredLiteral {
+    [self assertRegex:@"error: (\\w+)" requiresLiteral:@"error: " caseInsensitive:NO];
+    [self assertRegex:@"^\\s*warning" requiresLiteral:@"warning" caseInsensitive:NO];
+    [self assertRegex:@"(?i)Failed to" requiresLiteral:@"Failed to" caseInsensitive:YES];
+    [self assertRegex:@"abc?d" requiresLiteral:@"ab" caseInsensitive:NO];
+    [self assertRegex:@"a\\.b+c" requiresLiteral:@"a.b" caseInsensitive:NO];
+    [self assertRegex:@"x{2}yz" requiresLiteral:@"yz" caseInsensitive:NO];
+    [self assertRegex:@"\\x41BCD" requiresLiteral:@"BCD" caseInsensitive:NO];
+    [self assertRegex:@"[abc]+def" requiresLiteral:@"def" caseInsensitive:NO];
+    [self assertRegex:@"(foo)?bar" requiresLiteral:@"bar" caseInsensitive:NO];
+    [self assertRegex:@"ab(?i:cd)ef" requiresLiteral:@"ab" caseInsensitive:YES];
+    [self assertRegex:@"foo|bar" requiresLiteral:nil caseInsensitive:NO];
+    [self assertRegex:@"\\Qab\\E" requiresLiteral:nil caseInsensitive:NO];
+    [self assertRegex:@"(?x) a b c" requiresLiteral:nil caseInsensitive:NO];
+    [self assertRegex:@"^.*$" requiresLiteral:nil caseInsensitive:NO];
+}
+
+- (NSArray<Trigger *> *)triggersWithRegexes:(NSArray<NSString *> *)regexes {
+    NSMutableArray<Trigger *> *triggers = [NSMutableArray array];
+    for (NSString *regex in regexes) {
+        [triggers addObject:[Trigger triggerFromDict:@{ kTriggerActionKey: @"BellTrigger",
+                                                        kTriggerRegexKey: regex }]];
+    }
+    return triggers;
+}
+
+- (void)testCandidatesIncludeEveryMatchingTrigger {
+    NSArray<NSString *> *regexes = @[ @"error: (\\w+)", @"(?i)warning", @"foo|bar", @"^\\[(\\d+)\\]", @"done$", @"(?i)kelvin" ];
+    iTermTriggerMatcher *matcher = [[[iTermTriggerMatcher alloc] initWithTriggers:[self triggersWithRegexes:regexes]] autorelease];
+    NSArray<NSString *> *lines = @[ @"error: disk full",
+                                    @"WARNING: low battery",
+                                    @"[12] done",
+                                    @"nothing to see here",
+                                    @"\u212Aelvin",
+                                    @"" ];
+    for (NSString *line in lines) {
+        NSIndexSet *candidates = [matcher indexesOfCandidateTriggersForString:line];
+        [regexes enumerateObjectsUsingBlock:^(NSString *regex, NSUInteger i, BOOL *stop) {
+            if ([line isMatchedByRegex:regex]) {
+                XCTAssertTrue([candidates containsIndex:i], @"line=%@ regex=%@", line, regex);
+            }
+        }];
+    }
+    // The KELVIN SIGN matches k case-insensitively.
+    XCTAssertTrue([[matcher indexesOfCandidateTriggersForString:@"\u212Aelvin"] containsIndex:5]);
+    // The alternation has no required literal so it is always a candidate, but nothing else is.
+    XCTAssertEqualObjects([matcher indexesOfCandidateTriggersForString:@"nothing to see here"],
+                          [NSIndexSet indexSetWithIndex:2]);
+}
+
+// Logs lines/sec for a chatty build log, running every trigger's regex on every line versus only
+// running the candidates' regexes, as the number of triggers grows.
+- (void)testThroughputVersusTriggerCount {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    NSMutableArray<NSString *> *lines = [NSMutableArray array];
+    for (int i = 0; i < 2000; i++) {
+        [lines addObject:[NSString stringWithFormat:@"[%4d/2000] Compiling CXX object src/module%d/file%d.cpp.o", i, i % 17, i]];
+    }
+    [lines addObject:@"src/module3/file3.cpp:12:5: error: use of undeclared identifier 'x'"];
+
+    for (NSNumber *count in @[ @1, @10, @40, @100 ]) {
+        NSMutableArray<NSString *> *regexes = [NSMutableArray array];
+        for (int i = 0; i < count.intValue; i++) {
+            NSString *severity = i ? [NSString stringWithFormat:@"error%d", i] : @"error";
+            [regexes addObject:[NSString stringWithFormat:@"^(\\S+):(\\d+):(\\d+): %@: (.*)$", severity]];
+        }
+        NSArray<Trigger *> *triggers = [self triggersWithRegexes:regexes];
+        iTermTriggerMatcher *matcher = [[[iTermTriggerMatcher alloc] initWithTriggers:triggers] autorelease];
+
+        NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+        NSInteger naiveMatches = 0;
+        for (NSString *line in lines) {
+            for (NSString *regex in regexes) {
+                naiveMatches += [line isMatchedByRegex:regex];
+            }
+        }
+        const NSTimeInterval naive = [NSDate timeIntervalSinceReferenceDate] - start;
+
+        start = [NSDate timeIntervalSinceReferenceDate];
+        __block NSInteger compiledMatches = 0;
+        for (NSString *line in lines) {
+            NSIndexSet *candidates = [matcher indexesOfCandidateTriggersForString:line];
+            [candidates enumerateIndexesUsingBlock:^(NSUInteger i, BOOL *stop) {
+                compiledMatches += [line isMatchedByRegex:regexes[i]];
+            }];
+        }
+        const NSTimeInterval compiled = [NSDate timeIntervalSinceReferenceDate] - start;
+
+        XCTAssertEqual(compiledMatches, naiveMatches);
+        NSLog(@"%@ triggers: %.0f lines/sec running every regex, %.0f lines/sec with the matcher",
+              count, lines.count / naive, lines.count / compiled);
+    }
+}
+
+@end
@@ -0,0 +1,167 @@
+//
+//  iTermWriteQueueTest.m
+//  iTerm2XCTests
+//
+
+#import <XCTest/XCTest.h>
+
+#import "PTYTask.h"
+#import "TaskNotifier.h"
+#import "iTermBenchmarkTesting.h"
+#import "iTermWriteQueue.h"
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+@interface iTermWriteQueueTest : XCTestCase
+@end
+
+@implementation iTermWriteQueueTest
+
+- (NSData *)dataOfLength:(NSUInteger)length seed:(int)seed {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    unsigned char *bytes = data.mutableBytes;
+    for (NSUInteger i = 0; i < length; i++) {
+        bytes[i] = (seed * 31 + i) % 251;
+    }
+    return data;
+}
+
+// Reads everything from |fd| until EOF on another thread.
+- (void)readAllFromFileDescriptor:(int)fd into:(NSMutableData *)output group:(dispatch_group_t)group {
+    dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        char buffer[65536];
+        ssize_t n;
+        while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+            [output appendBytes:buffer length:n];
+        }
+    });
+}
+
+- (void)testWritesEverythingInOrderAcrossChunks {
+    int fds[2];
+    XCTAssertEqual(pipe(fds), 0);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    NSMutableData *output = [NSMutableData data];
+    dispatch_group_t group = dispatch_group_create();
+    [self readAllFromFileDescriptor:fds[0] into:output group:group];
+
+    iTermWriteQueue *queue = [[[iTermWriteQueue alloc] init] autorelease];
+    NSMutableData *expected = [NSMutableData data];
+    NSUInteger totalWritten = 0;
+    for (int i = 0; i < 300; i++) {
+        // Sizes straddle the chunk size.
+        NSData *data = [self dataOfLength:1 + (i * 7919) % 150000 seed:i];
+        [queue appendData:data];
+        [expected appendData:data];
+        XCTAssertEqual(queue.length, expected.length - totalWritten);
+
+        BOOL wouldBlock = NO;
+        const ssize_t written = [queue writeToFileDescriptor:fds[1] wouldBlock:&wouldBlock];
+        XCTAssertGreaterThanOrEqual(written, 0);
+        totalWritten += written;
+        XCTAssertEqual(queue.length, expected.length - totalWritten);
+        XCTAssertTrue(wouldBlock || queue.length == 0);
+    }
+    while (queue.length) {
+        BOOL wouldBlock;
+        XCTAssertGreaterThanOrEqual([queue writeToFileDescriptor:fds[1] wouldBlock:&wouldBlock], 0);
+        if (wouldBlock) {
+            usleep(1000);
+        }
+    }
+    close(fds[1]);
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    dispatch_release(group);
+    close(fds[0]);
+    XCTAssertEqualObjects(output, expected);
+}
+
+- (void)testErrorsAreReported {
+    int fds[2];
+    XCTAssertEqual(pipe(fds), 0);
+    close(fds[0]);
+    signal(SIGPIPE, SIG_IGN);
+    iTermWriteQueue *queue = [[[iTermWriteQueue alloc] init] autorelease];
+    [queue appendBytes:"hello" length:5];
+    BOOL wouldBlock;
+    XCTAssertEqual([queue writeToFileDescriptor:fds[1] wouldBlock:&wouldBlock], -1);
+    XCTAssertEqual(errno, EPIPE);
+    XCTAssertEqual(queue.length, 5);
+    [queue removeAllBytes];
+    XCTAssertEqual(queue.length, 0);
+    close(fds[1]);
+}
+
+// Pushes 100 MB through a PTYTask whose file descriptor is one end of a socket pair, the way
+// pasting or the API's send_text does, and logs the throughput and CPU time used.
+- (void)testPTYTaskWriteThroughput {
+    if (!iTermShouldRunBenchmarks()) {
+        return;
+    }
+    int fds[2];
+    XCTAssertEqual(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+    // No server or child process, so nothing gets signaled when the task goes away.
+    PTYTask *task = [[PTYTask alloc] init];
+    iTermFileDescriptorServerConnection connection = {
+        .ok = 1,
+        .ptyMasterFd = fds[0],
+        .childPid = 0,
+        .socketFd = -1,
+        .serverPid = -1
+    };
+    [task attachToServer:connection];
+
+    const NSUInteger total = 100 * 1024 * 1024;
+    __block NSUInteger bytesRead = 0;
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        char buffer[65536];
+        while (bytesRead < total) {
+            const ssize_t n = read(fds[1], buffer, sizeof(buffer));
+            if (n <= 0) {
+                break;
+            }
+            bytesRead += n;
+        }
+    });
+
+    struct rusage usageBefore;
+    getrusage(RUSAGE_SELF, &usageBefore);
+    const NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+
+    // Queue at most a few megabytes at a time, as a paste would.
+    NSData *data = [self dataOfLength:64 * 1024 seed:0];
+    const NSUInteger maximumQueued = 4 * 1024 * 1024;
+    NSUInteger maximumSeen = 0;
+    for (NSUInteger queued = 0; queued < total; queued += data.length) {
+        while (task.numberOfBytesQueuedForWriting > maximumQueued) {
+            usleep(100);
+        }
+        [task writeTask:data];
+        maximumSeen = MAX(maximumSeen, task.numberOfBytesQueuedForWriting);
+    }
+    dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 60 * NSEC_PER_SEC));
+
+    const NSTimeInterval duration = [NSDate timeIntervalSinceReferenceDate] - start;
+    struct rusage usageAfter;
+    getrusage(RUSAGE_SELF, &usageAfter);
+    const double cpu = (usageAfter.ru_utime.tv_sec - usageBefore.ru_utime.tv_sec +
+                        usageAfter.ru_stime.tv_sec - usageBefore.ru_stime.tv_sec +
+                        (usageAfter.ru_utime.tv_usec - usageBefore.ru_utime.tv_usec +
+                         usageAfter.ru_stime.tv_usec - usageBefore.ru_stime.tv_usec) / 1000000.0);
+    NSLog(@"Wrote %@ MB through PTYTask at %.0f MB/s using %.2f s of CPU (including the reader). At most %@ bytes were queued.",
+          @(total / (1024 * 1024)), total / duration / (1024 * 1024), cpu, @(maximumSeen));
+    XCTAssertEqual(bytesRead, total);
+    XCTAssertEqual(task.numberOfBytesQueuedForWriting, 0);
+
+    [[TaskNotifier sharedInstance] deregisterTask:task];
+    [task release];
+    dispatch_release(group);
+    close(fds[1]);
+}
+
+@end
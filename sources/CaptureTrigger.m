@@ -80,7 +80,7 @@ static NSString *const kSuppressCaptureOutputToolNotVisibleWarning =
     output.line = stringLine.stringValue;
     output.trigger = self;
     output.values = [NSArray arrayWithObjects:capturedStrings count:captureCount];
-    output.mark = [aSession markAddedAtCursorOfClass:[iTermCapturedOutputMark class]];
+    output.mark = [aSession markAddedAtAbsoluteLine:lineNumber ofClass:[iTermCapturedOutputMark class]];
     [aSession addCapturedOutput:output];
     return NO;
 }
@@ -136,7 +136,7 @@
     } else {
         dvr = [[self copyWithFramesFrom:from to:to] autorelease];
     }
-    return @{ @"version": @1,
+    return @{ @"version": @2,
               @"capacity": @(dvr->capacity_),
               @"buffer": dvr->buffer_.dictionaryValue };
 }
@@ -145,7 +145,9 @@
     if (!dict) {
         return NO;
     }
-    if ([dict[@"version"] integerValue] != 1) {
+    // Version 2 added row diff frames and compression. Version 1 frames can still be decoded.
+    const NSInteger version = [dict[@"version"] integerValue];
+    if (version != 1 && version != 2) {
         return NO;
     }
     int capacity = [dict[@"capacity"] intValue];
@@ -33,15 +33,21 @@
 // Sequences in a diff frame begin with one byte indicating the type of content
 // that follows. The values come from this enum:
 enum {
-    kSameSequence,
-    kDiffSequence
+    // Runs of bytes. In a row diff frame these cover one row that was changed in place.
+    kSameSequence,  // Followed by an int count of bytes that didn't change.
+    kDiffSequence,  // Followed by an int count of bytes and the bytes.
+
+    // Whole rows, only in row diff frames.
+    kSameRowsSequence,  // Followed by an int count of rows that didn't change.
+    kMovedRowSequence   // Followed by the int index of the row in the previous frame to copy.
 };
 
 // Types of frames that DVREncoder and DVRDecoder use.
 struct timeval;
 typedef enum {
     DVRFrameTypeKeyFrame,
-    DVRFrameTypeDiffFrame
+    DVRFrameTypeDiffFrame,
+    DVRFrameTypeRowDiffFrame
 } DVRFrameType;
 
 @interface DVRBuffer : NSObject
@@ -82,5 +88,8 @@ typedef enum {
 - (BOOL)loadFromDictionary:(NSDictionary *)dict;
 - (DVRIndexEntry *)firstEntryWithTimestampAfter:(long long)timestamp;
 
+// Binary searches for the first frame at or after |timestamp|. Returns -1 if there is none.
+- (long long)firstKeyWithTimestampAtLeast:(long long)timestamp;
+
 @end
 
@@ -29,7 +29,6 @@
 #import "DVRBuffer.h"
 
 #import "iTermMalloc.h"
-#import "NSArray+iTerm.h"
 #import "NSDictionary+iTerm.h"
 
 @implementation DVRBuffer {
@@ -42,8 +41,9 @@
     // Total size of storage in bytes.
     long long capacity_;
 
-    // Maps a frame key number to DVRIndexEntry*.
-    NSMutableDictionary* index_;
+    // The DVRIndexEntry for each key from firstKey_ to nextKey_ - 1, in order. Timestamps increase
+    // with keys, so this is also sorted by timestamp.
+    NSMutableArray<DVRIndexEntry *> *index_;
 
     // First key in index.
     long long firstKey_;
@@ -70,7 +70,7 @@
     if (self) {
         capacity_ = maxsize;
         store_ = iTermMalloc(maxsize);
-        index_ = [[NSMutableDictionary alloc] init];
+        index_ = [[NSMutableArray alloc] init];
         firstKey_ = 0;
         nextKey_ = 0;
         begin_ = 0;
@@ -89,10 +89,9 @@
 
 - (NSDictionary *)exportedIndex {
     NSMutableDictionary *dict = [NSMutableDictionary dictionary];
-    for (NSNumber *key in index_) {
-        DVRIndexEntry *entry = index_[key];
-        dict[key] = entry.dictionaryValue;
-    }
+    [index_ enumerateObjectsUsingBlock:^(DVRIndexEntry *entry, NSUInteger i, BOOL *stop) {
+        dict[@(firstKey_ + i)] = entry.dictionaryValue;
+    }];
     return dict;
 }
 
@@ -122,18 +121,19 @@
         scratch_ = store_ + [scratch integerValue];
     }
 
+    firstKey_ = [dict[@"firstKey"] longLongValue];
+    nextKey_ = [dict[@"nextKey"] longLongValue];
     NSDictionary *indexDict = dict[@"index"];
-    for (NSNumber *key in indexDict) {
-        NSDictionary *value = indexDict[key];
-        DVRIndexEntry *entry = [DVRIndexEntry entryFromDictionaryValue:value];
+    [index_ removeAllObjects];
+    for (long long key = firstKey_; key < nextKey_; key++) {
+        NSDictionary *value = indexDict[@(key)];
+        DVRIndexEntry *entry = value ? [DVRIndexEntry entryFromDictionaryValue:value] : nil;
         if (!entry) {
             return NO;
         }
-        index_[key] = entry;
+        [index_ addObject:entry];
     }
 
-    firstKey_ = [dict[@"firstKey"] longLongValue];
-    nextKey_ = [dict[@"nextKey"] longLongValue];
     begin_ = [dict[@"begin"] longLongValue];
     end_ = [dict[@"end"] longLongValue];
     return YES;
@@ -169,7 +169,7 @@
     scratch_ = 0;
 
     long long key = nextKey_++;
-    [index_ setObject:entry forKey:[NSNumber numberWithLongLong:key]];
+    [index_ addObject:entry];
     [entry release];
 
     return key;
@@ -180,7 +180,7 @@
     long long key = firstKey_++;
     DVRIndexEntry* entry = [self entryForKey:key];
     begin_ = entry->position + entry->frameLength;
-    [index_ removeObjectForKey:[NSNumber numberWithLongLong:key]];
+    [index_ removeObjectAtIndex:0];
 }
 
 - (void*)blockForKey:(long long)key
@@ -224,26 +224,31 @@
 - (DVRIndexEntry*)entryForKey:(long long)key
 {
     assert(index_);
-    return [index_ objectForKey:[NSNumber numberWithLongLong:key]];
+    if (key < firstKey_ || key >= nextKey_) {
+        return nil;
+    }
+    return index_[key - firstKey_];
 }
 
-- (DVRIndexEntry *)firstEntryWithTimestampAfter:(long long)timestamp {
-    NSArray<NSNumber *> *frameNumbers = [[index_ allKeys] sortedArrayUsingSelector:@selector(compare:)];
-    NSArray<NSNumber *> *timestamps = [frameNumbers mapWithBlock:^NSNumber *(NSNumber *frameNumber) {
-        DVRIndexEntry *entry = index_[frameNumber];
-        return @(entry->info.timestamp);
-    }];
-    NSUInteger frameNumberIndex = [timestamps indexOfObject:@(timestamp + 1)
-                                              inSortedRange:NSMakeRange(0, frameNumbers.count)
-                                                    options:NSBinarySearchingInsertionIndex
-                                            usingComparator:
-                                   ^NSComparisonResult(NSNumber * _Nonnull timestamp1, NSNumber * _Nonnull timestamp2) {
-                                       return [timestamp1 compare:timestamp2];
-                                   }];
-    if (frameNumberIndex == NSNotFound || frameNumberIndex == index_.count) {
-        return nil;
+- (long long)firstKeyWithTimestampAtLeast:(long long)timestamp {
+    NSUInteger lower = 0;
+    NSUInteger upper = index_.count;
+    while (lower < upper) {
+        const NSUInteger middle = lower + (upper - lower) / 2;
+        if (index_[middle]->info.timestamp < timestamp) {
+            lower = middle + 1;
+        } else {
+            upper = middle;
+        }
     }
-    return index_[frameNumbers[frameNumberIndex]];
+    if (lower == index_.count) {
+        return -1;
+    }
+    return firstKey_ + lower;
+}
+
+- (DVRIndexEntry *)firstEntryWithTimestampAfter:(long long)timestamp {
+    return [self entryForKey:[self firstKeyWithTimestampAtLeast:timestamp + 1]];
 }
 
 - (char*)scratch
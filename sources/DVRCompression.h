@@ -0,0 +1,16 @@
+//
+//  DVRCompression.h
+//  iTerm2
+//
+//  Compresses instant replay frames with zlib. Screens are mostly runs of identical cells and
+//  repeated text, which compress well even at the fastest level.
+//
+
+#import <Foundation/Foundation.h>
+
+// Compresses |length| bytes into at most |capacity| bytes of |dest|. Returns the compressed length,
+// or -1 if it wouldn't fit.
+int DVRCompress(const char *source, int length, char *dest, int capacity);
+
+// Decompresses into exactly |destLength| bytes. Returns NO if |source| is malformed.
+BOOL DVRDecompress(const char *source, int length, char *dest, int destLength);
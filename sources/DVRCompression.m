@@ -0,0 +1,32 @@
+//
+//  DVRCompression.m
+//  iTerm2
+//
+
+#import "DVRCompression.h"
+
+#include <zlib.h>
+
+int DVRCompress(const char *source, int length, char *dest, int capacity) {
+    if (capacity <= 0) {
+        return -1;
+    }
+    uLongf destLength = capacity;
+    // Frames are recorded as the screen changes, so favor speed over ratio.
+    const int status = compress2((Bytef *)dest,
+                                 &destLength,
+                                 (const Bytef *)source,
+                                 length,
+                                 Z_BEST_SPEED);
+    if (status != Z_OK) {
+        // Z_BUF_ERROR means it didn't fit.
+        return -1;
+    }
+    return (int)destLength;
+}
+
+BOOL DVRDecompress(const char *source, int length, char *dest, int destLength) {
+    uLongf actualLength = destLength;
+    const int status = uncompress((Bytef *)dest, &actualLength, (const Bytef *)source, length);
+    return status == Z_OK && actualLength == (uLongf)destLength;
+}
@@ -29,6 +29,7 @@
 #import "DVRDecoder.h"
 
 #import "DebugLogging.h"
+#import "DVRCompression.h"
 #import "DVRIndexEntry.h"
 #import "iTermMalloc.h"
 #import "LineBuffer.h"
@@ -41,6 +42,7 @@
 // Load a key or diff frame from a particular key.
 - (void)_loadKeyFrameWithKey:(long long)key;
 - (void)_loadDiffFrameWithKey:(long long)key;
+- (void)_loadRowDiffFrameWithKey:(long long)key;
 
 @end
 
@@ -54,9 +56,17 @@
     // Most recent frame.
     char* frame_;
 
+    // A row diff frame is decoded into this and then swapped with frame_, since rows that moved
+    // are copied from the previous frame.
+    char* backFrame_;
+
     // Length of frame.
     int length_;
 
+    // Holds a decompressed frame.
+    char* decompressed_;
+    int decompressedCapacity_;
+
     // Most recent frame's key (not timestamp).
     long long key_;
 }
@@ -77,21 +87,19 @@
     if (frame_) {
         free(frame_);
     }
+    free(backFrame_);
+    free(decompressed_);
     [super dealloc];
 }
 
 - (BOOL)seek:(long long)timestamp
 {
-    // TODO(georgen): Do a binary search
-    long long lastKey = [buffer_ lastKey];
-    for (long long key = [buffer_ firstKey]; key <= lastKey; ++key) {
-        DVRIndexEntry* entry = [buffer_ entryForKey:key];
-        if (entry->info.timestamp >= timestamp) {
-            [self _seekToEntryWithKey:key];
-            return YES;
-        }
+    long long key = [buffer_ firstKeyWithTimestampAtLeast:timestamp];
+    if (key < 0) {
+        return NO;
     }
-    return NO;
+    [self _seekToEntryWithKey:key];
+    return YES;
 }
 
 - (char*)decodedFrame
@@ -202,7 +210,12 @@
         --j;
     }
 
-    [self _loadKeyFrameWithKey:j];
+    if (key_ >= j && key_ <= key && key_ >= [buffer_ firstKey]) {
+        // The current frame is on the way from the key frame to 'key', so start from it instead.
+        j = key_;
+    } else {
+        [self _loadKeyFrameWithKey:j];
+    }
 
 #ifdef DVRDEBUG
     [self debug:@"Key frame:" buffer:frame_ length:length_];
@@ -211,7 +224,11 @@
     // Apply all the diff frames up to key.
     while (j != key) {
         ++j;
-        [self _loadDiffFrameWithKey:j];
+        if ([buffer_ entryForKey:j]->info.frameType == DVRFrameTypeRowDiffFrame) {
+            [self _loadRowDiffFrameWithKey:j];
+        } else {
+            [self _loadDiffFrameWithKey:j];
+        }
 #ifdef DVRDEBUG
         [self debug:[NSString stringWithFormat:@"After applying diff of %d:", j] buffer:frame_ length:length_];
 #endif
@@ -222,18 +239,42 @@
 #endif
 }
 
+// Returns the frame's bytes, decompressing them if needed, and sets *lengthPtr to their length.
+- (char *)bytesForEntry:(DVRIndexEntry *)entry key:(long long)key length:(int *)lengthPtr
+{
+    char *data = [buffer_ blockForKey:key];
+    if (!entry->uncompressedLength) {
+        *lengthPtr = entry->frameLength;
+        return data;
+    }
+    if (entry->uncompressedLength > decompressedCapacity_) {
+        decompressedCapacity_ = entry->uncompressedLength;
+        free(decompressed_);
+        decompressed_ = iTermMalloc(decompressedCapacity_);
+    }
+    if (!DVRDecompress(data, entry->frameLength, decompressed_, entry->uncompressedLength)) {
+        DLog(@"Frame with key %lld is corrupt", key);
+        memset(decompressed_, 0, entry->uncompressedLength);
+    }
+    *lengthPtr = entry->uncompressedLength;
+    return decompressed_;
+}
+
 - (void)_loadKeyFrameWithKey:(long long)key
 {
     DVRIndexEntry* entry = [buffer_ entryForKey:key];
-    if (length_ != entry->frameLength && frame_) {
+    int length;
+    char* data = [self bytesForEntry:entry key:key length:&length];
+    if (length_ != length && frame_) {
         free(frame_);
         frame_ = 0;
+        free(backFrame_);
+        backFrame_ = 0;
     }
-    length_ = entry->frameLength;
+    length_ = length;
     if (!frame_) {
         frame_ = iTermMalloc(length_);
     }
-    char* data = [buffer_ blockForKey:key];
     info_ = entry->info;
     DLog(@"Frame with key %lld has size %dx%d", key, info_.width, info_.height);
     memcpy(frame_,  data, length_);
@@ -246,9 +287,10 @@
 #endif
     DVRIndexEntry* entry = [buffer_ entryForKey:key];
     info_ = entry->info;
-    char* diff = [buffer_ blockForKey:key];
+    int length;
+    char* diff = [self bytesForEntry:entry key:key length:&length];
     int o = 0;
-    for (int i = 0; i < entry->frameLength; ) {
+    for (int i = 0; i < length; ) {
         int n;
         switch (diff[i++]) {
             case kSameSequence:
@@ -279,5 +321,57 @@
     }
 }
 
-@end
+- (void)_loadRowDiffFrameWithKey:(long long)key
+{
+    DVRIndexEntry* entry = [buffer_ entryForKey:key];
+    info_ = entry->info;
+    int length;
+    char* diff = [self bytesForEntry:entry key:key length:&length];
+    if (!backFrame_) {
+        backFrame_ = iTermMalloc(length_);
+    }
+    const int rowLength = length_ / info_.height;
+    int o = 0;
+    for (int i = 0; i < length; ) {
+        const char type = diff[i++];
+        int n;
+        memcpy(&n, diff + i, sizeof(n));
+        i += sizeof(n);
+        switch (type) {
+            case kSameSequence:
+                assert(o + n <= length_);
+                memcpy(backFrame_ + o, frame_ + o, n);
+                o += n;
+                break;
+
+            case kDiffSequence:
+                assert(o + n <= length_);
+                memcpy(backFrame_ + o, diff + i, n);
+                o += n;
+                i += n;
+                break;
+
+            case kSameRowsSequence:
+                assert(o + n * rowLength <= length_);
+                memcpy(backFrame_ + o, frame_ + o, n * rowLength);
+                o += n * rowLength;
+                break;
+
+            case kMovedRowSequence:
+                assert(o + rowLength <= length_ && (n + 1) * rowLength <= length_);
+                memcpy(backFrame_ + o, frame_ + n * rowLength, rowLength);
+                o += rowLength;
+                break;
+
+            default:
+                NSLog(@"Unexpected block type %d", (int)type);
+                assert(0);
+        }
+    }
+    assert(o == length_);
+    char *temp = frame_;
+    frame_ = backFrame_;
+    backFrame_ = temp;
+}
 
+@end
@@ -27,7 +27,10 @@
 
 #import "DVREncoder.h"
 #import "DebugLogging.h"
+#import "DVRCompression.h"
 #import "DVRIndexEntry.h"
+#import "iTermAdvancedSettingsModel.h"
+#import "iTermMalloc.h"
 #include "LineBuffer.h"
 #include <sys/time.h>
 //#define DVRDEBUG
@@ -43,20 +46,52 @@ static long long now()
     return result;
 }
 
+// Rows are compared by hash first so that finding where a row moved to doesn't need a memcmp
+// against every row of the previous frame.
+static uint64_t DVRHashRow(const char *bytes, int length) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    int i = 0;
+    for (; i + (int)sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    }
+    for (; i < length; i++) {
+        hash = (hash ^ (unsigned char)bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Appends a sequence to a diff. Returns NO if it wouldn't fit in maxBytes.
+static BOOL DVRAppendSequence(char *scratch, int *o, int maxBytes, char type, int value, const char *bytes, int length) {
+    if (*o + 1 + (int)sizeof(value) + length > maxBytes) {
+        return NO;
+    }
+    scratch[(*o)++] = type;
+    memcpy(scratch + *o, &value, sizeof(value));
+    *o += sizeof(value);
+    if (length) {
+        memcpy(scratch + *o, bytes, length);
+        *o += length;
+    }
+    return YES;
+}
+
 @interface DVREncoder ()
 // Save a key frame into DVRBuffer.
-- (void)_appendKeyFrame:(NSArray *)frameLines length:(int)length info:(DVRFrameInfo*)info;
+- (void)_appendKeyFrameWithLength:(int)length info:(DVRFrameInfo*)info;
 
 // Save a diff frame into DVRBuffer.
-- (void)_appendDiffFrame:(NSArray *)frameLine length:(int)length info:(DVRFrameInfo*)info;
+- (void)_appendDiffFrameWithLength:(int)length info:(DVRFrameInfo*)info;
 
-// Save a frame into DVRBuffer.
+// Save a frame into DVRBuffer, compressing it if that makes it smaller.
 - (void)_appendFrameImpl:(char *)buffer length:(int)length type:(DVRFrameType)type info:(DVRFrameInfo*)info;
 
-// Calculate the diff between buffer,length and the previous frame. Saves results into
+// Calculate the diff between the frame and the previous frame, row by row. Saves results into
 // scratch. Won't use more than maxSize bytes in scratch. Returns number of bytes used or
 // -1 if the diff was larger than maxSize.
-- (int)_computeDiff:(NSArray *)frameLines length:(int)length dest:(char*)scratch maxSize:(int)maxSize;
+- (int)_computeRowDiffWithHeight:(int)height dest:(char*)scratch maxSize:(int)maxSize;
 
 @end
 
@@ -68,6 +103,25 @@ static long long now()
     // The last encoded frame.
     NSMutableData* lastFrame_;
 
+    // The frame being encoded. It becomes lastFrame_ once it's appended.
+    NSMutableData* frame_;
+
+    // Hash of each row of lastFrame_ and frame_. Valid for rowCount_ rows, which is 0 if the
+    // frame can't be split into rows of equal length.
+    uint64_t* lastRowHashes_;
+    uint64_t* rowHashes_;
+    int lastRowCount_;
+    int rowCount_;
+    int rowHashCapacity_;
+
+    // Distance from the last moved row to where it came from in the previous frame. Rows usually
+    // all move together, so the next moved row is most likely found at the same distance.
+    int lastShift_;
+
+    // Holds a frame while it's compressed.
+    char* compressed_;
+    int compressedCapacity_;
+
     // Info from the last frame.
     DVRFrameInfo lastInfo_;
 
@@ -89,6 +143,7 @@ static long long now()
     if (self) {
         buffer_ = [buffer retain];
         lastFrame_ = nil;
+        frame_ = [[NSMutableData alloc] init];
         count_ = 0;
         haveReservation_ = NO;
     }
@@ -98,6 +153,10 @@ static long long now()
 - (void)dealloc
 {
     [lastFrame_ release];
+    [frame_ release];
+    free(lastRowHashes_);
+    free(rowHashes_);
+    free(compressed_);
     [buffer_ release];
     [super dealloc];
 }
@@ -117,11 +176,15 @@ static long long now()
 
 - (void)appendFrame:(NSArray *)frameLines length:(int)length info:(DVRFrameInfo*)info
 {
+    [self loadFrameLines:frameLines length:length];
+
     BOOL eligibleForDiff;
     if (lastFrame_ &&
         length == [lastFrame_ length] &&
         info->width == lastInfo_.width &&
         info->height == lastInfo_.height &&
+        rowCount_ == info->height &&
+        lastRowCount_ == rowCount_ &&
         bytesSinceLastKeyFrame_ < [buffer_ capacity] / 2) {
         eligibleForDiff = YES;
     } else {
@@ -131,10 +194,20 @@ static long long now()
     const int kKeyFrameFrequency = 100;
 
     if (!eligibleForDiff || count_++ % kKeyFrameFrequency == 0) {
-        [self _appendKeyFrame:frameLines length:length info:info];
+        [self _appendKeyFrameWithLength:length info:info];
     } else {
-        [self _appendDiffFrame:frameLines length:length info:info];
+        [self _appendDiffFrameWithLength:length info:info];
     }
+
+    // The frame just appended is what the next one is diffed against.
+    NSMutableData *temp = lastFrame_ ?: [[NSMutableData alloc] init];
+    lastFrame_ = frame_;
+    frame_ = temp;
+
+    uint64_t *tempHashes = lastRowHashes_;
+    lastRowHashes_ = rowHashes_;
+    rowHashes_ = tempHashes;
+    lastRowCount_ = rowCount_;
 }
 
 - (BOOL)reserve:(int)length
@@ -177,35 +250,56 @@ static long long now()
 #endif
 }
 
-- (NSMutableData *)combinedFrameLines:(NSArray *)frameLines {
-    NSMutableData *data = [[[NSMutableData alloc] init] autorelease];
-    for (NSData *line in frameLines) {
-        [data appendData:line];
+// Copies the lines into frame_ and hashes each one.
+- (void)loadFrameLines:(NSArray *)frameLines length:(int)length
+{
+    [frame_ setLength:length];
+    char *bytes = [frame_ mutableBytes];
+    const int numLines = [frameLines count];
+    const int rowLength = numLines ? length / numLines : 0;
+    if (numLines > rowHashCapacity_) {
+        // The height changed, so the next frame is a key frame and the old hashes aren't needed.
+        rowHashCapacity_ = numLines;
+        free(lastRowHashes_);
+        free(rowHashes_);
+        lastRowHashes_ = iTermMalloc(rowHashCapacity_ * sizeof(uint64_t));
+        rowHashes_ = iTermMalloc(rowHashCapacity_ * sizeof(uint64_t));
+        lastRowCount_ = 0;
+    }
+    rowCount_ = numLines;
+    int o = 0;
+    for (int y = 0; y < numLines; y++) {
+        NSData *line = frameLines[y];
+        const int lineLength = line.length;
+        assert(o + lineLength <= length);
+        memcpy(bytes + o, line.bytes, lineLength);
+        if (lineLength == rowLength) {
+            rowHashes_[y] = DVRHashRow(bytes + o, lineLength);
+        } else {
+            rowCount_ = 0;
+        }
+        o += lineLength;
     }
-    return data;
+    assert(o == length);
 }
 
-- (void)_appendKeyFrame:(NSArray *)frameLines length:(int)length info:(DVRFrameInfo*)info
+- (void)_appendKeyFrameWithLength:(int)length info:(DVRFrameInfo*)info
 {
-    [lastFrame_ release];
-    lastFrame_ = [[self combinedFrameLines:frameLines] retain];
-    assert(lastFrame_.length == length);
     char* scratch = [buffer_ scratch];
-    memcpy(scratch, [lastFrame_ mutableBytes], length);
+    memcpy(scratch, [frame_ bytes], length);
     [self _appendFrameImpl:scratch length:length type:DVRFrameTypeKeyFrame info:info];
     bytesSinceLastKeyFrame_ = 0;
 }
 
-- (void)_appendDiffFrame:(NSArray *)frameLines length:(int)length info:(DVRFrameInfo*)info
+- (void)_appendDiffFrameWithLength:(int)length info:(DVRFrameInfo*)info
 {
     char* scratch = [buffer_ scratch];
-    int diffBytes = [self _computeDiff:frameLines
-                                length:length
-                                  dest:scratch
-                               maxSize:reservation_];
+    int diffBytes = [self _computeRowDiffWithHeight:info->height
+                                               dest:scratch
+                                            maxSize:reservation_];
     if (diffBytes < 0) {
         // Diff ended up being larger than a key frame would be.
-        [self _appendKeyFrame:frameLines length:length info:info];
+        [self _appendKeyFrameWithLength:length info:info];
         return;
     }
 
@@ -216,8 +310,7 @@ static long long now()
         NSLog(@"Offset %d: %d (%c)", i, (int)scratch[i], scratch[i]);
     }
 #endif
-    [self _appendFrameImpl:scratch length:diffBytes type:DVRFrameTypeDiffFrame info:info];
-    bytesSinceLastKeyFrame_ += diffBytes;
+    [self _appendFrameImpl:scratch length:diffBytes type:DVRFrameTypeRowDiffFrame info:info];
 }
 
 - (void)_appendFrameImpl:(char*)dest length:(int)length type:(DVRFrameType)type info:(DVRFrameInfo*)info
@@ -225,6 +318,22 @@ static long long now()
     assert(haveReservation_);
     haveReservation_ = NO;
 
+    int uncompressedLength = 0;
+    if ([iTermAdvancedSettingsModel compressInstantReplay] && length > 0) {
+        if (length > compressedCapacity_) {
+            compressedCapacity_ = length;
+            free(compressed_);
+            compressed_ = iTermMalloc(compressedCapacity_);
+        }
+        // Keep the frame as-is unless compressing it saves something.
+        const int compressedLength = DVRCompress(dest, length, compressed_, length - 1);
+        if (compressedLength >= 0) {
+            memcpy(dest, compressed_, compressedLength);
+            uncompressedLength = length;
+            length = compressedLength;
+        }
+    }
+
 #ifdef DVRDEBUG
     NSLog(@"Append frame of type %d starting at %x length %d at index %d", (int)type, dest, length, [buffer_ lastKey]+1);
 #endif
@@ -236,90 +345,93 @@ static long long now()
     entry->info = *info;
     entry->info.timestamp = now();
     entry->info.frameType = type;
+    entry->uncompressedLength = uncompressedLength;
+    if (type != DVRFrameTypeKeyFrame) {
+        bytesSinceLastKeyFrame_ += length;
+    }
     DLog(@"Append frame with key %lld, size %dx%d", key, info->width, info->height);
 }
 
-- (int)_computeDiff:(NSArray *)frameLines length:(int)length dest:(char*)scratch maxSize:(int)maxBytes
+// Returns the row of the previous frame that's identical to row y of this frame, or -1.
+- (int)sourceOfMovedRow:(int)y rowLength:(int)rowLength
 {
+    const char *bytes = [frame_ bytes] + (size_t)y * rowLength;
+    const char *other = [lastFrame_ bytes];
+    const uint64_t hash = rowHashes_[y];
+    const int guess = y + lastShift_;
+    if (guess >= 0 && guess < lastRowCount_ && guess != y && lastRowHashes_[guess] == hash &&
+        !memcmp(bytes, other + (size_t)guess * rowLength, rowLength)) {
+        return guess;
+    }
+    for (int j = 0; j < lastRowCount_; j++) {
+        if (j != y && lastRowHashes_[j] == hash && !memcmp(bytes, other + (size_t)j * rowLength, rowLength)) {
+            lastShift_ = j - y;
+            return j;
+        }
+    }
+    return -1;
+}
+
+- (int)_computeRowDiffWithHeight:(int)height dest:(char*)scratch maxSize:(int)maxBytes
+{
+    const int length = [frame_ length];
     assert(length == [lastFrame_ length]);
-    char* other = [lastFrame_ mutableBytes];
-    assert(other);
+    assert(height == rowCount_ && height == lastRowCount_ && height > 0);
+    const char *frame = [frame_ bytes];
+    const char *other = [lastFrame_ bytes];
+    const int rowLength = length / height;
+    const int cellSize = sizeof(screen_char_t);
+    assert(rowLength % cellSize == 0);
 
     int o = 0;
-    int sameCount = 0;
-    int diffCount = 0;
-    char* startDiff = 0;
-
-    // TODO(georgen): Implement a better diff
-    int numLines = [frameLines count];
-    int i = 0;
-    for (int y = 0; y < numLines; y++) {
-        NSMutableData *lineData = [frameLines objectAtIndex:y];
-        char *frameLine = [lineData mutableBytes];
-        const int numChars = lineData.length;
-        for (int x = 0; x < numChars; x++, i++) {
-            // TODO: This should be a screen_char_t-wise comparison, not bytewise
-            if (frameLine[x] == other[i]) {
-                if (diffCount > 0) {
-                    if (o + 1 + sizeof(diffCount) + diffCount > maxBytes) {
-                        // Diff is too big.
-                        return -1;
-                    }
-                    scratch[o++] = kDiffSequence;
-                    memcpy(scratch + o, &diffCount, sizeof(diffCount));
-                    o += sizeof(diffCount);
-                    memcpy(scratch + o, startDiff, diffCount);
-                    o += diffCount;
-                    [self debug:@"diff " buffer:startDiff length:diffCount];
-                    diffCount = 0;
-                }
-                ++sameCount;
-            } else {
-                if (sameCount > 0) {
-                    if (o + 1 + sizeof(sameCount) > maxBytes) {
-                        // Diff is too big.
-                        return -1;
-                    }
-                    scratch[o++] = kSameSequence;
-                    memcpy(scratch + o, &sameCount, sizeof(sameCount));
-                    o += sizeof(sameCount);
-    #ifdef DVRDEBUG
-                    NSLog(@"%d the same", sameCount);
-    #endif
-                    sameCount = 0;
-                }
-                if (!diffCount) {
-                    startDiff = frameLine + x;
-                }
-                other[i] = frameLine[x];
-                ++diffCount;
-            }
+    int sameRows = 0;
+    for (int y = 0; y < height; y++) {
+        const char *row = frame + (size_t)y * rowLength;
+        const char *otherRow = other + (size_t)y * rowLength;
+        if (rowHashes_[y] == lastRowHashes_[y] && !memcmp(row, otherRow, rowLength)) {
+            ++sameRows;
+            continue;
         }
-        if (diffCount > 0) {
-            if (o + 1 + sizeof(diffCount) + diffCount > maxBytes) {
-                // Diff is too big.
+        if (sameRows > 0) {
+            if (!DVRAppendSequence(scratch, &o, maxBytes, kSameRowsSequence, sameRows, NULL, 0)) {
                 return -1;
             }
-            scratch[o++] = kDiffSequence;
-            memcpy(scratch + o, &diffCount, sizeof(diffCount));
-            o += sizeof(diffCount);
-            memcpy(scratch + o, startDiff, diffCount);
-            o += diffCount;
-            [self debug:@"diff " buffer:startDiff length:diffCount];
-            diffCount = 0;
+            sameRows = 0;
         }
-        if (sameCount > 0) {
-            if (o + 1 + sizeof(sameCount) > maxBytes) {
-                // Diff is too big.
+
+        const int source = [self sourceOfMovedRow:y rowLength:rowLength];
+        if (source >= 0) {
+            if (!DVRAppendSequence(scratch, &o, maxBytes, kMovedRowSequence, source, NULL, 0)) {
                 return -1;
             }
-            scratch[o++] = kSameSequence;
-            memcpy(scratch + o, &sameCount, sizeof(sameCount));
-            o += sizeof(sameCount);
-#ifdef DVRDEBUG
-            NSLog(@"%d the same", sameCount);
-#endif
-            sameCount = 0;
+            continue;
+        }
+
+        // The row changed in place. Record which cells differ.
+        int x = 0;
+        while (x < rowLength) {
+            const BOOL same = !memcmp(row + x, otherRow + x, cellSize);
+            int end = x + cellSize;
+            while (end < rowLength && (memcmp(row + end, otherRow + end, cellSize) == 0) == same) {
+                end += cellSize;
+            }
+            const int count = end - x;
+            if (same) {
+                if (!DVRAppendSequence(scratch, &o, maxBytes, kSameSequence, count, NULL, 0)) {
+                    return -1;
+                }
+            } else {
+                if (!DVRAppendSequence(scratch, &o, maxBytes, kDiffSequence, count, row + x, count)) {
+                    return -1;
+                }
+                [self debug:@"diff " buffer:(char *)row + x length:count];
+            }
+            x = end;
+        }
+    }
+    if (sameRows > 0) {
+        if (!DVRAppendSequence(scratch, &o, maxBytes, kSameRowsSequence, sameRows, NULL, 0)) {
+            return -1;
         }
     }
     return o;
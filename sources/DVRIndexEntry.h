@@ -54,6 +54,9 @@ typedef struct {
 
     // Number of bytes in buffer.
     int frameLength;
+
+    // If the frame is compressed, the number of bytes it decompresses to. Otherwise 0.
+    int uncompressedLength;
 }
 
 + (instancetype)entryFromDictionaryValue:(NSDictionary *)dict;
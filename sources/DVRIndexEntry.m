@@ -34,6 +34,7 @@
     DVRIndexEntry *entry = [[[self alloc] init] autorelease];
     entry->position = [dict[@"position"] longLongValue];
     entry->frameLength = [dict[@"frameLength"] intValue];
+    entry->uncompressedLength = [dict[@"uncompressedLength"] intValue];
 
     NSDictionary *infoDict = dict[@"info"];
     entry->info.width = [infoDict[@"width"] intValue];
@@ -54,7 +55,8 @@
                           @"timestamp": @(info.timestamp),
                           @"frameType": @(info.frameType) },
               @"position": @(position),
-              @"frameLength": @(frameLength) };
+              @"frameLength": @(frameLength),
+              @"uncompressedLength": @(uncompressedLength) };
 }
 
 @end
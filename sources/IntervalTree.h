@@ -1,5 +1,4 @@
 #import <Foundation/Foundation.h>
-#import "AATree.h"
 
 @class IntervalTreeEntry;
 
@@ -30,7 +29,7 @@
 - (NSDictionary *)dictionaryValue;
 @end
 
-// A node in the interval tree will contain one or more entries, each of which has an interval and an object. All intervals should have the same location.
+// An object in the interval tree along with its interval.
 @interface IntervalTreeEntry : NSObject
 @property(nonatomic, retain) Interval *interval;
 @property(nonatomic, retain) id<IntervalTreeObject> object;
@@ -38,19 +37,7 @@
 + (IntervalTreeEntry *)entryWithInterval:(Interval *)interval object:(id<IntervalTreeObject>)object;
 @end
 
-@interface IntervalTreeValue : NSObject
-@property(nonatomic, assign) long long maxLimitAtSubtree;
-@property(nonatomic, retain) NSMutableArray *entries;
-
-// Largest limit of all entries
-@property(nonatomic, readonly) long long maxLimit;
-
-// Interval including intervals of all entries at this entry exactly
-- (Interval *)spanningInterval;
-
-@end
-
-@interface IntervalTree : NSObject <AATreeDelegate>
+@interface IntervalTree : NSObject
 
 @property(nonatomic, readonly) NSInteger count;
 @property(nonatomic, readonly) NSString *debugString;
@@ -65,6 +52,19 @@
 - (NSArray<IntervalTreeObject> *)allObjects;
 - (BOOL)containsObject:(id<IntervalTreeObject>)object;
 
+// Calls |block| with each object whose interval intersects [location, limit), in order of
+// location, until it sets *stop. Unlike -objectsInInterval: this doesn't allocate. |block| must
+// not modify the tree.
+- (void)enumerateObjectsFromLocation:(long long)location
+                               limit:(long long)limit
+                               block:(void (^NS_NOESCAPE)(id<IntervalTreeObject> object, BOOL *stop))block;
+
+// Removes every object whose interval ends at or before |limit| and then calls |block| with each
+// of them in order. Their entries are still set during the call. This is much faster than removing
+// them one at a time.
+- (void)removeObjectsWithLimitAtMost:(long long)limit
+                               block:(void (^NS_NOESCAPE)(id<IntervalTreeObject> object))block;
+
 // Returns the object with the highest limit
 - (NSArray<IntervalTreeObject> *)objectsWithLargestLimit;
 // Returns the object with the smallest limit
@@ -0,0 +1,1021 @@
+#import "IntervalTree.h"
+#import "DebugLogging.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+static const long long kMinLocation = LLONG_MIN / 2;
+static const long long kMaxLimit = kMinLocation + LLONG_MAX;
+
+static NSString *const kIntervalTreeEntriesKey = @"Entries";
+static NSString *const kIntervalTreeIntervalKey = @"Interval";
+static NSString *const kIntervalTreeObjectKey = @"Object";
+static NSString *const kIntervalTreeClassNameKey = @"Class";
+
+static NSString *const kIntervalLocationKey = @"Location";
+static NSString *const kIntervalLengthKey = @"Length";
+
+namespace iTerm2 {
+    // An AA tree of intervals ordered by location, augmented with the smallest and largest limit
+    // in each subtree so range and limit queries can skip subtrees that can't contain an answer.
+    // Nodes live in one vector and refer to each other by index. Entries at the same location are
+    // ordered by a serial number, so every entry gets its own node and keys are unique.
+    class IntervalTreeCore {
+    public:
+        struct Entry {
+            long long location;
+            long long limit;
+            long long serial;
+            void *object;
+        };
+
+    private:
+        typedef int32_t Index;
+
+        // Index 0 is a sentinel that stands in for a missing child.
+        static const Index kNil = 0;
+
+        // AA trees are at most 2*log2(n) deep.
+        static const int kMaxDepth = 80;
+
+        struct Node {
+            Entry entry;
+            long long minLimit;
+            long long maxLimit;
+            Index left;
+            Index right;
+            int level;
+        };
+
+        std::vector<Node> _nodes;
+        std::vector<Index> _free;
+        Index _root;
+        size_t _count;
+
+        static bool IsLess(const Entry &a, const Entry &b) {
+            return a.location < b.location || (a.location == b.location && a.serial < b.serial);
+        }
+
+        Index allocate(const Entry &entry) {
+            Index n;
+            if (_free.empty()) {
+                n = static_cast<Index>(_nodes.size());
+                _nodes.emplace_back();
+            } else {
+                n = _free.back();
+                _free.pop_back();
+            }
+            Node &node = _nodes[n];
+            node.entry = entry;
+            node.minLimit = entry.limit;
+            node.maxLimit = entry.limit;
+            node.left = kNil;
+            node.right = kNil;
+            node.level = 1;
+            return n;
+        }
+
+        void update(Index n) {
+            Node &node = _nodes[n];
+            const Node &left = _nodes[node.left];
+            const Node &right = _nodes[node.right];
+            node.minLimit = std::min(node.entry.limit, std::min(left.minLimit, right.minLimit));
+            node.maxLimit = std::max(node.entry.limit, std::max(left.maxLimit, right.maxLimit));
+        }
+
+        Index skew(Index t) {
+            if (t == kNil) {
+                return t;
+            }
+            const Index l = _nodes[t].left;
+            if (_nodes[l].level != _nodes[t].level) {
+                return t;
+            }
+            _nodes[t].left = _nodes[l].right;
+            _nodes[l].right = t;
+            update(t);
+            update(l);
+            return l;
+        }
+
+        Index split(Index t) {
+            if (t == kNil) {
+                return t;
+            }
+            const Index r = _nodes[t].right;
+            if (_nodes[_nodes[r].right].level != _nodes[t].level) {
+                return t;
+            }
+            _nodes[t].right = _nodes[r].left;
+            _nodes[r].left = t;
+            _nodes[r].level++;
+            update(t);
+            update(r);
+            return r;
+        }
+
+        Index insert(Index t, Index n) {
+            if (t == kNil) {
+                return n;
+            }
+            if (IsLess(_nodes[n].entry, _nodes[t].entry)) {
+                _nodes[t].left = insert(_nodes[t].left, n);
+            } else {
+                _nodes[t].right = insert(_nodes[t].right, n);
+            }
+            update(t);
+            return split(skew(t));
+        }
+
+        Index remove(Index t, const Entry &key) {
+            if (t == kNil) {
+                return t;
+            }
+            if (IsLess(key, _nodes[t].entry)) {
+                _nodes[t].left = remove(_nodes[t].left, key);
+            } else if (IsLess(_nodes[t].entry, key)) {
+                _nodes[t].right = remove(_nodes[t].right, key);
+            } else if (_nodes[t].left == kNil && _nodes[t].right == kNil) {
+                _free.push_back(t);
+                return kNil;
+            } else if (_nodes[t].left == kNil) {
+                // Replace this node's entry with its successor's.
+                Index s = _nodes[t].right;
+                while (_nodes[s].left != kNil) {
+                    s = _nodes[s].left;
+                }
+                const Entry successor = _nodes[s].entry;
+                _nodes[t].right = remove(_nodes[t].right, successor);
+                _nodes[t].entry = successor;
+            } else {
+                // Replace this node's entry with its predecessor's.
+                Index p = _nodes[t].left;
+                while (_nodes[p].right != kNil) {
+                    p = _nodes[p].right;
+                }
+                const Entry predecessor = _nodes[p].entry;
+                _nodes[t].left = remove(_nodes[t].left, predecessor);
+                _nodes[t].entry = predecessor;
+            }
+            update(t);
+
+            // Rebalance.
+            Node &node = _nodes[t];
+            const int level = std::min(_nodes[node.left].level, _nodes[node.right].level) + 1;
+            if (level < node.level) {
+                node.level = level;
+                if (level < _nodes[node.right].level) {
+                    _nodes[node.right].level = level;
+                }
+            }
+            t = skew(t);
+            _nodes[t].right = skew(_nodes[t].right);
+            const Index r = _nodes[t].right;
+            if (r != kNil) {
+                _nodes[r].right = skew(_nodes[r].right);
+            }
+            t = split(t);
+            _nodes[t].right = split(_nodes[t].right);
+            return t;
+        }
+
+        // Builds a perfectly balanced tree. Giving the left side the smaller half and each node the
+        // level floor(log2(size + 1)) satisfies the AA invariants.
+        Index build(const std::vector<Entry> &entries, size_t begin, size_t end) {
+            if (begin == end) {
+                return kNil;
+            }
+            const size_t size = end - begin;
+            const size_t middle = begin + (size - 1) / 2;
+            const Index n = allocate(entries[middle]);
+            const Index left = build(entries, begin, middle);
+            const Index right = build(entries, middle + 1, end);
+            Node &node = _nodes[n];
+            node.left = left;
+            node.right = right;
+            node.level = 0;
+            for (size_t s = size + 1; s > 1; s >>= 1) {
+                node.level++;
+            }
+            update(n);
+            return n;
+        }
+
+        void findSmallestLimitAfter(Index n, long long bound, long long *best) const {
+            const Node &node = _nodes[n];
+            if (n == kNil || node.maxLimit <= bound || node.minLimit >= *best) {
+                return;
+            }
+            if (node.minLimit > bound) {
+                *best = node.minLimit;
+                return;
+            }
+            findSmallestLimitAfter(node.left, bound, best);
+            if (node.entry.limit > bound && node.entry.limit < *best) {
+                *best = node.entry.limit;
+            }
+            // Entries to the right start at or after this one, so they end there or later.
+            if (node.entry.location < *best) {
+                findSmallestLimitAfter(node.right, bound, best);
+            }
+        }
+
+        void findLargestLimitBefore(Index n, long long bound, long long *best) const {
+            const Node &node = _nodes[n];
+            if (n == kNil || node.minLimit >= bound || node.maxLimit <= *best) {
+                return;
+            }
+            if (node.maxLimit < bound) {
+                *best = node.maxLimit;
+                return;
+            }
+            if (node.entry.location < bound) {
+                findLargestLimitBefore(node.right, bound, best);
+            }
+            if (node.entry.limit < bound && node.entry.limit > *best) {
+                *best = node.entry.limit;
+            }
+            findLargestLimitBefore(node.left, bound, best);
+        }
+
+        template<typename Block>
+        bool enumerateWithLimit(Index n, long long limit, Block &block) const {
+            const Node &node = _nodes[n];
+            if (n == kNil || node.minLimit > limit || node.maxLimit < limit) {
+                return false;
+            }
+            if (enumerateWithLimit(node.left, limit, block)) {
+                return true;
+            }
+            if (node.entry.limit == limit && block(node.entry)) {
+                return true;
+            }
+            return node.entry.location <= limit && enumerateWithLimit(node.right, limit, block);
+        }
+
+        template<typename Block>
+        bool enumerateAtLocation(Index n, long long location, Block &block) const {
+            if (n == kNil) {
+                return false;
+            }
+            const Node &node = _nodes[n];
+            if (node.entry.location >= location && enumerateAtLocation(node.left, location, block)) {
+                return true;
+            }
+            if (node.entry.location == location && block(node.entry)) {
+                return true;
+            }
+            return node.entry.location <= location && enumerateAtLocation(node.right, location, block);
+        }
+
+        void collectWithLimitAtMost(Index n, long long limit, std::vector<Entry> *entries) const {
+            const Node &node = _nodes[n];
+            if (n == kNil || node.minLimit > limit) {
+                return;
+            }
+            collectWithLimitAtMost(node.left, limit, entries);
+            if (node.entry.limit <= limit) {
+                entries->push_back(node.entry);
+            }
+            if (node.entry.location <= limit) {
+                collectWithLimitAtMost(node.right, limit, entries);
+            }
+        }
+
+        // Returns the number of nodes in the subtree, or -1 if it's broken.
+        long long check(Index n, const Entry *lower, const Entry *upper) const {
+            if (n == kNil) {
+                return 0;
+            }
+            const Node &node = _nodes[n];
+            const Node &left = _nodes[node.left];
+            const Node &right = _nodes[node.right];
+            if ((lower && !IsLess(*lower, node.entry)) ||
+                (upper && !IsLess(node.entry, *upper)) ||
+                node.entry.limit < node.entry.location ||
+                node.minLimit != std::min(node.entry.limit, std::min(left.minLimit, right.minLimit)) ||
+                node.maxLimit != std::max(node.entry.limit, std::max(left.maxLimit, right.maxLimit)) ||
+                left.level != node.level - 1 ||
+                (right.level != node.level && right.level != node.level - 1) ||
+                _nodes[right.right].level >= node.level ||
+                (node.level > 1 && (node.left == kNil || node.right == kNil))) {
+                return -1;
+            }
+            const long long leftCount = check(node.left, lower, &node.entry);
+            const long long rightCount = check(node.right, &node.entry, upper);
+            if (leftCount < 0 || rightCount < 0) {
+                return -1;
+            }
+            return leftCount + rightCount + 1;
+        }
+
+    public:
+        IntervalTreeCore() : _nodes(1), _root(kNil), _count(0) {
+            Node &sentinel = _nodes[kNil];
+            sentinel.entry = { 0, 0, 0, nullptr };
+            sentinel.minLimit = LLONG_MAX;
+            sentinel.maxLimit = LLONG_MIN;
+            sentinel.left = kNil;
+            sentinel.right = kNil;
+            sentinel.level = 0;
+        }
+
+        size_t count() const {
+            return _count;
+        }
+
+        void add(const Entry &entry) {
+            _root = insert(_root, allocate(entry));
+            _count++;
+        }
+
+        // Returns the object of the entry with the same location and serial as |key|.
+        void *find(const Entry &key) const {
+            Index n = _root;
+            while (n != kNil) {
+                const Entry &entry = _nodes[n].entry;
+                if (IsLess(key, entry)) {
+                    n = _nodes[n].left;
+                } else if (IsLess(entry, key)) {
+                    n = _nodes[n].right;
+                } else {
+                    return entry.object;
+                }
+            }
+            return nullptr;
+        }
+
+        // Removes the entry with the same location, serial, and object as |key|. Returns whether
+        // there was one.
+        bool remove(const Entry &key) {
+            if (key.object == nullptr || find(key) != key.object) {
+                return false;
+            }
+            _root = remove(_root, key);
+            _count--;
+            return true;
+        }
+
+        // Replaces the contents of the tree with |entries|, which must be sorted.
+        void build(const std::vector<Entry> &entries) {
+            _nodes.resize(1);
+            _free.clear();
+            _nodes.reserve(entries.size() + 1);
+            _root = build(entries, 0, entries.size());
+            _count = entries.size();
+        }
+
+        // Calls |block| with each entry in order until it returns true.
+        template<typename Block>
+        void enumerate(Block block) const {
+            enumerateIntersecting(LLONG_MIN, LLONG_MAX, block, true);
+        }
+
+        // Calls |block| in order with each entry that intersects [location, limit) until it returns
+        // true. Empty entries intersect nothing unless |includeEmpty| is set. Doesn't allocate.
+        // |block| must not modify the tree.
+        template<typename Block>
+        void enumerateIntersecting(long long location,
+                                   long long limit,
+                                   Block block,
+                                   bool includeEmpty = false) const {
+            Index stack[kMaxDepth];
+            int depth = 0;
+            Index n = _root;
+            while (true) {
+                while (n != kNil && (includeEmpty || _nodes[n].maxLimit > location)) {
+                    assert(depth < kMaxDepth);
+                    stack[depth++] = n;
+                    n = _nodes[n].left;
+                }
+                if (depth == 0) {
+                    return;
+                }
+                n = stack[--depth];
+                const Entry &entry = _nodes[n].entry;
+                if (!includeEmpty && entry.location >= limit) {
+                    return;
+                }
+                if (includeEmpty || std::max(entry.location, location) < std::min(entry.limit, limit)) {
+                    if (block(entry)) {
+                        return;
+                    }
+                }
+                n = _nodes[n].right;
+            }
+        }
+
+        // Each of these finds a value and returns false if there is none. Enumerate the entries
+        // having it with enumerateWithLimit() or enumerateAtLocation().
+        bool smallestLimit(long long *limit) const {
+            *limit = _nodes[_root].minLimit;
+            return _root != kNil;
+        }
+
+        bool largestLimit(long long *limit) const {
+            *limit = _nodes[_root].maxLimit;
+            return _root != kNil;
+        }
+
+        bool smallestLimitAfter(long long bound, long long *limit) const {
+            *limit = LLONG_MAX;
+            findSmallestLimitAfter(_root, bound, limit);
+            return *limit != LLONG_MAX;
+        }
+
+        bool largestLimitBefore(long long bound, long long *limit) const {
+            *limit = LLONG_MIN;
+            findLargestLimitBefore(_root, bound, limit);
+            return *limit != LLONG_MIN;
+        }
+
+        bool largestLocation(long long *location) const {
+            Index n = _root;
+            while (_nodes[n].right != kNil) {
+                n = _nodes[n].right;
+            }
+            *location = _nodes[n].entry.location;
+            return _root != kNil;
+        }
+
+        bool largestLocationBefore(long long bound, long long *location) const {
+            bool found = false;
+            Index n = _root;
+            while (n != kNil) {
+                const Entry &entry = _nodes[n].entry;
+                if (entry.location < bound) {
+                    *location = entry.location;
+                    found = true;
+                    n = _nodes[n].right;
+                } else {
+                    n = _nodes[n].left;
+                }
+            }
+            return found;
+        }
+
+        template<typename Block>
+        void enumerateWithLimit(long long limit, Block block) const {
+            enumerateWithLimit(_root, limit, block);
+        }
+
+        template<typename Block>
+        void enumerateAtLocation(long long location, Block block) const {
+            enumerateAtLocation(_root, location, block);
+        }
+
+        // Removes every entry whose limit is at most |limit| and then calls |block| with each of
+        // them in order.
+        template<typename Block>
+        void removeEntriesWithLimitAtMost(long long limit, Block block) {
+            std::vector<Entry> removed;
+            collectWithLimitAtMost(_root, limit, &removed);
+            if (removed.empty()) {
+                return;
+            }
+            if (removed.size() * 8 > _count) {
+                // Rebuilding from what's left is cheaper than removing this many one at a time.
+                std::vector<Entry> kept;
+                kept.reserve(_count - removed.size());
+                enumerate([&kept, limit](const Entry &entry) {
+                    if (entry.limit > limit) {
+                        kept.push_back(entry);
+                    }
+                    return false;
+                });
+                build(kept);
+            } else {
+                for (const Entry &entry : removed) {
+                    _root = remove(_root, entry);
+                }
+                _count -= removed.size();
+            }
+            for (const Entry &entry : removed) {
+                block(entry);
+            }
+        }
+
+        bool isValid() const {
+            return _nodes[kNil].level == 0 &&
+                   _nodes[kNil].left == kNil &&
+                   _nodes[kNil].right == kNil &&
+                   check(_root, nullptr, nullptr) == static_cast<long long>(_count) &&
+                   _nodes.size() == _count + _free.size() + 1;
+        }
+    };
+}  // namespace iTerm2
+
+@interface IntervalTreeForwardLimitEnumerator : NSEnumerator {
+    long long previousLimit_;
+    IntervalTree *tree_;
+}
+@property(nonatomic, assign) long long previousLimit;
+@end
+
+@implementation IntervalTreeForwardLimitEnumerator
+@synthesize previousLimit = previousLimit_;
+
+- (instancetype)initWithTree:(IntervalTree *)tree {
+    self = [super init];
+    if (self) {
+        tree_ = [tree retain];
+        previousLimit_ = -2;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [tree_ release];
+    [super dealloc];
+}
+
+- (NSArray *)allObjects {
+    NSMutableArray *result = [NSMutableArray array];
+    NSObject *o = [self nextObject];
+    while (o) {
+        [result addObject:o];
+    }
+    return result;
+}
+
+- (id)nextObject {
+    NSArray *objects;
+    if (previousLimit_ == -2) {
+        objects = [tree_ objectsWithSmallestLimit];
+    } else if (previousLimit_ == -1) {
+        return nil;
+    } else {
+        objects = [tree_ objectsWithSmallestLimitAfter:previousLimit_];
+    }
+    if (!objects.count) {
+        previousLimit_ = -1;
+    } else {
+        id<IntervalTreeObject> obj = objects[0];
+        previousLimit_ = [obj.entry.interval limit];
+    }
+    return objects;
+}
+
+@end
+
+@interface IntervalTreeReverseLimitEnumerator : NSEnumerator {
+    long long previousLimit_;
+    IntervalTree *tree_;
+}
+@property(nonatomic, assign) long long previousLimit;
+@end
+
+@implementation IntervalTreeReverseLimitEnumerator
+
+@synthesize previousLimit = previousLimit_;
+
+- (instancetype)initWithTree:(IntervalTree *)tree {
+    self = [super init];
+    if (self) {
+        tree_ = [tree retain];
+        previousLimit_ = -2;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [tree_ release];
+    [super dealloc];
+}
+
+- (NSArray *)allObjects {
+    NSMutableArray *result = [NSMutableArray array];
+    NSObject *o = [self nextObject];
+    while (o) {
+        [result addObject:o];
+    }
+    return result;
+}
+
+- (id)nextObject {
+    NSArray *objects;
+    if (previousLimit_ == -2) {
+        objects = [tree_ objectsWithLargestLimit];
+    } else if (previousLimit_ == -1) {
+        return nil;
+    } else {
+        objects = [tree_ objectsWithLargestLimitBefore:previousLimit_];
+    }
+    if (!objects.count) {
+        previousLimit_ = -1;
+        return nil;
+    } else {
+        id<IntervalTreeObject> obj = objects[0];
+        previousLimit_ = [obj.entry.interval limit];
+        return objects;
+    }
+}
+
+@end
+
+@interface IntervalTreeReverseEnumerator : NSEnumerator {
+    long long previousLocation_;
+    IntervalTree *tree_;
+}
+@property(nonatomic, assign) long long previousLocation;
+@end
+
+@implementation IntervalTreeReverseEnumerator
+
+@synthesize previousLocation = previousLocation_;
+
+- (instancetype)initWithTree:(IntervalTree *)tree {
+    self = [super init];
+    if (self) {
+        tree_ = [tree retain];
+        previousLocation_ = -2;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [tree_ release];
+    [super dealloc];
+}
+
+- (NSArray *)allObjects {
+    NSMutableArray *result = [NSMutableArray array];
+    NSObject *o = [self nextObject];
+    while (o) {
+        [result addObject:o];
+    }
+    return result;
+}
+
+- (id)nextObject {
+    NSArray *objects;
+    if (previousLocation_ == -2) {
+        objects = [tree_ objectsWithLargestLocation];
+    } else if (previousLocation_ == -1) {
+        return nil;
+    } else {
+        objects = [tree_ objectsWithLargestLocationBefore:previousLocation_];
+    }
+    if (!objects.count) {
+        previousLocation_ = -1;
+        return nil;
+    } else {
+        id<IntervalTreeObject> obj = objects[0];
+        previousLocation_ = [obj.entry.interval location];
+        return objects;
+    }
+}
+
+@end
+
+@implementation Interval
+
++ (Interval *)intervalWithDictionary:(NSDictionary *)dict {
+    if (!dict[kIntervalLocationKey] || !dict[kIntervalLengthKey]) {
+        return nil;
+    }
+    return [self intervalWithLocation:[dict[kIntervalLocationKey] longLongValue]
+                               length:[dict[kIntervalLengthKey] longLongValue]];
+}
+
++ (Interval *)intervalWithLocation:(long long)location length:(long long)length {
+    Interval *interval = [[[Interval alloc] init] autorelease];
+    interval.location = location;
+    interval.length = length;
+    [interval boundsCheck];
+    return interval;
+}
+
++ (Interval *)maxInterval {
+    Interval *interval = [[[Interval alloc] init] autorelease];
+    interval.location = kMinLocation;
+    interval.length = kMaxLimit - kMinLocation ;
+    return interval;
+}
+
+- (long long)limit {
+    return _location + _length;
+}
+
+- (BOOL)intersects:(Interval *)other {
+    return MAX(self.location, other.location) < MIN(self.limit, other.limit);
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p [%lld, %lld)>",
+            self.class, self, self.location, self.limit];
+}
+
+- (void)boundsCheck {
+    assert(_location >= kMinLocation);
+    assert(_length >= 0);
+    if (_location > 0) {
+        assert(_location < kMaxLimit - _length);
+    } else {
+        assert(_location + _length < kMaxLimit);
+    }
+}
+
+- (BOOL)isEqualToInterval:(Interval *)interval {
+    return self.location == interval.location && self.length == interval.length;
+}
+
+- (NSDictionary *)dictionaryValue {
+    return @{ kIntervalLocationKey: @(_location),
+              kIntervalLengthKey: @(_length) };
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    return [[Interval intervalWithLocation:_location length:_length] retain];
+}
+
+@end
+
+@interface IntervalTreeEntry ()
+// The entry's key in the tree that holds it. This doesn't change even if |interval| does.
+@property(nonatomic, assign) long long location;
+@property(nonatomic, assign) long long serial;
+@end
+
+@implementation IntervalTreeEntry
+
++ (IntervalTreeEntry *)entryWithInterval:(Interval *)interval
+                                  object:(id<IntervalTreeObject>)object {
+    IntervalTreeEntry *entry = [[[IntervalTreeEntry alloc] init] autorelease];
+    entry.interval = interval;
+    entry.object = object;
+    return entry;
+}
+
+- (void)dealloc {
+    [_interval release];
+    [_object release];
+    [super dealloc];
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p interval=%@ object=%@>",
+            self.class, self, self.interval, self.object];
+}
+@end
+
+typedef iTerm2::IntervalTreeCore::Entry IntervalTreeCoreEntry;
+
+static IntervalTreeEntry *IntervalTreeEntryForCoreEntry(const IntervalTreeCoreEntry &entry) {
+    return (IntervalTreeEntry *)entry.object;
+}
+
+@implementation IntervalTree {
+    iTerm2::IntervalTreeCore *_core;
+    long long _nextSerial;
+}
+
+- (instancetype)initWithDictionary:(NSDictionary *)dict {
+    self = [self init];
+    if (self) {
+        std::vector<IntervalTreeCoreEntry> entries;
+        for (NSDictionary *entry in dict[kIntervalTreeEntriesKey]) {
+            NSDictionary *intervalDict = entry[kIntervalTreeIntervalKey];
+            NSDictionary *objectDict = entry[kIntervalTreeObjectKey];
+            NSString *className = entry[kIntervalTreeClassNameKey];
+            if (intervalDict && objectDict && className) {
+                Class theClass = NSClassFromString(className);
+                if ([theClass instancesRespondToSelector:@selector(initWithDictionary:)]) {
+                    id<IntervalTreeObject> object = [[[theClass alloc] initWithDictionary:objectDict] autorelease];
+                    if (object) {
+                        Interval *interval = [Interval intervalWithDictionary:intervalDict];
+                        if (interval.limit >= 0) {
+                            entries.push_back([self coreEntryForNewObject:object withInterval:interval]);
+                        }
+                    }
+                }
+            }
+        }
+        // Saved entries are usually in order already. Building the tree in one go is much faster
+        // than adding them one at a time.
+        std::stable_sort(entries.begin(),
+                         entries.end(),
+                         [](const IntervalTreeCoreEntry &a, const IntervalTreeCoreEntry &b) {
+                             return a.location < b.location;
+                         });
+        _core->build(entries);
+    }
+    return self;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _core = new iTerm2::IntervalTreeCore();
+    }
+    return self;
+}
+
+- (void)dealloc {
+    _core->enumerate([](const IntervalTreeCoreEntry &coreEntry) {
+        IntervalTreeEntry *entry = IntervalTreeEntryForCoreEntry(coreEntry);
+        entry.object.entry = nil;
+        [entry release];
+        return false;
+    });
+    delete _core;
+    [super dealloc];
+}
+
+// Makes the tree's entry for |object| and points |object| at it. The tree owns the returned
+// entry's reference to it.
+- (IntervalTreeCoreEntry)coreEntryForNewObject:(id<IntervalTreeObject>)object
+                                  withInterval:(Interval *)interval {
+    [interval boundsCheck];
+    assert(object.entry == nil);  // Object must not belong to another tree
+    IntervalTreeEntry *entry = [[IntervalTreeEntry alloc] init];
+    entry.interval = interval;
+    entry.object = object;
+    entry.location = interval.location;
+    entry.serial = _nextSerial++;
+    object.entry = entry;
+    return { interval.location, interval.limit, entry.serial, entry };
+}
+
+- (void)addObject:(id<IntervalTreeObject>)object withInterval:(Interval *)interval {
+    DLog(@"Add %@ at %@", object, interval);
+    _core->add([self coreEntryForNewObject:object withInterval:interval]);
+}
+
+- (void)removeObject:(id<IntervalTreeObject>)object {
+    DLog(@"Remove %@\n%@", object, [NSThread callStackSymbols]);
+    IntervalTreeEntry *entry = object.entry;
+    if (entry && _core->remove({ entry.location, 0, entry.serial, entry })) {
+        object.entry = nil;
+        [entry release];
+    }
+}
+
+- (void)removeObjectsWithLimitAtMost:(long long)limit
+                               block:(void (^NS_NOESCAPE)(id<IntervalTreeObject>))block {
+    _core->removeEntriesWithLimitAtMost(limit, [block](const IntervalTreeCoreEntry &coreEntry) {
+        IntervalTreeEntry *entry = IntervalTreeEntryForCoreEntry(coreEntry);
+        id<IntervalTreeObject> object = [[entry.object retain] autorelease];
+        if (block) {
+            block(object);
+        }
+        object.entry = nil;
+        [entry release];
+    });
+}
+
+- (void)enumerateObjectsFromLocation:(long long)location
+                               limit:(long long)limit
+                               block:(void (^NS_NOESCAPE)(id<IntervalTreeObject>, BOOL *))block {
+    _core->enumerateIntersecting(location, limit, [block](const IntervalTreeCoreEntry &coreEntry) {
+        BOOL stop = NO;
+        block(IntervalTreeEntryForCoreEntry(coreEntry).object, &stop);
+        return static_cast<bool>(stop);
+    });
+}
+
+- (NSArray *)objectsInInterval:(Interval *)interval {
+    NSMutableArray *array = [NSMutableArray array];
+    _core->enumerateIntersecting(interval.location, interval.limit, [array](const IntervalTreeCoreEntry &entry) {
+        [array addObject:IntervalTreeEntryForCoreEntry(entry).object];
+        return false;
+    });
+    return array;
+}
+
+- (NSArray *)allObjects {
+    return [self objectsInInterval:[Interval maxInterval]];
+}
+
+- (NSInteger)count {
+    return _core->count();
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p count=%@>", self.class, self, @(self.count)];
+}
+
+- (BOOL)containsObject:(id<IntervalTreeObject>)object {
+    IntervalTreeEntry *entry = object.entry;
+    return entry && _core->find({ entry.location, 0, entry.serial, entry }) == entry;
+}
+
+- (NSArray *)objectsWithLimit:(long long)limit {
+    NSMutableArray *objects = [NSMutableArray array];
+    _core->enumerateWithLimit(limit, [objects](const IntervalTreeCoreEntry &entry) {
+        [objects addObject:IntervalTreeEntryForCoreEntry(entry).object];
+        return false;
+    });
+    return objects;
+}
+
+- (NSArray *)objectsAtLocation:(long long)location {
+    NSMutableArray *objects = [NSMutableArray array];
+    _core->enumerateAtLocation(location, [objects](const IntervalTreeCoreEntry &entry) {
+        [objects addObject:IntervalTreeEntryForCoreEntry(entry).object];
+        return false;
+    });
+    return objects;
+}
+
+- (NSArray *)objectsWithSmallestLimit {
+    long long limit;
+    return _core->smallestLimit(&limit) ? [self objectsWithLimit:limit] : nil;
+}
+
+- (NSArray *)objectsWithLargestLimit {
+    long long limit;
+    return _core->largestLimit(&limit) ? [self objectsWithLimit:limit] : nil;
+}
+
+- (NSArray *)objectsWithLargestLocation {
+    long long location;
+    return _core->largestLocation(&location) ? [self objectsAtLocation:location] : @[];
+}
+
+- (NSArray *)objectsWithLargestLocationBefore:(long long)location {
+    long long largest;
+    return _core->largestLocationBefore(location, &largest) ? [self objectsAtLocation:largest] : nil;
+}
+
+- (NSArray *)objectsWithLargestLimitBefore:(long long)bound {
+    long long limit;
+    return _core->largestLimitBefore(bound, &limit) ? [self objectsWithLimit:limit] : nil;
+}
+
+- (NSArray *)objectsWithSmallestLimitAfter:(long long)bound {
+    long long limit;
+    return _core->smallestLimitAfter(bound, &limit) ? [self objectsWithLimit:limit] : nil;
+}
+
+- (NSEnumerator *)reverseEnumeratorAt:(long long)start {
+    assert(start >= 0);
+    IntervalTreeReverseEnumerator *enumerator =
+        [[[IntervalTreeReverseEnumerator alloc] initWithTree:self] autorelease];
+    enumerator.previousLocation = start + 1;
+    return enumerator;
+}
+
+- (NSEnumerator *)reverseLimitEnumeratorAt:(long long)start {
+    assert(start >= 0);
+    IntervalTreeReverseLimitEnumerator *enumerator =
+        [[[IntervalTreeReverseLimitEnumerator alloc] initWithTree:self] autorelease];
+    enumerator.previousLimit = start;
+    return enumerator;
+}
+
+- (NSEnumerator *)forwardLimitEnumeratorAt:(long long)start {
+    assert(start >= 0);
+    IntervalTreeForwardLimitEnumerator *enumerator =
+        [[[IntervalTreeForwardLimitEnumerator alloc] initWithTree:self] autorelease];
+    enumerator.previousLimit = start;
+    return enumerator;
+}
+
+- (NSEnumerator *)reverseLimitEnumerator {
+    return [[[IntervalTreeReverseLimitEnumerator alloc] initWithTree:self] autorelease];
+}
+
+- (NSEnumerator *)forwardLimitEnumerator {
+    return [[[IntervalTreeForwardLimitEnumerator alloc] initWithTree:self] autorelease];
+}
+
+- (void)sanityCheck {
+    assert(_core->isValid());
+    _core->enumerate([](const IntervalTreeCoreEntry &coreEntry) {
+        IntervalTreeEntry *entry = IntervalTreeEntryForCoreEntry(coreEntry);
+        assert(entry.object.entry == entry);
+        assert(entry.interval.location == coreEntry.location);
+        assert(entry.interval.limit == coreEntry.limit);
+        return false;
+    });
+}
+
+- (NSString *)debugString {
+    NSMutableString *string = [NSMutableString string];
+    _core->enumerate([string](const IntervalTreeCoreEntry &coreEntry) {
+        [string appendFormat:@"[%lld, %lld) %@\n",
+         coreEntry.location, coreEntry.limit, IntervalTreeEntryForCoreEntry(coreEntry).object];
+        return false;
+    });
+    return string;
+}
+
+- (NSDictionary *)dictionaryValueWithOffset:(long long)offset {
+    NSMutableArray *objectDicts = [NSMutableArray arrayWithCapacity:self.count];
+    _core->enumerateIntersecting(kMinLocation, kMaxLimit, [objectDicts, offset](const IntervalTreeCoreEntry &coreEntry) {
+        id<IntervalTreeObject> object = IntervalTreeEntryForCoreEntry(coreEntry).object;
+        [objectDicts addObject:@{ kIntervalTreeIntervalKey: @{ kIntervalLocationKey: @(coreEntry.location + offset),
+                                                               kIntervalLengthKey: @(coreEntry.limit - coreEntry.location) },
+                                  kIntervalTreeObjectKey: object.dictionaryValue,
+                                  kIntervalTreeClassNameKey: NSStringFromClass(object.class) }];
+        return false;
+    });
+    return @{ kIntervalTreeEntriesKey: objectDicts };
+}
+
+@end
@@ -25,6 +25,8 @@ typedef struct {
 } LineBlockMetadata;
 
 @class LineBlock;
+@class iTermLineBlockSpillFile;
+@class iTermLineBlockStore;
 
 @protocol iTermLineBlockObserver<NSObject>
 - (void)lineBlockDidChange:(LineBlock *)lineBlock;
@@ -41,8 +43,23 @@ typedef struct {
 @property(nonatomic, assign) BOOL mayHaveDoubleWidthCharacter;
 @property(nonatomic, readonly) int numberOfCharacters;
 
+// YES if the characters are mapped from a file (a spill file or a restored block store) rather
+// than held in memory. They are copied back into memory if the block changes.
+@property(nonatomic, readonly, getter=isSpilled) BOOL spilled;
+
+// YES after -storeCompactly until the block changes.
+@property(nonatomic, readonly, getter=isCompact) BOOL compact;
+
+// Bytes of characters held in memory and mapped from a file, respectively.
+@property(nonatomic, readonly) long long residentBytes;
+@property(nonatomic, readonly) long long spilledBytes;
+
 + (instancetype)blockWithDictionary:(NSDictionary *)dictionary;
 
+// Restores a block saved with -dictionaryWithBlockStore:. Its characters are read from the store's
+// mapped file as they're needed.
++ (instancetype)blockWithDictionary:(NSDictionary *)dictionary blockStore:(iTermLineBlockStore *)blockStore;
+
 - (instancetype)initWithRawBufferSize:(int)size;
 
 // Try to append a line to the end of the buffer. Returns false if it does not fit. If length > buffer_size it will never succeed.
@@ -57,6 +74,8 @@ typedef struct {
 // Try to get a line that is lineNum after the first line in this block after wrapping them to a given width.
 // If the line is present, return a pointer to its start and fill in *lineLength with the number of bytes in the line.
 // If the line is not present, decrement *lineNum by the number of lines in this block and return NULL.
+// Pointers returned by this and -rawLine: are valid until the block changes. For a compact block
+// they are also valid only until the current autorelease pool drains.
 - (screen_char_t*)getWrappedLineWithWrapWidth:(int)width
                                       lineNum:(int*)lineNum
                                    lineLength:(int*)lineLength
@@ -133,6 +152,20 @@ typedef struct {
 // Returns the total number of lines, including dropped lines.
 - (int)numEntries;
 
+// Moves the characters to |spillFile| and frees the memory they used. Returns NO if the block was
+// already spilled, is empty, or the file couldn't be written.
+- (BOOL)spillToFile:(iTermLineBlockSpillFile *)spillFile;
+
+// Replaces the characters with a compact encoding that is decoded again when they are next
+// accessed. Use this only for blocks that are no longer appended to; appending or resizing goes
+// back to the usual representation. Returns NO if the block is already compact, spilled, empty,
+// or wouldn't get smaller.
+- (BOOL)storeCompactly;
+
+// Returns NO if the block definitely contains no matches for |substring|. This consults an index
+// of the block's trigrams, so it is much faster than searching. Regex modes always return YES.
+- (BOOL)mayContainMatchesOfSubstring:(NSString *)substring mode:(iTermFindMode)mode;
+
 // Searches for a substring, populating results with ResultRange objects.
 - (void)findSubstring:(NSString*)substring
               options:(int)options
@@ -200,12 +233,26 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
 // invalid if the block is changed.
 - (NSDictionary *)dictionary;
 
+// Like -dictionary, but the lines are written to |blockStore| (unless it already has them) and the
+// dictionary refers to them by offset. Use this only for blocks that are no longer appended to, or
+// every save will write a new record.
+- (NSDictionary *)dictionaryWithBlockStore:(iTermLineBlockStore *)blockStore;
+
 // Number of empty lines at the end of the block.
 - (int)numberOfTrailingEmptyLines;
 
 // Call this only before a line block has been created.
 void EnableDoubleWidthCharacterLineCache(void);
 
+// Overrides the advanced setting. Affects only line blocks created afterwards.
+void LineBlockSetSearchIndexEnabled(BOOL enabled);
+
+// Discards the decoded characters of all but the most recently used compact blocks, skipping blocks
+// that a method is using right now. This happens on its own on the main queue; tests call it to do
+// it sooner. Pointers that were returned into discarded characters stay valid until the
+// autorelease pool that was current when they were returned drains.
+void LineBlockDiscardDecodedCharacters(NSUInteger maximumNumberOfDecodedBlocks);
+
 - (void)addObserver:(id<iTermLineBlockObserver>)observer;
 - (void)removeObserver:(id<iTermLineBlockObserver>)observer;
 - (BOOL)hasObserver:(id<iTermLineBlockObserver>)observer;
@@ -16,12 +16,18 @@ extern "C" {
 #import "NSBundle+iTerm.h"
 #import "RegexKitLite.h"
 #import "iTermAdvancedSettingsModel.h"
+#import "iTermLineBlockSpillFile.h"
+#import "iTermLineBlockStore.h"
 }
+#include <algorithm>
+#include <list>
+#include <os/lock.h>
 #include <unordered_map>
 #include <vector>
 
 static BOOL gEnableDoubleWidthCharacterLineCache = NO;
 static BOOL gUseCachingNumberOfLines = NO;
+static BOOL gEnableSearchIndex = NO;
 
 NSString *const kLineBlockRawBufferKey = @"Raw Buffer";
 NSString *const kLineBlockBufferStartOffsetKey = @"Buffer Start Offset";
@@ -32,13 +38,150 @@ NSString *const kLineBlockCLLKey = @"Cumulative Line Lengths";
 NSString *const kLineBlockIsPartialKey = @"Is Partial";
 NSString *const kLineBlockMetadataKey = @"Metadata";
 NSString *const kLineBlockMayHaveDWCKey = @"May Have Double Width Character";
+NSString *const kLineBlockRecordOffsetKey = @"Record Offset";
 
 static NSInteger LineBlockNextGeneration = -1;
+static long long LineBlockNextContentIdentifier = 1;
+
+// A record in an iTermLineBlockStore is this header followed by an array of
+// iTermLineBlockRecordMetadata and an array of cumulative line lengths, both with
+// numberOfEntries elements, and then numberOfCharacters screen_char_ts.
+static const uint32_t kLineBlockRecordMagic = 0x4c426c6b;
+
+typedef struct {
+    uint32_t magic;
+    int32_t numberOfCharacters;
+    int32_t numberOfEntries;
+    int32_t unused;
+} iTermLineBlockRecordHeader;
+
+typedef struct {
+    NSTimeInterval timestamp;
+    screen_char_t continuation;
+} iTermLineBlockRecordMetadata;
+
+static size_t iTermLineBlockRecordCharactersOffset(int numberOfEntries) {
+    return (sizeof(iTermLineBlockRecordHeader) +
+            numberOfEntries * (sizeof(iTermLineBlockRecordMetadata) + sizeof(int)));
+}
 
 void EnableDoubleWidthCharacterLineCache() {
     gEnableDoubleWidthCharacterLineCache = YES;
 }
 
+static void LineBlockLoadSettings() {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        if ([iTermAdvancedSettingsModel dwcLineCache]) {
+            gEnableDoubleWidthCharacterLineCache = YES;
+            gUseCachingNumberOfLines = YES;
+        }
+        gEnableSearchIndex = [iTermAdvancedSettingsModel indexScrollbackForSearch];
+    });
+}
+
+void LineBlockSetSearchIndexEnabled(BOOL enabled) {
+    LineBlockLoadSettings();
+    gEnableSearchIndex = enabled;
+}
+
+// Compact storage for the characters of a block that is no longer appended to. In scrollback most
+// cells have ASCII codes and share their colors and style with their neighbors, so codes are stored
+// on their own (one byte each when they all fit) and the remaining bytes of each screen_char_t are
+// run-length encoded. The encoding is exact, so decoding gives back the same bytes.
+namespace iTermCompactCharacters {
+
+static_assert(offsetof(screen_char_t, code) == 0, "code must come first");
+static const size_t kAttributesOffset = sizeof(unichar);
+static const size_t kAttributesLength = sizeof(screen_char_t) - kAttributesOffset;
+
+// Followed by numberOfRuns Runs and then numberOfCharacters codes of bytesPerCode bytes each.
+struct Header {
+    int32_t numberOfCharacters;
+    int32_t numberOfRuns;
+    int32_t bytesPerCode;
+    int32_t unused;
+};
+
+struct Run {
+    // Index just past the last character with these attributes.
+    int32_t end;
+    unsigned char attributes[kAttributesLength];
+};
+
+static const unsigned char *Attributes(const screen_char_t *c) {
+    return (const unsigned char *)c + kAttributesOffset;
+}
+
+static NSData *Encode(const screen_char_t *chars, int length) {
+    std::vector<Run> runs;
+    bool narrow = true;
+    for (int i = 0; i < length; i++) {
+        if (chars[i].code > 0xff) {
+            narrow = false;
+        }
+        const unsigned char *attributes = Attributes(&chars[i]);
+        if (!runs.empty() && !memcmp(runs.back().attributes, attributes, kAttributesLength)) {
+            runs.back().end = i + 1;
+            continue;
+        }
+        Run run;
+        run.end = i + 1;
+        memcpy(run.attributes, attributes, kAttributesLength);
+        runs.push_back(run);
+    }
+
+    const int bytesPerCode = narrow ? 1 : sizeof(unichar);
+    const size_t runsOffset = sizeof(Header);
+    const size_t codesOffset = runsOffset + runs.size() * sizeof(Run);
+    NSMutableData *data = [NSMutableData dataWithLength:codesOffset + length * bytesPerCode];
+    unsigned char *bytes = (unsigned char *)data.mutableBytes;
+    Header header = { length, (int32_t)runs.size(), bytesPerCode, 0 };
+    memcpy(bytes, &header, sizeof(header));
+    memcpy(bytes + runsOffset, runs.data(), runs.size() * sizeof(Run));
+    if (narrow) {
+        unsigned char *codes = bytes + codesOffset;
+        for (int i = 0; i < length; i++) {
+            codes[i] = chars[i].code;
+        }
+    } else {
+        unichar *codes = (unichar *)(bytes + codesOffset);
+        for (int i = 0; i < length; i++) {
+            codes[i] = chars[i].code;
+        }
+    }
+    return data;
+}
+
+// |dest| must have room for the number of characters that were encoded.
+static void Decode(NSData *data, screen_char_t *dest) {
+    const unsigned char *bytes = (const unsigned char *)data.bytes;
+    const Header *header = (const Header *)bytes;
+    const Run *runs = (const Run *)(bytes + sizeof(Header));
+    const unsigned char *codes = (const unsigned char *)(runs + header->numberOfRuns);
+    int i = 0;
+    for (int r = 0; r < header->numberOfRuns; r++) {
+        screen_char_t c;
+        memset(&c, 0, sizeof(c));
+        memcpy((unsigned char *)&c + kAttributesOffset, runs[r].attributes, kAttributesLength);
+        const int end = runs[r].end;
+        if (header->bytesPerCode == 1) {
+            for (; i < end; i++) {
+                dest[i] = c;
+                dest[i].code = codes[i];
+            }
+        } else {
+            const unichar *wideCodes = (const unichar *)codes;
+            for (; i < end; i++) {
+                dest[i] = c;
+                dest[i].code = wideCodes[i];
+            }
+        }
+    }
+}
+
+}  // namespace iTermCompactCharacters
+
 struct iTermNumFullLinesCacheKey {
     int offset;
     int length;
@@ -72,6 +215,141 @@ struct iTermNumFullLinesCacheKeyHasher {
     }
 };
 
+// A Bloom-style filter of the case-folded ASCII trigrams that appear in a block's raw lines. Each
+// trigram sets one bit, so a needle whose trigrams are not all present cannot occur in the block.
+// Non-ASCII characters aren't indexed (case- and diacritic-insensitive matching makes them hard to
+// fold), so a block containing any is never ruled out. Dropping or popping lines only marks the
+// filter stale; it gets rebuilt before it is next consulted.
+struct iTermTrigramFilter {
+    static const int kLogNumberOfBits = 14;
+    static const int kNumberOfBits = 1 << kLogNumberOfBits;
+
+    std::vector<uint64_t> bits;
+    bool hasNonASCII;
+    bool stale;
+
+    iTermTrigramFilter() : hasNonASCII(false), stale(false) { }
+
+    // Filters start out disabled and use no memory.
+    bool enabled() const {
+        return !bits.empty();
+    }
+
+    void enable() {
+        bits.assign(kNumberOfBits / 64, 0);
+    }
+
+    void invalidate() {
+        stale = true;
+    }
+
+    void clear() {
+        std::fill(bits.begin(), bits.end(), 0);
+        hasNonASCII = false;
+        stale = false;
+    }
+
+    // Mirrors ScreenCharArrayToString, which skips private-use characters such as DWC_RIGHT.
+    static bool IsSkipped(const screen_char_t &c) {
+        return c.code >= ITERM2_PRIVATE_BEGIN && c.code <= ITERM2_PRIVATE_END;
+    }
+
+    static uint32_t Fold(unichar c) {
+        return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    }
+
+    static int BitForTrigram(uint32_t trigram) {
+        return (trigram * 2654435761u) >> (32 - kLogNumberOfBits);
+    }
+
+    void set(uint32_t trigram) {
+        const int bit = BitForTrigram(trigram);
+        bits[bit / 64] |= (1ULL << (bit % 64));
+    }
+
+    bool test(uint32_t trigram) const {
+        const int bit = BitForTrigram(trigram);
+        return (bits[bit / 64] & (1ULL << (bit % 64))) != 0;
+    }
+
+    void addChars(const screen_char_t *chars, int length) {
+        uint32_t trigram = 0;
+        int run = 0;
+        for (int i = 0; i < length; i++) {
+            if (IsSkipped(chars[i])) {
+                continue;
+            }
+            if (chars[i].complexChar || chars[i].code >= 0x80) {
+                hasNonASCII = true;
+                run = 0;
+                continue;
+            }
+            trigram = ((trigram << 7) | Fold(chars[i].code)) & 0x1fffff;
+            if (++run >= 3) {
+                set(trigram);
+            }
+        }
+    }
+
+    // Returns false only if |needle| definitely does not occur in the indexed text.
+    bool mayContain(NSString *needle) const {
+        if (hasNonASCII) {
+            return true;
+        }
+        const NSUInteger length = needle.length;
+        if (length < 3) {
+            return true;
+        }
+        unichar *chars = (unichar *)iTermMalloc(sizeof(unichar) * length);
+        [needle getCharacters:chars];
+        for (NSUInteger i = 0; i < length; i++) {
+            if (chars[i] >= 0x80) {
+                // Could match a ligature, a full-width form, etc.
+                free(chars);
+                return true;
+            }
+        }
+        bool result = true;
+        uint32_t trigram = 0;
+        for (NSUInteger i = 0; i < length; i++) {
+            trigram = ((trigram << 7) | Fold(chars[i])) & 0x1fffff;
+            if (i >= 2 && !test(trigram)) {
+                result = false;
+                break;
+            }
+        }
+        free(chars);
+        return result;
+    }
+};
+
+static BOOL iTermLineBlockBeginUsingCharacters(LineBlock *lineBlock);
+static void iTermLineBlockEndUsingCharacters(LineBlock *lineBlock);
+
+namespace {
+// While this is in scope, the characters of a compact block are decoded in raw_buffer and won't be
+// discarded. Pointers into them that a method returns stay valid until the caller's autorelease
+// pool drains, even if the block discards them first.
+class iTermLineBlockCharactersUse {
+public:
+    explicit iTermLineBlockCharactersUse(LineBlock *lineBlock)
+        : _lineBlock(lineBlock), _began(iTermLineBlockBeginUsingCharacters(lineBlock)) {
+    }
+    ~iTermLineBlockCharactersUse() {
+        if (_began) {
+            iTermLineBlockEndUsingCharacters(_lineBlock);
+        }
+    }
+    iTermLineBlockCharactersUse(const iTermLineBlockCharactersUse &) = delete;
+    iTermLineBlockCharactersUse &operator=(const iTermLineBlockCharactersUse &) = delete;
+
+private:
+    __unsafe_unretained LineBlock *_lineBlock;
+    // NO if the block wasn't compact, so there was nothing to keep.
+    BOOL _began;
+};
+}
+
 @implementation LineBlock {
     // The raw lines, end-to-end. There is no delimiter between each line.
     screen_char_t* raw_buffer;
@@ -109,6 +387,86 @@ struct iTermNumFullLinesCacheKeyHasher {
     std::unordered_map<iTermNumFullLinesCacheKey, int, iTermNumFullLinesCacheKeyHasher> _numberOfFullLinesCache;
 
     std::vector<void *> _observers;
+
+    // Used to skip blocks that can't contain a search query.
+    iTermTrigramFilter _searchIndex;
+
+    // Changes whenever lines are added or removed. Copies share it until one of them changes. A
+    // block store uses it to recognize blocks it already has.
+    long long _contentIdentifier;
+
+    // When restored from a block store or spilled, raw_buffer points into this until it needs to
+    // change.
+    NSData *_mappedRawBuffer;
+
+    // Set by -storeCompactly. While it's set, raw_buffer is NULL unless the characters are decoded,
+    // in which case it points into _decodedCharacters. Like the rest of the block, this changes
+    // only on the thread that owns the block.
+    NSData *_compactCharacters;
+    BOOL _compactCharactersSpilled;
+
+    // The rest are guarded by gDecodedBlocksLock, since concurrent searches decode blocks and the
+    // main queue discards them. So are raw_buffer and buffer_start while the block is compact.
+
+    // Decoded characters of a compact block. Each use retains and autoreleases it, so pointers
+    // into it outlive its removal from the block.
+    NSData *_decodedCharacters;
+    // Number of iTermLineBlockCharactersUse objects for this block in scope. The decoded
+    // characters aren't discarded while it's positive.
+    int _numberOfCharactersUses;
+    // This block's entry in gDecodedBlocks, valid while _decodedCharacters is set.
+    std::list<LineBlock *>::iterator _decodedBlocksEntry;
+}
+
+// Compact blocks whose characters are decoded, least recently used first. Blocks may be decoded by
+// concurrent searches, so these are protected by gDecodedBlocksLock.
+static std::list<LineBlock *> gDecodedBlocks;
+static BOOL gDiscardScheduled;
+static os_unfair_lock gDecodedBlocksLock = OS_UNFAIR_LOCK_INIT;
+
+// Decoded characters are kept for this many blocks so scrolling around doesn't decode the same
+// blocks over and over.
+static const NSUInteger kMaximumNumberOfDecodedBlocks = 16;
+
+// Must hold gDecodedBlocksLock. The characters are freed once the last pointer handed out for them
+// is autoreleased.
+static void iTermLineBlockReleaseDecodedCharacters(__unsafe_unretained LineBlock *block) {
+    gDecodedBlocks.erase(block->_decodedBlocksEntry);
+    [block->_decodedCharacters release];
+    block->_decodedCharacters = nil;
+    block->raw_buffer = NULL;
+    block->buffer_start = NULL;
+}
+
+// Must hold gDecodedBlocksLock. Returns YES if the caller should schedule a discard after unlocking.
+static BOOL iTermLineBlockShouldScheduleDiscard(void) {
+    if (gDiscardScheduled || gDecodedBlocks.size() <= kMaximumNumberOfDecodedBlocks) {
+        return NO;
+    }
+    gDiscardScheduled = YES;
+    return YES;
+}
+
+static void iTermLineBlockScheduleDiscard(void) {
+    dispatch_async(dispatch_get_main_queue(), ^{
+        LineBlockDiscardDecodedCharacters(kMaximumNumberOfDecodedBlocks);
+    });
+}
+
+void LineBlockDiscardDecodedCharacters(NSUInteger maximumNumberOfDecodedBlocks) {
+    os_unfair_lock_lock(&gDecodedBlocksLock);
+    gDiscardScheduled = NO;
+    auto it = gDecodedBlocks.begin();
+    while (gDecodedBlocks.size() > maximumNumberOfDecodedBlocks && it != gDecodedBlocks.end()) {
+        LineBlock *block = *it;
+        ++it;
+        if (block->_numberOfCharactersUses > 0) {
+            // Its last use will schedule another discard if there are still too many.
+            continue;
+        }
+        iTermLineBlockReleaseDecodedCharacters(block);
+    }
+    os_unfair_lock_unlock(&gDecodedBlocksLock);
 }
 
 NS_INLINE void iTermLineBlockDidChange(__unsafe_unretained LineBlock *lineBlock) {
@@ -142,15 +500,13 @@ NS_INLINE void iTermLineBlockDidChange(__unsafe_unretained LineBlock *lineBlock)
 }
 
 - (void)commonInit {
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        if ([iTermAdvancedSettingsModel dwcLineCache]) {
-            gEnableDoubleWidthCharacterLineCache = YES;
-            gUseCachingNumberOfLines = YES;
-        }
-    });
+    LineBlockLoadSettings();
 
+    _contentIdentifier = LineBlockNextContentIdentifier++;
     cached_numlines_width = -1;
+    if (gEnableSearchIndex) {
+        _searchIndex.enable();
+    }
     if (cll_capacity > 0) {
         metadata_ = (LineBlockMetadata *)calloc(sizeof(LineBlockMetadata), cll_capacity);
     }
@@ -160,31 +516,54 @@ NS_INLINE void iTermLineBlockDidChange(__unsafe_unretained LineBlock *lineBlock)
     return [[[self alloc] initWithDictionary:dictionary] autorelease];
 }
 
++ (instancetype)blockWithDictionary:(NSDictionary *)dictionary blockStore:(iTermLineBlockStore *)blockStore {
+    return [[[self alloc] initWithDictionary:dictionary blockStore:blockStore] autorelease];
+}
+
 - (instancetype)initWithDictionary:(NSDictionary *)dictionary {
+    return [self initWithDictionary:dictionary blockStore:nil];
+}
+
+- (instancetype)initWithDictionary:(NSDictionary *)dictionary blockStore:(iTermLineBlockStore *)blockStore {
     self = [super init];
     if (self) {
-        NSArray *requiredKeys = @[ kLineBlockRawBufferKey,
-                                   kLineBlockBufferStartOffsetKey,
-                                   kLineBlockStartOffsetKey,
-                                   kLineBlockFirstEntryKey,
-                                   kLineBlockBufferSizeKey,
-                                   kLineBlockCLLKey,
-                                   kLineBlockMetadataKey,
-                                   kLineBlockIsPartialKey,
-                                   kLineBlockMayHaveDWCKey ];
+        NSNumber *recordOffset = dictionary[kLineBlockRecordOffsetKey];
+        NSMutableArray *requiredKeys = [[@[ kLineBlockBufferStartOffsetKey,
+                                            kLineBlockStartOffsetKey,
+                                            kLineBlockFirstEntryKey,
+                                            kLineBlockBufferSizeKey,
+                                            kLineBlockIsPartialKey,
+                                            kLineBlockMayHaveDWCKey ] mutableCopy] autorelease];
+        if (!recordOffset) {
+            [requiredKeys addObjectsFromArray:@[ kLineBlockRawBufferKey,
+                                                 kLineBlockCLLKey,
+                                                 kLineBlockMetadataKey ]];
+        }
         for (NSString *requiredKey in requiredKeys) {
             if (!dictionary[requiredKey]) {
                 [self autorelease];
                 return nil;
             }
         }
-        NSData *data = dictionary[kLineBlockRawBufferKey];
         buffer_size = [dictionary[kLineBlockBufferSizeKey] intValue];
+        start_offset = [dictionary[kLineBlockStartOffsetKey] intValue];
+        first_entry = [dictionary[kLineBlockFirstEntryKey] intValue];
+        if (recordOffset) {
+            if (![self loadRecordAtOffset:recordOffset.longLongValue fromBlockStore:blockStore]) {
+                [self autorelease];
+                return nil;
+            }
+            buffer_start = raw_buffer + [dictionary[kLineBlockBufferStartOffsetKey] intValue];
+            is_partial = [dictionary[kLineBlockIsPartialKey] boolValue];
+            _searchIndex.invalidate();
+            _mayHaveDoubleWidthCharacter = [dictionary[kLineBlockMayHaveDWCKey] boolValue];
+            return self;
+        }
+
+        NSData *data = dictionary[kLineBlockRawBufferKey];
         raw_buffer = (screen_char_t *)iTermMalloc(buffer_size * sizeof(screen_char_t));
         memmove(raw_buffer, data.bytes, data.length);
         buffer_start = raw_buffer + [dictionary[kLineBlockBufferStartOffsetKey] intValue];
-        start_offset = [dictionary[kLineBlockStartOffsetKey] intValue];
-        first_entry = [dictionary[kLineBlockFirstEntryKey] intValue];
 
         NSArray *cllArray = dictionary[kLineBlockCLLKey];
         cll_capacity = [cllArray count];
@@ -212,14 +591,243 @@ NS_INLINE void iTermLineBlockDidChange(__unsafe_unretained LineBlock *lineBlock)
 
         cll_entries = cll_capacity;
         is_partial = [dictionary[kLineBlockIsPartialKey] boolValue];
+        _searchIndex.invalidate();
         _mayHaveDoubleWidthCharacter = [dictionary[kLineBlockMayHaveDWCKey] boolValue];
     }
     return self;
 }
 
+// Reads the lines saved by -appendRecordToBlockStore:. The characters stay in the mapped file
+// until the buffer needs to change.
+- (BOOL)loadRecordAtOffset:(long long)offset fromBlockStore:(iTermLineBlockStore *)blockStore {
+    NSData *headerData = [blockStore dataAtOffset:offset length:sizeof(iTermLineBlockRecordHeader)];
+    if (!headerData) {
+        DLog(@"No record at %@ in %@", @(offset), blockStore.path);
+        return NO;
+    }
+    const iTermLineBlockRecordHeader *header = (const iTermLineBlockRecordHeader *)headerData.bytes;
+    if (header->magic != kLineBlockRecordMagic ||
+        header->numberOfEntries < 0 ||
+        header->numberOfCharacters < 0 ||
+        header->numberOfCharacters > buffer_size) {
+        DLog(@"Bad record header at %@ in %@", @(offset), blockStore.path);
+        return NO;
+    }
+    const int numberOfEntries = header->numberOfEntries;
+    const int numberOfCharacters = header->numberOfCharacters;
+    const size_t charactersOffset = iTermLineBlockRecordCharactersOffset(numberOfEntries);
+    const size_t length = charactersOffset + numberOfCharacters * sizeof(screen_char_t);
+    NSData *record = [blockStore dataAtOffset:offset length:length];
+    if (!record) {
+        DLog(@"Truncated record at %@ in %@", @(offset), blockStore.path);
+        return NO;
+    }
+    const unsigned char *bytes = (const unsigned char *)record.bytes;
+    const iTermLineBlockRecordMetadata *metadata =
+        (const iTermLineBlockRecordMetadata *)(bytes + sizeof(iTermLineBlockRecordHeader));
+    const int *cll = (const int *)(metadata + numberOfEntries);
+
+    cll_capacity = numberOfEntries;
+    cll_entries = numberOfEntries;
+    cumulative_line_lengths = (int *)iTermMalloc(sizeof(int) * MAX(1, cll_capacity));
+    memcpy(cumulative_line_lengths, cll, sizeof(int) * cll_capacity);
+    [self commonInit];
+    for (int i = 0; i < cll_capacity; i++) {
+        metadata_[i].continuation = metadata[i].continuation;
+        metadata_[i].timestamp = metadata[i].timestamp;
+        metadata_[i].generation = LineBlockNextGeneration--;
+    }
+
+    if (numberOfCharacters > 0) {
+        _mappedRawBuffer = [[blockStore dataAtOffset:offset + charactersOffset
+                                              length:numberOfCharacters * sizeof(screen_char_t)] retain];
+        raw_buffer = (screen_char_t *)_mappedRawBuffer.bytes;
+    } else {
+        raw_buffer = (screen_char_t *)iTermMalloc(sizeof(screen_char_t) * MAX(1, buffer_size));
+    }
+    [blockStore adoptRecordAtOffset:offset length:length key:_contentIdentifier];
+    return YES;
+}
+
+// Copies characters out of the mapped file so raw_buffer can be modified or resized.
+- (void)copyMappedRawBuffer {
+    if (!_mappedRawBuffer) {
+        return;
+    }
+    screen_char_t *copy = (screen_char_t *)iTermMalloc(sizeof(screen_char_t) * MAX(1, buffer_size));
+    memcpy(copy, raw_buffer, _mappedRawBuffer.length);
+    raw_buffer = copy;
+    buffer_start = raw_buffer + start_offset;
+    [_mappedRawBuffer release];
+    _mappedRawBuffer = nil;
+}
+
+- (BOOL)spillToFile:(iTermLineBlockSpillFile *)spillFile {
+    if (_compactCharacters) {
+        return [self spillCompactCharactersToFile:spillFile];
+    }
+    const int used = [self rawSpaceUsed];
+    if (_mappedRawBuffer || used == 0) {
+        return NO;
+    }
+    NSData *data = [spillFile spillBytes:raw_buffer length:used * sizeof(screen_char_t)];
+    if (!data) {
+        return NO;
+    }
+    const ptrdiff_t bufferStartOffset = buffer_start - raw_buffer;
+    free(raw_buffer);
+    _mappedRawBuffer = [data retain];
+    raw_buffer = (screen_char_t *)_mappedRawBuffer.bytes;
+    buffer_start = raw_buffer + bufferStartOffset;
+    return YES;
+}
+
+- (BOOL)spillCompactCharactersToFile:(iTermLineBlockSpillFile *)spillFile {
+    if (_compactCharactersSpilled) {
+        return NO;
+    }
+    NSData *data = [spillFile spillBytes:_compactCharacters.bytes length:_compactCharacters.length];
+    if (!data) {
+        return NO;
+    }
+    [_compactCharacters release];
+    _compactCharacters = [data retain];
+    _compactCharactersSpilled = YES;
+    return YES;
+}
+
+- (BOOL)isSpilled {
+    return _mappedRawBuffer != nil || _compactCharactersSpilled;
+}
+
+- (long long)residentBytes {
+    long long bytes = 0;
+    if (_compactCharacters) {
+        os_unfair_lock_lock(&gDecodedBlocksLock);
+        bytes += _decodedCharacters.length;
+        os_unfair_lock_unlock(&gDecodedBlocksLock);
+    } else if (raw_buffer && !_mappedRawBuffer) {
+        bytes += (long long)buffer_size * sizeof(screen_char_t);
+    }
+    if (!_compactCharactersSpilled) {
+        bytes += _compactCharacters.length;
+    }
+    return bytes;
+}
+
+- (long long)spilledBytes {
+    return _mappedRawBuffer.length + (_compactCharactersSpilled ? _compactCharacters.length : 0);
+}
+
+#pragma mark - Compact Storage
+
+- (BOOL)isCompact {
+    return _compactCharacters != nil;
+}
+
+- (BOOL)storeCompactly {
+    const int used = [self rawSpaceUsed];
+    if (_compactCharacters || _mappedRawBuffer || used == 0) {
+        return NO;
+    }
+    NSData *data = iTermCompactCharacters::Encode(raw_buffer, used);
+    if (data.length >= used * sizeof(screen_char_t)) {
+        return NO;
+    }
+    _compactCharacters = [data retain];
+    free(raw_buffer);
+    raw_buffer = NULL;
+    buffer_start = NULL;
+    return YES;
+}
+
+// Decodes the characters of a compact block into raw_buffer if needed and keeps them there until
+// the matching iTermLineBlockEndUsingCharacters(). Use iTermLineBlockCharactersUse instead of
+// calling these directly. Returns NO if the block isn't compact.
+static BOOL iTermLineBlockBeginUsingCharacters(__unsafe_unretained LineBlock *lineBlock) {
+    if (!lineBlock->_compactCharacters) {
+        return NO;
+    }
+    os_unfair_lock_lock(&gDecodedBlocksLock);
+    if (lineBlock->_decodedCharacters) {
+        gDecodedBlocks.splice(gDecodedBlocks.end(), gDecodedBlocks, lineBlock->_decodedBlocksEntry);
+    } else {
+        const NSUInteger length = sizeof(screen_char_t) * MAX(1, lineBlock->buffer_size);
+        screen_char_t *decoded = (screen_char_t *)iTermMalloc(length);
+        iTermCompactCharacters::Decode(lineBlock->_compactCharacters, decoded);
+        lineBlock->_decodedCharacters = [[NSData alloc] initWithBytesNoCopy:decoded
+                                                                     length:length
+                                                               freeWhenDone:YES];
+        lineBlock->raw_buffer = decoded;
+        lineBlock->buffer_start = decoded + lineBlock->start_offset;
+        gDecodedBlocks.push_back(lineBlock);
+        lineBlock->_decodedBlocksEntry = std::prev(gDecodedBlocks.end());
+    }
+    lineBlock->_numberOfCharactersUses++;
+    [[lineBlock->_decodedCharacters retain] autorelease];
+    os_unfair_lock_unlock(&gDecodedBlocksLock);
+    return YES;
+}
+
+static void iTermLineBlockEndUsingCharacters(__unsafe_unretained LineBlock *lineBlock) {
+    os_unfair_lock_lock(&gDecodedBlocksLock);
+    lineBlock->_numberOfCharactersUses--;
+    const BOOL schedule = iTermLineBlockShouldScheduleDiscard();
+    os_unfair_lock_unlock(&gDecodedBlocksLock);
+    if (schedule) {
+        iTermLineBlockScheduleDiscard();
+    }
+}
+
+// Returns the characters of a compact block in a buffer owned by the caller. This doesn't add the
+// block to the decoded blocks, so it's for one-off reads of the whole block.
+- (NSData *)newDataWithDecodedCharacters {
+    NSMutableData *data = [[NSMutableData alloc] initWithLength:sizeof(screen_char_t) * [self rawSpaceUsed]];
+    iTermCompactCharacters::Decode(_compactCharacters, (screen_char_t *)data.mutableBytes);
+    return data;
+}
+
+- (void)discardDecodedCharacters {
+    os_unfair_lock_lock(&gDecodedBlocksLock);
+    if (_decodedCharacters) {
+        iTermLineBlockReleaseDecodedCharacters(self);
+    }
+    os_unfair_lock_unlock(&gDecodedBlocksLock);
+}
+
+// Called before the characters change. Afterwards the block is stored in raw_buffer as usual.
+- (void)discardCompactCharacters {
+    if (!_compactCharacters) {
+        return;
+    }
+    const NSUInteger length = sizeof(screen_char_t) * MAX(1, buffer_size);
+    screen_char_t *chars = (screen_char_t *)iTermMalloc(length);
+    os_unfair_lock_lock(&gDecodedBlocksLock);
+    if (_decodedCharacters) {
+        // Callers may still hold pointers into the decoded characters, so copy them rather than
+        // take them over.
+        memcpy(chars, _decodedCharacters.bytes, length);
+        iTermLineBlockReleaseDecodedCharacters(self);
+    } else {
+        iTermCompactCharacters::Decode(_compactCharacters, chars);
+    }
+    raw_buffer = chars;
+    buffer_start = chars + start_offset;
+    [_compactCharacters release];
+    _compactCharacters = nil;
+    _compactCharactersSpilled = NO;
+    os_unfair_lock_unlock(&gDecodedBlocksLock);
+}
+
 - (void)dealloc
 {
-    if (raw_buffer) {
+    if (_compactCharacters) {
+        [self discardDecodedCharacters];
+        [_compactCharacters release];
+    }
+    if (_mappedRawBuffer) {
+        [_mappedRawBuffer release];
+    } else if (raw_buffer) {
         free(raw_buffer);
     }
     if (cumulative_line_lengths) {
@@ -238,10 +846,18 @@ NS_INLINE void iTermLineBlockDidChange(__unsafe_unretained LineBlock *lineBlock)
 
 - (LineBlock *)copyWithZone:(NSZone *)zone {
     LineBlock *theCopy = [[LineBlock alloc] init];
-    theCopy->raw_buffer = (screen_char_t*)iTermMalloc(sizeof(screen_char_t) * buffer_size);
-    memmove(theCopy->raw_buffer, raw_buffer, sizeof(screen_char_t) * buffer_size);
-    size_t bufferStartOffset = (buffer_start - raw_buffer);
-    theCopy->buffer_start = theCopy->raw_buffer + bufferStartOffset;
+    if (_compactCharacters) {
+        // The encoded characters never change, so the copy shares them and decodes its own when
+        // it needs them.
+        theCopy->_compactCharacters = [_compactCharacters retain];
+        theCopy->_compactCharactersSpilled = _compactCharactersSpilled;
+    } else {
+        theCopy->raw_buffer = (screen_char_t*)iTermMalloc(sizeof(screen_char_t) * buffer_size);
+        // Only the used part is copied because a mapped raw_buffer ends there.
+        memmove(theCopy->raw_buffer, raw_buffer, sizeof(screen_char_t) * [self rawSpaceUsed]);
+        size_t bufferStartOffset = (buffer_start - raw_buffer);
+        theCopy->buffer_start = theCopy->raw_buffer + bufferStartOffset;
+    }
     theCopy->start_offset = start_offset;
     theCopy->first_entry = first_entry;
     theCopy->buffer_size = buffer_size;
@@ -262,6 +878,8 @@ NS_INLINE void iTermLineBlockDidChange(__unsafe_unretained LineBlock *lineBlock)
     theCopy->is_partial = is_partial;
     theCopy->cached_numlines = cached_numlines;
     theCopy->cached_numlines_width = cached_numlines_width;
+    theCopy->_searchIndex = _searchIndex;
+    theCopy->_contentIdentifier = _contentIdentifier;
 
     return theCopy;
 }
@@ -311,6 +929,7 @@ static char* formatsct(screen_char_t* src, int len, char* dest) {
 
 - (void)appendToDebugString:(NSMutableString *)s
 {
+    iTermLineBlockCharactersUse use(self);
     char temp[1000];
     int i;
     int prev;
@@ -332,6 +951,7 @@ static char* formatsct(screen_char_t* src, int len, char* dest) {
 }
 
 - (void)dump:(int)rawOffset toDebugLog:(BOOL)toDebugLog {
+    iTermLineBlockCharactersUse use(self);
     if (toDebugLog) {
         DLog(@"numRawLines=%@", @([self numRawLines]));
     } else {
@@ -367,10 +987,20 @@ static char* formatsct(screen_char_t* src, int len, char* dest) {
     auto it = insertResult.first;
     auto wasInserted = insertResult.second;
     if (wasInserted) {
-        result = iTermLineBlockNumberOfFullLinesImpl(raw_buffer + offset,
-                                                     length,
-                                                     width,
-                                                     _mayHaveDoubleWidthCharacter);
+        if (width > 1 && _mayHaveDoubleWidthCharacter) {
+            // Double-width characters that wrap have to be found.
+            iTermLineBlockCharactersUse use(self);
+            result = iTermLineBlockNumberOfFullLinesImpl(raw_buffer + offset,
+                                                         length,
+                                                         width,
+                                                         _mayHaveDoubleWidthCharacter);
+        } else {
+            // The characters aren't looked at.
+            result = iTermLineBlockNumberOfFullLinesImpl(raw_buffer + offset,
+                                                         length,
+                                                         width,
+                                                         _mayHaveDoubleWidthCharacter);
+        }
         it->second = result;
     } else {
         result = it->second;
@@ -436,7 +1066,16 @@ extern "C" int iTermLineBlockNumberOfFullLinesImpl(screen_char_t *buffer,
     if (cll_entries >= iTermLineBlockMaxLines) {
         return NO;
     }
+    [self discardCompactCharacters];
+    [self copyMappedRawBuffer];
+    _contentIdentifier = LineBlockNextContentIdentifier++;
     memcpy(raw_buffer + space_used, buffer, sizeof(screen_char_t) * length);
+    const BOOL appendingToLastLine = (is_partial && !(!partial && length == 0));
+    if (_searchIndex.enabled() && !_searchIndex.stale) {
+        [self addToSearchIndexFromOffset:space_used
+                                  length:length
+                     appendingToLastLine:appendingToLastLine];
+    }
     // There's an edge case here. In the else clause, the line buffer looks like this originally:
     //   |xxxx| EOL_SOFT
     // Then append an empty line with EOL_HARD. The desired result is
@@ -447,7 +1086,7 @@ extern "C" int iTermLineBlockNumberOfFullLinesImpl(screen_char_t *buffer,
     //
     // This can happen in practice if the now-empty line being appended formerly had some stuff
     // but that stuff was erased and the EOL_SOFT was left behind.
-    if (is_partial && !(!partial && length == 0)) {
+    if (appendingToLastLine) {
         // append to an existing line
         NSAssert(cll_entries > 0, @"is_partial but has no entries");
         // update the numlines cache with the new number of full lines that the updated line has.
@@ -622,7 +1261,7 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
     for (i = first_entry; i < cll_entries; ++i) {
         int cll = cumulative_line_lengths[i] - start_offset;
         length = cll - prev;
-        const int spans = [self numberOfFullLinesFromOffset:(buffer_start - raw_buffer) + prev
+        const int spans = [self numberOfFullLinesFromOffset:start_offset + prev
                                                      length:length
                                                       width:width];
         if (lineNum > spans) {
@@ -644,7 +1283,7 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
     for (i = first_entry; i < cll_entries; ++i) {
         int cll = cumulative_line_lengths[i] - start_offset;
         length = cll - prev;
-        const int spans = [self numberOfFullLinesFromOffset:(buffer_start - raw_buffer) + prev
+        const int spans = [self numberOfFullLinesFromOffset:start_offset + prev
                                                      length:length
                                                       width:width];
         if (lineNum > spans) {
@@ -681,6 +1320,7 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
                                  continuation:(screen_char_t *)continuationPtr
 {
     ITBetaAssert(*lineNum >= 0, @"Negative lines to getWrappedLineWithWrapWidth");
+    iTermLineBlockCharactersUse use(self);
     int prev = 0;
     int numEmptyLines = 0;
     for (int i = first_entry; i < cll_entries; ++i) {
@@ -787,7 +1427,7 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
     for (i = first_entry; i < cll_entries; ++i) {
         int cll = cumulative_line_lengths[i] - start_offset;
         int length = cll - prev;
-        const int marginalLines = [self numberOfFullLinesFromOffset:(buffer_start - raw_buffer) + prev
+        const int marginalLines = [self numberOfFullLinesFromOffset:start_offset + prev
                                                              length:length
                                                               width:width] + 1;
         count += marginalLines;
@@ -816,7 +1456,9 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
         // There is no last line to pop.
         return NO;
     }
+    iTermLineBlockCharactersUse use(self);
     _numberOfFullLinesCache.clear();
+    _contentIdentifier = LineBlockNextContentIdentifier++;
     int start;
     if (cll_entries == first_entry + 1) {
         start = 0;
@@ -869,6 +1511,9 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
         start_offset = 0;
         first_entry = 0;
         cll_entries = 0;
+        _searchIndex.clear();
+    } else {
+        _searchIndex.invalidate();
     }
     // refresh cache
     cached_numlines_width = -1;
@@ -910,6 +1555,7 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
 
 - (screen_char_t*)rawLine:(int)linenum
 {
+    iTermLineBlockCharactersUse use(self);
     int start;
     if (linenum == 0) {
         start = 0;
@@ -922,6 +1568,8 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
 - (void)changeBufferSize:(int)capacity {
     NSAssert(capacity >= [self rawSpaceUsed], @"Truncating used space");
     capacity = MAX(1, capacity);
+    [self discardCompactCharacters];
+    [self copyMappedRawBuffer];
     raw_buffer = (screen_char_t*) realloc((void*) raw_buffer, sizeof(screen_char_t) * capacity);
     buffer_start = raw_buffer + start_offset;
     buffer_size = capacity;
@@ -949,6 +1597,7 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
     int length;
     int i;
     *charsDropped = 0;
+    iTermLineBlockCharactersUse use(self);
     int initialOffset = start_offset;
     _numberOfFullLinesCache.clear();
     for (i = first_entry; i < cll_entries; ++i) {
@@ -989,6 +1638,7 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
             }
 
             *charsDropped = start_offset - initialOffset;
+            _searchIndex.invalidate();
 
 #ifdef TEST_LINEBUFFER_SANITY
             [self checkAndResetCachedNumlines:"dropLines" width: width];
@@ -1001,11 +1651,13 @@ int OffsetOfWrappedLine(screen_char_t* p, int n, int length, int width, BOOL may
 
     // Consumed the whole buffer.
     cached_numlines_width = -1;
+    _contentIdentifier = LineBlockNextContentIdentifier++;
     cll_entries = 0;
     buffer_start = raw_buffer;
     start_offset = 0;
     first_entry = 0;
     *charsDropped = [self rawSpaceUsed];
+    _searchIndex.clear();
     iTermLineBlockDidChange(self);
     return orig_n - n;
 }
@@ -1394,12 +2046,53 @@ static int Search(NSString* needle,
     return -1;
 }
 
+// Indexes |length| chars appended at |offset|. When they extend the last raw line, the trigrams
+// that straddle the old end of the line get indexed too.
+- (void)addToSearchIndexFromOffset:(int)offset
+                            length:(int)length
+               appendingToLastLine:(BOOL)appendingToLastLine {
+    int from = offset;
+    if (appendingToLastLine) {
+        const int lineStart = [self _lineRawOffset:cll_entries - 1];
+        int context = 0;
+        while (from > lineStart && context < 2) {
+            --from;
+            if (!iTermTrigramFilter::IsSkipped(raw_buffer[from])) {
+                ++context;
+            }
+        }
+    }
+    _searchIndex.addChars(raw_buffer + from, offset + length - from);
+}
+
+- (void)rebuildSearchIndex {
+    iTermLineBlockCharactersUse use(self);
+    _searchIndex.clear();
+    for (int i = first_entry; i < cll_entries; i++) {
+        _searchIndex.addChars(raw_buffer + [self _lineRawOffset:i], [self _lineLength:i]);
+    }
+}
+
+- (BOOL)mayContainMatchesOfSubstring:(NSString *)substring mode:(iTermFindMode)mode {
+    if (!_searchIndex.enabled()) {
+        return YES;
+    }
+    if (mode == iTermFindModeCaseSensitiveRegex || mode == iTermFindModeCaseInsensitiveRegex) {
+        return YES;
+    }
+    if (_searchIndex.stale) {
+        [self rebuildSearchIndex];
+    }
+    return _searchIndex.mayContain(substring);
+}
+
 - (void)findSubstring:(NSString*)substring
               options:(int)options
                  mode:(iTermFindMode)mode
              atOffset:(int)offset
               results:(NSMutableArray *)results
       multipleResults:(BOOL)multipleResults {
+    iTermLineBlockCharactersUse use(self);
     if (offset == -1) {
         offset = [self rawSpaceUsed] - 1;
     }
@@ -1457,6 +2150,7 @@ static int Search(NSString* needle,
     if (width <= 0) {
         return NO;
     }
+    iTermLineBlockCharactersUse use(self);
     int i;
     *x = 0;
     *y = 0;
@@ -1537,10 +2231,16 @@ static int Search(NSString* needle,
 }
 
 - (NSDictionary *)dictionary {
-    NSData *rawBufferData = [NSData dataWithBytes:raw_buffer
-                                           length:[self rawSpaceUsed] * sizeof(screen_char_t)];
+    NSData *rawBufferData;
+    if (_compactCharacters) {
+        rawBufferData = [[self newDataWithDecodedCharacters] autorelease];
+    } else {
+        rawBufferData = [NSData dataWithBytes:raw_buffer
+                                       length:[self rawSpaceUsed] * sizeof(screen_char_t)];
+    }
+    // start_offset is always buffer_start - raw_buffer, and a compact block may have no raw_buffer.
     return @{ kLineBlockRawBufferKey: rawBufferData,
-              kLineBlockBufferStartOffsetKey: @(buffer_start - raw_buffer),
+              kLineBlockBufferStartOffsetKey: @(start_offset),
               kLineBlockStartOffsetKey: @(start_offset),
               kLineBlockFirstEntryKey: @(first_entry),
               kLineBlockBufferSizeKey: @(buffer_size),
@@ -1550,6 +2250,48 @@ static int Search(NSString* needle,
               kLineBlockMayHaveDWCKey: @(_mayHaveDoubleWidthCharacter) };
 }
 
+- (NSDictionary *)dictionaryWithBlockStore:(iTermLineBlockStore *)blockStore {
+    long long offset = [blockStore offsetOfRecordWithKey:_contentIdentifier];
+    if (offset < 0) {
+        offset = [self appendRecordToBlockStore:blockStore];
+    }
+    if (offset < 0) {
+        return [self dictionary];
+    }
+    // start_offset is always buffer_start - raw_buffer, and a compact block has no raw_buffer.
+    return @{ kLineBlockRecordOffsetKey: @(offset),
+              kLineBlockBufferStartOffsetKey: @(start_offset),
+              kLineBlockStartOffsetKey: @(start_offset),
+              kLineBlockFirstEntryKey: @(first_entry),
+              kLineBlockBufferSizeKey: @(buffer_size),
+              kLineBlockIsPartialKey: @(is_partial),
+              kLineBlockMayHaveDWCKey: @(_mayHaveDoubleWidthCharacter) };
+}
+
+- (long long)appendRecordToBlockStore:(iTermLineBlockStore *)blockStore {
+    NSData *decoded = _compactCharacters ? [[self newDataWithDecodedCharacters] autorelease] : nil;
+    screen_char_t *chars = decoded ? (screen_char_t *)decoded.bytes : raw_buffer;
+    iTermLineBlockRecordHeader header = {
+        .magic = kLineBlockRecordMagic,
+        .numberOfCharacters = [self rawSpaceUsed],
+        .numberOfEntries = cll_entries
+    };
+    std::vector<iTermLineBlockRecordMetadata> metadata(cll_entries);
+    for (int i = 0; i < cll_entries; i++) {
+        metadata[i].timestamp = metadata_[i].timestamp;
+        metadata[i].continuation = metadata_[i].continuation;
+    }
+    const struct iovec parts[] = {
+        { &header, sizeof(header) },
+        { metadata.data(), metadata.size() * sizeof(iTermLineBlockRecordMetadata) },
+        { cumulative_line_lengths, cll_entries * sizeof(int) },
+        { chars, header.numberOfCharacters * sizeof(screen_char_t) }
+    };
+    return [blockStore appendRecordWithKey:_contentIdentifier
+                                     parts:parts
+                                     count:sizeof(parts) / sizeof(*parts)];
+}
+
 - (int)numberOfCharacters {
     return self.rawSpaceUsed - start_offset;
 }
@@ -34,6 +34,8 @@
 #import "LineBufferHelpers.h"
 #import "VT100GridTypes.h"
 
+@class iTermLineBlockStore;
+
 // A LineBuffer represents an ordered collection of strings of screen_char_t. Each string forms a
 // logical line of text plus color information. Logic is provided for the following major functions:
 //   - If the lines are wrapped onto a screen of some width, find the Nth wrapped line
@@ -50,9 +52,33 @@
 // Absolute block number of last block.
 @property(nonatomic, readonly) int largestAbsoluteBlockNumber;
 
+// When searching for multiple results, search full blocks on several threads at once. Defaults
+// to YES.
+@property(nonatomic, assign) BOOL searchesBlocksConcurrently;
+
+// Store blocks compactly once they fill up. Characters are decoded again when they're accessed.
+// Defaults to the compactScrollback advanced setting.
+@property(nonatomic, assign) BOOL storesFullBlocksCompactly;
+
+// When full blocks hold more than this many bytes of characters, the oldest ones are spilled to a
+// temporary file and mapped back in as needed. 0 means no limit. Defaults to the
+// maximumResidentScrollbackMegabytes advanced setting.
+@property(nonatomic, assign) long long residentBytesLimit;
+
+// Bytes of characters held in memory and mapped from a file, respectively.
+@property(nonatomic, readonly) long long residentBytes;
+@property(nonatomic, readonly) long long spilledBytes;
+
 - (LineBuffer*)initWithBlockSize:(int)bs;
 - (LineBuffer *)initWithDictionary:(NSDictionary *)dictionary;
 
+// Restores a dictionary made by -dictionaryWithBlockStore:. |blockStore| must have been opened from
+// the path given by +blockStorePathInDictionary:.
+- (LineBuffer *)initWithDictionary:(NSDictionary *)dictionary blockStore:(iTermLineBlockStore *)blockStore;
+
+// Returns the path of the block store a dictionary refers to, or nil if it is self-contained.
++ (NSString *)blockStorePathInDictionary:(NSDictionary *)dictionary;
+
 // Returns a copy of this buffer that can be appended to but that you must not
 // pop lines from. Only the last block is deep-copied; references are held to
 // all earlier blocks.
@@ -176,6 +202,11 @@
 // changed.
 - (NSDictionary *)dictionary;
 
+// Returns a dictionary with the entire contents of the line buffer. Every block but the last is
+// saved in |blockStore|, which writes only the ones it doesn't already have, so this stays cheap
+// no matter how much history there is. Falls back to -dictionary if |blockStore| is nil.
+- (NSDictionary *)dictionaryWithBlockStore:(iTermLineBlockStore *)blockStore;
+
 // Append text in reverse video to the end of the line buffer.
 - (void)appendMessage:(NSString *)message;
 
@@ -33,6 +33,8 @@
 #import "DebugLogging.h"
 #import "iTermAdvancedSettingsModel.h"
 #import "iTermLineBlockArray.h"
+#import "iTermLineBlockSpillFile.h"
+#import "iTermLineBlockStore.h"
 #import "iTermMalloc.h"
 #import "LineBlock.h"
 #import "RegexKitLite.h"
@@ -47,6 +49,7 @@ static NSString *const kLineBufferNumDroppedBlocksKey = @"Num Dropped Blocks";
 static NSString *const kLineBufferDroppedCharsKey = @"Dropped Chars";
 static NSString *const kLineBufferTruncatedKey = @"Truncated";
 static NSString *const kLineBufferMayHaveDWCKey = @"May Have Double Width Character";
+static NSString *const kLineBufferBlockStorePathKey = @"Block Store Path";
 
 static const int kLineBufferVersion = 1;
 static const NSInteger kUnicodeVersion = 9;
@@ -77,6 +80,9 @@ static const NSInteger kUnicodeVersion = 9;
 
     // Number of char that have been dropped
     long long droppedChars;
+
+    // Holds the characters of blocks spilled to stay under residentBytesLimit. Created lazily.
+    iTermLineBlockSpillFile *_spillFile;
 }
 
 // Append a block
@@ -104,6 +110,9 @@ static const NSInteger kUnicodeVersion = 9;
     max_lines = -1;
     num_wrapped_lines_width = -1;
     num_dropped_blocks = 0;
+    _searchesBlocksConcurrently = YES;
+    _storesFullBlocksCompactly = [iTermAdvancedSettingsModel compactScrollback];
+    _residentBytesLimit = (long long)[iTermAdvancedSettingsModel maximumResidentScrollbackMegabytes] * 1024 * 1024;
 }
 
 // The designated initializer. We prefer not to expose the notion of block sizes to
@@ -120,6 +129,10 @@ static const NSInteger kUnicodeVersion = 9;
 }
 
 - (LineBuffer *)initWithDictionary:(NSDictionary *)dictionary {
+    return [self initWithDictionary:dictionary blockStore:nil];
+}
+
+- (LineBuffer *)initWithDictionary:(NSDictionary *)dictionary blockStore:(iTermLineBlockStore *)blockStore {
     self = [super init];
     if (self) {
         [self commonInit];
@@ -135,7 +148,7 @@ static const NSInteger kUnicodeVersion = 9;
         num_dropped_blocks = [dictionary[kLineBufferNumDroppedBlocksKey] intValue];
         droppedChars = [dictionary[kLineBufferDroppedCharsKey] longLongValue];
         for (NSDictionary *blockDictionary in dictionary[kLineBufferBlocksKey]) {
-            LineBlock *block = [LineBlock blockWithDictionary:blockDictionary];
+            LineBlock *block = [LineBlock blockWithDictionary:blockDictionary blockStore:blockStore];
             if (!block) {
                 [self autorelease];
                 return nil;
@@ -146,8 +159,13 @@ static const NSInteger kUnicodeVersion = 9;
     return self;
 }
 
++ (NSString *)blockStorePathInDictionary:(NSDictionary *)dictionary {
+    return dictionary[kLineBufferBlockStorePathKey];
+}
+
 - (void)dealloc {
     [_lineBlocks release];
+    [_spillFile release];
     [super dealloc];
 }
 
@@ -365,6 +383,7 @@ static int RawNumLines(LineBuffer* buffer, int width) {
             } else {
                 block = [self _addBlockOfSize:block_size];
             }
+            [self storeFullBlocksEfficiently];
         }
 
         // Append the prefix if there is one (the prefix was a partial line that we're
@@ -401,6 +420,66 @@ static int RawNumLines(LineBuffer* buffer, int width) {
     }
 }
 
+// Called after a block fills up. Full blocks don't change unless lines are popped off the end of
+// the buffer, and old ones are rarely read. The block that just filled is stored compactly, and the
+// oldest blocks are spilled until the rest fit in residentBytesLimit so they can live in a file and
+// let the kernel page them in on the occasion they're searched or scrolled to.
+- (void)storeFullBlocksEfficiently {
+    const NSInteger count = _lineBlocks.count;
+    if (_storesFullBlocksCompactly && count >= 2) {
+        [_lineBlocks[count - 2] storeCompactly];
+    }
+    [self spillColdBlocks];
+}
+
+// Spills the oldest full blocks until the rest fit in residentBytesLimit.
+- (void)spillColdBlocks {
+    if (_residentBytesLimit <= 0) {
+        return;
+    }
+    NSArray<LineBlock *> *blocks = _lineBlocks.blocks;
+    long long residentBytes = 0;
+    // The last block is still being appended to.
+    for (NSInteger i = (NSInteger)blocks.count - 2; i >= 0; i--) {
+        LineBlock *block = blocks[i];
+        if (block.isSpilled) {
+            // Everything before it was spilled already.
+            break;
+        }
+        residentBytes += block.residentBytes;
+        if (residentBytes <= _residentBytesLimit) {
+            continue;
+        }
+        if (!_spillFile) {
+            _spillFile = [[iTermLineBlockSpillFile alloc] init];
+            if (!_spillFile) {
+                // Don't try again.
+                _residentBytesLimit = 0;
+                return;
+            }
+        }
+        if (![block spillToFile:_spillFile]) {
+            return;
+        }
+    }
+}
+
+- (long long)residentBytes {
+    long long sum = 0;
+    for (LineBlock *block in _lineBlocks.blocks) {
+        sum += block.residentBytes;
+    }
+    return sum;
+}
+
+- (long long)spilledBytes {
+    long long sum = 0;
+    for (LineBlock *block in _lineBlocks.blocks) {
+        sum += block.spilledBytes;
+    }
+    return sum;
+}
+
 - (NSInteger)generationForLineNumber:(int)lineNum width:(int)width {
     int remainder = 0;
     LineBlock *block = [_lineBlocks blockContainingLineNumber:lineNum
@@ -718,6 +797,10 @@ NS_INLINE int TotalNumberOfRawLines(LineBuffer *self) {
 
     assert(blockIndex >= 0);
     assert(blockIndex < numBlocks);
+    if ([self shouldSearchConcurrentlyFromBlockIndex:blockIndex context:context]) {
+        [self findSubstringConcurrently:context fromBlockIndex:blockIndex stopAt:stopPosition];
+        return;
+    }
     LineBlock* block = _lineBlocks[blockIndex];
 
     if (blockIndex == 0 &&
@@ -737,17 +820,46 @@ NS_INLINE int TotalNumberOfRawLines(LineBuffer *self) {
 
     // NSLog(@"search block %d starting at offset %d", context.absBlockNum - num_dropped_blocks, context.offset);
 
-    [block findSubstring:context.substring
-                 options:context.options
-                    mode:context.mode
-                atOffset:context.offset
-                 results:context.results
-         multipleResults:((context.options & FindMultipleResults) != 0)];
+    if ([block mayContainMatchesOfSubstring:context.substring mode:context.mode]) {
+        [block findSubstring:context.substring
+                     options:context.options
+                        mode:context.mode
+                    atOffset:context.offset
+                     results:context.results
+             multipleResults:((context.options & FindMultipleResults) != 0)];
+    }
     NSMutableArray* filtered = [NSMutableArray arrayWithCapacity:[context.results count]];
+    const BOOL haveOutOfRangeResults = [self addResults:context.results
+                                         fromBlockIndex:blockIndex
+                                             toFiltered:filtered
+                                                context:context
+                                                 stopAt:stopPosition];
+    context.results = filtered;
+    if ([filtered count] == 0 && haveOutOfRangeResults) {
+        context.status = NotFound;
+    }
+
+    // Prepare to continue searching next block.
+    if (context.dir < 0) {
+        context.offset = -1;
+    } else {
+        context.offset = 0;
+    }
+    context.absBlockNum = context.absBlockNum + context.dir;
+}
+
+// Converts block-relative results to buffer positions and adds the ones that lie before
+// |stopPosition| to |filtered|, setting the context's status to Matched if there are any. Returns
+// YES if any result was beyond |stopPosition|.
+- (BOOL)addResults:(NSArray<ResultRange *> *)results
+    fromBlockIndex:(NSInteger)blockIndex
+        toFiltered:(NSMutableArray *)filtered
+           context:(FindContext *)context
+            stopAt:(LineBufferPosition *)stopPosition {
     BOOL haveOutOfRangeResults = NO;
-    int blockPosition = [self _blockPosition:context.absBlockNum - num_dropped_blocks];
+    const int blockPosition = [self _blockPosition:blockIndex];
     const int stopAt = stopPosition.absolutePosition - droppedChars;
-    for (ResultRange* range in context.results) {
+    for (ResultRange* range in results) {
         range->position += blockPosition;
         if (context.dir * (range->position - stopAt) > 0 ||
             context.dir * (range->position + context.matchLength - stopAt) > 0) {
@@ -759,18 +871,88 @@ NS_INLINE int TotalNumberOfRawLines(LineBuffer *self) {
             [filtered addObject:range];
         }
     }
-    context.results = filtered;
-    if ([filtered count] == 0 && haveOutOfRangeResults) {
-        context.status = NotFound;
+    return haveOutOfRangeResults;
+}
+
+// Searching for all results visits every block, so full blocks can be searched in parallel.
+// Only do this when the context is positioned at the start of a block (every block after the
+// first one searched is). The last block may still be appended to, so it is always searched by
+// the ordinary path.
+- (BOOL)shouldSearchConcurrentlyFromBlockIndex:(NSInteger)blockIndex context:(FindContext *)context {
+    if (!self.searchesBlocksConcurrently) {
+        return NO;
+    }
+    if (!(context.options & FindMultipleResults)) {
+        return NO;
     }
+    if (context.offset != (context.dir > 0 ? 0 : -1)) {
+        return NO;
+    }
+    if ([[NSProcessInfo processInfo] activeProcessorCount] < 2) {
+        return NO;
+    }
+    const NSInteger lastBlockIndex = _lineBlocks.count - 1;
+    return blockIndex != lastBlockIndex && (context.dir > 0 || blockIndex > 0);
+}
 
-    // Prepare to continue searching next block.
-    if (context.dir < 0) {
-        context.offset = -1;
-    } else {
-        context.offset = 0;
+- (void)findSubstringConcurrently:(FindContext *)context
+                   fromBlockIndex:(NSInteger)blockIndex
+                           stopAt:(LineBufferPosition *)stopPosition {
+    // Each call does a bounded amount of work so the caller's time slicing still works.
+    const NSInteger maxCount = [[NSProcessInfo processInfo] activeProcessorCount] * 4;
+    const NSInteger lastBlockIndex = _lineBlocks.count - 1;
+    const int dir = context.dir;
+    const size_t count = dir > 0 ? MIN(maxCount, lastBlockIndex - blockIndex) : MIN(maxCount, blockIndex + 1);
+
+    LineBlock **blocks = (LineBlock **)iTermMalloc(sizeof(LineBlock *) * count);
+    NSMutableArray **resultsByBlock = (NSMutableArray **)calloc(count, sizeof(NSMutableArray *));
+    for (size_t i = 0; i < count; i++) {
+        blocks[i] = _lineBlocks[blockIndex + (NSInteger)i * dir];
     }
-    context.absBlockNum = context.absBlockNum + context.dir;
+    NSString *substring = context.substring;
+    const int options = context.options;
+    const iTermFindMode mode = context.mode;
+    const int offset = context.offset;
+
+    // GCD hands out iterations to idle workers, so a block full of matches doesn't hold up the
+    // others.
+    dispatch_apply(count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), ^(size_t i) {
+        @autoreleasepool {
+            if (![blocks[i] mayContainMatchesOfSubstring:substring mode:mode]) {
+                return;
+            }
+            NSMutableArray *results = [[NSMutableArray alloc] init];
+            [blocks[i] findSubstring:substring
+                             options:options
+                                mode:mode
+                            atOffset:offset
+                             results:results
+                     multipleResults:YES];
+            resultsByBlock[i] = results;
+        }
+    });
+
+    // Merge in search order, stopping at the first block with a result beyond stopPosition.
+    NSMutableArray *filtered = [NSMutableArray array];
+    BOOL haveOutOfRangeResults = NO;
+    for (size_t i = 0; i < count; i++) {
+        if (resultsByBlock[i] && !haveOutOfRangeResults) {
+            haveOutOfRangeResults = [self addResults:resultsByBlock[i]
+                                      fromBlockIndex:blockIndex + (NSInteger)i * dir
+                                          toFiltered:filtered
+                                             context:context
+                                              stopAt:stopPosition];
+        }
+        [resultsByBlock[i] release];
+    }
+    free(resultsByBlock);
+    free(blocks);
+
+    context.results = filtered;
+    if (haveOutOfRangeResults && filtered.count == 0) {
+        context.status = NotFound;
+    }
+    context.absBlockNum = context.absBlockNum + (int)count * dir;
 }
 
 // Returns an array of XRange values
@@ -1093,6 +1275,36 @@ NS_INLINE int TotalNumberOfRawLines(LineBuffer *self) {
               kLineBufferMayHaveDWCKey: @(_mayHaveDoubleWidthCharacter) };
 }
 
+- (NSDictionary *)dictionaryWithBlockStore:(iTermLineBlockStore *)blockStore {
+    if (!blockStore) {
+        return [self dictionary];
+    }
+    NSMutableArray *codedBlocks = [NSMutableArray arrayWithCapacity:_lineBlocks.count];
+    LineBlock *lastBlock = _lineBlocks.lastBlock;
+    [blockStore beginSave];
+    for (LineBlock *block in _lineBlocks.blocks) {
+        @autoreleasepool {
+            if (block == lastBlock) {
+                [codedBlocks addObject:[block dictionary]];
+            } else {
+                [codedBlocks addObject:[block dictionaryWithBlockStore:blockStore]];
+            }
+        }
+    }
+    [blockStore endSave];
+    return @{ kLineBufferVersionKey: @(kLineBufferVersion),
+              kLineBufferBlocksKey: codedBlocks,
+              kLineBufferTruncatedKey: @NO,
+              kLineBufferBlockSizeKey: @(block_size),
+              kLineBufferCursorXKey: @(cursor_x),
+              kLineBufferCursorRawlineKey: @(cursor_rawline),
+              kLineBufferMaxLinesKey: @(max_lines),
+              kLineBufferNumDroppedBlocksKey: @(num_dropped_blocks),
+              kLineBufferDroppedCharsKey: @(droppedChars),
+              kLineBufferMayHaveDWCKey: @(_mayHaveDoubleWidthCharacter),
+              kLineBufferBlockStorePathKey: blockStore.path };
+}
+
 - (void)appendMessage:(NSString *)message {
     if (!_lineBlocks.count) {
         [self _addBlockOfSize:message.length];
@@ -10,6 +10,7 @@
 #import "PTYScrollView.h"
 #import "PTYSession.h"
 #import "SessionView.h"
+#import "VT100ScreenMark.h"
 
 // Whether to stop scrolling.
 typedef enum {
@@ -76,7 +77,9 @@ typedef enum {
                     atAbsoluteLineNumber:(long long)lineNumber
                         useInterpolation:(BOOL)useInterpolation
                                     stop:(BOOL *)stop {
-    [aSession.screen terminalSaveScrollPositionWithArgument:@"saveCursorLine"];
+    // The action can run after more output has arrived, so mark the line that matched rather than
+    // the cursor's line.
+    [aSession markAddedAtAbsoluteLine:lineNumber ofClass:[VT100ScreenMark class]];
     if ([self shouldStopScrolling]) {
         [[aSession.view.scrollview ptyVerticalScroller] setUserScroll:YES];
     }
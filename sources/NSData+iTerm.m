@@ -9,29 +9,16 @@
 #import "NSData+iTerm.h"
 
 #import "DebugLogging.h"
+#import "iTermBase64Decoder.h"
 #import "NSArray+iTerm.h"
 #import "NSStringITerm.h"
-#import "RegexKitLite.h"
 #import <apr-1/apr_base64.h>
 #import <CommonCrypto/CommonDigest.h>
 
 @implementation NSData (iTerm)
 
 + (NSData *)dataWithBase64EncodedString:(NSString *)string {
-    const char *buffer = [[string stringByReplacingOccurrencesOfRegex:@"[\x0a\x0d]" withString:@""] UTF8String];
-    int destLength = apr_base64_decode_len(buffer);
-    if (destLength <= 0) {
-        return nil;
-    }
-
-    NSMutableData *data = [NSMutableData dataWithLength:destLength];
-    char *decodedBuffer = [data mutableBytes];
-    int resultLength = apr_base64_decode(decodedBuffer, buffer);
-    if (resultLength <= 0) {
-        return nil;
-    }
-    [data setLength:resultLength];
-    return data;
+    return [iTermBase64Decoder dataByDecodingString:string];
 }
 
 - (NSString *)stringWithBase64EncodingWithLineBreak:(NSString *)lineBreak {
@@ -738,6 +738,8 @@ typedef enum {
 - (void)nextMarkOrNote;
 - (void)scrollToMark:(id<iTermMark>)mark;
 - (id<iTermMark>)markAddedAtCursorOfClass:(Class)theClass;
+// Returns nil without adding a mark if |line| is no longer in history.
+- (id<iTermMark>)markAddedAtAbsoluteLine:(long long)line ofClass:(Class)theClass;
 
 // Select this session and tab and bring window to foreground.
 - (void)reveal;
@@ -84,6 +84,7 @@
 #import "iTermTextExtractor.h"
 #import "iTermTheme.h"
 #import "iTermThroughputEstimator.h"
+#import "iTermTokenExecutionScheduler.h"
 #import "iTermTmuxStatusBarMonitor.h"
 #import "iTermTmuxOptionMonitor.h"
 #import "iTermUpdateCadenceController.h"
@@ -133,11 +134,14 @@
 #import "TmuxStateParser.h"
 #import "TmuxWindowOpener.h"
 #import "Trigger.h"
+#import "iTermTriggerEvaluator.h"
+#import "iTermTriggerMatcher.h"
 #import "VT100RemoteHost.h"
 #import "VT100Screen.h"
 #import "VT100ScreenMark.h"
 #import "VT100Terminal.h"
 #import "VT100Token.h"
+#import "VT100TokenPool.h"
 #import "WindowControllerInterface.h"
 #import <apr-1/apr_base64.h>
 #include <stdlib.h>
@@ -278,6 +282,7 @@ static const NSUInteger kMaxHosts = 100;
     iTermStandardKeyMapperDelegate,
     iTermStatusBarViewControllerDelegate,
     iTermTermkeyKeyMapperDelegate,
+    iTermTriggerEvaluatorDelegate,
     iTermUpdateCadenceControllerDelegate,
     iTermWorkingDirectoryPollerDelegate>
 @property(nonatomic, retain) Interval *currentMarkOrNotePosition;
@@ -291,6 +296,10 @@ static const NSUInteger kMaxHosts = 100;
 // Time the window was last resized at.
 @property(nonatomic) NSTimeInterval lastResize;
 @property(atomic, assign) PTYSessionTmuxMode tmuxMode;
+
+// Number of bytes the PTY thread reads into the parser at a time. Set on the main thread from the
+// throughput estimate; read on the PTY thread.
+@property(atomic, assign) int readBatchSize;
 @property(nonatomic, copy) NSString *lastDirectory;
 @property(nonatomic) BOOL lastDirectoryIsUnsuitableForOldPWD;
 @property(nonatomic, retain) VT100RemoteHost *lastRemoteHost;  // last remote host at time of setting current directory
@@ -371,6 +380,15 @@ static const NSUInteger kMaxHosts = 100;
     // The current triggers.
     NSMutableArray *_triggers;
 
+    // Runs the regexes of _triggers on a background queue and hands back matches in line order.
+    // Its matcher is rebuilt along with _triggers.
+    iTermTriggerEvaluator *_triggerEvaluator;
+
+    // Whether _triggerEvaluator is backlogged, and for a tmux gateway, how many of its clients'
+    // evaluators are. Reading output is suspended while either is set.
+    BOOL _triggersBacklogged;
+    NSInteger _numberOfTmuxClientsWithTriggersBacklogged;
+
     // Does the terminal think this session is focused?
     BOOL _focused;
 
@@ -477,6 +495,8 @@ static const NSUInteger kMaxHosts = 100;
     NSMutableDictionary<id, ITMNotificationRequest *> *_keystrokeSubscriptions;
     NSMutableDictionary<id, ITMNotificationRequest *> *_keyboardFilterSubscriptions;
     NSMutableDictionary<id, ITMNotificationRequest *> *_updateSubscriptions;
+    // Incremented each time a screen update notification with contents is posted.
+    long long _screenUpdateGeneration;
     NSMutableDictionary<id, ITMNotificationRequest *> *_promptSubscriptions;
     NSMutableDictionary<id, ITMNotificationRequest *> *_customEscapeSequenceNotifications;
 
@@ -671,6 +691,7 @@ static const NSUInteger kMaxHosts = 100;
         _hostnameToShell = [[NSMutableDictionary alloc] init];
         _automaticProfileSwitcher = [[iTermAutomaticProfileSwitcher alloc] initWithDelegate:self];
         _throughputEstimator = [[iTermThroughputEstimator alloc] initWithHistoryOfDuration:5.0 / 30.0 secondsPerBucket:1 / 30.0];
+        self.readBatchSize = 4096;
         _cadenceController = [[iTermUpdateCadenceController alloc] initWithThroughputEstimator:_throughputEstimator];
         _cadenceController.delegate = self;
 
@@ -782,6 +803,8 @@ ITERM_WEAKLY_REFERENCEABLE
     dispatch_release(_executionSemaphore);
     [_colorMap release];
     [_triggers release];
+    _triggerEvaluator.delegate = nil;
+    [_triggerEvaluator release];
     [_pasteboard release];
     [_pbtext release];
     [_creationDate release];
@@ -2148,6 +2171,8 @@ ITERM_WEAKLY_REFERENCEABLE
         [self _maybeWarnAboutShortLivedSessions];
     }
     if (self.tmuxMode == TMUX_CLIENT) {
+        // Don't leave the gateway suspended on behalf of a pane that's going away.
+        [self setTriggersBacklogged:NO];
         assert([_delegate tmuxWindow] >= 0);
         [_tmuxController deregisterWindow:[_delegate tmuxWindow]
                                windowPane:self.tmuxPane
@@ -2529,7 +2554,34 @@ ITERM_WEAKLY_REFERENCEABLE
 - (void)threadedReadTask:(char *)buffer length:(int)length {
     // Pass the input stream to the parser.
     [_terminal.parser putStreamData:buffer length:length];
+    [self threadedParseInputOfLength:length];
+}
+
+// This is run in PTYTask's thread. The task reads straight into the parser's stream.
+- (void)threadedReadTaskWithReader:(int (^)(char *, int))reader {
+    const int length = [_terminal.parser appendStreamDataWithCapacity:self.readBatchSize
+                                                               writer:reader];
+    if (length > 0) {
+        [self threadedParseInputOfLength:length];
+    }
+}
 
+// Runs on the main thread. Picks how many bytes the PTY thread should read before handing off to
+// the parser. A visible session reads about one frame's worth of output at a time so the display
+// keeps up. A session in the background is in "throughput mode": it reads about 100ms worth at a
+// time (the PTY thread keeps reading until EAGAIN or the batch fills) since nobody is watching
+// and larger batches mean fewer trips through the parser and main queue. Idle sessions stay at the
+// minimum so they don't hold on to big parser buffers.
+- (void)updateReadBatchSize {
+    static const int kMinimumReadBatchSize = 4096;
+    static const int kMaximumReadBatchSize = 1024 * 1024;
+    const BOOL visible = [_delegate sessionBelongsToVisibleTab] && !self.view.window.isMiniaturized;
+    const NSInteger throughput = _throughputEstimator.estimatedThroughput;
+    const NSInteger desired = visible ? throughput / 60 : throughput / 10;
+    self.readBatchSize = (int)MAX(kMinimumReadBatchSize, MIN(kMaximumReadBatchSize, desired));
+}
+
+- (void)threadedParseInputOfLength:(int)length {
     // Parse the input stream into an array of tokens.
     CVector vector;
     CVectorCreate(&vector, 100);
@@ -2550,10 +2602,12 @@ ITERM_WEAKLY_REFERENCEABLE
 
     [self retain];
     dispatch_retain(_executionSemaphore);
-    dispatch_async(dispatch_get_main_queue(), ^{
-        if (_useAdaptiveFrameRate) {
-            [_throughputEstimator addByteCount:length];
-        }
+    // Executing goes through the scheduler rather than straight to the main queue so that a
+    // session flooding output takes turns with the others instead of starving them.
+    [[iTermTokenExecutionScheduler sharedInstance] enqueueBlock:^{
+        // The estimator also sizes PTY reads, so feed it even without adaptive frame rate.
+        [_throughputEstimator addByteCount:length];
+        [self updateReadBatchSize];
         [self executeTokens:&vector bytesHandled:length];
 
         // Unblock the background thread; if it's ready, it can send the main thread more tokens
@@ -2561,7 +2615,7 @@ ITERM_WEAKLY_REFERENCEABLE
         dispatch_semaphore_signal(_executionSemaphore);
         dispatch_release(_executionSemaphore);
         [self release];
-    });
+    } forKey:self];
 }
 
 - (void)synchronousReadTask:(NSString *)string {
@@ -2596,6 +2650,20 @@ ITERM_WEAKLY_REFERENCEABLE
     });
 }
 
+- (void)executeTokensInVector:(const CVector *)vector {
+    const int n = CVectorCount(vector);
+    int i = 0;
+    while (i < n) {
+        if (![self shouldExecuteToken]) {
+            break;
+        }
+
+        DLog(@"Execute token %@ cursor=(%d, %d)", CVectorGetObject(vector, i), _screen.cursorX - 1, _screen.cursorY - 1);
+        // Adjacent strings are appended in one go, so this may execute more than one token.
+        i += [_terminal executeTokensInVector:vector startingAtIndex:i];
+    }
+}
+
 - (void)executeTokens:(const CVector *)vector bytesHandled:(int)length {
     STOPWATCH_START(executing);
     DLog(@"Session %@ begins executing tokens", self);
@@ -2610,37 +2678,42 @@ ITERM_WEAKLY_REFERENCEABLE
         CVectorDestroy(vector);
         return;
     } else if (_queuedTokens.count) {
-        // A closed session was just un-closed. Execute queued up tokens.
+        // A closed session was just un-closed. Execute queued up tokens followed by the new ones
+        // as a single run so strings that straddle the two can be coalesced.
+        CVector combined;
+        CVectorCreate(&combined, _queuedTokens.count + n + 1);
         for (VT100Token *token in _queuedTokens) {
-            if (![self shouldExecuteToken]) {
-                break;
-            }
-            [_terminal executeToken:token];
+            CVectorAppend(&combined, token);
         }
-        [self recycleQueuedTokens];
-    }
-
-    for (int i = 0; i < n; i++) {
-        if (![self shouldExecuteToken]) {
-            break;
+        for (int i = 0; i < n; i++) {
+            CVectorAppend(&combined, CVectorGet(vector, i));
         }
-
-        VT100Token *token = CVectorGetObject(vector, i);
-        DLog(@"Execute token %@ cursor=(%d, %d)", token, _screen.cursorX - 1, _screen.cursorY - 1);
-        [_terminal executeToken:token];
+        [self executeTokensInVector:&combined];
+        CVectorDestroy(&combined);
+        [self recycleQueuedTokens];
+    } else {
+        [self executeTokensInVector:vector];
     }
+    [_tmuxGateway flushPendingOutput];
 
     [self finishedHandlingNewOutputOfLength:length];
 
-    // When busy, we spend a lot of time performing recycleObject, so farm it
-    // off to a background thread.
+    // When busy, we spend a lot of time resetting tokens for reuse, so farm it off to a background
+    // thread. Tokens go back to the parser's pool in bulk so the parser doesn't have to allocate
+    // new ones.
     CVector temp = *vector;
+    VT100TokenPool *pool = [_terminal.parser.tokenPool retain];
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
-        for (int i = 0; i < n; i++) {
-            VT100Token *token = CVectorGetObject(&temp, i);
-            [token release];
+        if (pool) {
+            [pool recycleTokensInVector:&temp];
+        } else {
+            for (int i = 0; i < n; i++) {
+                VT100Token *token = CVectorGetObject(&temp, i);
+                [token release];
+            }
         }
         CVectorDestroy(&temp);
+        [pool release];
     })
     STOPWATCH_LAP(executing);
 }
@@ -2697,23 +2770,11 @@ ITERM_WEAKLY_REFERENCEABLE
 - (void)checkTriggersOnPartialLine:(BOOL)partial
                         stringLine:(iTermStringLine *)stringLine
                         lineNumber:(long long)startAbsLineNumber {
-    // If the trigger causes the session to get released, don't crash.
-    [[self retain] autorelease];
-
-    // If a trigger changes the current profile then _triggers gets released and we should stop
-    // processing triggers. This can happen with automatic profile switching.
-    NSArray<Trigger *> *triggers = [[_triggers retain] autorelease];
-
-    for (Trigger *trigger in triggers) {
-        BOOL stop = [trigger tryString:stringLine
-                             inSession:self
-                           partialLine:partial
-                            lineNumber:startAbsLineNumber
-                      useInterpolation:_triggerParametersUseInterpolatedStrings];
-        if (stop || _exited || (_triggers != triggers)) {
-            break;
-        }
-    }
+    // The regexes run in the background. Actions are performed in
+    // -triggerEvaluator:didEvaluate:.
+    [_triggerEvaluator evaluateStringLine:stringLine
+                               lineNumber:startAbsLineNumber
+                              partialLine:partial];
 }
 
 - (void)appendStringToTriggerLine:(NSString *)s {
@@ -2798,9 +2859,9 @@ ITERM_WEAKLY_REFERENCEABLE
 {
     DLog(@"threaded task broken pipe");
     // Put the call to brokenPipe in the same queue as executeTokens:bytesHandled: to avoid a race.
-    dispatch_async(dispatch_get_main_queue(), ^{
+    [[iTermTokenExecutionScheduler sharedInstance] enqueueBlock:^{
         [self brokenPipe];
-    });
+    } forKey:self];
 }
 
 - (void)taskDiedImmediately {
@@ -3675,6 +3736,11 @@ ITERM_WEAKLY_REFERENCEABLE
             [_triggers addObject:trigger];
         }
     }
+    if (!_triggerEvaluator) {
+        _triggerEvaluator = [[iTermTriggerEvaluator alloc] init];
+        _triggerEvaluator.delegate = self;
+    }
+    _triggerEvaluator.matcher = [[[iTermTriggerMatcher alloc] initWithTriggers:_triggers] autorelease];
     _triggerParametersUseInterpolatedStrings = [iTermProfilePreferences boolForKey:KEY_TRIGGERS_USE_INTERPOLATED_STRINGS
                                                                          inProfile:aDict];
 
@@ -7655,16 +7721,77 @@ scrollToFirstResult:(BOOL)scrollToFirstResult {
     }
 }
 
-- (void)textViewDidFindDirtyRects {
-    if (_updateSubscriptions.count) {
-        ITMNotification *notification = [[[ITMNotification alloc] init] autorelease];
-        notification.screenUpdateNotification = [[[ITMScreenUpdateNotification alloc] init] autorelease];
-        notification.screenUpdateNotification.session = self.guid;
-        [_updateSubscriptions enumerateKeysAndObjectsUsingBlock:^(id  _Nonnull key, ITMNotificationRequest * _Nonnull obj, BOOL * _Nonnull stop) {
+- (void)textViewDidFindDirtyRectsOnLines:(NSIndexSet *)lines {
+    if (!_updateSubscriptions.count) {
+        return;
+    }
+    __block ITMNotification *notification = nil;
+    __block ITMNotification *notificationWithContents = nil;
+    [_updateSubscriptions enumerateKeysAndObjectsUsingBlock:^(id  _Nonnull key, ITMNotificationRequest * _Nonnull obj, BOOL * _Nonnull stop) {
+        const BOOL includeContents = (obj.argumentsOneOfCase == ITMNotificationRequest_Arguments_OneOfCase_ScreenUpdateRequest &&
+                                      obj.screenUpdateRequest.includeContents);
+        if (includeContents) {
+            if (!notificationWithContents) {
+                notificationWithContents = [self screenUpdateNotificationWithContentsOfLines:lines];
+            }
+            [[iTermAPIHelper sharedInstance] postAPINotification:notificationWithContents
+                                                 toConnectionKey:key];
+        } else {
+            if (!notification) {
+                notification = [[[ITMNotification alloc] init] autorelease];
+                notification.screenUpdateNotification = [[[ITMScreenUpdateNotification alloc] init] autorelease];
+                notification.screenUpdateNotification.session = self.guid;
+            }
             [[iTermAPIHelper sharedInstance] postAPINotification:notification
                                                  toConnectionKey:key];
-        }];
-    }
+        }
+    }];
+}
+
+// Builds a screen update notification that carries the contents of |lines|, which are absolute
+// line numbers. Lines no longer in the buffer are skipped.
+- (ITMNotification *)screenUpdateNotificationWithContentsOfLines:(NSIndexSet *)lines {
+    ITMNotification *notification = [[[ITMNotification alloc] init] autorelease];
+    ITMScreenUpdateNotification *update = [[[ITMScreenUpdateNotification alloc] init] autorelease];
+    notification.screenUpdateNotification = update;
+    update.session = self.guid;
+    update.generation = ++_screenUpdateGeneration;
+
+    const long long overflow = _screen.totalScrollbackOverflow;
+    const long long firstLineOnScreen = _screen.numberOfScrollbackLines + overflow;
+    update.firstLineOnScreen = firstLineOnScreen;
+    update.cursor.x = _screen.currentGrid.cursor.x;
+    update.cursor.y = _screen.currentGrid.cursor.y + firstLineOnScreen;
+
+    const int width = _screen.width;
+    const long long limit = _screen.numberOfLines + overflow;
+    [lines enumerateIndexesUsingBlock:^(NSUInteger absLine, BOOL * _Nonnull stop) {
+        if ((long long)absLine < overflow || (long long)absLine >= limit) {
+            return;
+        }
+        const screen_char_t *const chars = [_screen getLineAtIndex:(int)(absLine - overflow)];
+        int length = width;
+        while (length > 0 && chars[length - 1].code == 0 && !chars[length - 1].complexChar) {
+            length--;
+        }
+        ITMScreenUpdateLine *line = [[[ITMScreenUpdateLine alloc] init] autorelease];
+        line.lineNumber = absLine;
+        line.contents.text = [self stringForLine:(screen_char_t *)chars
+                                          length:length
+                                       cppsArray:line.contents.codePointsPerCellArray];
+        switch (chars[width].code) {
+            case EOL_HARD:
+                line.contents.continuation = ITMLineContents_Continuation_ContinuationHardEol;
+                break;
+
+            case EOL_SOFT:
+            case EOL_DWC:
+                line.contents.continuation = ITMLineContents_Continuation_ContinuationSoftEol;
+                break;
+        }
+        [update.linesArray addObject:line];
+    }];
+    return notification;
 }
 
 - (void)textViewBeginDrag
@@ -9128,6 +9255,14 @@ scrollToFirstResult:(BOOL)scrollToFirstResult {
                          ofClass:theClass];
 }
 
+- (id<iTermMark>)markAddedAtAbsoluteLine:(long long)line ofClass:(Class)theClass {
+    const long long relativeLine = line - [_screen totalScrollbackOverflow];
+    if (relativeLine < 0 || relativeLine >= [_screen numberOfLines]) {
+        return nil;
+    }
+    return [self markAddedAtLine:(int)relativeLine ofClass:theClass];
+}
+
 - (void)screenActivateWindow {
     [NSApp activateIgnoringOtherApps:YES];
 }
@@ -10616,6 +10751,32 @@ scrollToFirstResult:(BOOL)scrollToFirstResult {
     return self.variablesScope;
 }
 
+- (NSUInteger)pasteHelperNumberOfBytesQueuedForWriting {
+    return _shell.numberOfBytesQueuedForWriting;
+}
+
+- (long long)pasteHelperNumberOfBytesRead {
+    return _shell.numberOfBytesRead;
+}
+
+- (BOOL)pasteHelperCanWriteData {
+    // tmux, broadcast input, and local echo all need the string that -writeTask: takes.
+    return (self.tmuxMode == TMUX_NONE &&
+            !_terminal.sendReceiveMode &&
+            ![[_delegate realParentWindow] broadcastInputToSession:self]);
+}
+
+// Does what -writeTask: does for a session that isn't broadcasting, without going through a string.
+- (void)pasteHelperWriteData:(NSData *)data {
+    if (_exited) {
+        return;
+    }
+    self.currentMarkOrNotePosition = nil;
+    [self setBell:NO];
+    [[_view.scrollview ptyVerticalScroller] setUserScroll:NO];
+    [_shell writeTask:data];
+}
+
 #pragma mark - iTermAutomaticProfileSwitcherDelegate
 
 - (NSString *)automaticProfileSwitcherSessionName {
@@ -11659,6 +11820,69 @@ scrollToFirstResult:(BOOL)scrollToFirstResult {
     return _badgeLabelSizeFraction;
 }
 
+#pragma mark - iTermTriggerEvaluatorDelegate
+
+- (void)triggerEvaluator:(iTermTriggerEvaluator *)evaluator didEvaluate:(iTermTriggerEvaluation *)evaluation {
+    if (_exited) {
+        return;
+    }
+    // If the trigger causes the session to get released, don't crash.
+    [[self retain] autorelease];
+
+    // If a trigger changes the current profile then _triggers gets replaced and we should stop
+    // processing triggers. This can happen with automatic profile switching. Lines enqueued before
+    // a profile change are still evaluated with the triggers that were in effect at the time.
+    NSArray<Trigger *> *currentTriggers = _triggers;
+    NSArray<Trigger *> *triggers = evaluation.matcher.triggers;
+    for (NSUInteger i = 0; i < triggers.count; i++) {
+        BOOL stop = [triggers[i] performActionForMatches:evaluation.matches[i]
+                                                onString:evaluation.stringLine
+                                               inSession:self
+                                             partialLine:evaluation.partialLine
+                                              lineNumber:evaluation.lineNumber
+                                        useInterpolation:_triggerParametersUseInterpolatedStrings];
+        if (stop || _exited || (_triggers != currentTriggers)) {
+            break;
+        }
+    }
+}
+
+- (void)triggerEvaluator:(iTermTriggerEvaluator *)evaluator didChangeBacklogged:(BOOL)backlogged {
+    DLog(@"%@: trigger backlog %@ (depth=%@ max=%@ evaluated=%@ dropped=%@)",
+         self,
+         backlogged ? @"began" : @"ended",
+         @(evaluator.queueDepth),
+         @(evaluator.maximumQueueDepth),
+         @(evaluator.numberOfLinesEvaluated),
+         @(evaluator.numberOfPartialLinesDropped));
+    [self setTriggersBacklogged:backlogged];
+}
+
+// Slow down the program rather than the UI: stop reading until triggers catch up. A tmux pane has
+// no PTY of its own, so its backlog suspends reading on the gateway. That holds up every pane in
+// the tmux session, which is the only flow control available.
+- (void)setTriggersBacklogged:(BOOL)backlogged {
+    if (backlogged == _triggersBacklogged) {
+        return;
+    }
+    _triggersBacklogged = backlogged;
+    if (self.isTmuxClient) {
+        [self.tmuxGatewaySession tmuxClientTriggersDidChangeBacklogged:backlogged];
+    } else {
+        [self updateReadingSuspended];
+    }
+}
+
+- (void)tmuxClientTriggersDidChangeBacklogged:(BOOL)backlogged {
+    // Clamped in case a client attached to a different gateway while backlogged.
+    _numberOfTmuxClientsWithTriggersBacklogged = MAX(0, _numberOfTmuxClientsWithTriggersBacklogged + (backlogged ? 1 : -1));
+    [self updateReadingSuspended];
+}
+
+- (void)updateReadingSuspended {
+    _shell.readingSuspended = (_triggersBacklogged || _numberOfTmuxClientsWithTriggersBacklogged > 0);
+}
+
 #pragma mark - iTermCopyModeHandlerDelegate
 
 - (void)copyModeHandlerDidChangeEnabledState:(iTermCopyModeHandler *)handler NOT_COPY_FAMILY {
@@ -16,6 +16,12 @@ extern NSString *kCoprocessStatusChangeNotification;
 // thread before kicking off a possibly async task in the main thread.
 - (void)threadedReadTask:(char *)buffer length:(int)length;
 
+// Runs in the same background thread as -threadedReadTask:length:. Like that method, but the
+// delegate supplies the buffer (sized as it sees fit) and |reader| fills it directly from the fd,
+// returning the number of bytes read. The reader only reads; it takes no locks, so the delegate may
+// call it while holding its own.
+- (void)threadedReadTaskWithReader:(int (^)(char *buffer, int capacity))reader;
+
 // Runs in the same background task as -threadedReadTask:length:.
 - (void)threadedTaskBrokenPipe;
 - (void)brokenPipe;  // Called in main thread
@@ -36,6 +42,9 @@ extern NSString *kCoprocessStatusChangeNotification;
 
 // No reading or writing allowed for now.
 @property(atomic, assign) BOOL paused;
+// Stop reading output while still writing input, e.g., while something downstream of the parser
+// catches up.
+@property(atomic, assign) BOOL readingSuspended;
 @property(nonatomic, readonly) BOOL pidIsChild;
 @property(nonatomic, readonly) pid_t serverPid;
 
@@ -57,6 +66,12 @@ extern NSString *kCoprocessStatusChangeNotification;
 @property(atomic, readonly) BOOL wantsWrite;
 @property(atomic, retain) Coprocess *coprocess;
 @property(atomic, readonly) BOOL writeBufferHasRoom;
+// Bytes passed to -writeTask: that haven't been written to the file descriptor yet. Producers of
+// large amounts of input can wait for this to fall before queueing more.
+@property(atomic, readonly) NSUInteger numberOfBytesQueuedForWriting;
+// Total bytes read from the file descriptor. Comparing it with what was written shows whether the
+// job is echoing its input as fast as it's sent.
+@property(atomic, readonly) long long numberOfBytesRead;
 @property(atomic, readonly) BOOL hasCoprocess;
 @property(nonatomic, readonly) BOOL passwordInput;
 @property(nonatomic) unichar pendingHighSurrogate;
@@ -95,8 +110,12 @@ extern NSString *kCoprocessStatusChangeNotification;
 - (BOOL)startLoggingToFileWithPath:(NSString*)path shouldAppend:(BOOL)shouldAppend;
 - (void)stopLogging;
 - (void)brokenPipe;
-- (void)processRead;
-- (void)processWrite;
+// Called by TaskNotifier when the fd is readable. Returns NO once a read would block; YES means
+// more data may be available and it should be called again.
+- (BOOL)processRead;
+
+// Called by TaskNotifier when the fd is writable. Returns NO if a write would block.
+- (BOOL)processWrite;
 
 - (void)stopCoprocess;
 
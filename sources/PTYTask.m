@@ -5,6 +5,8 @@
 #import "iTermMalloc.h"
 #import "iTermNotificationController.h"
 #import "iTermProcessCache.h"
+#import "iTermSessionLogger.h"
+#import "iTermWriteQueue.h"
 #import "NSWorkspace+iTerm.h"
 #import "PreferencePanel.h"
 #import "PTYTask.h"
@@ -100,8 +102,9 @@ static void HandleSigChld(int n) {
 @interface PTYTask ()
 @property(atomic, assign) BOOL hasMuteCoprocess;
 @property(atomic, assign) BOOL coprocessOnlyTaskIsDead;
-@property(atomic, retain) NSFileHandle *logHandle;
+@property(atomic, retain) iTermSessionLogger *logger;
 @property(nonatomic, copy) NSString *logPath;
+@property(atomic, readwrite) long long numberOfBytesRead;
 @end
 
 @implementation PTYTask {
@@ -114,8 +117,8 @@ static void HandleSigChld(int n) {
     NSString* path;
     BOOL hasOutput;
 
-    NSLock* writeLock;  // protects writeBuffer
-    NSMutableData* writeBuffer;
+    NSLock* writeLock;  // protects writeQueue
+    iTermWriteQueue* writeQueue;
 
 
     Coprocess *coprocess_;  // synchronized (self)
@@ -125,6 +128,7 @@ static void HandleSigChld(int n) {
     // Number of spins of the select loop left before we tell the delegate we were deregistered.
     int _spinsNeeded;
     BOOL _paused;
+    BOOL _readingSuspended;
 
     int _socketFd;  // File descriptor for unix domain socket connected to server. Only safe to close after server is dead.
 
@@ -142,7 +146,7 @@ static void HandleSigChld(int n) {
         _childPid = (pid_t)-1;
         fd = -1;
         _serverChildPid = -1;
-        writeBuffer = [[NSMutableData alloc] init];
+        writeQueue = [[iTermWriteQueue alloc] init];
         writeLock = [[NSLock alloc] init];
     }
     return self;
@@ -169,7 +173,7 @@ static void HandleSigChld(int n) {
     }
 
     [self closeFileDescriptor];
-    [_logHandle closeFile];
+    [_logger close];
 
     @synchronized (self) {
         [[self coprocess] mainProcessDidTerminate];
@@ -197,6 +201,20 @@ static void HandleSigChld(int n) {
     [[TaskNotifier sharedInstance] unblock];
 }
 
+- (BOOL)readingSuspended {
+    @synchronized(self) {
+        return _readingSuspended;
+    }
+}
+
+- (void)setReadingSuspended:(BOOL)readingSuspended {
+    @synchronized(self) {
+        _readingSuspended = readingSuspended;
+    }
+    // Start/stop selecting on our FD
+    [[TaskNotifier sharedInstance] unblock];
+}
+
 - (BOOL)pidIsChild {
     return _serverChildPid == -1 && _childPid != -1;
 }
@@ -234,9 +252,7 @@ static void HandleSigChld(int n) {
 }
 
 - (BOOL)logging {
-    @synchronized(self) {
-        return (_logHandle != nil);
-    }
+    return self.logger != nil;
 }
 
 - (Coprocess *)coprocess {
@@ -251,15 +267,19 @@ static void HandleSigChld(int n) {
         coprocess_ = coprocess;
         self.hasMuteCoprocess = coprocess_.mute;
     }
-    [[TaskNotifier sharedInstance] unblock];
+    [[TaskNotifier sharedInstance] taskDidChangeCoprocess:self];
 }
 
 - (BOOL)writeBufferHasRoom {
     const int kMaxWriteBufferSize = 1024 * 10;
+    return self.numberOfBytesQueuedForWriting < kMaxWriteBufferSize;
+}
+
+- (NSUInteger)numberOfBytesQueuedForWriting {
     [writeLock lock];
-    BOOL hasRoom = [writeBuffer length] < kMaxWriteBufferSize;
+    const NSUInteger length = writeQueue.length;
     [writeLock unlock];
-    return hasRoom;
+    return length;
 }
 
 - (BOOL)hasCoprocess {
@@ -396,11 +416,11 @@ static void HandleSigChld(int n) {
         });
     } else {
         // Write as much as we can now through the non-blocking pipe
-        // Lock to protect the writeBuffer from the IO thread
+        // Lock to protect the writeQueue from the IO thread
         [writeLock lock];
-        [writeBuffer appendData:data];
-        [[TaskNotifier sharedInstance] unblock];
+        [writeQueue appendData:data];
         [writeLock unlock];
+        [[TaskNotifier sharedInstance] taskDidEnqueueWrite:self];
     }
 }
 
@@ -440,7 +460,7 @@ static void HandleSigChld(int n) {
         [self closeFileDescriptor];
         [[TaskNotifier sharedInstance] deregisterTask:self];
         // Require that it spin twice so we can be completely sure that the task won't get called
-        // again. If we add the observer just before select() was going to be called, it wouldn't
+        // again. If we add the observer just before the notifier was going to block, it wouldn't
         // mean anything; but after the second call, we know we've been moved into the dead pool.
         @synchronized(self) {
             _spinsNeeded = 2;
@@ -452,7 +472,7 @@ static void HandleSigChld(int n) {
         // Force a spin
         [[TaskNotifier sharedInstance] unblock];
 
-        // This isn't an atomic update, but select() should be resilient to
+        // This isn't an atomic update, but the notifier should be resilient to
         // being passed a half-broken fd. We must change it because after this
         // function returns, a new task may be created with this fd and then
         // the select thread wouldn't know which task a fd belongs to.
@@ -465,20 +485,32 @@ static void HandleSigChld(int n) {
 
 - (BOOL)startLoggingToFileWithPath:(NSString*)aPath shouldAppend:(BOOL)shouldAppend {
     @synchronized(self) {
-        self.logPath = [aPath stringByStandardizingPath];
-
-        [_logHandle closeFile];
-        self.logHandle = [NSFileHandle fileHandleForWritingAtPath:_logPath];
-        if (_logHandle == nil) {
-            NSFileManager *fileManager = [NSFileManager defaultManager];
-            [fileManager createFileAtPath:_logPath contents:nil attributes:nil];
-            self.logHandle = [NSFileHandle fileHandleForWritingAtPath:_logPath];
-        }
-        if (shouldAppend) {
-            [_logHandle seekToEndOfFile];
-        } else {
-            [_logHandle truncateFileAtOffset:0];
+        [self.logger close];
+
+        NSString *logPath = [aPath stringByStandardizingPath];
+        const BOOL compress = [iTermAdvancedSettingsModel compressSessionLogs];
+        if (compress && ![logPath.pathExtension isEqualToString:@"gz"]) {
+            logPath = [logPath stringByAppendingPathExtension:@"gz"];
         }
+        self.logPath = logPath;
+        iTermSessionLogger *logger =
+            [[iTermSessionLogger alloc] initWithPath:logPath
+                                              append:shouldAppend
+                                            compress:compress
+                                          bufferSize:(NSUInteger)[iTermAdvancedSettingsModel sessionLogBufferMegabytes] * 1024 * 1024];
+        logger.maximumFileSize = (long long)[iTermAdvancedSettingsModel maximumSessionLogMegabytes] * 1024 * 1024;
+        logger.dropsBytesWhenFull = [iTermAdvancedSettingsModel dropSessionLogOutputWhenBehind];
+        logger.didCatchUp = ^{
+            // wantsRead changed.
+            [[TaskNotifier sharedInstance] unblock];
+        };
+        logger.didDropBytes = ^{
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [[iTermNotificationController sharedInstance] notify:@"Session log is incomplete"
+                                                     withDescription:[NSString stringWithFormat:@"Output could not be written to %@ fast enough and some of it was left out.", logPath]];
+            });
+        };
+        self.logger = logger;
 
         return self.logging;
     }
@@ -486,9 +518,9 @@ static void HandleSigChld(int n) {
 
 - (void)stopLogging {
     @synchronized(self) {
-        [_logHandle closeFile];
+        [self.logger close];
         self.logPath = nil;
-        self.logHandle = nil;
+        self.logger = nil;
     }
 }
 
@@ -498,67 +530,86 @@ static void HandleSigChld(int n) {
     [self.delegate threadedTaskBrokenPipe];
 }
 
-- (void)processRead {
-    int iterations = 4;
-    int bytesRead = 0;
-
-    char buffer[MAXRW * iterations];
-    for (int i = 0; i < iterations; ++i) {
-        // Only read up to MAXRW*iterations bytes, then release control
-        ssize_t n = read(fd, buffer + bytesRead, MAXRW);
-        if (n < 0) {
-            // There was a read error.
-            if (errno != EAGAIN && errno != EINTR) {
-                // It was a serious error.
-                [self brokenPipe];
-                return;
-            } else {
-                // We could read again in the case of EINTR but it would
-                // complicate the code with little advantage. Just bail out.
-                n = 0;
+- (BOOL)processRead {
+    __block BOOL mayHaveMore = YES;
+    __block BOOL eof = NO;
+    __block BOOL error = NO;
+    const int fd = self.fd;
+    // The reader runs while the parser holds its lock, so it must not take the logger's or the
+    // coprocess's locks. When the bytes are needed for either, it copies them and the fan-out
+    // happens after the delegate returns.
+    const BOOL wantsBytes = self.logger != nil || self.hasCoprocess;
+    __block NSData *bytesForFanOut = nil;
+    int (^reader)(char *, int) = ^int(char *buffer, int capacity) {
+        int bytesRead = 0;
+        while (bytesRead < capacity) {
+            // TaskNotifier's file descriptor registrations are edge-triggered, so keep reading
+            // until the kernel reports there is nothing left (or the buffer fills and the notifier
+            // must call us again).
+            ssize_t n = read(fd, buffer + bytesRead, capacity - bytesRead);
+            if (n < 0) {
+                // There was a read error.
+                if (errno != EAGAIN && errno != EINTR) {
+                    // It was a serious error.
+                    error = YES;
+                    mayHaveMore = NO;
+                } else if (errno == EAGAIN) {
+                    mayHaveMore = NO;
+                }
+                // On EINTR, try again on the next spin.
+                break;
             }
+            if (n == 0) {
+                // End of file. There won't be another edge, so treat it like a broken pipe.
+                mayHaveMore = NO;
+                eof = YES;
+                break;
+            }
+            bytesRead += n;
         }
-        bytesRead += n;
-        if (n < MAXRW) {
-            // If we read fewer bytes than expected, return. For some apparently
-            // undocumented reason, read() never returns more than 1024 bytes
-            // (at least on OS 10.6), so that's what MAXRW is set to. If that
-            // ever goes down this'll break.
-            break;
+        if (bytesRead > 0) {
+            // Only the TaskNotifier thread reads, so this doesn't race with itself.
+            self.numberOfBytesRead += bytesRead;
+            if (wantsBytes) {
+                bytesForFanOut = [NSData dataWithBytes:buffer length:bytesRead];
+            }
         }
+        return bytesRead;
+    };
+
+    id<PTYTaskDelegate> delegate = self.delegate;
+    if (delegate) {
+        // The delegate lends us its parser's buffer so the bytes are only copied once.
+        [delegate threadedReadTaskWithReader:reader];
+    } else {
+        char buffer[MAXRW * 4];
+        reader(buffer, sizeof(buffer));
+    }
+    if (bytesForFanOut) {
+        [self didReadBytes:bytesForFanOut];
     }
 
     hasOutput = YES;
 
-    // Send data to the terminal
-    [self readTask:buffer length:bytesRead];
+    if (error || eof) {
+        [self brokenPipe];
+    }
+    return mayHaveMore;
 }
 
-- (void)processWrite {
-    // Retain to prevent the object from being released during this method
-    // Lock to protect the writeBuffer from the main thread
+- (BOOL)processWrite {
+    // Lock to protect the writeQueue from the main thread
     [writeLock lock];
+    // Write until the queue is empty or the kernel's buffer is full.
+    BOOL wouldBlock = NO;
+    const ssize_t written = [writeQueue writeToFileDescriptor:fd wouldBlock:&wouldBlock];
+    [writeLock unlock];
 
-    // Only write up to MAXRW bytes, then release control
-    char* ptr = [writeBuffer mutableBytes];
-    unsigned int length = [writeBuffer length];
-    if (length > MAXRW) {
-        length = MAXRW;
-    }
-    ssize_t written = write(fd, [writeBuffer mutableBytes], length);
-
-    // No data?
-    if ((written < 0) && (!(errno == EAGAIN || errno == EINTR))) {
+    if (written < 0) {
         [self brokenPipe];
-    } else if (written > 0) {
-        // Shrink the writeBuffer
-        length = [writeBuffer length] - written;
-        memmove(ptr, ptr+written, length);
-        [writeBuffer setLength:length];
+        return NO;
     }
-
-    // Clean up locks
-    [writeLock unlock];
+    return !wouldBlock;
 }
 
 - (void)stopCoprocess {
@@ -580,17 +631,9 @@ static void HandleSigChld(int n) {
 }
 
 - (void)logData:(const char *)buffer length:(int)length {
-    @synchronized(self) {
-        if ([self logging]) {
-            @try {
-                [_logHandle writeData:[NSData dataWithBytes:buffer
-                                                     length:length]];
-            } @catch (NSException *exception) {
-                DLog(@"Exception while logging %@ bytes of data: %@", @(length), exception);
-                [self stopLogging];
-            }
-        }
-    }
+    // This doesn't wait for the disk. If the logger can't keep up, wantsRead stops further reads
+    // until it does (or it drops the bytes, if so configured).
+    [self.logger logBytes:buffer length:length];
 }
 
 - (BOOL)tryToAttachToServerWithProcessId:(pid_t)thePid {
@@ -1023,34 +1066,28 @@ static void HandleSigChld(int n) {
 #pragma mark I/O
 
 - (BOOL)wantsRead {
-    return !self.paused;
+    return !self.paused && !self.readingSuspended && !self.logger.isBehind;
 }
 
 - (BOOL)wantsWrite {
     if (self.paused) {
         return NO;
     }
-    [writeLock lock];
-    BOOL wantsWrite = [writeBuffer length] > 0;
-    [writeLock unlock];
-    return wantsWrite;
+    return self.numberOfBytesQueuedForWriting > 0;
 }
 
 - (BOOL)hasOutput {
     return hasOutput;
 }
 
-// The bytes in data were just read from the fd.
-- (void)readTask:(char *)buffer length:(int)length {
-    [self logData:buffer length:length];
-
-    // The delegate is responsible for parsing VT100 tokens here and sending them off to the
-    // main thread for execution. If its queues get too large, it can block.
-    [self.delegate threadedReadTask:buffer length:length];
+// The bytes in data were just read from the fd. This gets called after the delegate has taken
+// them, outside the parser's lock.
+- (void)didReadBytes:(NSData *)data {
+    [self logData:data.bytes length:(int)data.length];
 
     @synchronized (self) {
         if (coprocess_) {
-            [coprocess_.outputBuffer appendData:[NSData dataWithBytes:buffer length:length]];
+            [coprocess_.outputBuffer appendData:data];
         }
     }
 }
@@ -1112,7 +1149,7 @@ static void HandleSigChld(int n) {
         unblock = (--_spinsNeeded) > 0;
     }
     if (unblock) {
-        // Force select() to return so we get another spin even if there is no
+        // Force the notifier to wake up so we get another spin even if there is no
         // activity on the file descriptors.
         [[TaskNotifier sharedInstance] unblock];
     } else {
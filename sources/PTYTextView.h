@@ -144,7 +144,8 @@ typedef NS_ENUM(NSInteger, PTYTextViewSelectionExtensionUnit) {
 - (void)textViewStopCoprocess;
 - (void)textViewPostTabContentsChangedNotification;
 - (void)textViewInvalidateRestorableState;
-- (void)textViewDidFindDirtyRects;
+// |lines| holds the absolute line numbers of the lines that changed.
+- (void)textViewDidFindDirtyRectsOnLines:(NSIndexSet *)lines;
 - (void)textViewBeginDrag;
 - (void)textViewMovePane;
 - (void)textViewSwapPane;
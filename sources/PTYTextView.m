@@ -5705,16 +5705,21 @@ scrollToFirstResult:(BOOL)scrollToFirstResult {
     }
 
     // Remove results from dirty lines and mark parts of the view as needing display.
+    // Absolute line numbers of the dirty lines.
+    NSMutableIndexSet *dirtyLines = [NSMutableIndexSet indexSet];
     if (allDirty) {
         foundDirty = YES;
         [_findOnPageHelper removeHighlightsInRange:NSMakeRange(lineStart + totalScrollbackOverflow,
                                                                lineEnd - lineStart)];
+        [dirtyLines addIndexesInRange:NSMakeRange(lineStart + totalScrollbackOverflow,
+                                                  lineEnd - lineStart)];
         [self setNeedsDisplayInRect:[self gridRect]];
     } else {
         for (int y = lineStart; y < lineEnd; y++) {
             VT100GridRange range = [_dataSource dirtyRangeForLine:y - lineStart];
             if (range.length > 0) {
                 foundDirty = YES;
+                [dirtyLines addIndex:y + totalScrollbackOverflow];
                 [_findOnPageHelper removeHighlightsInRange:NSMakeRange(y + totalScrollbackOverflow, 1)];
                 [_findOnPageHelper removeSearchResultsInRange:NSMakeRange(y + totalScrollbackOverflow, 1)];
                 [self setNeedsDisplayOnLine:y inRange:range];
@@ -5742,7 +5747,7 @@ scrollToFirstResult:(BOOL)scrollToFirstResult {
     if (foundDirty) {
         [_dataSource saveToDvr];
         [_delegate textViewInvalidateRestorableState];
-        [_delegate textViewDidFindDirtyRects];
+        [_delegate textViewDidFindDirtyRectsOnLines:dirtyLines];
     }
 
     if (foundDirty && [_dataSource shouldSendContentsChangedNotification]) {
@@ -18,6 +18,10 @@
 @property(nonatomic, copy) void (^progress)(NSInteger);
 @property(nonatomic, assign) NSInteger bytesWritten;
 
+// Adaptive pastes ignore the preferences and size each chunk from how quickly the session takes
+// input and echoes it back.
+@property(nonatomic, assign) BOOL adaptive;
+
 - (instancetype)initWithBytesPerCallPrefKey:(NSString*)bytesPerCallKey
                      defaultValue:(int)bytesPerCallDefault
          delayBetweenCallsPrefKey:(NSString*)delayBetweenCallsKey
@@ -25,4 +29,10 @@
 
 - (void)updateValues;
 
+// For adaptive pastes. Call before each chunk with the number of bytes written to the session that
+// it hasn't taken yet and the total number of bytes it has output. Updates bytesPerCall and
+// delayBetweenCalls and returns the number of bytes to write now, which may be 0.
+- (NSInteger)numberOfBytesToWriteWithBytesQueued:(NSUInteger)bytesQueued
+                                       bytesRead:(long long)bytesRead;
+
 @end
@@ -7,14 +7,36 @@
 //
 
 #import "PasteContext.h"
+#import "DebugLogging.h"
 #import "iTermAdvancedSettingsModel.h"
 
+// Bounds on the number of bytes an adaptive paste keeps in flight.
+static const int kAdaptiveMinimumBytesPerCall = 1024;
+static const int kAdaptiveMaximumBytesPerCall = 1024 * 1024;
+
+static const float kAdaptiveMinimumDelay = 0.001;
+static const float kAdaptiveMaximumDelay = 0.05;
+
+// Once the session has echoed something, it may fall this far behind what it was sent before the
+// paste waits for it.
+static const long long kAdaptiveMaximumEchoLag = 64 * 1024;
+
+// A session that is behind and echoes nothing for this long probably doesn't echo what's pasted
+// (e.g., it redraws only part of what it reads), so echo stops pacing the paste.
+static const NSTimeInterval kAdaptiveEchoStallTimeout = 0.25;
+
 @interface PasteContext ()
 @property(nonatomic, copy) NSString *bytesPerCallKey;
 @property(nonatomic, copy) NSString *delayBetweenCallsKey;
 @end
 
-@implementation PasteContext
+@implementation PasteContext {
+    BOOL _adaptiveStarted;
+    long long _initialBytesRead;
+    long long _lastBytesRead;
+    NSTimeInterval _lastEchoTime;
+    BOOL _ignoresEcho;
+}
 
 - (instancetype)initWithBytesPerCallPrefKey:(NSString*)bytesPerCallKey
                      defaultValue:(int)bytesPerCallDefault
@@ -40,6 +62,9 @@
 }
 
 - (void)updateValues {
+    if (_adaptive) {
+        return;
+    }
     if (_isUpload && [iTermAdvancedSettingsModel accelerateUploads]) {
         _bytesPerCall = 40960;
         _delayBetweenCalls = 0.01;
@@ -53,6 +78,47 @@
     }
 }
 
+- (NSInteger)numberOfBytesToWriteWithBytesQueued:(NSUInteger)bytesQueued
+                                       bytesRead:(long long)bytesRead {
+    const NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    if (!_adaptiveStarted) {
+        _adaptiveStarted = YES;
+        _initialBytesRead = bytesRead;
+        _lastBytesRead = bytesRead;
+        _lastEchoTime = now;
+        _bytesPerCall = kAdaptiveMinimumBytesPerCall;
+        _delayBetweenCalls = kAdaptiveMinimumDelay;
+    }
+    if (bytesRead != _lastBytesRead) {
+        _lastBytesRead = bytesRead;
+        _lastEchoTime = now;
+    }
+
+    // A session that echoes its input (e.g., a shell on a slow remote host) shows how fast it's
+    // really reading, even when something in between takes input faster.
+    const long long echoed = bytesRead - _initialBytesRead;
+    const long long delivered = _bytesWritten - (long long)bytesQueued;
+    if (!_ignoresEcho && echoed > 0 && delivered - echoed > kAdaptiveMaximumEchoLag) {
+        if (now - _lastEchoTime < kAdaptiveEchoStallTimeout) {
+            DLog(@"Wait for echo. %@ bytes behind.", @(delivered - echoed));
+            _delayBetweenCalls = MIN(_delayBetweenCalls * 2, kAdaptiveMaximumDelay);
+            return 0;
+        }
+        DLog(@"Nothing echoed for %@ sec. Stop pacing by echo.", @(now - _lastEchoTime));
+        _ignoresEcho = YES;
+    }
+
+    // Grow while the PTY takes everything it's given and back off while input piles up.
+    if (bytesQueued == 0) {
+        _bytesPerCall = MIN(_bytesPerCall * 2, kAdaptiveMaximumBytesPerCall);
+        _delayBetweenCalls = kAdaptiveMinimumDelay;
+    } else if (bytesQueued > (NSUInteger)_bytesPerCall / 2) {
+        _bytesPerCall = MAX(_bytesPerCall / 2, kAdaptiveMinimumBytesPerCall);
+        _delayBetweenCalls = MIN(_delayBetweenCalls * 2, kAdaptiveMaximumDelay);
+    }
+    return MAX(0, (NSInteger)_bytesPerCall - (NSInteger)bytesQueued);
+}
+
 - (void)setBytesPerCall:(int)newBytesPerCall {
     _bytesPerCall = newBytesPerCall;
     if (_bytesPerCallKey) {
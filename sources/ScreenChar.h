@@ -340,7 +340,8 @@ static inline BOOL ScreenCharHasDefaultAttributesAndColors(const screen_char_t s
 
 @end
 
-// Look up the string associated with a complex char's key.
+// Look up the string associated with a complex char's key. The result is autoreleased, so it stays
+// valid even if the key is reused by another thread.
 NSString* ComplexCharToStr(int key);
 BOOL ComplexCharCodeIsSpacingCombiningMark(unichar code);
 
@@ -37,6 +37,8 @@
 #import "iTermMalloc.h"
 #import "NSCharacterSet+iTerm.h"
 
+#import <os/lock.h>
+
 static NSString *const kScreenCharComplexCharMapKey = @"Complex Char Map";
 static NSString *const kScreenCharSpacingCombiningMarksKey = @"Spacing Combining Marks";
 static NSString *const kScreenCharInverseComplexCharMapKey = @"Inverse Complex Char Map";
@@ -44,11 +46,43 @@ static NSString *const kScreenCharImageMapKey = @"Image Map";
 static NSString *const kScreenCharCCMNextKeyKey = @"Next Key";
 static NSString *const kScreenCharHasWrappedKey = @"Has Wrapped";
 
-// Maps codes to strings
-static NSMutableDictionary* complexCharMap;
-static NSMutableSet<NSNumber *> *spacingCombiningMarkCodeNumbers;
-// Maps strings to codes.
-static NSMutableDictionary* inverseComplexCharMap;
+// Complex chars live in a flat table indexed by code, split into lazily allocated pages. Any
+// thread may look up a code's string without locking: entries are fully written before their
+// string is published, and a string that gets replaced is released only once no reader can still
+// be between loading it and retaining it (see gComplexCharReaders). A string-to-code index using
+// open addressing finds existing codes for new strings. Everything that adds codes holds
+// gComplexCharLock.
+#define kComplexCharMaxKey 0xf000
+#define kComplexCharPageSize 256
+
+typedef struct {
+    NSString *string;  // Retained. nil if the code is unused.
+    uint32_t hash;
+    // UTF-16 length of |string|. The characters are kept here so lookups can compare them without
+    // going through NSString, unless it's longer than kMaxParts.
+    int length;
+    BOOL isSpacingCombiningMark;
+    unichar characters[kMaxParts];
+} iTermComplexCharEntry;
+
+static os_unfair_lock gComplexCharLock = OS_UNFAIR_LOCK_INIT;
+static iTermComplexCharEntry *gComplexCharPages[kComplexCharMaxKey / kComplexCharPageSize];
+
+// Maps strings to codes. Slots hold a code, 0 for never used, or kComplexCharIndexTombstone.
+#define kComplexCharIndexTombstone 0xffff
+static uint16_t *gComplexCharIndex;
+static int gComplexCharIndexCapacity;  // Always a power of 2.
+static int gComplexCharIndexCount;
+static int gComplexCharIndexTombstones;
+
+// Number of threads that may be between loading an entry's string and retaining (or copying) it.
+// Readers increment it before the load and decrement it after; all accesses are sequentially
+// consistent. A writer that unpublishes a string and then sees zero knows that every later reader
+// will load the replacement, so the old string can be released.
+static int gComplexCharReaders;
+// Strings whose codes were reused but which a reader might still be about to retain. Released the
+// next time a code is reused while no reads are in progress. Protected by gComplexCharLock.
+static NSMutableArray<NSString *> *gRetiredComplexCharStrings;
 // Image info. Maps a NSNumber with the image's code to an ImageInfo object.
 static NSMutableDictionary* gImages;
 static NSMutableDictionary* gEncodableImageMap;
@@ -166,11 +200,199 @@ iTermTriState iTermTriStateFromBool(BOOL b) {
 
 @end
 
-static void CreateComplexCharMapIfNeeded() {
-    if (!complexCharMap) {
-        complexCharMap = [[NSMutableDictionary alloc] initWithCapacity:1000];
-        spacingCombiningMarkCodeNumbers = [[NSMutableSet alloc] initWithCapacity:1000];
-        inverseComplexCharMap = [[NSMutableDictionary alloc] initWithCapacity:1000];
+static iTermComplexCharEntry *ComplexCharEntry(int key) {
+    if (key <= 0 || key >= kComplexCharMaxKey) {
+        return NULL;
+    }
+    iTermComplexCharEntry *page = __atomic_load_n(&gComplexCharPages[key / kComplexCharPageSize],
+                                                  __ATOMIC_ACQUIRE);
+    if (!page) {
+        return NULL;
+    }
+    return &page[key % kComplexCharPageSize];
+}
+
+// Must hold gComplexCharLock.
+static iTermComplexCharEntry *ComplexCharEntryAllocatingIfNeeded(int key) {
+    iTermComplexCharEntry *entry = ComplexCharEntry(key);
+    if (entry) {
+        return entry;
+    }
+    iTermComplexCharEntry *page = calloc(kComplexCharPageSize, sizeof(iTermComplexCharEntry));
+    __atomic_store_n(&gComplexCharPages[key / kComplexCharPageSize], page, __ATOMIC_RELEASE);
+    return &page[key % kComplexCharPageSize];
+}
+
+// FNV-1a over UTF-16 code units.
+static uint32_t ComplexCharHash(const unichar *characters, int length) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash = (hash ^ characters[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static BOOL ComplexCharEntryEquals(const iTermComplexCharEntry *entry,
+                                   uint32_t hash,
+                                   NSString *string,
+                                   const unichar *characters,
+                                   int length) {
+    if (entry->hash != hash || entry->length != length) {
+        return NO;
+    }
+    if (length <= kMaxParts) {
+        return !memcmp(entry->characters, characters, length * sizeof(unichar));
+    }
+    return [entry->string isEqualToString:string];
+}
+
+// Returns the index slot holding |string| or, if it's absent, the slot it should be inserted at.
+// Must hold gComplexCharLock.
+static int ComplexCharIndexSlot(uint32_t hash, NSString *string, const unichar *characters, int length) {
+    const int mask = gComplexCharIndexCapacity - 1;
+    int insertionSlot = -1;
+    for (int i = hash & mask; ; i = (i + 1) & mask) {
+        const uint16_t key = gComplexCharIndex[i];
+        if (key == 0) {
+            return insertionSlot >= 0 ? insertionSlot : i;
+        }
+        if (key == kComplexCharIndexTombstone) {
+            if (insertionSlot < 0) {
+                insertionSlot = i;
+            }
+            continue;
+        }
+        if (ComplexCharEntryEquals(ComplexCharEntry(key), hash, string, characters, length)) {
+            return i;
+        }
+    }
+}
+
+// Makes room for one more code, rebuilding the index from the table if it's getting crowded.
+// Must hold gComplexCharLock.
+static void ComplexCharIndexReserve(void) {
+    if ((gComplexCharIndexCount + gComplexCharIndexTombstones + 1) * 2 <= gComplexCharIndexCapacity) {
+        return;
+    }
+    int capacity = 1024;
+    while (capacity < (gComplexCharIndexCount + 1) * 4) {
+        capacity *= 2;
+    }
+    free(gComplexCharIndex);
+    gComplexCharIndex = calloc(capacity, sizeof(*gComplexCharIndex));
+    gComplexCharIndexCapacity = capacity;
+    gComplexCharIndexCount = 0;
+    gComplexCharIndexTombstones = 0;
+    const int mask = capacity - 1;
+    for (int key = 1; key < kComplexCharMaxKey; key++) {
+        iTermComplexCharEntry *entry = ComplexCharEntry(key);
+        if (!entry || !entry->string) {
+            continue;
+        }
+        int i = entry->hash & mask;
+        while (gComplexCharIndex[i]) {
+            i = (i + 1) & mask;
+        }
+        gComplexCharIndex[i] = key;
+        gComplexCharIndexCount++;
+    }
+}
+
+// Returns the code for |string| or 0 if it has none. Must hold gComplexCharLock.
+static int ComplexCharLookUp(uint32_t hash, NSString *string, const unichar *characters, int length) {
+    if (!gComplexCharIndex) {
+        return 0;
+    }
+    const uint16_t key = gComplexCharIndex[ComplexCharIndexSlot(hash, string, characters, length)];
+    return key == kComplexCharIndexTombstone ? 0 : key;
+}
+
+// Removes |key|'s string from the table so the code can be reused. Must hold gComplexCharLock.
+static void ComplexCharRemove(int key) {
+    iTermComplexCharEntry *entry = ComplexCharEntry(key);
+    if (!entry || !entry->string) {
+        return;
+    }
+    const int mask = gComplexCharIndexCapacity - 1;
+    for (int i = entry->hash & mask; gComplexCharIndex[i]; i = (i + 1) & mask) {
+        if (gComplexCharIndex[i] == key) {
+            gComplexCharIndex[i] = kComplexCharIndexTombstone;
+            gComplexCharIndexCount--;
+            gComplexCharIndexTombstones++;
+            break;
+        }
+    }
+    NSString *retired = entry->string;
+    __atomic_store_n(&entry->string, nil, __ATOMIC_SEQ_CST);
+    entry->isSpacingCombiningMark = NO;
+
+    if (!gRetiredComplexCharStrings) {
+        gRetiredComplexCharStrings = [[NSMutableArray alloc] init];
+    }
+    [gRetiredComplexCharStrings addObject:retired];
+    [retired release];
+    if (__atomic_load_n(&gComplexCharReaders, __ATOMIC_SEQ_CST) == 0) {
+        [gRetiredComplexCharStrings removeAllObjects];
+    }
+}
+
+// Calls |block| with |key|'s string (or nil). The string is guaranteed to stay alive until |block|
+// returns; retain it to keep it longer.
+static void ComplexCharWithString(int key, void (^NS_NOESCAPE block)(NSString *string)) {
+    iTermComplexCharEntry *entry = ComplexCharEntry(key);
+    if (!entry) {
+        block(nil);
+        return;
+    }
+    __atomic_add_fetch(&gComplexCharReaders, 1, __ATOMIC_SEQ_CST);
+    block(__atomic_load_n(&entry->string, __ATOMIC_SEQ_CST));
+    __atomic_sub_fetch(&gComplexCharReaders, 1, __ATOMIC_SEQ_CST);
+}
+
+// Assigns |string| to the unused code |key|. Must hold gComplexCharLock.
+static void ComplexCharInsert(int key,
+                              NSString *string,
+                              uint32_t hash,
+                              const unichar *characters,
+                              int length,
+                              BOOL isSpacingCombiningMark) {
+    ComplexCharIndexReserve();
+    iTermComplexCharEntry *entry = ComplexCharEntryAllocatingIfNeeded(key);
+    entry->hash = hash;
+    entry->length = length;
+    entry->isSpacingCombiningMark = isSpacingCombiningMark;
+    if (length <= kMaxParts) {
+        memcpy(entry->characters, characters, length * sizeof(unichar));
+    }
+    // Publish the string last so readers never see a half-written entry.
+    __atomic_store_n(&entry->string, [string copy], __ATOMIC_RELEASE);
+
+    const int slot = ComplexCharIndexSlot(hash, string, characters, length);
+    const uint16_t existing = gComplexCharIndex[slot];
+    if (existing != 0 && existing != kComplexCharIndexTombstone) {
+        // Restored state can give one string two codes. The index only needs one of them.
+        return;
+    }
+    if (existing == kComplexCharIndexTombstone) {
+        gComplexCharIndexTombstones--;
+    }
+    gComplexCharIndex[slot] = key;
+    gComplexCharIndexCount++;
+}
+
+// Calls |block| with |string|'s UTF-16 code units.
+static void ComplexCharWithCharacters(NSString *string,
+                                      void (^NS_NOESCAPE block)(const unichar *characters, int length)) {
+    const int length = (int)string.length;
+    unichar stackBuffer[64];
+    unichar *characters = stackBuffer;
+    if (length > (int)(sizeof(stackBuffer) / sizeof(*stackBuffer))) {
+        characters = iTermMalloc(length * sizeof(unichar));
+    }
+    [string getCharacters:characters range:NSMakeRange(0, length)];
+    block(characters, length);
+    if (characters != stackBuffer) {
+        free(characters);
     }
 }
 
@@ -179,12 +401,16 @@ NSString *ComplexCharToStr(int key) {
         return ReplacementString();
     }
 
-    CreateComplexCharMapIfNeeded();
-    return [complexCharMap objectForKey:[NSNumber numberWithInt:key]];
+    __block NSString *result = nil;
+    ComplexCharWithString(key, ^(NSString *string) {
+        result = [string retain];
+    });
+    return [result autorelease];
 }
 
 BOOL ComplexCharCodeIsSpacingCombiningMark(unichar code) {
-    return [spacingCombiningMarkCodeNumbers containsObject:@(code)];
+    iTermComplexCharEntry *entry = ComplexCharEntry(code);
+    return entry && entry->isSpacingCombiningMark;
 }
 
 NSString *ScreenCharToStr(const screen_char_t *const sct) {
@@ -208,7 +434,15 @@ int ExpandScreenChar(screen_char_t* sct, unichar* dest) {
     if (sct->code == UNICODE_REPLACEMENT_CHAR) {
         value = ReplacementString();
     } else if (sct->complexChar) {
-        value = ComplexCharToStr(sct->code);
+        // This is hot, so copy the characters out while the string is pinned rather than paying
+        // for a retain and autorelease.
+        __block int length = 0;
+        ComplexCharWithString(sct->code, ^(NSString *string) {
+            [string getCharacters:dest];
+            length = (int)string.length;
+        });
+        // length is 0 if state restoration went awry.
+        return length;
     } else {
         *dest = sct->code;
         return 1;
@@ -237,6 +471,19 @@ static BOOL ComplexCharKeyIsReserved(int k) {
     return k >= iTermBoxDrawingCodeMin && k <= iTermBoxDrawingCodeMax;
 }
 
+// Returns the next code for a complex char or image. Must hold gComplexCharLock.
+static int ComplexCharAllocateKey(void) {
+    int newKey;
+    do {
+        if (ccmNextKey >= kComplexCharMaxKey) {
+            ccmNextKey = 1;
+            hasWrapped = YES;
+        }
+        newKey = ccmNextKey++;
+    } while (ComplexCharKeyIsReserved(newKey));
+    return newKey;
+}
+
 static void AllocateImageMapsIfNeeded(void) {
     if (!gImages) {
         gImages = [[NSMutableDictionary alloc] init];
@@ -250,10 +497,9 @@ screen_char_t ImageCharForNewImage(NSString *name,
                                    BOOL preserveAspectRatio,
                                    NSEdgeInsets inset) {
     AllocateImageMapsIfNeeded();
-    int newKey;
-    do {
-        newKey = ccmNextKey++;
-    } while (ComplexCharKeyIsReserved(newKey));
+    os_unfair_lock_lock(&gComplexCharLock);
+    const int newKey = ComplexCharAllocateKey();
+    os_unfair_lock_unlock(&gComplexCharLock);
 
     screen_char_t c;
     memset(&c, 0, sizeof(c));
@@ -301,47 +547,40 @@ VT100GridCoord GetPositionOfImageInChar(screen_char_t c) {
 
 int GetOrSetComplexChar(NSString *str,
                         iTermTriState isSpacingCombiningMark) {
-    CreateComplexCharMapIfNeeded();
-    NSNumber *number = inverseComplexCharMap[str];
-    if (number) {
-        return [number intValue];
-    }
-
-    int newKey;
-    do {
-        newKey = ccmNextKey++;
-    } while (ComplexCharKeyIsReserved(newKey));
+    __block int newKey = 0;
+    __block BOOL added = NO;
+    ComplexCharWithCharacters(str, ^(const unichar *characters, int length) {
+        const uint32_t hash = ComplexCharHash(characters, length);
+        os_unfair_lock_lock(&gComplexCharLock);
+        newKey = ComplexCharLookUp(hash, str, characters, length);
+        if (newKey) {
+            os_unfair_lock_unlock(&gComplexCharLock);
+            return;
+        }
 
-    number = @(newKey);
-    if (hasWrapped) {
-        NSString* oldStr = complexCharMap[number];
-        if (oldStr) {
-            [inverseComplexCharMap removeObjectForKey:oldStr];
-            [spacingCombiningMarkCodeNumbers removeObject:number];
+        newKey = ComplexCharAllocateKey();
+        if (hasWrapped) {
+            ComplexCharRemove(newKey);
         }
-    }
-    switch (isSpacingCombiningMark) {
-        case iTermTriStateTrue:
-            [spacingCombiningMarkCodeNumbers addObject:number];
-            break;
-        case iTermTriStateFalse:
-            break;
-        case iTermTriStateOther: {
-            NSCharacterSet *scmSet = [NSCharacterSet spacingCombiningMarksForUnicodeVersion:12];
-            if ([str rangeOfCharacterFromSet:scmSet].location != NSNotFound) {
-                [spacingCombiningMarkCodeNumbers addObject:number];
+        BOOL scm = NO;
+        switch (isSpacingCombiningMark) {
+            case iTermTriStateTrue:
+                scm = YES;
+                break;
+            case iTermTriStateFalse:
+                break;
+            case iTermTriStateOther: {
+                NSCharacterSet *scmSet = [NSCharacterSet spacingCombiningMarksForUnicodeVersion:12];
+                scm = ([str rangeOfCharacterFromSet:scmSet].location != NSNotFound);
             }
         }
-    }
-    complexCharMap[number] = str;
-    inverseComplexCharMap[str] = number;
-    if ([iTermAdvancedSettingsModel restoreWindowContents]) {
+        ComplexCharInsert(newKey, str, hash, characters, length, scm);
+        os_unfair_lock_unlock(&gComplexCharLock);
+        added = YES;
+    });
+    if (added && [iTermAdvancedSettingsModel restoreWindowContents]) {
         [NSApp invalidateRestorableState];
     }
-    if (ccmNextKey == 0xf000) {
-        ccmNextKey = 1;
-        hasWrapped = YES;
-    }
     return newKey;
 }
 
@@ -350,7 +589,7 @@ int AppendToComplexChar(int key, unichar codePoint) {
         return UNICODE_REPLACEMENT_CHAR;
     }
 
-    NSString* str = [complexCharMap objectForKey:[NSNumber numberWithInt:key]];
+    NSString* str = ComplexCharToStr(key);
     if ([str length] == kMaxParts) {
         NSLog(@"Warning: char <<%@>> with key %d reached max length %d", str,
               key, kMaxParts);
@@ -702,33 +941,62 @@ void ConvertCharsToGraphicsCharset(screen_char_t *s, int len)
 }
 
 NSDictionary *ScreenCharEncodedRestorableState(void) {
-    return @{ kScreenCharComplexCharMapKey: complexCharMap ?: @{},
-              kScreenCharSpacingCombiningMarksKey: spacingCombiningMarkCodeNumbers.allObjects ?: @[],
-              kScreenCharInverseComplexCharMapKey: inverseComplexCharMap ?: @{},
+    // The inverse map is redundant but is kept so older versions can restore this state.
+    NSMutableDictionary<NSNumber *, NSString *> *complexCharMap = [NSMutableDictionary dictionary];
+    NSMutableDictionary<NSString *, NSNumber *> *inverseComplexCharMap = [NSMutableDictionary dictionary];
+    NSMutableArray<NSNumber *> *spacingCombiningMarks = [NSMutableArray array];
+    os_unfair_lock_lock(&gComplexCharLock);
+    for (int key = 1; key < kComplexCharMaxKey; key++) {
+        iTermComplexCharEntry *entry = ComplexCharEntry(key);
+        if (!entry || !entry->string) {
+            continue;
+        }
+        complexCharMap[@(key)] = entry->string;
+        inverseComplexCharMap[entry->string] = @(key);
+        if (entry->isSpacingCombiningMark) {
+            [spacingCombiningMarks addObject:@(key)];
+        }
+    }
+    const int nextKey = ccmNextKey;
+    const BOOL wrapped = hasWrapped;
+    os_unfair_lock_unlock(&gComplexCharLock);
+
+    return @{ kScreenCharComplexCharMapKey: complexCharMap,
+              kScreenCharSpacingCombiningMarksKey: spacingCombiningMarks,
+              kScreenCharInverseComplexCharMapKey: inverseComplexCharMap,
               kScreenCharImageMapKey: gEncodableImageMap ?: @{},
-              kScreenCharCCMNextKeyKey: @(ccmNextKey),
-              kScreenCharHasWrappedKey: @(hasWrapped) };
+              kScreenCharCCMNextKeyKey: @(nextKey),
+              kScreenCharHasWrappedKey: @(wrapped) };
 }
 
 void ScreenCharDecodeRestorableState(NSDictionary *state) {
     NSDictionary *stateComplexCharMap = state[kScreenCharComplexCharMapKey];
-    CreateComplexCharMapIfNeeded();
-    for (id key in stateComplexCharMap) {
-        if (!complexCharMap[key]) {
-            complexCharMap[key] = stateComplexCharMap[key];
+    NSSet<NSNumber *> *spacingCombiningMarks = [NSSet setWithArray:state[kScreenCharSpacingCombiningMarksKey] ?: @[]];
+    // The inverse map in |state| is ignored because the index is rebuilt from the codes.
+    for (NSNumber *number in stateComplexCharMap) {
+        NSString *string = stateComplexCharMap[number];
+        const int key = number.intValue;
+        if (![number isKindOfClass:[NSNumber class]] ||
+            ![string isKindOfClass:[NSString class]] ||
+            key <= 0 ||
+            key >= kComplexCharMaxKey) {
+            continue;
         }
-    }
-    NSArray<NSString *> *spacingCombiningMarksArray = state[kScreenCharSpacingCombiningMarksKey];
-    for (NSNumber *number in spacingCombiningMarksArray) {
-        [spacingCombiningMarkCodeNumbers addObject:number];
+        ComplexCharWithCharacters(string, ^(const unichar *characters, int length) {
+            os_unfair_lock_lock(&gComplexCharLock);
+            iTermComplexCharEntry *entry = ComplexCharEntry(key);
+            if (!entry || !entry->string) {
+                ComplexCharInsert(key,
+                                  string,
+                                  ComplexCharHash(characters, length),
+                                  characters,
+                                  length,
+                                  [spacingCombiningMarks containsObject:number]);
+            }
+            os_unfair_lock_unlock(&gComplexCharLock);
+        });
     }
 
-    NSDictionary *stateInverseMap = state[kScreenCharInverseComplexCharMapKey];
-    for (id key in stateInverseMap) {
-        if (!inverseComplexCharMap[key]) {
-            inverseComplexCharMap[key] = stateInverseMap[key];
-        }
-    }
     NSDictionary *imageMap = state[kScreenCharImageMapKey];
     AllocateImageMapsIfNeeded();
     for (id key in imageMap) {
@@ -739,6 +1007,8 @@ void ScreenCharDecodeRestorableState(NSDictionary *state) {
             DLog(@"Decoded restorable state for image %@: %@", key, info);
         }
     }
+    os_unfair_lock_lock(&gComplexCharLock);
     ccmNextKey = [state[kScreenCharCCMNextKeyKey] intValue];
     hasWrapped = [state[kScreenCharHasWrappedKey] boolValue];
+    os_unfair_lock_unlock(&gComplexCharLock);
 }
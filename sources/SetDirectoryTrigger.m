@@ -40,7 +40,8 @@
                                          completion:^(NSString *currentDirectory) {
                                              if (currentDirectory.length) {
                                                  [aSession didUseShellIntegration];
-                                                 [aSession.screen terminalCurrentDirectoryDidChangeTo:currentDirectory];
+                                                 [aSession.screen currentDirectoryDidChangeTo:currentDirectory
+                                                                             atAbsoluteLine:lineNumber];
                                              }
                                          }];
     return YES;
@@ -40,7 +40,7 @@
                                          completion:^(NSString *remoteHost) {
                                              if (remoteHost.length) {
                                                  [aSession didUseShellIntegration];
-                                                 [aSession.screen terminalSetRemoteHost:remoteHost];
+                                                 [aSession.screen setRemoteHost:remoteHost atAbsoluteLine:lineNumber];
                                              }
                                          }];
     return YES;
@@ -1,8 +1,10 @@
-// This implements a select loop that runs in a special thread.
+// This implements an event loop that runs in a special thread. Task file descriptors are
+// registered with kqueue for as long as the task is registered, so the cost of a wakeup is
+// proportional to the number of tasks with activity rather than the number of tasks.
 
 #import <Foundation/Foundation.h>
 
-// Posted just before select() is called.
+// Posted just before the event loop blocks.
 extern NSString *const kTaskNotifierDidSpin;
 
 @class PTYTask;
@@ -15,6 +17,13 @@ extern NSString *const kTaskNotifierDidSpin;
 - (void)registerTask:(PTYTask *)task;
 - (void)deregisterTask:(PTYTask *)task;
 
+// Call after appending to a task's write buffer. Must not be called while holding the task's
+// write lock.
+- (void)taskDidEnqueueWrite:(PTYTask *)task;
+
+// Call when a registered task gains a coprocess so its file descriptors get watched.
+- (void)taskDidChangeCoprocess:(PTYTask *)task;
+
 - (void)unblock;
 - (void)run;
 
@@ -11,8 +11,8 @@
 #import "DebugLogging.h"
 #import "PTYTask.h"
 
+#include "iTermEventQueue.h"
 #include <sys/time.h>
-#include <sys/select.h>
 
 #define PtyTaskDebugLog(args...)
 
@@ -20,17 +20,50 @@ NSString *const kTaskNotifierDidSpin = @"kTaskNotifierDidSpin";
 static int unblockPipeR;
 static int unblockPipeW;
 
+// Tags attached to event queue registrations so an event can be routed without a search.
+typedef NS_ENUM(uint32_t, TaskNotifierEventTag) {
+    TaskNotifierEventTagUnblockPipe,
+    TaskNotifierEventTagTask,
+    TaskNotifierEventTagCoprocess
+};
+
+// Maximum number of events handled per spin.
+static const int kTaskNotifierMaxEvents = 64;
+
 @implementation TaskNotifier
 {
     NSMutableArray *_tasks;
     NSMutableArray *_coprocessOnlyTasks;
-    // Set to true when an element of '_tasks' was modified
-    BOOL tasksChanged;
-    // Protects '_tasks', '_coprocessOnlyTasks', and 'tasksChanged'.
+    // Protects all the ivars below as well as '_tasks' and '_coprocessOnlyTasks'.
     NSRecursiveLock* tasksLock;
 
     // A set of NSNumber*s holding pids of tasks that need to be wait()ed on
     NSMutableSet* deadpool;
+
+    // kqueue (or epoll) descriptor. Task file descriptors stay registered for as long as the task
+    // is, so nothing is rebuilt per spin.
+    int _eventQueue;
+
+    // Maps a task's file descriptor (as registered) to the task.
+    NSMutableDictionary<NSNumber *, PTYTask *> *_tasksByFileDescriptor;
+
+    // Registrations are edge-triggered, so a task remains in this set from the time its file
+    // descriptor reports readiness until a read would block.
+    NSMutableSet<PTYTask *> *_readableTasks;
+
+    // Tasks with bytes in their write buffer, and the subset of those whose last write would have
+    // blocked and which are waiting for a write event. Only tasks in '_writeBlockedTasks' have a
+    // write filter registered, so idle tasks never wake the loop when their buffer drains. Only
+    // tasks in '_readableTasks' and '_tasksWithPendingWrites' are visited on a spin.
+    NSMutableSet<PTYTask *> *_tasksWithPendingWrites;
+    NSMutableSet<PTYTask *> *_writeBlockedTasks;
+
+    // Tasks that have (or recently had) a coprocess, including all coprocess-only tasks.
+    NSMutableSet<PTYTask *> *_tasksWithCoprocesses;
+
+    // Maps coprocess read and write file descriptors to their task. Rebuilt every spin from
+    // '_tasksWithCoprocesses', which is small.
+    NSMutableDictionary<NSNumber *, PTYTask *> *_tasksByCoprocessFileDescriptor;
 }
 
 
@@ -53,7 +86,12 @@ static int unblockPipeW;
         _tasks = [[NSMutableArray alloc] init];
         _coprocessOnlyTasks = [[NSMutableArray alloc] init];
         tasksLock = [[NSRecursiveLock alloc] init];
-        tasksChanged = NO;
+        _tasksByFileDescriptor = [[NSMutableDictionary alloc] init];
+        _readableTasks = [[NSMutableSet alloc] init];
+        _tasksWithPendingWrites = [[NSMutableSet alloc] init];
+        _writeBlockedTasks = [[NSMutableSet alloc] init];
+        _tasksWithCoprocesses = [[NSMutableSet alloc] init];
+        _tasksByCoprocessFileDescriptor = [[NSMutableDictionary alloc] init];
 
         int unblockPipe[2];
         if (pipe(unblockPipe) != 0) {
@@ -69,6 +107,16 @@ static int unblockPipeW;
         }
         unblockPipeR = unblockPipe[0];
         unblockPipeW = unblockPipe[1];
+
+        _eventQueue = iTermEventQueueCreate();
+        if (_eventQueue < 0 ||
+            iTermEventQueueAddEdgeTriggered(_eventQueue,
+                                            unblockPipeR,
+                                            iTermEventQueueFilterRead,
+                                            TaskNotifierEventTagUnblockPipe) != 0) {
+            [self release];
+            return nil;
+        }
     }
     return self;
 }
@@ -79,8 +127,17 @@ static int unblockPipeW;
     [_coprocessOnlyTasks release];
     [tasksLock release];
     [deadpool release];
+    [_tasksByFileDescriptor release];
+    [_readableTasks release];
+    [_tasksWithPendingWrites release];
+    [_writeBlockedTasks release];
+    [_tasksWithCoprocesses release];
+    [_tasksByCoprocessFileDescriptor release];
     close(unblockPipeR);
     close(unblockPipeW);
+    if (_eventQueue >= 0) {
+        close(_eventQueue);
+    }
     [super dealloc];
 }
 
@@ -90,11 +147,28 @@ static int unblockPipeW;
     PtyTaskDebugLog(@"Add task at %p\n", (void*)task);
     if (task.isCoprocessOnly) {
         [_coprocessOnlyTasks addObject:task];
+        [_tasksWithCoprocesses addObject:task];
     } else {
         [_tasks addObject:task];
+        const int fd = task.fd;
+        if (fd >= 0) {
+            if (iTermEventQueueAddEdgeTriggered(_eventQueue,
+                                                fd,
+                                                iTermEventQueueFilterRead,
+                                                TaskNotifierEventTagTask) != 0) {
+                DLog(@"Failed to register fd %d for %@: %s", fd, task, strerror(errno));
+            }
+            _tasksByFileDescriptor[@(fd)] = task;
+            // An edge may have been missed before registration, so assume the fd is readable.
+            // The first read will find out otherwise.
+            [_readableTasks addObject:task];
+            [_tasksWithPendingWrites addObject:task];
+        }
+        if (task.hasCoprocess) {
+            [_tasksWithCoprocesses addObject:task];
+        }
     }
     PtyTaskDebugLog(@"There are now %lu tasks\n", (unsigned long)_tasks.count);
-    tasksChanged = YES;
     PtyTaskDebugLog(@"registerTask: unlock\n");
     [tasksLock unlock];
     [self unblock];
@@ -116,9 +190,18 @@ static int unblockPipeW;
     if ([task hasCoprocess]) {
         [deadpool addObject:@([[task coprocess] pid])];
     }
+    // The task may have already closed its fd (and another task may have reused it) so look the
+    // registration up by task rather than trusting -fd.
+    for (NSNumber *fd in [_tasksByFileDescriptor allKeysForObject:task]) {
+        iTermEventQueueRemove(_eventQueue, fd.intValue);
+        [_tasksByFileDescriptor removeObjectForKey:fd];
+    }
+    [_readableTasks removeObject:task];
+    [_tasksWithPendingWrites removeObject:task];
+    [_writeBlockedTasks removeObject:task];
+    [_tasksWithCoprocesses removeObject:task];
     [_tasks removeObject:task];
     [_coprocessOnlyTasks removeObject:task];
-    tasksChanged = YES;
     PtyTaskDebugLog(@"End remove task %p. There are now %lu tasks and %ld coprocess-only tasks.\n",
                     (void*)task,
                     (unsigned long)[_tasks count],
@@ -128,6 +211,25 @@ static int unblockPipeW;
     [self unblock];
 }
 
+- (void)taskDidEnqueueWrite:(PTYTask *)task {
+    [tasksLock lock];
+    const int fd = task.fd;
+    if (fd >= 0 && _tasksByFileDescriptor[@(fd)] == task) {
+        [_tasksWithPendingWrites addObject:task];
+    }
+    [tasksLock unlock];
+    [self unblock];
+}
+
+- (void)taskDidChangeCoprocess:(PTYTask *)task {
+    [tasksLock lock];
+    if ([_tasks containsObject:task] || [_coprocessOnlyTasks containsObject:task]) {
+        [_tasksWithCoprocesses addObject:task];
+    }
+    [tasksLock unlock];
+    [self unblock];
+}
+
 // NB: This is currently used for coprocesses.
 - (void)waitForPid:(pid_t)pid {
     [tasksLock lock];
@@ -148,121 +250,241 @@ void UnblockTaskNotifier(void) {
     write(unblockPipeW, &dummy, 1);
 }
 
-- (BOOL)handleReadOnFileDescriptor:(int)fd task:(PTYTask *)task fdSet:(fd_set *)fdSet {
-    if (FD_ISSET(fd, fdSet)) {
-        PtyTaskDebugLog(@"run/processRead: unlock");
-        [tasksLock unlock];
-        [task processRead];
-        PtyTaskDebugLog(@"run/processRead: lock");
-        [tasksLock lock];
-        if (tasksChanged) {
-            PtyTaskDebugLog(@"Restart iteration\n");
-            tasksChanged = NO;
-            return YES;
+- (void)drainUnblockPipe {
+    char dummy[32];
+    for (;;) {
+        const ssize_t n = read(unblockPipeR, dummy, sizeof(dummy));
+        if (n > 0) {
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
         }
+        // Empty (EAGAIN), or something unexpected. Either way there's nothing more to read.
+        break;
     }
-    return NO;
 }
 
-- (BOOL)handleWriteOnFileDescriptor:(int)fd task:(PTYTask *)task fdSet:(fd_set *)fdSet {
-    if (FD_ISSET(fd, fdSet)) {
-        PtyTaskDebugLog(@"run/processWrite: unlock");
-        [tasksLock unlock];
-        [task retain];
-        [task processWrite];
-        [task release];
-        PtyTaskDebugLog(@"run/processWrite: lock");
-        [tasksLock lock];
-        if (tasksChanged) {
-            PtyTaskDebugLog(@"Restart iteration\n");
-            tasksChanged = NO;
+- (void)reapDeadpool {
+    if ([deadpool count] == 0) {
+        return;
+    }
+    // waitpid() on pids that we think are dead or will be dead soon.
+    NSMutableSet* newDeadpool = [NSMutableSet setWithCapacity:[deadpool count]];
+    for (NSNumber* pid in deadpool) {
+        if ([pid intValue] < 0) {
+            continue;
+        }
+        int statLoc;
+        PtyTaskDebugLog(@"wait on %d", [pid intValue]);
+        pid_t waitresult = waitpid([pid intValue], &statLoc, WNOHANG);
+        if (waitresult == 0) {
+            // the process is not yet dead, so put it back in the pool
+            [newDeadpool addObject:pid];
+        } else if (waitresult < 0) {
+            if (errno != ECHILD) {
+                PtyTaskDebugLog(@"  wait failed with %d (%s), adding back to deadpool", errno, strerror(errno));
+                [newDeadpool addObject:pid];
+            } else {
+                PtyTaskDebugLog(@"  wait failed with ECHILD, I guess we already waited on it.");
+            }
+        }
+    }
+    [deadpool release];
+    deadpool = [newDeadpool retain];
+}
+
+// Must be called while synchronized on |task|.
+- (void)reapCoprocess:(Coprocess *)coprocess ofTask:(PTYTask *)task {
+    [deadpool addObject:@([coprocess pid])];
+    [coprocess terminate];
+    [task setCoprocess:nil];
+}
+
+// Arms one-shot registrations for the file descriptors of all live coprocesses. Coprocesses are
+// rare so it's fine to do this on every spin. Returns YES if a coprocess was reaped.
+- (BOOL)armCoprocesses {
+    BOOL reaped = NO;
+    [_tasksByCoprocessFileDescriptor removeAllObjects];
+    for (PTYTask *task in [_tasksWithCoprocesses allObjects]) {
+        @synchronized (task) {
+            Coprocess *coprocess = [task coprocess];
+            if (!coprocess) {
+                [_tasksWithCoprocesses removeObject:task];
+                continue;
+            }
+            if ([coprocess eof]) {
+                [self reapCoprocess:coprocess ofTask:task];
+                [_tasksWithCoprocesses removeObject:task];
+                reaped = YES;
+                continue;
+            }
+            if ([coprocess wantToRead] && [task writeBufferHasRoom]) {
+                int rfd = [coprocess readFileDescriptor];
+                _tasksByCoprocessFileDescriptor[@(rfd)] = task;
+                iTermEventQueueAddOneShot(_eventQueue, rfd, iTermEventQueueFilterRead, TaskNotifierEventTagCoprocess);
+            }
+            if ([coprocess wantToWrite]) {
+                int wfd = [coprocess writeFileDescriptor];
+                _tasksByCoprocessFileDescriptor[@(wfd)] = task;
+                iTermEventQueueAddOneShot(_eventQueue, wfd, iTermEventQueueFilterWrite, TaskNotifierEventTagCoprocess);
+            }
+        }
+    }
+    return reaped;
+}
+
+// Returns YES if some task can make progress without waiting for the kernel.
+- (BOOL)haveReadyTasks {
+    for (PTYTask *task in _readableTasks) {
+        if ([task wantsRead]) {
+            return YES;
+        }
+    }
+    for (PTYTask *task in _tasksWithPendingWrites) {
+        if (![_writeBlockedTasks containsObject:task] && [task wantsWrite]) {
             return YES;
         }
     }
     return NO;
 }
 
-- (BOOL)handleErrorOnFileDescriptor:(int)fd task:(PTYTask *)task fdSet:(fd_set *)fdSet {
-    if (FD_ISSET(fd, fdSet)) {
+- (void)handleTaskEvent:(const iTermEventQueueEvent *)event {
+    PTYTask *task = _tasksByFileDescriptor[@(event->fd)];
+    if (!task) {
+        PtyTaskDebugLog(@"Event for unregistered fd %d", event->fd);
+        return;
+    }
+    if (event->error) {
+        DLog(@"Event queue reported error %d (%s) for fd %d of %@",
+             event->error, strerror(event->error), event->fd, task);
         PtyTaskDebugLog(@"run/brokenPipe: unlock");
+        [[task retain] autorelease];
         [tasksLock unlock];
         // brokenPipe will call deregisterTask and add the pid to
         // deadpool.
         [task brokenPipe];
         PtyTaskDebugLog(@"run/brokenPipe: lock");
         [tasksLock lock];
-        if (tasksChanged) {
-            PtyTaskDebugLog(@"Restart iteration\n");
-            tasksChanged = NO;
-            return YES;
+        return;
+    }
+    if (event->filters & iTermEventQueueFilterRead) {
+        [_readableTasks addObject:task];
+    }
+    if (event->filters & iTermEventQueueFilterWrite) {
+        [self task:task setWriteBlocked:NO];
+    }
+}
+
+// Tracks whether |task|'s last write would have blocked and registers for a write event only
+// while it is. Must be called with tasksLock held.
+- (void)task:(PTYTask *)task setWriteBlocked:(BOOL)blocked {
+    if (blocked == [_writeBlockedTasks containsObject:task]) {
+        return;
+    }
+    for (NSNumber *fd in [_tasksByFileDescriptor allKeysForObject:task]) {
+        if (iTermEventQueueSetWriteInterest(_eventQueue, fd.intValue, TaskNotifierEventTagTask, blocked) != 0) {
+            DLog(@"Failed to %@ write interest for fd %@ of %@: %s",
+                 blocked ? @"add" : @"remove", fd, task, strerror(errno));
         }
     }
-    return NO;
+    if (blocked) {
+        [_writeBlockedTasks addObject:task];
+    } else {
+        [_writeBlockedTasks removeObject:task];
+    }
 }
 
-- (void)handleReadOnFileDescriptor:(int)fd
-                              task:(PTYTask *)task
-                     withCoprocess:(Coprocess *)coprocess
-                             fdSet:(fd_set *)fdSet {
-    if (![coprocess eof] && FD_ISSET(fd, fdSet)) {
-        PtyTaskDebugLog(@"Reading from coprocess");
-        [coprocess read];
-        [task writeTask:coprocess.inputBuffer];
-        [coprocess.inputBuffer setLength:0];
+- (void)processReadableTasks {
+    for (PTYTask *task in [_readableTasks allObjects]) {
+        // A previous task's callback may have deregistered this one.
+        if (![_readableTasks containsObject:task] || ![task wantsRead]) {
+            continue;
+        }
+        PtyTaskDebugLog(@"run/processRead: unlock");
+        [[task retain] autorelease];
+        [tasksLock unlock];
+        const BOOL mayHaveMore = [task processRead];
+        PtyTaskDebugLog(@"run/processRead: lock");
+        [tasksLock lock];
+        if (!mayHaveMore) {
+            [_readableTasks removeObject:task];
+        }
     }
 }
 
-- (void)handleErrorOnFileDescriptor:(int)fd
-                      withCoprocess:(Coprocess *)coprocess
-                              fdSet:(fd_set *)fdSet {
-    if (FD_ISSET(fd, fdSet)) {
-        PtyTaskDebugLog(@"EOF on coprocess %@", coprocess);
-        coprocess.eof = YES;
+- (void)processWritableTasks {
+    for (PTYTask *task in [_tasksWithPendingWrites allObjects]) {
+        if (![_tasksWithPendingWrites containsObject:task] ||
+            [_writeBlockedTasks containsObject:task]) {
+            continue;
+        }
+        if (![task wantsWrite]) {
+            // Paused tasks keep their place so they get written once unpaused.
+            if (!task.paused) {
+                [_tasksWithPendingWrites removeObject:task];
+            }
+            continue;
+        }
+        PtyTaskDebugLog(@"run/processWrite: unlock");
+        [[task retain] autorelease];
+        [tasksLock unlock];
+        const BOOL stillWritable = [task processWrite];
+        PtyTaskDebugLog(@"run/processWrite: lock");
+        [tasksLock lock];
+        if (!stillWritable && [_tasksWithPendingWrites containsObject:task]) {
+            [self task:task setWriteBlocked:YES];
+        }
     }
 }
 
-- (void)handleWriteOnFileDescriptor:(int)coprocessWriteFd
-                      withCoprocess:(Coprocess *)coprocess
-                              fdSet:(fd_set *)fdSet {
-    if (FD_ISSET(coprocessWriteFd, fdSet)) {
-        if (![coprocess eof]) {
+// Moves input around between a coprocess and its task. Returns YES if the coprocess terminated.
+- (BOOL)handleCoprocessEvent:(const iTermEventQueueEvent *)event {
+    PTYTask *task = _tasksByCoprocessFileDescriptor[@(event->fd)];
+    if (!task) {
+        return NO;
+    }
+    if (!task.isCoprocessOnly && ([task fd] < 0 || [task hasBrokenPipe])) {
+        return NO;
+    }
+    @synchronized (task) {
+        Coprocess *coprocess = [task coprocess];
+        if (!coprocess) {
+            return NO;
+        }
+        if (event->fd == [coprocess readFileDescriptor]) {
+            if (event->error) {
+                PtyTaskDebugLog(@"EOF on coprocess %@", coprocess);
+                coprocess.eof = YES;
+            } else if (![coprocess eof] && (event->filters & iTermEventQueueFilterRead)) {
+                PtyTaskDebugLog(@"Reading from coprocess");
+                [coprocess read];
+                [task writeTask:coprocess.inputBuffer];
+                [coprocess.inputBuffer setLength:0];
+            }
+        }
+        if (event->fd == [coprocess writeFileDescriptor] &&
+            (event->filters & iTermEventQueueFilterWrite) &&
+            ![coprocess eof]) {
             PtyTaskDebugLog(@"Write to coprocess %@", coprocess);
             [coprocess write];
         }
+        if ([coprocess eof]) {
+            [self reapCoprocess:coprocess ofTask:task];
+            return YES;
+        }
     }
+    return NO;
 }
 
 - (void)run
 {
-    fd_set rfds;
-    fd_set wfds;
-    fd_set efds;
-    int highfd;
-    NSEnumerator* iter;
+    iTermEventQueueEvent events[kTaskNotifierMaxEvents];
     NSAutoreleasePool* autoreleasePool = [[NSAutoreleasePool alloc] init];
 
-    // FIXME: replace this with something better...
     for(;;) {
-
-        FD_ZERO(&rfds);
-        FD_ZERO(&wfds);
-        FD_ZERO(&efds);
-
-        // Unblock pipe to interrupt select() whenever a PTYTask register/unregisters
-        highfd = unblockPipeR;
-        FD_SET(unblockPipeR, &rfds);
-        NSMutableSet* handledFds = [[NSMutableSet alloc] initWithCapacity:256];
-
-        // Add all the PTYTask pipes
         PtyTaskDebugLog(@"run1: lock");
         [tasksLock lock];
-        PtyTaskDebugLog(@"Begin cleaning out dead tasks");
-        for (PTYTask *theTask in _tasks) {
-            if ([theTask fd] < 0) {
-                PtyTaskDebugLog(@"Deregister dead task %@\n", theTask);
-                [self deregisterTask:theTask];
-            }
-        }
         // Make a copy because -deregisterTask modifies _coprocessOnlyTasks
         NSArray *coprocessOnlyTasks = [_coprocessOnlyTasks copy];
         for (PTYTask *theTask in coprocessOnlyTasks) {
@@ -272,84 +494,19 @@ void UnblockTaskNotifier(void) {
         }
         [coprocessOnlyTasks release];
 
-        if ([deadpool count] > 0) {
-            // waitpid() on pids that we think are dead or will be dead soon.
-            NSMutableSet* newDeadpool = [NSMutableSet setWithCapacity:[deadpool count]];
-            for (NSNumber* pid in deadpool) {
-                if ([pid intValue] < 0) {
-                    continue;
-                }
-                int statLoc;
-                PtyTaskDebugLog(@"wait on %d", [pid intValue]);
-                pid_t waitresult = waitpid([pid intValue], &statLoc, WNOHANG);
-                if (waitresult == 0) {
-                    // the process is not yet dead, so put it back in the pool
-                    [newDeadpool addObject:pid];
-                } else if (waitresult < 0) {
-                    if (errno != ECHILD) {
-                        PtyTaskDebugLog(@"  wait failed with %d (%s), adding back to deadpool", errno, strerror(errno));
-                        [newDeadpool addObject:pid];
-                    } else {
-                        PtyTaskDebugLog(@"  wait failed with ECHILD, I guess we already waited on it.");
-                    }
-                }
-            }
-            [deadpool release];
-            deadpool = [newDeadpool retain];
-        }
+        [self reapDeadpool];
+        const BOOL reapedCoprocess = [self armCoprocesses];
 
-        // Figure out the file descriptors to select on.
-        PtyTaskDebugLog(@"Begin enumeration over %lu tasks\n", (unsigned long)[_tasks count]);
-        for (NSArray *taskArray in @[ _tasks, _coprocessOnlyTasks ]) {
-            for (PTYTask *task in taskArray) {
-                PtyTaskDebugLog(@"Got task %@\n", task);
-                int fd = [task fd];
-                if (fd < 0) {
-                    PtyTaskDebugLog(@"Task has fd of %d\n", fd);
-                } else {
-                    // PtyTaskDebugLog(@"Select on fd %d\n", fd);
-                    if (fd > highfd) {
-                        highfd = fd;
-                    }
-                    if ([task wantsRead]) {
-                        FD_SET(fd, &rfds);
-                    }
-                    if ([task wantsWrite]) {
-                        FD_SET(fd, &wfds);
-                    }
-                    FD_SET(fd, &efds);
-                }
-
-                @synchronized (task) {
-                    Coprocess *coprocess = [task coprocess];
-                    if (coprocess) {
-                        if ([coprocess wantToRead] && [task writeBufferHasRoom]) {
-                            int rfd = [coprocess readFileDescriptor];
-                            if (rfd > highfd) {
-                                highfd = rfd;
-                            }
-                            FD_SET(rfd, &rfds);
-                        }
-                        if ([coprocess wantToWrite]) {
-                            int wfd = [coprocess writeFileDescriptor];
-                            if (wfd > highfd) {
-                                highfd = wfd;
-                            }
-                            FD_SET(wfd, &wfds);
-                        }
-                        if (![coprocess eof]) {
-                            int rfd = [coprocess readFileDescriptor];
-                            if (rfd > highfd) {
-                                highfd = rfd;
-                            }
-                            FD_SET(rfd, &efds);
-                        }
-                    }
-                }
-            }
-        }
+        // Don't block if a task was cut off mid-read or mid-write on the last spin. Its fd won't
+        // produce another edge until it has been drained.
+        const int timeout = [self haveReadyTasks] ? 0 : -1;
         PtyTaskDebugLog(@"run1: unlock");
         [tasksLock unlock];
+        if (reapedCoprocess) {
+            [self performSelectorOnMainThread:@selector(notifyCoprocessChange)
+                                   withObject:nil
+                                waitUntilDone:YES];
+        }
 
         [[NSNotificationCenter defaultCenter] postNotificationName:kTaskNotifierDidSpin object:nil];
 
@@ -357,127 +514,37 @@ void UnblockTaskNotifier(void) {
         autoreleasePool = [[NSAutoreleasePool alloc] init];
 
         // Poll...
-        if (select(highfd+1, &rfds, &wfds, &efds, NULL) <= 0) {
-            switch(errno) {
-                case EAGAIN:
-                case EINTR:
-                default:
-                    goto breakloop;
-                    // If the file descriptor is closed in the main thread there's a race where sometimes you'll get an EBADF.
-            }
-        }
-
-        // Interrupted?
-        if (FD_ISSET(unblockPipeR, &rfds)) {
-            char dummy[32];
-            do {
-                read(unblockPipeR, dummy, sizeof(dummy));
-            } while (errno != EAGAIN);
+        const int count = iTermEventQueueWait(_eventQueue, events, kTaskNotifierMaxEvents, timeout);
+        if (count < 0) {
+            // EINTR, or EBADF if a file descriptor was closed out from under us. Just try again.
+            continue;
         }
 
-        // Check for read events on PTYTask pipes
         PtyTaskDebugLog(@"run2: lock");
         [tasksLock lock];
-        PtyTaskDebugLog(@"Iterating over %lu tasks\n", (unsigned long)_tasks.count);
-        iter = [_tasks objectEnumerator];
-        BOOL notifyOfCoprocessChange = NO;
-
-        PTYTask *task;
-        while ((task = [iter nextObject])) {
-            PtyTaskDebugLog(@"Got task %@\n", task);
-            int fd = [task fd];
-
-            if (fd >= 0) {
-                // This is mostly paranoia, but if two threads
-                // end up with the same fd (because one closed
-                // and there was a race condition) then trying
-                // to read twice would hang.
-
-                if ([handledFds containsObject:@(fd)]) {
-                    PtyTaskDebugLog(@"Duplicate fd %d", fd);
-                    continue;
-                }
-                [[task retain] autorelease];
-                [handledFds addObject:@(fd)];
-
-                if ([self handleReadOnFileDescriptor:fd task:task fdSet:&rfds]) {
-                    iter = [_tasks objectEnumerator];
-                }
-                if ([self handleWriteOnFileDescriptor:fd task:task fdSet:&wfds]) {
-                    iter = [_tasks objectEnumerator];
-                }
-                if ([self handleErrorOnFileDescriptor:fd task:task fdSet:&efds]) {
-                    iter = [_tasks objectEnumerator];
-                }
-                // Move input around between coprocess and main process.
-                if ([task fd] >= 0 && ![task hasBrokenPipe]) {  // Make sure the pipe wasn't just broken.
-                    @synchronized (task) {
-                        Coprocess *coprocess = [task coprocess];
-                        if (coprocess) {
-                            fd = [coprocess readFileDescriptor];
-                            if ([handledFds containsObject:@(fd)]) {
-                                NSLog(@"Duplicate fd %d", fd);
-                                continue;
-                            }
-                            [handledFds addObject:@(fd)];
-
-                            [self handleReadOnFileDescriptor:fd task:task withCoprocess:coprocess fdSet:&rfds];
-                            [self handleErrorOnFileDescriptor:fd withCoprocess:coprocess fdSet:&efds];
-
-                            // Handle writes
-                            int coprocessWriteFd = [coprocess writeFileDescriptor];
-                            if ([handledFds containsObject:@(coprocessWriteFd)]) {
-                                NSLog(@"Duplicate fd %d", coprocessWriteFd);
-                                continue;
-                            }
-                            [handledFds addObject:@(coprocessWriteFd)];
-                            [self handleWriteOnFileDescriptor:coprocessWriteFd withCoprocess:coprocess fdSet:&wfds];
-
-                            if ([coprocess eof]) {
-                                [deadpool addObject:@([coprocess pid])];
-                                [coprocess terminate];
-                                [task setCoprocess:nil];
-                                notifyOfCoprocessChange = YES;
-                            }
-                        }
-                    }
-                }
+        for (int i = 0; i < count; i++) {
+            switch ((TaskNotifierEventTag)events[i].tag) {
+                case TaskNotifierEventTagUnblockPipe:
+                    [self drainUnblockPipe];
+                    break;
+                case TaskNotifierEventTagTask:
+                    [self handleTaskEvent:&events[i]];
+                    break;
+                case TaskNotifierEventTagCoprocess:
+                    break;
             }
         }
 
-        // Handle coprocess reads, writes, and deaths for coprocess-only tasks.
-          PtyTaskDebugLog(@"Iterating over %lu coprocess-only tasks\n", (unsigned long)_coprocessOnlyTasks.count);
-          for (PTYTask *coprocessOnlyTask in _coprocessOnlyTasks) {
-            @synchronized (coprocessOnlyTask) {
-                PtyTaskDebugLog(@"Checking coprocess olnly task %@", coprocessOnlyTask);
-                Coprocess *coprocess = [coprocessOnlyTask coprocess];
-                if (coprocess) {
-                    int fd = [coprocess readFileDescriptor];
-                    if ([handledFds containsObject:@(fd)]) {
-                        NSLog(@"Duplicate fd %d", fd);
-                        continue;
-                    }
-                    [handledFds addObject:@(fd)];
-
-                    [self handleReadOnFileDescriptor:fd task:coprocessOnlyTask withCoprocess:coprocess fdSet:&rfds];
-                    [self handleErrorOnFileDescriptor:fd withCoprocess:coprocess fdSet:&efds];
-
-                    // Handle writes
-                    int coprocessWriteFd = [coprocess writeFileDescriptor];
-                    if ([handledFds containsObject:@(coprocessWriteFd)]) {
-                        NSLog(@"Duplicate fd %d", coprocessWriteFd);
-                        continue;
-                    }
-                    [handledFds addObject:@(coprocessWriteFd)];
-                    [self handleWriteOnFileDescriptor:coprocessWriteFd withCoprocess:coprocess fdSet:&wfds];
-
-                    if ([coprocess eof]) {
-                        [deadpool addObject:@([coprocess pid])];
-                        [coprocess terminate];
-                        [coprocessOnlyTask setCoprocess:nil];
-                        notifyOfCoprocessChange = YES;
-                    }
-                }
+        PtyTaskDebugLog(@"Processing %lu readable tasks and %lu tasks with pending writes\n",
+                        (unsigned long)_readableTasks.count,
+                        (unsigned long)_tasksWithPendingWrites.count);
+        [self processReadableTasks];
+        [self processWritableTasks];
+
+        BOOL notifyOfCoprocessChange = NO;
+        for (int i = 0; i < count; i++) {
+            if (events[i].tag == TaskNotifierEventTagCoprocess) {
+                notifyOfCoprocessChange = [self handleCoprocessEvent:&events[i]] || notifyOfCoprocessChange;
             }
         }
 
@@ -489,8 +556,6 @@ void UnblockTaskNotifier(void) {
                                 waitUntilDone:YES];
         }
 
-    breakloop:
-        [handledFds release];
         [autoreleasePool drain];
         autoreleasePool = [[NSAutoreleasePool alloc] init];
     }
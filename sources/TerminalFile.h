@@ -15,6 +15,8 @@ extern NSString *const kTerminalFileShouldStopNotification;
 @interface TerminalFile : TransferrableFile
 
 @property(nonatomic, copy) NSString *localPath;
+
+// Number of bytes decoded so far.
 @property(nonatomic, readonly) NSInteger length;
 
 // You must call -download after initWithName:size: to enter starting status.
@@ -22,10 +24,11 @@ extern NSString *const kTerminalFileShouldStopNotification;
 // A size of -1 means the size is unknown.
 - (instancetype)initWithName:(NSString *)name size:(NSInteger)size;
 
-// Appends data to a file in transferring status. Enters transferring status.
+// Appends base64 data to a file in transferring status. Enters transferring status. The data is
+// decoded as it arrives and written to a temporary file.
 - (void)appendData:(NSString *)data;
 
-// Marks the end of data, at which time the file is decoded and saved. If -stop
+// Marks the end of data, at which time the file is moved to its final location. If -stop
 // was called, the cancelled state is entered.
 - (void)endOfData;
 
@@ -7,16 +7,18 @@
 //
 
 #import "TerminalFile.h"
+#import "DebugLogging.h"
 #import "FileTransferManager.h"
 #import "FutureMethods.h"
 #import "NSSavePanel+iTerm.h"
-#import "RegexKitLite.h"
-#import <apr-1/apr_base64.h>
+#import "iTermBase64Decoder.h"
 
 NSString *const kTerminalFileShouldStopNotification = @"kTerminalFileShouldStopNotification";
 
 @interface TerminalFile ()
-@property(nonatomic, retain) NSMutableString *data;
+// Decodes into temporaryPath, or into memory if that file couldn't be created.
+@property(nonatomic, retain) iTermBase64Decoder *decoder;
+@property(nonatomic, copy) NSString *temporaryPath;
 @property(nonatomic, copy) NSString *filename;  // No path, just a name.
 @property(nonatomic, retain) NSString *error;
 @end
@@ -65,7 +67,9 @@ NSString *const kTerminalFileShouldStopNotification = @"kTerminalFileShouldStopN
 - (void)dealloc {
     [TransferrableFile unlockFileName:_localPath];
     [_localPath release];
-    [_data release];
+    [_decoder release];
+    [self removeTemporaryFile];
+    [_temporaryPath release];
     [_filename release];
     [_error release];
     [super dealloc];
@@ -96,7 +100,12 @@ NSString *const kTerminalFileShouldStopNotification = @"kTerminalFileShouldStopN
         [[FileTransferManager sharedInstance] transferrableFile:self
                                  didFinishTransmissionWithError:error];
     }
-    self.data = [NSMutableString string];
+    self.temporaryPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    self.decoder = [[[iTermBase64Decoder alloc] initWithOutputPath:self.temporaryPath] autorelease];
+    if (!self.decoder) {
+        self.temporaryPath = nil;
+        self.decoder = [[[iTermBase64Decoder alloc] init] autorelease];
+    }
 }
 
 - (void)upload {
@@ -106,7 +115,8 @@ NSString *const kTerminalFileShouldStopNotification = @"kTerminalFileShouldStopN
 - (void)stop {
     self.status = kTransferrableFileStatusCancelling;
     [[FileTransferManager sharedInstance] transferrableFileWillStop:self];
-    self.data = nil;
+    self.decoder = nil;
+    [self removeTemporaryFile];
     [[NSNotificationCenter defaultCenter] postNotificationName:kTerminalFileShouldStopNotification
                                                         object:self];
     [TransferrableFile unlockFileName:_localPath];
@@ -123,16 +133,10 @@ NSString *const kTerminalFileShouldStopNotification = @"kTerminalFileShouldStopN
 #pragma mark - APIs
 
 - (void)appendData:(NSString *)data {
-    if (self.data) {
+    if (self.decoder) {
         self.status = kTransferrableFileStatusTransferring;
-
-        // This keeps apr_base64_decode_len accurate.
-        data = [data stringByReplacingOccurrencesOfRegex:@"[\r\n]" withString:@""];
-
-        [self.data appendString:data];
-        double approximateSize = self.data.length;
-        approximateSize *= 4.0 / 3.0;
-        self.bytesTransferred = floor(approximateSize);
+        [self.decoder appendString:data];
+        self.bytesTransferred = self.decoder.numberOfBytesDecoded;
         if (self.fileSize >= 0) {
             self.bytesTransferred = MIN(self.fileSize, self.bytesTransferred);
         }
@@ -141,7 +145,7 @@ NSString *const kTerminalFileShouldStopNotification = @"kTerminalFileShouldStopN
 }
 
 - (NSInteger)length {
-    return self.data.length;
+    return self.decoder.numberOfBytesDecoded;
 }
 
 - (void)endOfData {
@@ -150,28 +154,21 @@ NSString *const kTerminalFileShouldStopNotification = @"kTerminalFileShouldStopN
 }
 
 - (void)handleEndOfData {
-    if (!self.data) {
+    if (!self.decoder) {
         self.status = kTransferrableFileStatusCancelled;
         [[FileTransferManager sharedInstance] transferrableFileDidStopTransfer:self];
         return;
     }
-    const char *buffer = [self.data UTF8String];
-    int destLength = apr_base64_decode_len(buffer);
-    if (destLength < 1) {
+    iTermBase64Decoder *decoder = self.decoder;
+    const BOOL ok = [decoder finish];
+    if (decoder.numberOfBytesDecoded == 0) {
+        [self removeTemporaryFile];
         [[FileTransferManager sharedInstance] transferrableFile:self
                                  didFinishTransmissionWithError:[self errorWithDescription:@"No data received."]];
         return;
     }
-    NSMutableData *data = [NSMutableData dataWithLength:destLength];
-    char *decodedBuffer = [data mutableBytes];
-    int resultLength = apr_base64_decode(decodedBuffer, buffer);
-    if (resultLength < 0) {
-        [[FileTransferManager sharedInstance] transferrableFile:self
-                                 didFinishTransmissionWithError:[self errorWithDescription:@"File corrupted (not valid base64)."]];
-        return;
-    }
-    [data setLength:resultLength];
-    if (![data writeToFile:self.localPath atomically:NO]) {
+    if (!ok || ![self moveDecodedDataToLocalPath]) {
+        [self removeTemporaryFile];
         [[FileTransferManager sharedInstance] transferrableFile:self
                                  didFinishTransmissionWithError:[self errorWithDescription:@"Failed to write file to disk."]];
         return;
@@ -183,6 +180,32 @@ NSString *const kTerminalFileShouldStopNotification = @"kTerminalFileShouldStopN
 
 #pragma mark - Private
 
+- (BOOL)moveDecodedDataToLocalPath {
+    if (!self.localPath) {
+        return NO;
+    }
+    if (!self.temporaryPath) {
+        return [self.decoder.data writeToFile:self.localPath atomically:NO];
+    }
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    [fileManager removeItemAtPath:self.localPath error:nil];
+    NSError *error = nil;
+    if (![fileManager moveItemAtPath:self.temporaryPath toPath:self.localPath error:&error]) {
+        DLog(@"Failed to move %@ to %@: %@", self.temporaryPath, self.localPath, error);
+        return NO;
+    }
+    self.temporaryPath = nil;
+    return YES;
+}
+
+- (void)removeTemporaryFile {
+    if (_temporaryPath) {
+        [[NSFileManager defaultManager] removeItemAtPath:_temporaryPath error:nil];
+        [_temporaryPath release];
+        _temporaryPath = nil;
+    }
+}
+
 - (NSError *)errorWithDescription:(NSString *)description {
     return [NSError errorWithDomain:@"com.googlecode.iterm2.TerminalFile"
                                code:1
@@ -78,6 +78,10 @@ typedef NS_ENUM(NSInteger, ControlCommand) {
 // The token must be TMUX_xxx.
 - (void)executeToken:(VT100Token *)token;
 
+// Delivers %output that -executeToken: held back so consecutive lines for a pane could be passed to
+// it at once. Call after executing a batch of tokens.
+- (void)flushPendingOutput;
+
 - (void)sendCommand:(NSString *)command
      responseTarget:(id)target
    responseSelector:(SEL)selector;
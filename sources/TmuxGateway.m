@@ -58,6 +58,13 @@ static NSString *kCommandIsLastInList = @"lastInList";
     // When we get the first %begin-%{end,error} we notify the delegate. Until that happens, this is
     // set to NO.
     BOOL _initialized;
+
+    // Decoded %output for _pendingOutputPane that hasn't been delivered yet. Consecutive %output
+    // lines for the same pane are delivered together by -flushPendingOutput. The buffer is reused.
+    char *_pendingOutput;
+    size_t _pendingOutputLength;
+    size_t _pendingOutputCapacity;
+    int _pendingOutputPane;
 }
 
 @synthesize delegate = delegate_;
@@ -83,6 +90,7 @@ static NSString *kCommandIsLastInList = @"lastInList";
     [_minimumServerVersion release];
     [_maximumServerVersion release];
     [_dcsID release];
+    free(_pendingOutput);
 
     [super dealloc];
 }
@@ -109,78 +117,102 @@ static NSString *kCommandIsLastInList = @"lastInList";
     [delegate_ tmuxHostDisconnected:[[_dcsID copy] autorelease]];  // Force the client to quit
 }
 
-- (NSData *)decodeEscapedOutput:(const char *)bytes
-{
-    NSMutableData *data = [NSMutableData data];
-    unsigned char c;
-    for (int i = 0; bytes[i]; i++) {
-        c = bytes[i];
+// Decodes the data of an %output line, where tmux escapes bytes less than space and backslash as
+// a backslash and three octal digits. Writes at most |length| bytes to |output| and returns the
+// number written.
+static size_t TmuxGatewayDecodeEscapedOutput(const char *bytes, size_t length, char *output) {
+    const unsigned char *p = (const unsigned char *)bytes;
+    const unsigned char *end = p + length;
+    char *out = output;
+    while (p < end) {
+        // Copy everything up to the next control character or backslash at once.
+        const unsigned char *run = p;
+        while (p < end && *p >= ' ' && *p != '\\') {
+            p++;
+        }
+        memcpy(out, run, p - run);
+        out += p - run;
+        if (p == end) {
+            break;
+        }
+        unsigned char c = *p++;
         if (c < ' ') {
             continue;
         }
-        if (c == '\\') {
-            // Read exactly three bytes of octal values, or else set c to '?'.
-            c = 0;
-            for (int j = 0; j < 3; j++) {
-                i++;
-                if (bytes[i] == '\r') {
-                    // Ignore \r's that the line driver sprinkles in at its pleasure.
-                    continue;
-                }
-                if (bytes[i] < '0' || bytes[i] > '7') {
-                    c = '?';
-                    i--;  // Back up in case bytes[i] is a null; we don't want to go off the end.
-                    break;
-                }
-                c *= 8;
-                c += bytes[i] - '0';
+        // Read exactly three bytes of octal values, or else set c to '?'.
+        c = 0;
+        for (int j = 0; j < 3; j++) {
+            if (p < end && *p == '\r') {
+                // Ignore \r's that the line driver sprinkles in at its pleasure.
+                p++;
+                continue;
             }
+            if (p == end || *p < '0' || *p > '7') {
+                // Leave the unexpected byte to be handled as ordinary data.
+                c = '?';
+                break;
+            }
+            c *= 8;
+            c += *p++ - '0';
         }
-        [data appendBytes:&c length:1];
+        *out++ = c;
     }
-    return data;
+    return out - output;
 }
 
 - (void)parseOutputCommandData:(NSData *)input
 {
-    // Null terminate so we can do some string parsing without too much pain.
-    NSMutableData *data = [NSMutableData dataWithData:input];
-    [data appendBytes:"" length:1];
-
     // This one is tricky to parse because the string version of the command could have bogus UTF-8.
     // %output %<pane id> <data...><newline>
-    const char *command = [data bytes];
-    char *space = strchr(command, ' ');
-    if (!space) {
+    const char *command = input.bytes;
+    const char *end = command + input.length;
+    static const char outputCommand[] = "%output %";
+    const size_t outputCommandLength = sizeof(outputCommand) - 1;
+    if (input.length <= outputCommandLength || memcmp(command, outputCommand, outputCommandLength)) {
         goto error;
     }
-    const char *outputCommand = "%output";
-    if (strncmp(outputCommand, command, strlen(outputCommand))) {
+    int windowPane = 0;
+    const char *p = command + outputCommandLength;
+    if (p == end || *p < '0' || *p > '9') {
         goto error;
     }
-    const char *paneId = space + 1;
-    if (*paneId != '%') {
-        goto error;
-    }
-    paneId++;
-    space = strchr(paneId, ' ');
-    if (!space) {
-        goto error;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (windowPane > (INT_MAX - 9) / 10) {
+            goto error;
+        }
+        windowPane = windowPane * 10 + (*p++ - '0');
     }
-    char *endptr = NULL;
-    int windowPane = strtol(paneId, &endptr, 10);
-    if (windowPane < 0 || endptr != space) {
+    if (p == end || *p != ' ') {
         goto error;
     }
+    p++;
 
-    NSData *decodedData = [self decodeEscapedOutput:space + 1];
-
-    TmuxLog(@"Run tmux command: \"%%output \"%%%d\" %.*s", windowPane, (int)[decodedData length], [decodedData bytes]);
-    [[[delegate_ tmuxController] sessionForWindowPane:windowPane] tmuxReadTask:decodedData];
-
+    if (_pendingOutputLength > 0 && windowPane != _pendingOutputPane) {
+        [self flushPendingOutput];
+    }
+    _pendingOutputPane = windowPane;
+    const size_t maximumLength = end - p;
+    if (_pendingOutputCapacity - _pendingOutputLength < maximumLength) {
+        _pendingOutputCapacity = MAX(_pendingOutputCapacity * 2, _pendingOutputLength + maximumLength);
+        _pendingOutput = realloc(_pendingOutput, _pendingOutputCapacity);
+    }
+    const size_t length = TmuxGatewayDecodeEscapedOutput(p, maximumLength, _pendingOutput + _pendingOutputLength);
+    TmuxLog(@"Run tmux command: \"%%output \"%%%d\" %.*s", windowPane, (int)length, _pendingOutput + _pendingOutputLength);
+    _pendingOutputLength += length;
     return;
+
 error:
-    [self abortWithErrorMessage:[NSString stringWithFormat:@"Malformed command (expected %%num data): \"%s\"", command]];
+    [self abortWithErrorMessage:[NSString stringWithFormat:@"Malformed command (expected %%num data): \"%.*s\"",
+                                 (int)input.length, command]];
+}
+
+- (void)flushPendingOutput {
+    if (_pendingOutputLength == 0) {
+        return;
+    }
+    NSData *data = [NSData dataWithBytes:_pendingOutput length:_pendingOutputLength];
+    _pendingOutputLength = 0;
+    [[[delegate_ tmuxController] sessionForWindowPane:_pendingOutputPane] tmuxReadTask:data];
 }
 
 - (void)parseLayoutChangeCommand:(NSString *)command
@@ -436,6 +468,10 @@ error:
     if (!acceptNotifications_) {
         TmuxLog(@"  Not accepting notifications");
     }
+    if (currentCommand_ || ![command hasPrefix:@"%output "]) {
+        // Output that came before this command must be delivered before it's handled.
+        [self flushPendingOutput];
+    }
     // Work around a bug in tmux 1.8: if unlink-window causes the current
     // session to be destroyed, no end guard is printed but %exit may be
     // received.
@@ -9,6 +9,11 @@
 
 @interface TmuxHistoryParser : NSObject
 
+// History is split into chunks of about this many bytes, which are parsed concurrently. The
+// colors and character set in effect at the start of each chunk are found first, so a chunk parses
+// the same way it would have if everything before it had been parsed too.
+@property (nonatomic) NSUInteger bytesPerChunk;
+
 + (instancetype)sharedInstance;
 - (NSArray<NSData *> *)parseDumpHistoryResponse:(NSString *)response
                          ambiguousIsDoubleWidth:(BOOL)ambiguousIsDoubleWidth
@@ -10,6 +10,75 @@
 #import "iTermMalloc.h"
 #import "ScreenChar.h"
 #import "VT100Terminal.h"
+#import "VT100TokenPool.h"
+
+static const NSUInteger kDefaultBytesPerChunk = 128 * 1024;
+
+// A run of whole lines of history, parsed independently of the others.
+@interface TmuxHistoryChunk : NSObject {
+@public
+    NSRange _range;  // Of the UTF-8 response
+    BOOL _isLast;
+
+    // State at the start of the chunk.
+    VT100GraphicRendition _graphicRendition;
+    int _charset;
+
+    // Control sequences in the chunk that change the state of the next one.
+    NSMutableData *_stateChanges;
+
+    // screen_char_t's of every line in the chunk, and the index just past the end of each line.
+    NSMutableData *_characters;
+    NSMutableData *_lineEnds;  // NSUInteger
+}
+@end
+
+@implementation TmuxHistoryChunk
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _stateChanges = [[NSMutableData alloc] init];
+        _characters = [[NSMutableData alloc] init];
+        _lineEnds = [[NSMutableData alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_stateChanges release];
+    [_characters release];
+    [_lineEnds release];
+    [super dealloc];
+}
+
+@end
+
+// Appends the control sequences in |bytes| that affect how later lines are parsed: SGR sequences
+// and the SO and SI controls that switch character sets. This is all tmux carries from one line to
+// the next.
+static void TmuxHistoryParserAppendStateChanges(const unsigned char *bytes,
+                                                NSUInteger length,
+                                                NSMutableData *stateChanges) {
+    const unsigned char *p = bytes;
+    const unsigned char *end = bytes + length;
+    while (p < end) {
+        const unsigned char c = *p++;
+        if (c == VT100CC_SO || c == VT100CC_SI) {
+            [stateChanges appendBytes:&c length:1];
+        } else if (c == VT100CC_ESC && p < end && *p == '[') {
+            // Skip parameters and intermediate bytes to the final byte.
+            const unsigned char *q = p + 1;
+            while (q < end && *q >= 0x20 && *q <= 0x3f) {
+                q++;
+            }
+            if (q < end && *q == 'm') {
+                [stateChanges appendBytes:p - 1 length:q + 1 - (p - 1)];
+            }
+            p = q;
+        }
+    }
+}
 
 @implementation TmuxHistoryParser
 
@@ -22,56 +91,148 @@
     return instance;
 }
 
-// Returns nil on error
-// TODO: Test with italics
-- (NSData *)dataForHistoryLine:(NSString *)hist
-                  withTerminal:(VT100Terminal *)terminal
-        ambiguousIsDoubleWidth:(BOOL)ambiguousIsDoubleWidth
-                unicodeVersion:(NSInteger)unicodeVersion {
-    screen_char_t *screenChars;
-    NSMutableData *result = [NSMutableData data];
-    NSData *histData = [hist dataUsingEncoding:NSUTF8StringEncoding];
-    [terminal.parser putStreamData:histData.bytes
-                            length:histData.length];
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _bytesPerChunk = kDefaultBytesPerChunk;
+    }
+    return self;
+}
+
+- (VT100Terminal *)newTerminal {
+    VT100Terminal *terminal = [[VT100Terminal alloc] init];
+    terminal.tmuxMode = YES;
+    [terminal setEncoding:NSUTF8StringEncoding];
+    return terminal;
+}
 
+- (void)executeTokensForData:(const void *)bytes
+                      length:(NSUInteger)length
+                  inTerminal:(VT100Terminal *)terminal
+                       block:(void (^)(VT100Token *token))block {
+    [terminal.parser putStreamData:bytes length:length];
     CVector vector;
-    CVectorCreate(&vector, 100);
+    CVectorCreate(&vector, 1024);
     [terminal.parser addParsedTokensToVector:&vector];
-    int n = CVectorCount(&vector);
+    const int n = CVectorCount(&vector);
     for (int i = 0; i < n; i++) {
         VT100Token *token = CVectorGetObject(&vector, i);
         [terminal executeToken:token];
-        NSString *string = token.isStringType ? token.string : nil;
-        if (!string && token->type == VT100_ASCIISTRING) {
-            string = [token stringForAsciiData];
+        if (block) {
+            block(token);
         }
+    }
+    [terminal.parser.tokenPool recycleTokensInVector:&vector];
+    CVectorDestroy(&vector);
+}
 
-        if (string) {
-            // Allocate double space in case they're all double-width characters.
-            screenChars = iTermMalloc(sizeof(screen_char_t) * 2 * string.length);
-            int len = 0;
-            StringToScreenChars(string,
-                                screenChars,
-                                [terminal foregroundColorCode],
-                                [terminal backgroundColorCode],
-                                &len,
-                                ambiguousIsDoubleWidth,
-                                NULL,
-                                NULL,
-                                NO,
-                                unicodeVersion);
-            if ([token isAscii] && [terminal charset]) {
-                ConvertCharsToGraphicsCharset(screenChars, len);
+// Splits the UTF-8 response into chunks of whole lines.
+- (NSArray<TmuxHistoryChunk *> *)chunksForData:(NSData *)data {
+    NSMutableArray<TmuxHistoryChunk *> *chunks = [NSMutableArray array];
+    const char *bytes = data.bytes;
+    const NSUInteger length = data.length;
+    NSUInteger start = 0;
+    do {
+        NSUInteger end = length;
+        if (length - start > _bytesPerChunk) {
+            const char *newline = memchr(bytes + start + _bytesPerChunk, '\n', length - start - _bytesPerChunk);
+            if (newline) {
+                end = newline + 1 - bytes;
             }
-            [result appendBytes:screenChars
-                         length:sizeof(screen_char_t) * len];
-            free(screenChars);
         }
-        [token release];
+        TmuxHistoryChunk *chunk = [[[TmuxHistoryChunk alloc] init] autorelease];
+        chunk->_range = NSMakeRange(start, end - start);
+        [chunks addObject:chunk];
+        start = end;
+    } while (start < length);
+    chunks.lastObject->_isLast = YES;
+    return chunks;
+}
+
+// Finds the state each chunk starts in. The state changes in each chunk are found concurrently and
+// then replayed in order, which is much cheaper than parsing everything.
+- (void)findInitialStatesOfChunks:(NSArray<TmuxHistoryChunk *> *)chunks data:(NSData *)data {
+    const unsigned char *bytes = data.bytes;
+    dispatch_apply(chunks.count - 1, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        TmuxHistoryChunk *chunk = chunks[i];
+        TmuxHistoryParserAppendStateChanges(bytes + chunk->_range.location,
+                                            chunk->_range.length,
+                                            chunk->_stateChanges);
+    });
+    VT100Terminal *terminal = [[self newTerminal] autorelease];
+    chunks[0]->_graphicRendition = terminal.graphicRendition;
+    chunks[0]->_charset = terminal.charset;
+    for (NSUInteger i = 1; i < chunks.count; i++) {
+        NSData *stateChanges = chunks[i - 1]->_stateChanges;
+        [self executeTokensForData:stateChanges.bytes
+                            length:stateChanges.length
+                        inTerminal:terminal
+                             block:nil];
+        chunks[i]->_graphicRendition = terminal.graphicRendition;
+        chunks[i]->_charset = terminal.charset;
     }
-    CVectorDestroy(&vector);
+}
 
-    return result;
+// TODO: Test with italics
+- (void)parseChunk:(TmuxHistoryChunk *)chunk
+              data:(NSData *)data
+ambiguousIsDoubleWidth:(BOOL)ambiguousIsDoubleWidth
+    unicodeVersion:(NSInteger)unicodeVersion {
+    VT100Terminal *terminal = [[self newTerminal] autorelease];
+    terminal.graphicRendition = chunk->_graphicRendition;
+    if (chunk->_charset) {
+        const char shiftOut = VT100CC_SO;
+        [self executeTokensForData:&shiftOut length:1 inTerminal:terminal block:nil];
+    }
+
+    NSMutableData *characters = chunk->_characters;
+    NSMutableData *lineEnds = chunk->_lineEnds;
+    __block screen_char_t *buffer = NULL;
+    __block NSUInteger capacity = 0;
+    [self executeTokensForData:(const char *)data.bytes + chunk->_range.location
+                        length:chunk->_range.length
+                    inTerminal:terminal
+                         block:^(VT100Token *token) {
+        if (token->type == VT100CC_LF) {
+            const NSUInteger end = characters.length / sizeof(screen_char_t);
+            [lineEnds appendBytes:&end length:sizeof(end)];
+            return;
+        }
+        NSString *string = token.isStringType ? token.string : nil;
+        if (!string && token->type == VT100_ASCIISTRING) {
+            string = [token stringForAsciiData];
+        }
+        if (!string) {
+            return;
+        }
+        // Allow double space in case they're all double-width characters.
+        if (capacity < 2 * string.length) {
+            free(buffer);
+            capacity = 2 * string.length;
+            buffer = iTermMalloc(sizeof(screen_char_t) * capacity);
+        }
+        int len = 0;
+        StringToScreenChars(string,
+                            buffer,
+                            [terminal foregroundColorCode],
+                            [terminal backgroundColorCode],
+                            &len,
+                            ambiguousIsDoubleWidth,
+                            NULL,
+                            NULL,
+                            NO,
+                            unicodeVersion);
+        if ([token isAscii] && [terminal charset]) {
+            ConvertCharsToGraphicsCharset(buffer, len);
+        }
+        [characters appendBytes:buffer length:sizeof(screen_char_t) * len];
+    }];
+    free(buffer);
+    if (chunk->_isLast) {
+        // The last line has no newline.
+        const NSUInteger end = characters.length / sizeof(screen_char_t);
+        [lineEnds appendBytes:&end length:sizeof(end)];
+    }
 }
 
 // Return an NSArray of NSData's. Each NSData is an array of screen_char_t's,
@@ -82,22 +243,37 @@
     if (![response length]) {
         return [NSArray array];
     }
-    NSArray *lines = [response componentsSeparatedByString:@"\n"];
+    NSData *data = [response dataUsingEncoding:NSUTF8StringEncoding];
+    NSArray<TmuxHistoryChunk *> *chunks = [self chunksForData:data];
+    [self findInitialStatesOfChunks:chunks data:data];
+    dispatch_apply(chunks.count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        @autoreleasepool {
+            [self parseChunk:chunks[i]
+                        data:data
+      ambiguousIsDoubleWidth:ambiguousIsDoubleWidth
+              unicodeVersion:unicodeVersion];
+        }
+    });
+
+    // Each line refers to its chunk's characters rather than copying them.
     NSMutableArray *screenLines = [NSMutableArray array];
-    VT100Terminal *terminal = [[[VT100Terminal alloc] init] autorelease];
-    terminal.tmuxMode = YES;
-    [terminal setEncoding:NSUTF8StringEncoding];
-    for (NSString *line in lines) {
-        NSData *data = [self dataForHistoryLine:line
-                                   withTerminal:terminal
-                         ambiguousIsDoubleWidth:ambiguousIsDoubleWidth
-                                 unicodeVersion:unicodeVersion];
-        if (!data) {
-            return nil;
+    for (TmuxHistoryChunk *chunk in chunks) {
+        NSData *characters = chunk->_characters;
+        const NSUInteger *lineEnds = chunk->_lineEnds.bytes;
+        const NSUInteger count = chunk->_lineEnds.length / sizeof(NSUInteger);
+        NSUInteger start = 0;
+        for (NSUInteger i = 0; i < count; i++) {
+            NSData *line =
+                [[[NSData alloc] initWithBytesNoCopy:(screen_char_t *)characters.bytes + start
+                                              length:(lineEnds[i] - start) * sizeof(screen_char_t)
+                                         deallocator:^(void *bytes, NSUInteger length) {
+                                             // The block retains the chunk's characters until this is freed.
+                                             [characters self];
+                                         }] autorelease];
+            [screenLines addObject:line];
+            start = lineEnds[i];
         }
-        [screenLines addObject:data];
     }
-
     return screenLines;
 }
 
@@ -16,6 +16,13 @@ extern NSString * const kTriggerActionKey;
 extern NSString * const kTriggerParameterKey;
 extern NSString * const kTriggerPartialLineKey;
 
+// A match of a trigger's regex against a line. Matches are found with
+// -[Trigger matchesInString:partialLine:], which may run on any thread, and later handed to
+// -[Trigger performActionForMatches:...] on the main thread.
+@interface iTermTriggerMatch : NSObject
+@property (nonatomic, readonly) NSInteger captureCount;
+@end
+
 @interface Trigger : NSObject
 
 @property (nonatomic, copy) NSString *regex;
@@ -74,6 +81,20 @@ extern NSString * const kTriggerPartialLineKey;
        lineNumber:(long long)lineNumber
  useInterpolation:(BOOL)useInterpolation;
 
+// Returns every match of the regex in |string|. Safe to call on any thread. Returns an empty array
+// for partial lines if this trigger doesn't handle them.
+- (NSArray<iTermTriggerMatch *> *)matchesInString:(NSString *)string partialLine:(BOOL)partialLine;
+
+// Performs the action for matches previously found by -matchesInString:partialLine: and updates
+// per-line state as tryString:... would. Main thread only. Returns YES if no more triggers should
+// be processed.
+- (BOOL)performActionForMatches:(NSArray<iTermTriggerMatch *> *)matches
+                       onString:(iTermStringLine *)stringLine
+                      inSession:(PTYSession *)aSession
+                    partialLine:(BOOL)partialLine
+                     lineNumber:(long long)lineNumber
+               useInterpolation:(BOOL)useInterpolation;
+
 // Subclasses must override this. Return YES if it can fire again on this line.
 - (BOOL)performActionWithCapturedStrings:(NSString *const *)capturedStrings
                           capturedRanges:(const NSRange *)capturedRanges
@@ -21,6 +21,51 @@ NSString * const kTriggerActionKey = @"action";
 NSString * const kTriggerParameterKey = @"parameter";
 NSString * const kTriggerPartialLineKey = @"partial";
 
+@interface iTermTriggerMatch()
+@property (nonatomic, readonly) const NSRange *capturedRanges;
+- (instancetype)initWithCapturedStrings:(NSString *const __unsafe_unretained *)capturedStrings
+                                 ranges:(const NSRange *)capturedRanges
+                                  count:(NSInteger)count;
+- (void)getCapturedStrings:(NSString *__unsafe_unretained *)capturedStrings;
+@end
+
+@implementation iTermTriggerMatch {
+    // Capture groups that didn't participate in the match hold NSNull.
+    NSArray *_capturedStrings;
+    NSData *_capturedRangesData;
+}
+
+- (instancetype)initWithCapturedStrings:(NSString *const __unsafe_unretained *)capturedStrings
+                                 ranges:(const NSRange *)capturedRanges
+                                  count:(NSInteger)count {
+    self = [super init];
+    if (self) {
+        NSMutableArray *strings = [NSMutableArray arrayWithCapacity:count];
+        for (NSInteger i = 0; i < count; i++) {
+            [strings addObject:capturedStrings[i] ?: [NSNull null]];
+        }
+        _capturedStrings = strings;
+        _capturedRangesData = [NSData dataWithBytes:capturedRanges length:sizeof(NSRange) * count];
+    }
+    return self;
+}
+
+- (NSInteger)captureCount {
+    return _capturedStrings.count;
+}
+
+- (const NSRange *)capturedRanges {
+    return (const NSRange *)_capturedRangesData.bytes;
+}
+
+- (void)getCapturedStrings:(NSString *__unsafe_unretained *)capturedStrings {
+    [_capturedStrings enumerateObjectsUsingBlock:^(id obj, NSUInteger i, BOOL *stop) {
+        capturedStrings[i] = [obj isKindOfClass:[NSString class]] ? obj : nil;
+    }];
+}
+
+@end
+
 @interface Trigger()<iTermObject>
 @end
 
@@ -134,9 +179,50 @@ NSString * const kTriggerPartialLineKey = @"partial";
       partialLine:(BOOL)partialLine
        lineNumber:(long long)lineNumber
  useInterpolation:(BOOL)useInterpolation {
-    if (_partialLine &&
-        !self.instantTriggerCanFireMultipleTimesPerLine &&
-        _lastLineNumber == lineNumber) {
+    // Don't bother running the regex if the action can't be performed.
+    NSArray<iTermTriggerMatch *> *matches = @[];
+    if (![self hasFiredOnPartialLine:lineNumber]) {
+        matches = [self matchesInString:stringLine.stringValue partialLine:partialLine];
+    }
+    return [self performActionForMatches:matches
+                                onString:stringLine
+                               inSession:aSession
+                             partialLine:partialLine
+                              lineNumber:lineNumber
+                        useInterpolation:useInterpolation];
+}
+
+- (BOOL)hasFiredOnPartialLine:(long long)lineNumber {
+    return (_partialLine &&
+            !self.instantTriggerCanFireMultipleTimesPerLine &&
+            _lastLineNumber == lineNumber);
+}
+
+- (NSArray<iTermTriggerMatch *> *)matchesInString:(NSString *)string partialLine:(BOOL)partialLine {
+    if (partialLine && !_partialLine) {
+        // This trigger doesn't support partial lines.
+        return @[];
+    }
+    NSMutableArray<iTermTriggerMatch *> *matches = [NSMutableArray array];
+    [string enumerateStringsMatchedByRegex:regex_
+                                usingBlock:^(NSInteger captureCount,
+                                             NSString *const __unsafe_unretained *capturedStrings,
+                                             const NSRange *capturedRanges,
+                                             volatile BOOL *const stopEnumerating) {
+                                    [matches addObject:[[iTermTriggerMatch alloc] initWithCapturedStrings:capturedStrings
+                                                                                                   ranges:capturedRanges
+                                                                                                    count:captureCount]];
+                                }];
+    return matches;
+}
+
+- (BOOL)performActionForMatches:(NSArray<iTermTriggerMatch *> *)matches
+                       onString:(iTermStringLine *)stringLine
+                      inSession:(PTYSession *)aSession
+                    partialLine:(BOOL)partialLine
+                     lineNumber:(long long)lineNumber
+               useInterpolation:(BOOL)useInterpolation {
+    if ([self hasFiredOnPartialLine:lineNumber]) {
         // Already fired a on a partial line on this line.
         if (!partialLine) {
             _lastLineNumber = -1;
@@ -148,26 +234,24 @@ NSString * const kTriggerPartialLineKey = @"partial";
         return NO;
     }
 
-    __block BOOL stopFutureTriggersFromRunningOnThisLine = NO;
-    NSString *s = stringLine.stringValue;
-    [s enumerateStringsMatchedByRegex:regex_
-                           usingBlock:^(NSInteger captureCount,
-                                        NSString *const __unsafe_unretained *capturedStrings,
-                                        const NSRange *capturedRanges,
-                                        volatile BOOL *const stopEnumerating) {
-                               self->_lastLineNumber = lineNumber;
-                               DLog(@"Trigger %@ matched string %@", self, s);
-                               if (![self performActionWithCapturedStrings:capturedStrings
-                                                            capturedRanges:capturedRanges
-                                                              captureCount:captureCount
-                                                                 inSession:aSession
-                                                                  onString:stringLine
-                                                      atAbsoluteLineNumber:lineNumber
-                                                          useInterpolation:useInterpolation
-                                                                      stop:&stopFutureTriggersFromRunningOnThisLine]) {
-                                   *stopEnumerating = YES;
-                               }
-                           }];
+    BOOL stopFutureTriggersFromRunningOnThisLine = NO;
+    for (iTermTriggerMatch *match in matches) {
+        _lastLineNumber = lineNumber;
+        DLog(@"Trigger %@ matched string %@", self, stringLine.stringValue);
+        const NSInteger captureCount = match.captureCount;
+        NSString *__unsafe_unretained capturedStrings[captureCount];
+        [match getCapturedStrings:capturedStrings];
+        if (![self performActionWithCapturedStrings:capturedStrings
+                                     capturedRanges:match.capturedRanges
+                                       captureCount:captureCount
+                                          inSession:aSession
+                                           onString:stringLine
+                               atAbsoluteLineNumber:lineNumber
+                                   useInterpolation:useInterpolation
+                                               stop:&stopFutureTriggersFromRunningOnThisLine]) {
+            break;
+        }
+    }
     if (!partialLine) {
         _lastLineNumber = -1;
     }
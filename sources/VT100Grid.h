@@ -249,7 +249,8 @@
 // TODO: write a test for this
 - (void)insertChar:(screen_char_t)c at:(VT100GridCoord)pos times:(int)num;
 
-// Returns an array of NSData for lines in order (corresponding with lines on screen).
+// Returns an array of NSData for lines in order (corresponding with lines on screen). The data
+// point into the grid's storage without copying, so use them before the grid is next modified.
 - (NSArray *)orderedLines;
 
 // Restore saved state excluding screen contents.
@@ -9,6 +9,7 @@
 #import "VT100Grid.h"
 
 #import "DebugLogging.h"
+#import "iTermMalloc.h"
 #import "LineBuffer.h"
 #import "NSDictionary+iTerm.h"
 #import "VT100GridTypes.h"
@@ -21,14 +22,12 @@ static NSString *const kGridScrollRegionColumnsKey = @"Scroll Region Columns";
 static NSString *const kGridUseScrollRegionColumnsKey = @"Use Scroll Region Columns";
 static NSString *const kGridSizeKey = @"Size";
 
-@interface VT100Grid ()
-@property(nonatomic, readonly) NSArray *lines;  // Warning: not in order found on screen!
-@end
-
 @implementation VT100Grid {
     VT100GridSize size_;
-    int screenTop_;  // Index into lines_ and dirty_ of first line visible in the grid.
-    NSMutableArray *lines_;  // Array of NSMutableData. Each data has size_.width+1 screen_char_t's.
+    int screenTop_;  // Index into lines_ and lineInfos_ of first line visible in the grid.
+    // size_.height rows of size_.width+1 screen_char_t's in one allocation. Rows are in ring order
+    // starting at screenTop_, so scrolling the whole screen doesn't move any characters.
+    screen_char_t *lines_;
     NSMutableArray *lineInfos_;  // Array of VT100LineInfo.
     id<VT100GridDelegate> delegate_;
     VT100GridCoord cursor_;
@@ -46,7 +45,6 @@ static NSString *const kGridSizeKey = @"Size";
 @synthesize scrollRegionCols = scrollRegionCols_;
 @synthesize useScrollRegionCols = useScrollRegionCols_;
 @synthesize allDirty = allDirty_;
-@synthesize lines = lines_;
 @synthesize savedDefaultChar = savedDefaultChar_;
 @synthesize cursor = cursor_;
 @synthesize delegate = delegate_;
@@ -64,24 +62,16 @@ static NSString *const kGridSizeKey = @"Size";
 }
 
 - (void)dealloc {
-    [lines_ release];
+    free(lines_);
     [lineInfos_ release];
     [cachedDefaultLine_ release];
     [resultLine_ release];
     [super dealloc];
 }
 
-- (NSMutableData *)lineDataAtLineNumber:(int)lineNumber {
-    if (lineNumber >= 0 && lineNumber < size_.height) {
-        return [lines_ objectAtIndex:(screenTop_ + lineNumber) % size_.height];
-    } else {
-        return nil;
-    }
-}
-
 - (screen_char_t *)screenCharsAtLineNumber:(int)lineNumber {
     assert(lineNumber >= 0);
-    return [[lines_ objectAtIndex:(screenTop_ + lineNumber) % size_.height] mutableBytes];
+    return lines_ + ((screenTop_ + lineNumber) % size_.height) * (size_.width + 1);
 }
 
 - (VT100LineInfo *)lineInfoAtLineNumber:(int)lineNumber {
@@ -348,10 +338,7 @@ static NSString *const kGridSizeKey = @"Size";
     screenTop_ = (screenTop_ + 1) % size_.height;
 
     // Empty contents of last line on screen.
-    NSMutableData *lastLineData = [self lineDataAtLineNumber:(size_.height - 1)];
-    if (lastLineData) {  // This if statement is just to quiet the analyzer.
-        [self clearLineData:lastLineData];
-    }
+    [self clearLineChars:[self screenCharsAtLineNumber:(size_.height - 1)]];
 
     if (lineBuffer) {
         // Mark new line at bottom of screen dirty.
@@ -1618,7 +1605,9 @@ static NSString *const kGridSizeKey = @"Size";
 - (NSArray *)orderedLines {
     NSMutableArray *array = [NSMutableArray array];
     for (int i = 0; i < size_.height; i++) {
-        [array addObject:[self lineDataAtLineNumber:i]];
+        [array addObject:[NSData dataWithBytesNoCopy:[self screenCharsAtLineNumber:i]
+                                              length:sizeof(screen_char_t) * (size_.width + 1)
+                                        freeWhenDone:NO]];
     }
     return array;
 }
@@ -1667,10 +1656,13 @@ static NSString *const kGridSizeKey = @"Size";
 
 #pragma mark - Private
 
-- (NSMutableArray *)linesWithSize:(VT100GridSize)size {
-    NSMutableArray *lines = [[[NSMutableArray alloc] init] autorelease];
+// Returns a malloc()ed buffer of |size.height| default lines.
+- (screen_char_t *)newLinesWithSize:(VT100GridSize)size {
+    const size_t stride = size.width + 1;
+    screen_char_t *lines = iTermMalloc(sizeof(screen_char_t) * stride * MAX(1, size.height));
+    NSData *defaultLine = [self defaultLineOfWidth:size.width];
     for (int i = 0; i < size.height; i++) {
-        [lines addObject:[[[self defaultLineOfWidth:size.width] mutableCopy] autorelease]];
+        memcpy(lines + i * stride, defaultLine.bytes, sizeof(screen_char_t) * stride);
     }
     return lines;
 }
@@ -1727,7 +1719,7 @@ static NSString *const kGridSizeKey = @"Size";
 
     [cachedDefaultLine_ release];
     cachedDefaultLine_ = nil;
-    [self clearLineData:line];
+    [self clearLineChars:line.mutableBytes width:width];
 
     cachedDefaultLine_ = [line retain];
 
@@ -1760,15 +1752,17 @@ static NSString *const kGridSizeKey = @"Size";
     }
 }
 
-- (void)clearLineData:(NSMutableData *)line {
-    int length = (int)([line length] / sizeof(screen_char_t));
-    // Clear length+1 so that continuation is set properly
-    [self clearScreenChars:[line mutableBytes] inRange:VT100GridRangeMake(0, length)];
-    screen_char_t *chars = (screen_char_t *)[line mutableBytes];
-    int width = [line length] / sizeof(screen_char_t) - 1;
+// |chars| holds |width|+1 screen_char_t's.
+- (void)clearLineChars:(screen_char_t *)chars width:(int)width {
+    // Clear width+1 so that continuation is set properly
+    [self clearScreenChars:chars inRange:VT100GridRangeMake(0, width + 1)];
     chars[width].code = EOL_HARD;
 }
 
+- (void)clearLineChars:(screen_char_t *)chars {
+    [self clearLineChars:chars width:size_.width];
+}
+
 // Returns number of lines dropped from line buffer because it exceeded its size (always 0 or 1).
 - (int)appendLineToLineBuffer:(LineBuffer *)lineBuffer
           unlimitedScrollback:(BOOL)unlimitedScrollback {
@@ -1832,9 +1826,9 @@ static NSString *const kGridSizeKey = @"Size";
 - (void)setSize:(VT100GridSize)newSize {
     if (newSize.width != size_.width || newSize.height != size_.height) {
         size_ = newSize;
-        [lines_ release];
+        free(lines_);
         [lineInfos_ release];
-        lines_ = [[self linesWithSize:newSize] retain];
+        lines_ = [self newLinesWithSize:newSize];
         lineInfos_ = [[self lineInfosWithSize:newSize] retain];
         scrollRegionRows_.location = MIN(scrollRegionRows_.location, size_.width - 1);
         scrollRegionRows_.length = MIN(scrollRegionRows_.length,
@@ -2017,11 +2011,7 @@ static void DumpBuf(screen_char_t* p, int n) {
 - (id)copyWithZone:(NSZone *)zone {
     VT100Grid *theCopy = [[VT100Grid alloc] initWithSize:size_
                                                 delegate:delegate_];
-    [theCopy->lines_ release];
-    theCopy->lines_ = [[NSMutableArray alloc] init];
-    for (NSObject *line in lines_) {
-        [theCopy->lines_ addObject:[[line mutableCopy] autorelease]];
-    }
+    memcpy(theCopy->lines_, lines_, sizeof(screen_char_t) * (size_.width + 1) * size_.height);
     [theCopy->lineInfos_ release];
     theCopy->lineInfos_ = [[NSMutableArray alloc] init];
     for (VT100LineInfo *line in lineInfos_) {
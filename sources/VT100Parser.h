@@ -11,6 +11,7 @@
 #import "VT100Token.h"
 
 @class VT100TmuxParser;
+@class VT100TokenPool;
 
 @interface VT100Parser : NSObject
 
@@ -18,15 +19,26 @@
 @property(atomic, assign) NSStringEncoding encoding;
 @property(nonatomic, readonly) int streamLength;
 
+// Tokens added by -addParsedTokensToVector: come from this pool. Give them back to it once they've
+// been executed instead of releasing them.
+@property(nonatomic, readonly) VT100TokenPool *tokenPool;
+
 - (void)putStreamData:(const char *)buffer length:(int)length;
+
+// Like -putStreamData:length: but lets |writer| fill the stream buffer directly, which saves a copy
+// when reading from a file descriptor. |writer| is given room for |capacity| bytes and returns the
+// number it stored. It runs while the parser is locked, so it must not call back into the parser
+// and must not block. Returns the number of bytes added to the stream.
+- (int)appendStreamDataWithCapacity:(int)capacity writer:(int (^)(char *buffer, int capacity))writer;
 - (void)clearStream;
 - (void)forceUnhookDCS:(NSString *)uniqueID;
 - (void)startTmuxRecoveryMode;
 
 // CVector was created for this method. Because so many VT100Token*s are created and destroyed,
-// too much time is spent adjusting their retain counts. Since an iTermObjectPool is used to avoid
+// too much time is spent adjusting their retain counts. Since a VT100TokenPool is used to avoid
 // alloc/dealloc calls, the retain counts aren't useful. Finally, NSMutableArray in OS 10.9 doesn't
-// respect initWithCapacity: for capacities over 16.
+// respect initWithCapacity: for capacities over 16. Each token added to |vector| is owned by the
+// caller.
 - (void)addParsedTokensToVector:(CVector *)vector;
 
 // Reset all state.
@@ -12,6 +12,7 @@
 #import "iTermMalloc.h"
 #import "VT100ControlParser.h"
 #import "VT100StringParser.h"
+#import "VT100TokenPool.h"
 
 #define kDefaultStreamSize 100000
 
@@ -24,6 +25,9 @@
     NSMutableDictionary *_savedStateForPartialParse;
     VT100ControlParser *_controlParser;
     BOOL _dcsHooked;
+    // Capacity requested by the most recent -appendStreamDataWithCapacity:writer: call. The stream
+    // isn't shrunk below this so readers that reuse a large batch size don't realloc every time.
+    int _lastReservation;
 }
 
 - (instancetype)init {
@@ -33,6 +37,7 @@
         _stream = iTermMalloc(_totalStreamLength);
         _savedStateForPartialParse = [[NSMutableDictionary alloc] init];
         _controlParser = [[VT100ControlParser alloc] init];
+        _tokenPool = [[VT100TokenPool alloc] init];
     }
     return self;
 }
@@ -41,6 +46,7 @@
     free(_stream);
     [_savedStateForPartialParse release];
     [_controlParser release];
+    [_tokenPool release];
     [super dealloc];
 }
 
@@ -55,8 +61,7 @@
     unsigned char *datap;
     int datalen;
 
-    VT100Token *token = [VT100Token token];
-    token.string = nil;
+    VT100Token *token = [_tokenPool newToken];
     // get our current position in the stream
     datap = _stream + _streamOffset;
     datalen = _currentStreamLength - _streamOffset;
@@ -69,7 +74,7 @@
         _streamOffset = 0;
         _currentStreamLength = 0;
 
-        if (_totalStreamLength >= kDefaultStreamSize * 2) {
+        if (_totalStreamLength >= MAX(kDefaultStreamSize, _lastReservation) * 2) {
             // We are done with this stream. Get rid of it and allocate a new one
             // to avoid allowing this to grow too big.
             free(_stream);
@@ -189,25 +194,41 @@
         // Don't append the outer wrapper to the output. Earlier, it was unwrapped and the inner
         // tokens were already added.
         if (token->type != DCS_TMUX_CODE_WRAP) {
-            [token retain];
             CVectorAppend(vector, token);
+        } else {
+            [_tokenPool recycleToken:token];
         }
         return YES;
     }
 
+    [_tokenPool recycleToken:token];
     return NO;
 }
 
-- (void)putStreamData:(const char *)buffer length:(int)length {
-    @synchronized(self) {
-        if (_currentStreamLength + length > _totalStreamLength) {
-            // Grow the stream if needed.
-            int n = (length + _currentStreamLength) / kDefaultStreamSize;
+// Ensures there are at least |length| free bytes after the end of the stream. Bytes that have
+// already been parsed are discarded first so the stream doesn't grow without bound while it is
+// continuously fed. Must be called while synchronized on self.
+- (void)reserveStreamCapacity:(int)length {
+    if (_currentStreamLength + length <= _totalStreamLength) {
+        return;
+    }
+    if (_streamOffset > 0) {
+        memmove(_stream, _stream + _streamOffset, _currentStreamLength - _streamOffset);
+        _currentStreamLength -= _streamOffset;
+        _streamOffset = 0;
+    }
+    if (_currentStreamLength + length > _totalStreamLength) {
+        // Grow the stream if needed.
+        int n = (length + _currentStreamLength) / kDefaultStreamSize;
 
-            _totalStreamLength += n * kDefaultStreamSize;
-            _stream = reallocf(_stream, _totalStreamLength);
-        }
+        _totalStreamLength += n * kDefaultStreamSize;
+        _stream = reallocf(_stream, _totalStreamLength);
+    }
+}
 
+- (void)putStreamData:(const char *)buffer length:(int)length {
+    @synchronized(self) {
+        [self reserveStreamCapacity:length];
         memcpy(_stream + _currentStreamLength, buffer, length);
         _currentStreamLength += length;
         assert(_currentStreamLength >= 0);
@@ -217,6 +238,20 @@
     }
 }
 
+- (int)appendStreamDataWithCapacity:(int)capacity writer:(int (^)(char *buffer, int capacity))writer {
+    @synchronized(self) {
+        _lastReservation = capacity;
+        [self reserveStreamCapacity:capacity];
+        const int length = writer((char *)_stream + _currentStreamLength, capacity);
+        if (length <= 0) {
+            return 0;
+        }
+        assert(length <= capacity);
+        _currentStreamLength += length;
+        return length;
+    }
+}
+
 - (int)streamLength {
     @synchronized(self) {
         return _currentStreamLength - _streamOffset;
@@ -209,6 +209,13 @@ extern int kVT100ScreenMinRows;
 - (void)commandDidStartAt:(VT100GridAbsCoord)coord;
 - (BOOL)commandDidEndAtAbsCoord:(VT100GridAbsCoord)coord;
 
+// Like -terminalCurrentDirectoryDidChangeTo: and -terminalSetRemoteHost:, but record the change on
+// the given line rather than the cursor's. Triggers use these because their actions may run after
+// the cursor has moved past the line that matched. A line that has scrolled out of history is
+// treated as the first line.
+- (void)currentDirectoryDidChangeTo:(NSString *)value atAbsoluteLine:(long long)absLine;
+- (void)setRemoteHost:(NSString *)remoteHost atAbsoluteLine:(long long)absLine;
+
 - (VT100GridCoordRange)coordRangeForInterval:(Interval *)interval;
 
 - (BOOL)confirmBigDownloadWithBeforeSize:(NSInteger)sizeBefore
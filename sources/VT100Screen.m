@@ -6,13 +6,16 @@
 #import "DVR.h"
 #import "IntervalTree.h"
 #import "iTermAdvancedSettingsModel.h"
+#import "iTermBase64Decoder.h"
 #import "iTermCapturedOutputMark.h"
 #import "iTermColorMap.h"
+#import "iTermController.h"
 #import "iTermExpose.h"
 #import "iTermNotificationController.h"
 #import "iTermImage.h"
 #import "iTermImageInfo.h"
 #import "iTermImageMark.h"
+#import "iTermLineBlockStore.h"
 #import "iTermURLMark.h"
 #import "iTermPreferences.h"
 #import "iTermSelection.h"
@@ -167,6 +170,9 @@ static const NSInteger VT100ScreenBigFileDownloadThreshold = 1024 * 1024 * 1024;
     // For REP
     screen_char_t _lastCharacter;
     BOOL _lastCharacterIsDoubleWidth;
+
+    // Holds full blocks of scrollback history for window restoration.
+    iTermLineBlockStore *_blockStore;
 }
 
 static NSString *const kInlineFileName = @"name";  // NSString
@@ -175,7 +181,7 @@ static NSString *const kInlineFileWidthUnits = @"width units";  // NSNumber of V
 static NSString *const kInlineFileHeight = @"height";  // NSNumber
 static NSString *const kInlineFileHeightUnits = @"height units"; // NSNumber of VT100TerminalUnits
 static NSString *const kInlineFilePreserveAspectRatio = @"preserve aspect ratio";  // NSNumber bool
-static NSString *const kInlineFileBase64String = @"base64 string";  // NSMutableString
+static NSString *const kInlineFileDecoder = @"decoder";  // iTermBase64Decoder
 static NSString *const kInlineFileInset = @"inset";  // NSValue of NSEdgeInsets
 static NSString *const kInlineFilePreconfirmed = @"preconfirmed";  // NSNumber
 
@@ -251,6 +257,7 @@ static NSString *const kInlineFilePreconfirmed = @"preconfirmed";  // NSNumber
     [_temporaryDoubleBuffer release];
     [_animatedLines release];
     [_copyString release];
+    [_blockStore release];
     [super dealloc];
 }
 
@@ -1175,7 +1182,17 @@ static NSString *const kInlineFilePreconfirmed = @"preconfirmed";  // NSNumber
 
     screen_char_t *buffer;
     buffer = asciiData->screenChars->buffer;
+    [self setUpAsciiScreenChars:buffer length:len];
 
+    [self appendScreenCharArrayAtCursor:buffer
+                                 length:len
+                             shouldFree:NO];
+    STOPWATCH_LAP(appendAsciiDataAtCursor);
+}
+
+// Gives ASCII characters the current colors and, if a graphics character set was selected,
+// translates them into graphics characters.
+- (void)setUpAsciiScreenChars:(screen_char_t *)buffer length:(int)len {
     screen_char_t fg = [terminal_ foregroundColorCode];
     screen_char_t bg = [terminal_ backgroundColorCode];
     screen_char_t zero = { 0 };
@@ -1188,16 +1205,9 @@ static NSString *const kInlineFilePreconfirmed = @"preconfirmed";  // NSNumber
         STOPWATCH_LAP(setUpScreenCharArray);
     }
 
-    // If a graphics character set was selected then translate buffer
-    // characters into graphics characters.
     if (charsetUsesLineDrawingMode_[[terminal_ charset]]) {
         ConvertCharsToGraphicsCharset(buffer, len);
     }
-
-    [self appendScreenCharArrayAtCursor:buffer
-                                 length:len
-                             shouldFree:NO];
-    STOPWATCH_LAP(appendAsciiDataAtCursor);
 }
 
 - (void)appendStringAtCursor:(NSString *)string {
@@ -1222,8 +1232,8 @@ static NSString *const kInlineFilePreconfirmed = @"preconfirmed";  // NSNumber
     screen_char_t *buffer;
     string = StringByNormalizingString(string, _normalization);
     len = [string length];
-    if (3 * len >= kStaticBufferElements) {
-        buffer = dynamicBuffer = (screen_char_t *) calloc(3 * len,
+    if (3 * (len + 1) >= kStaticBufferElements) {
+        buffer = dynamicBuffer = (screen_char_t *) calloc(3 * (len + 1),
                                                           sizeof(screen_char_t));
         assert(buffer);
         if (!buffer) {
@@ -1237,8 +1247,32 @@ static NSString *const kInlineFilePreconfirmed = @"preconfirmed";  // NSNumber
     BOOL predecessorIsDoubleWidth = NO;
     VT100GridCoord pred = [currentGrid_ coordinateBefore:currentGrid_.cursor
                                 movedBackOverDoubleWidth:&predecessorIsDoubleWidth];
+    screen_char_t *predecessor = pred.x >= 0 ? [self getLineAtScreenIndex:pred.y] + pred.x : NULL;
+    len = [self convertNormalizedString:string
+                          toScreenChars:buffer
+                            predecessor:predecessor
+               predecessorIsDoubleWidth:predecessorIsDoubleWidth];
+    [self appendScreenCharArrayAtCursor:buffer
+                                 length:len
+                             shouldFree:NO];
+    if (buffer == dynamicBuffer) {
+        free(buffer);
+    }
+}
+
+// Converts |string| into |buffer|, which must have room for 3 * ([string length] + 1) elements.
+// |predecessor| is the character |string| will follow, or NULL if there isn't one. A combining mark
+// at the start of |string| is joined to it in place. Returns the number of elements of |buffer|
+// to append.
+- (int)convertNormalizedString:(NSString *)string
+                 toScreenChars:(screen_char_t *)buffer
+                   predecessor:(screen_char_t *)predecessor
+      predecessorIsDoubleWidth:(BOOL)predecessorIsDoubleWidth {
     NSString *augmentedString = string;
-    NSString *predecessorString = pred.x >= 0 ? [currentGrid_ stringForCharacterAt:pred] : nil;
+    NSString *predecessorString = nil;
+    if (predecessor && (predecessor->code || predecessor->complexChar)) {
+        predecessorString = CharToStr(predecessor->code, predecessor->complexChar);
+    }
     BOOL augmented = predecessorString != nil;
     if (augmented) {
         augmentedString = [predecessorString stringByAppendingString:string];
@@ -1252,6 +1286,7 @@ static NSString *const kInlineFilePreconfirmed = @"preconfirmed";  // NSNumber
     // and combining marks, replace private codes with replacement characters, swallow zero-
     // width spaces, and set fg/bg colors and attributes.
     BOOL dwc = NO;
+    int len = 0;
     StringToScreenChars(augmentedString,
                         buffer,
                         [terminal_ foregroundColorCode],
@@ -1262,11 +1297,10 @@ static NSString *const kInlineFilePreconfirmed = @"preconfirmed";  // NSNumber
                         &dwc,
                         _normalization,
                         [delegate_ screenUnicodeVersion]);
-    ssize_t bufferOffset = 0;
+    int bufferOffset = 0;
     if (augmented && len > 0) {
-        screen_char_t *theLine = [self getLineAtScreenIndex:pred.y];
-        theLine[pred.x].code = buffer[0].code;
-        theLine[pred.x].complexChar = buffer[0].complexChar;
+        predecessor->code = buffer[0].code;
+        predecessor->complexChar = buffer[0].complexChar;
         bufferOffset++;
 
         if (predecessorIsDoubleWidth && len > 1 && buffer[1].code == DWC_RIGHT) {
@@ -1283,12 +1317,75 @@ static NSString *const kInlineFilePreconfirmed = @"preconfirmed";  // NSNumber
     if (dwc) {
         linebuffer_.mayHaveDoubleWidthCharacter = dwc;
     }
-    [self appendScreenCharArrayAtCursor:buffer + bufferOffset
-                                 length:len - bufferOffset
-                             shouldFree:NO];
-    if (buffer == dynamicBuffer) {
-        free(buffer);
+    len = MAX(0, len - bufferOffset);
+    memmove(buffer, buffer + bufferOffset, len * sizeof(screen_char_t));
+    return len;
+}
+
+- (void)appendStringTokensAtCursor:(VT100Token *const *)tokens count:(int)count {
+    if (!_wraparoundMode) {
+        // Without wraparound, text past the right margin overwrites the last column, so the
+        // character a string follows isn't necessarily the last one appended before it.
+        for (int i = 0; i < count; i++) {
+            if (tokens[i]->type == VT100_ASCIISTRING) {
+                [self appendAsciiDataAtCursor:tokens[i].asciiData];
+            } else {
+                [self appendStringAtCursor:tokens[i].string];
+            }
+        }
+        return;
+    }
+
+    // Convert every token into one buffer so the grid wraps and scrolls the whole run at once.
+    int capacity = 0;
+    NSMutableArray<NSString *> *strings = [NSMutableArray array];
+    for (int i = 0; i < count; i++) {
+        if (tokens[i]->type == VT100_ASCIISTRING) {
+            capacity += tokens[i].asciiData->length;
+        } else if (tokens[i].string.length) {
+            NSString *string = StringByNormalizingString(tokens[i].string, _normalization);
+            [strings addObject:string];
+            capacity += 3 * ((int)string.length + 1);
+        }
+    }
+    screen_char_t *buffer = iTermMalloc(MAX(1, capacity) * sizeof(screen_char_t));
+    int len = 0;
+    int stringIndex = 0;
+    for (int i = 0; i < count; i++) {
+        if (tokens[i]->type == VT100_ASCIISTRING) {
+            AsciiData *asciiData = tokens[i].asciiData;
+            if (asciiData->length < 1) {
+                continue;
+            }
+            memcpy(buffer + len, asciiData->screenChars->buffer, asciiData->length * sizeof(screen_char_t));
+            [self setUpAsciiScreenChars:buffer + len length:asciiData->length];
+            len += asciiData->length;
+        } else if (tokens[i].string.length) {
+            // The string follows the last character in the buffer, or the one before the cursor if
+            // the buffer is still empty.
+            BOOL predecessorIsDoubleWidth = NO;
+            screen_char_t *predecessor = NULL;
+            if (len > 0) {
+                int p = len - 1;
+                if (buffer[p].code == DWC_RIGHT && !buffer[p].complexChar && p > 0) {
+                    p--;
+                    predecessorIsDoubleWidth = YES;
+                }
+                predecessor = buffer + p;
+            } else {
+                VT100GridCoord pred = [currentGrid_ coordinateBefore:currentGrid_.cursor
+                                            movedBackOverDoubleWidth:&predecessorIsDoubleWidth];
+                predecessor = pred.x >= 0 ? [self getLineAtScreenIndex:pred.y] + pred.x : NULL;
+            }
+            len += [self convertNormalizedString:strings[stringIndex++]
+                                   toScreenChars:buffer + len
+                                     predecessor:predecessor
+                        predecessorIsDoubleWidth:predecessorIsDoubleWidth];
+        }
     }
+    [self appendScreenCharArrayAtCursor:buffer
+                                 length:len
+                             shouldFree:YES];
 }
 
 - (void)appendScreenCharArrayAtCursor:(screen_char_t *)buffer
@@ -2253,18 +2350,14 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
     long long lastDeadLocation = [self totalScrollbackOverflow] * (self.width + 1);
     long long totalScrollbackOverflow = [self totalScrollbackOverflow];
     if (lastDeadLocation > 0) {
-        Interval *deadInterval = [Interval intervalWithLocation:0 length:lastDeadLocation + 1];
-        for (id<IntervalTreeObject> obj in [intervalTree_ objectsInInterval:deadInterval]) {
-            if ([obj.entry.interval limit] <= lastDeadLocation) {
-                if ([obj isKindOfClass:[VT100ScreenMark class]]) {
-                    long long theKey = (totalScrollbackOverflow +
-                                        [self coordRangeForInterval:obj.entry.interval].end.y);
-                    [markCache_ removeObjectForKey:@(theKey)];
-                    self.lastCommandMark = nil;
-                }
-                [intervalTree_ removeObject:obj];
+        [intervalTree_ removeObjectsWithLimitAtMost:lastDeadLocation block:^(id<IntervalTreeObject> obj) {
+            if ([obj isKindOfClass:[VT100ScreenMark class]]) {
+                long long theKey = (totalScrollbackOverflow +
+                                    [self coordRangeForInterval:obj.entry.interval].end.y);
+                [markCache_ removeObjectForKey:@(theKey)];
+                self.lastCommandMark = nil;
             }
-        }
+        }];
     }
 }
 
@@ -2318,8 +2411,9 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
                                                                                  line,
                                                                                  0,
                                                                                  line + 1)];
-    NSArray *objects = [intervalTree_ objectsInInterval:interval];
-    for (id<IntervalTreeObject> note in objects) {
+    [intervalTree_ enumerateObjectsFromLocation:interval.location
+                                          limit:interval.limit
+                                          block:^(id<IntervalTreeObject> note, BOOL *stop) {
         if ([note isKindOfClass:[PTYNoteViewController class]]) {
             VT100GridCoordRange range = [self coordRangeForInterval:note.entry.interval];
             VT100GridRange gridRange;
@@ -2335,19 +2429,20 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
             }
             [result addObject:[NSValue valueWithGridRange:gridRange]];
         }
-    }
+    }];
     return result;
 }
 
 - (NSArray *)notesInRange:(VT100GridCoordRange)range {
     Interval *interval = [self intervalForGridCoordRange:range];
-    NSArray *objects = [intervalTree_ objectsInInterval:interval];
     NSMutableArray *notes = [NSMutableArray array];
-    for (id<IntervalTreeObject> o in objects) {
+    [intervalTree_ enumerateObjectsFromLocation:interval.location
+                                          limit:interval.limit
+                                          block:^(id<IntervalTreeObject> o, BOOL *stop) {
         if ([o isKindOfClass:[PTYNoteViewController class]]) {
             [notes addObject:o];
         }
-    }
+    }];
     return notes;
 }
 
@@ -2594,6 +2689,27 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
     [delegate_ screenDidAppendAsciiDataToCurrentLine:asciiData];
 }
 
+- (void)terminalAppendStringTokens:(VT100Token *const *)tokens count:(int)count {
+    if (collectInputForPrinting_) {
+        for (int i = 0; i < count; i++) {
+            if (tokens[i]->type == VT100_ASCIISTRING) {
+                [self terminalAppendAsciiData:tokens[i].asciiData];
+            } else {
+                [self terminalAppendString:tokens[i].string];
+            }
+        }
+        return;
+    }
+    [self appendStringTokensAtCursor:tokens count:count];
+    for (int i = 0; i < count; i++) {
+        if (tokens[i]->type == VT100_ASCIISTRING) {
+            [delegate_ screenDidAppendAsciiDataToCurrentLine:tokens[i].asciiData];
+        } else {
+            [delegate_ screenDidAppendStringToCurrentLine:tokens[i].string];
+        }
+    }
+}
+
 - (void)terminalRingBell {
     [delegate_ screenDidAppendStringToCurrentLine:@"\a"];
     [self activateBell];
@@ -3539,9 +3655,15 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
                                 screenOrigin + self.height);
     Interval *screenInterval = [self intervalForGridCoordRange:screenRange];
     for (id<IntervalTreeObject> note in [intervalTree_ objectsInInterval:screenInterval]) {
-        if (note.entry.interval.location < screenInterval.location) {
-            // Truncate note so that it ends just before screen.
-            note.entry.interval.length = screenInterval.location - note.entry.interval.location;
+        Interval *interval = [[note.entry.interval retain] autorelease];
+        if (interval.location < screenInterval.location) {
+            // Truncate note so that it ends just before screen. The tree needs to know its new
+            // limit, so take it out and put it back.
+            [[note retain] autorelease];
+            [intervalTree_ removeObject:note];
+            [intervalTree_ addObject:note
+                        withInterval:[Interval intervalWithLocation:interval.location
+                                                             length:screenInterval.location - interval.location]];
         }
         if ([note isKindOfClass:[PTYNoteViewController class]]) {
             [(PTYNoteViewController *)note setNoteHidden:YES];
@@ -3565,6 +3687,22 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
 
 - (void)terminalSetRemoteHost:(NSString *)remoteHost {
     DLog(@"Set remote host to %@ %@", remoteHost, self);
+    [self setRemoteHostFromString:remoteHost onLine:[self numberOfLines] - [self height] + currentGrid_.cursorY];
+}
+
+- (void)setRemoteHost:(NSString *)remoteHost atAbsoluteLine:(long long)absLine {
+    DLog(@"Set remote host to %@ at line %@ %@", remoteHost, @(absLine), self);
+    [self setRemoteHostFromString:remoteHost onLine:[self lineNumberForAbsoluteLine:absLine]];
+}
+
+// Converts an absolute line number to one usable with this screen's line-based APIs, clamping
+// lines that have been lost from history to the first line.
+- (int)lineNumberForAbsoluteLine:(long long)absLine {
+    const long long line = absLine - [self totalScrollbackOverflow];
+    return (int)MAX(0, MIN(line, [self numberOfLines] - 1));
+}
+
+- (void)setRemoteHostFromString:(NSString *)remoteHost onLine:(int)line {
     // Search backwards because Windows UPN format includes an @ in the user name. I don't think hostnames would ever have an @ sign.
     NSRange atRange = [remoteHost rangeOfString:@"@" options:NSBackwardsSearch];
     NSString *user = nil;
@@ -3579,11 +3717,15 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
         host = remoteHost;
     }
 
-    [self setHost:host user:user];
+    [self setHost:host user:user onLine:line];
 }
 
 - (void)setHost:(NSString *)host user:(NSString *)user {
-    DLog(@"setHost:%@ user:%@ %@", host, user, self);
+    [self setHost:host user:user onLine:[self numberOfLines] - [self height] + currentGrid_.cursorY];
+}
+
+- (void)setHost:(NSString *)host user:(NSString *)user onLine:(int)line {
+    DLog(@"setHost:%@ user:%@ onLine:%d %@", host, user, line, self);
     VT100RemoteHost *currentHost = [self remoteHostOnLine:[self numberOfLines]];
     if (!host || !user) {
         // A trigger can set the host and user alone. If remoteHost looks like example.com or
@@ -3598,8 +3740,7 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
         }
     }
 
-    int cursorLine = [self numberOfLines] - [self height] + currentGrid_.cursorY;
-    VT100RemoteHost *remoteHostObj = [self setRemoteHost:host user:user onLine:cursorLine];
+    VT100RemoteHost *remoteHostObj = [self setRemoteHost:host user:user onLine:line];
 
     if (![remoteHostObj isEqualToRemoteHost:currentHost]) {
         [delegate_ screenCurrentHostDidChange:remoteHostObj];
@@ -3675,7 +3816,14 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
 }
 
 - (void)terminalCurrentDirectoryDidChangeTo:(NSString *)value {
-    int cursorLine = [self numberOfLines] - [self height] + currentGrid_.cursorY;
+    [self currentDirectoryDidChangeTo:value onLine:[self numberOfLines] - [self height] + currentGrid_.cursorY];
+}
+
+- (void)currentDirectoryDidChangeTo:(NSString *)value atAbsoluteLine:(long long)absLine {
+    [self currentDirectoryDidChangeTo:value onLine:[self lineNumberForAbsoluteLine:absLine]];
+}
+
+- (void)currentDirectoryDidChangeTo:(NSString *)value onLine:(int)cursorLine {
     NSString *dir = value;
     if (!dir.length) {
         dir = [delegate_ screenCurrentWorkingDirectory];
@@ -3775,7 +3923,7 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
                           kInlineFileHeight: @(height),
                           kInlineFileHeightUnits: @(heightUnits),
                           kInlineFilePreserveAspectRatio: @(preserveAspectRatio),
-                          kInlineFileBase64String: [NSMutableString string],
+                          kInlineFileDecoder: [[[iTermBase64Decoder alloc] init] autorelease],
                           kInlineFileInset: [NSValue futureValueWithEdgeInsets:inset],
                           kInlineFilePreconfirmed: @(size >= VT100ScreenBigFileDownloadThreshold) } retain];
     return YES;
@@ -4011,7 +4159,9 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
     if (inlineFileInfo_) {
         DLog(@"Inline file received");
         // TODO: Handle objects other than images.
-        NSData *data = [NSData dataWithBase64EncodedString:inlineFileInfo_[kInlineFileBase64String]];
+        iTermBase64Decoder *decoder = inlineFileInfo_[kInlineFileDecoder];
+        [decoder finish];
+        NSData *data = decoder.numberOfBytesDecoded > 0 ? decoder.data : nil;
         [self appendImageAtCursorWithName:inlineFileInfo_[kInlineFileName]
                                     width:[inlineFileInfo_[kInlineFileWidth] intValue]
                                     units:(VT100TerminalUnits)[inlineFileInfo_[kInlineFileWidthUnits] intValue]
@@ -4045,9 +4195,10 @@ basedAtAbsoluteLineNumber:(long long)absoluteLineNumber
 
 - (void)terminalDidReceiveBase64FileData:(NSString *)data {
     if (inlineFileInfo_) {
-        const NSInteger lengthBefore = [inlineFileInfo_[kInlineFileBase64String] length];
-        [inlineFileInfo_[kInlineFileBase64String] appendString:data];
-        const NSInteger lengthAfter = [inlineFileInfo_[kInlineFileBase64String] length];
+        iTermBase64Decoder *decoder = inlineFileInfo_[kInlineFileDecoder];
+        const NSInteger lengthBefore = decoder.numberOfBytesDecoded;
+        [decoder appendString:data];
+        const NSInteger lengthAfter = decoder.numberOfBytesDecoded;
 
         if (![inlineFileInfo_[kInlineFilePreconfirmed] boolValue]) {
             [self confirmBigDownloadWithBeforeSize:lengthBefore afterSize:lengthAfter];
@@ -5445,16 +5596,37 @@ static void SwapInt(int *a, int *b) {
     }
 }
 
+- (iTermLineBlockStore *)blockStore {
+    // History only goes to disk for users who already have window contents restored, since that's
+    // the only time it's read back.
+    if (![iTermAdvancedSettingsModel saveScrollbackIncrementally] ||
+        ![iTermAdvancedSettingsModel restoreWindowContents] ||
+        ![[iTermController sharedInstance] willRestoreWindowsAtNextLaunch]) {
+        return nil;
+    }
+    if (!_blockStore) {
+        _blockStore = [[iTermLineBlockStore alloc] init];
+    }
+    return _blockStore;
+}
+
 - (NSDictionary *)contentsDictionary {
-    // We want 10k lines of history at 80 cols, and fewer for small widths, to keep the size
-    // reasonable.
-    int maxArea = 10000 * 80;
     int effectiveWidth = self.width ?: 80;
-    int maxLines = MAX(1000, maxArea / effectiveWidth);
+    iTermLineBlockStore *blockStore = [self blockStore];
+    LineBuffer *temp;
+    if (blockStore) {
+        // Full blocks are saved by reference, so all of history can be saved cheaply.
+        temp = [[linebuffer_ newAppendOnlyCopy] autorelease];
+    } else {
+        // We want 10k lines of history at 80 cols, and fewer for small widths, to keep the size
+        // reasonable.
+        int maxArea = 10000 * 80;
+        int maxLines = MAX(1000, maxArea / effectiveWidth);
 
-    // Make a copy of the last blocks of the line buffer; enough to contain at least |maxLines|.
-    LineBuffer *temp = [linebuffer_ appendOnlyCopyWithMinimumLines:maxLines
-                                                           atWidth:effectiveWidth];
+        // Make a copy of the last blocks of the line buffer; enough to contain at least |maxLines|.
+        temp = [linebuffer_ appendOnlyCopyWithMinimumLines:maxLines
+                                                    atWidth:effectiveWidth];
+    }
 
     // Offset for intervals so 0 is the first char in the provided contents.
     int linesDroppedForBrevity = ([linebuffer_ numLinesWithWidth:effectiveWidth] -
@@ -5469,7 +5641,7 @@ static void SwapInt(int *a, int *b) {
         numLines = [currentGrid_ numberOfLinesUsed];
     }
     [currentGrid_ appendLines:numLines toLineBuffer:temp];
-    NSMutableDictionary *dict = [[[temp dictionary] mutableCopy] autorelease];
+    NSMutableDictionary *dict = [[[temp dictionaryWithBlockStore:blockStore] mutableCopy] autorelease];
     dict[kScreenStateKey] =
         [@{ kScreenStateTabStopsKey: [tabStops_ allObjects] ?: @[],
             kScreenStateTerminalKey: [terminal_ stateDictionary] ?: @{},
@@ -5564,7 +5736,21 @@ static void SwapInt(int *a, int *b) {
         }
     }
 
-    LineBuffer *lineBuffer = [[LineBuffer alloc] initWithDictionary:dictionary];
+    iTermLineBlockStore *blockStore = nil;
+    NSString *blockStorePath = [LineBuffer blockStorePathInDictionary:dictionary];
+    if (blockStorePath) {
+        blockStore = [iTermLineBlockStore storeWithContentsOfFile:blockStorePath];
+    }
+    LineBuffer *lineBuffer = [[LineBuffer alloc] initWithDictionary:dictionary blockStore:blockStore];
+    if (!lineBuffer && blockStorePath) {
+        DLog(@"Failed to restore line buffer from block store %@", blockStorePath);
+        lineBuffer = [[LineBuffer alloc] init];
+    }
+    if (blockStore.isWritable) {
+        // Keep appending to the same file so restored blocks needn't be written again.
+        [_blockStore release];
+        _blockStore = [blockStore retain];
+    }
     [lineBuffer setMaxLines:maxScrollbackLines_ + self.height];
     if (!unlimitedScrollback_) {
         [lineBuffer dropExcessLinesWithWidth:self.width];
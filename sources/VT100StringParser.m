@@ -11,7 +11,10 @@
 #import "DebugLogging.h"
 #import "NSStringITerm.h"
 #import "ScreenChar.h"
+#import "VT100StringParserSIMD.h"
 
+// Decodes a run of non-ASCII UTF-8 characters straight to UTF-16 and stores it in token.string,
+// so ParseString doesn't have to decode the bytes a second time through NSString.
 static void DecodeUTF8Bytes(unsigned char *datap,
                             int datalen,
                             int *rmlen,
@@ -22,6 +25,14 @@ static void DecodeUTF8Bytes(unsigned char *datap,
     int utf8DecodeResult;
     int theChar = 0;
 
+    // Find the end of the non-ASCII run first. Every character in it takes at least two bytes and
+    // at most two UTF-16 code units, so this bounds the output.
+    const int runLength = VT100CountNonASCIIBytes(datap, datalen);
+    enum { kMaxStackCharacters = 1024 };
+    unichar stackCharacters[kMaxStackCharacters];
+    unichar *characters = runLength <= kMaxStackCharacters ? stackCharacters : iTermMalloc(runLength * sizeof(unichar));
+    int numCharacters = 0;
+
     while (true) {
         utf8DecodeResult = decode_utf8_char(p, len, &theChar);
         // Stop on error or end of stream.
@@ -34,6 +45,13 @@ static void DecodeUTF8Bytes(unsigned char *datap,
         if (theChar < 0x80) {
             break;
         }
+        if (theChar > 0xffff) {
+            theChar -= 0x10000;
+            characters[numCharacters++] = 0xd800 + (theChar >> 10);
+            characters[numCharacters++] = 0xdc00 + (theChar & 0x3ff);
+        } else {
+            characters[numCharacters++] = theChar;
+        }
         p += utf8DecodeResult;
         len -= utf8DecodeResult;
     }
@@ -44,6 +62,15 @@ static void DecodeUTF8Bytes(unsigned char *datap,
         *rmlen = p - datap;
         assert(p >= datap);
         token->type = VT100_STRING;
+        if (characters == stackCharacters) {
+            token.string = [[[NSString alloc] initWithCharacters:characters
+                                                          length:numCharacters] autorelease];
+        } else {
+            token.string = [[[NSString alloc] initWithCharactersNoCopy:characters
+                                                                length:numCharacters
+                                                          freeWhenDone:YES] autorelease];
+            characters = NULL;
+        }
     } else {
         // Report error or waiting state.
         if (utf8DecodeResult == 0) {
@@ -53,6 +80,9 @@ static void DecodeUTF8Bytes(unsigned char *datap,
             token->type = VT100_INVALID_SEQUENCE;
         }
     }
+    if (characters != stackCharacters) {
+        free(characters);
+    }
 }
 
 
@@ -284,28 +314,15 @@ static void DecodeASCIIBytes(unsigned char *datap,
                              int datalen,
                              int *rmlen,
                              VT100Token *token) {
-    unsigned char *p = datap;
-    int len = datalen;
-
-    // I tried the ideas mentioned here:
-    // http://stackoverflow.com/questions/22218605/is-this-function-a-good-candidate-for-simd-on-intel
-    // (using 8-bytes-at-a-time bit twiddling and SIMD)
-    // and although this while loop completed faster, the overall benchmark speed on spam.cc did
-    // not improve.
-    while (len > 0) {
-        if (*p >= 0x20 && *p <= 0x7f) {
-            p++;
-            len--;
-        } else {
-            break;
-        }
-    }
-    if (len == datalen) {
+    // This used to be a byte-at-a-time loop. An earlier experiment with 8-bytes-at-a-time bit
+    // twiddling didn't move the spam.cc benchmark, but a 16-byte vector compare does on long runs
+    // of printable ASCII.
+    const int length = VT100CountPrintableASCIIBytes(datap, datalen);
+    if (length == 0) {
         *rmlen = 0;
         token->type = VT100_WAIT;
     } else {
-        *rmlen = datalen - len;
-        assert(datalen >= len);
+        *rmlen = length;
         token->type = VT100_ASCIISTRING;
     }
 }
@@ -351,7 +368,7 @@ void ParseString(unsigned char *datap,
         datap[0] = ONECHAR_UNKNOWN;
         result.string = ReplacementString();
         result->type = VT100_STRING;
-    } else if (result->type != VT100_WAIT && !isAscii) {
+    } else if (result->type != VT100_WAIT && !isAscii && !result.string) {
         result.string = [[[NSString alloc] initWithBytes:datap
                                                     length:*rmlen
                                                   encoding:encoding] autorelease];
@@ -0,0 +1,96 @@
+//
+//  VT100StringParserSIMD.h
+//  iTerm2
+//
+//  Vectorized scanners used by VT100StringParser to find the end of a run of bytes. Each has an
+//  SSE2 and a NEON implementation plus a scalar fallback, and they all give identical results.
+//  This is plain C so the benchmark in tests/ can use it.
+//
+
+#ifndef VT100StringParserSIMD_h
+#define VT100StringParserSIMD_h
+
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Returns the number of leading bytes of |p| (up to |len|) in the range [0x20, 0x7f].
+static inline int VT100CountPrintableASCIIBytesScalar(const unsigned char *p, int len) {
+    int i = 0;
+    while (i < len && p[i] >= 0x20 && p[i] <= 0x7f) {
+        i++;
+    }
+    return i;
+}
+
+// Returns the number of leading bytes of |p| (up to |len|) that are >= 0x80.
+static inline int VT100CountNonASCIIBytesScalar(const unsigned char *p, int len) {
+    int i = 0;
+    while (i < len && p[i] >= 0x80) {
+        i++;
+    }
+    return i;
+}
+
+#if defined(__ARM_NEON)
+// Returns a 64-bit mask with four bits per lane of |cmp|, which must hold 0x00 or 0xff per lane.
+static inline uint64_t VT100NEONMovemask(uint8x16_t cmp) {
+    const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+#endif
+
+static inline int VT100CountPrintableASCIIBytes(const unsigned char *p, int len) {
+    int i = 0;
+#if defined(__SSE2__)
+    // As signed bytes, 0x80-0xff are negative, so one signed compare rejects both C0 controls and
+    // high bytes.
+    const __m128i threshold = _mm_set1_epi8(0x20);
+    for (; i + 16 <= len; i += 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i *)(p + i));
+        const int mask = _mm_movemask_epi8(_mm_cmplt_epi8(chunk, threshold));
+        if (mask) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#elif defined(__ARM_NEON)
+    const int8x16_t threshold = vdupq_n_s8(0x20);
+    for (; i + 16 <= len; i += 16) {
+        const int8x16_t chunk = vreinterpretq_s8_u8(vld1q_u8(p + i));
+        const uint64_t mask = VT100NEONMovemask(vcltq_s8(chunk, threshold));
+        if (mask) {
+            return i + (__builtin_ctzll(mask) >> 2);
+        }
+    }
+#endif
+    return i + VT100CountPrintableASCIIBytesScalar(p + i, len - i);
+}
+
+static inline int VT100CountNonASCIIBytes(const unsigned char *p, int len) {
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= len; i += 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i *)(p + i));
+        // High bit clear means ASCII, which ends the run.
+        const int mask = ~_mm_movemask_epi8(chunk) & 0xffff;
+        if (mask) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= len; i += 16) {
+        const uint8x16_t chunk = vld1q_u8(p + i);
+        const uint64_t mask = VT100NEONMovemask(vcltq_u8(chunk, vdupq_n_u8(0x80)));
+        if (mask) {
+            return i + (__builtin_ctzll(mask) >> 2);
+        }
+    }
+#endif
+    return i + VT100CountNonASCIIBytesScalar(p + i, len - i);
+}
+
+#endif /* VT100StringParserSIMD_h */
@@ -116,6 +116,12 @@ typedef struct {
 // Calls appropriate delegate methods to handle a token.
 - (void)executeToken:(VT100Token *)token;
 
+// Executes the token at |index| and returns the number of tokens executed. If it starts a run of
+// string tokens, ASCII or not, the whole run is handed to the delegate at once so the screen does
+// one wrap/scroll pass for it. Nothing can change the graphic rendition between adjacent string
+// tokens, so the run is drawn exactly as the separate tokens would have been.
+- (int)executeTokensInVector:(const CVector *)vector startingAtIndex:(int)index;
+
 - (void)stopReceivingFile;
 
 // Change saved cursor positions to the origin.
@@ -1297,6 +1297,31 @@ static const int kMaxScreenRows = 4096;
     return savedCursor->position;
 }
 
+- (BOOL)canCoalesceStringToken:(VT100Token *)token {
+    // Saved data is echoed to the pasteboard token by token, so leave those alone.
+    return token.isStringType && !token->savingData;
+}
+
+- (int)executeTokensInVector:(const CVector *)vector startingAtIndex:(int)index {
+    VT100Token *first = CVectorGetObject(vector, index);
+    const int n = CVectorCount(vector);
+    int end = index + 1;
+    // While receiving a file or pasteboard contents, string tokens carry base64 data and a
+    // VT100_STRING means the transfer ended, so each must be seen individually.
+    if (!receivingFile_ && !_copyingToPasteboard && [self canCoalesceStringToken:first]) {
+        while (end < n && [self canCoalesceStringToken:CVectorGetObject(vector, end)]) {
+            end++;
+        }
+    }
+    if (end == index + 1) {
+        [self executeToken:first];
+    } else {
+        [delegate_ terminalAppendStringTokens:(VT100Token *const *)vector->elements + index
+                                        count:end - index];
+    }
+    return end - index;
+}
+
 - (void)executeToken:(VT100Token *)token {
     // Handle tmux stuff, which completely bypasses all other normal execution steps.
     if (token->type == DCS_TMUX_HOOK) {
@@ -51,6 +51,9 @@ typedef NS_ENUM(int, VT100TerminalColorIndex) {
 // Append a string at the cursor's position and advance the cursor, scrolling if necessary.
 - (void)terminalAppendString:(NSString *)string;
 - (void)terminalAppendAsciiData:(AsciiData *)asciiData;
+// Appends adjacent string tokens (VT100_ASCIISTRING and VT100_STRING in any order) as though each
+// were appended in turn.
+- (void)terminalAppendStringTokens:(VT100Token *const *)tokens count:(int)count;
 
 // Play/display the bell.
 - (void)terminalRingBell;
@@ -230,7 +230,7 @@ typedef struct {
     ScreenChars *screenChars;
 } AsciiData;
 
-@interface VT100Token : NSObject {
+@interface VT100Token : NSObject<NSCopying> {
 @public
     VT100TerminalTokenType type;
 
@@ -268,6 +268,13 @@ typedef struct {
 
 - (void)setAsciiBytes:(char *)bytes length:(int)length;
 
+// Returns the token to the state of a newly allocated one so VT100TokenPool can hand it out again.
+- (void)prepareForReuse;
+
+// Tokens are recycled once they've been executed, so anything that keeps one past that must keep a
+// copy rather than retain it.
+- (id)copyWithZone:(NSZone *)zone;
+
 // Returns a string for |asciiData|, for convenience (this is slow).
 - (NSString *)stringForAsciiData;
 
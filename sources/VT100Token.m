@@ -53,6 +53,57 @@
     [super dealloc];
 }
 
+- (void)prepareForReuse {
+    type = 0;
+    savingData = NO;
+    code = 0;
+
+    self.string = nil;
+    self.kvpKey = nil;
+    self.kvpValue = nil;
+    self.savedData = nil;
+
+    // Keep the CSI allocation; it's needed by most tokens that aren't plain text.
+    if (_csi) {
+        memset(_csi, 0, sizeof(*_csi));
+    }
+
+    [self freeAsciiData];
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    VT100Token *theCopy = [[VT100Token alloc] init];
+    theCopy->type = type;
+    theCopy->savingData = savingData;
+    theCopy->code = code;
+    theCopy.string = _string;
+    theCopy.kvpKey = _kvpKey;
+    theCopy.kvpValue = _kvpValue;
+    theCopy.savedData = _savedData;
+    if (_csi) {
+        memcpy(theCopy.csi, _csi, sizeof(*_csi));
+    }
+    if (_asciiData.buffer) {
+        [theCopy setAsciiBytes:_asciiData.buffer length:_asciiData.length];
+    }
+    return theCopy;
+}
+
+- (void)freeAsciiData {
+    if (_asciiData.buffer != _asciiData.staticBuffer) {
+        free(_asciiData.buffer);
+    }
+    if (_asciiData.screenChars &&
+        _asciiData.screenChars->buffer != _asciiData.screenChars->staticBuffer) {
+        free(_asciiData.screenChars->buffer);
+    }
+    _asciiData.buffer = NULL;
+    _asciiData.length = 0;
+    _asciiData.screenChars = NULL;
+    _screenChars.buffer = NULL;
+    _screenChars.length = 0;
+}
+
 - (NSString *)codeName {
     NSDictionary *map = @{@(VT100CC_NULL):                    @"VT100CC_NULL",
                           @(VT100CC_SOH):                     @"VT100CC_SOH",
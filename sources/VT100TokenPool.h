@@ -0,0 +1,29 @@
+//
+//  VT100TokenPool.h
+//  iTerm2
+//
+//  Recycles VT100Tokens between the thread that parses a session's input and the threads that
+//  dispose of them after execution, so a steady stream of output doesn't alloc and dealloc a token
+//  (and its CSI parameters) for every escape sequence and run of text.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "CVector.h"
+#import "VT100Token.h"
+
+@interface VT100TokenPool : NSObject
+
+// Returns a fresh token owned by the caller. Only one thread may call this at a time (the parser
+// calls it while synchronized on itself).
+- (VT100Token *)newToken;
+
+// Takes ownership of the tokens in |vector|, which must be the only thing still using them. Each
+// one is reset and kept for reuse, or released if the pool is full, so code that keeps a token
+// after it's executed must keep a copy. Does not destroy |vector|. Safe to call from any thread.
+- (void)recycleTokensInVector:(const CVector *)vector;
+
+// Like -recycleTokensInVector: for a single token.
+- (void)recycleToken:(VT100Token *)token;
+
+@end
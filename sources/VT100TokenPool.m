@@ -0,0 +1,92 @@
+//
+//  VT100TokenPool.m
+//  iTerm2
+//
+
+#import "VT100TokenPool.h"
+
+#import <os/lock.h>
+
+// Bounds the memory held by idle tokens after a burst of output.
+static const int kMaximumPooledTokens = 4096;
+
+@implementation VT100TokenPool {
+    // Tokens ready to hand out. Only touched by the thread calling -newToken, so it needs no lock.
+    CVector _available;
+
+    // Tokens that have been recycled but not yet moved to _available. Guarded by _lock.
+    os_unfair_lock _lock;
+    CVector _returned;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        CVectorCreate(&_available, 256);
+        CVectorCreate(&_returned, 256);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    for (int i = 0; i < CVectorCount(&_available); i++) {
+        [CVectorGetObject(&_available, i) release];
+    }
+    CVectorDestroy(&_available);
+    for (int i = 0; i < CVectorCount(&_returned); i++) {
+        [CVectorGetObject(&_returned, i) release];
+    }
+    CVectorDestroy(&_returned);
+    [super dealloc];
+}
+
+- (VT100Token *)newToken {
+    if (_available.count == 0) {
+        // Take everything that's been returned in one go so the lock is held once per batch of
+        // tokens rather than once per token.
+        os_unfair_lock_lock(&_lock);
+        CVector temp = _available;
+        _available = _returned;
+        _returned = temp;
+        os_unfair_lock_unlock(&_lock);
+    }
+    if (_available.count == 0) {
+        return [[VT100Token alloc] init];
+    }
+    _available.count -= 1;
+    return CVectorGetObject(&_available, _available.count);
+}
+
+- (void)recycleTokensInVector:(const CVector *)vector {
+    const int n = CVectorCount(vector);
+    // Resetting a token may release strings and free buffers, so do it outside the lock. Other
+    // references a token has, like the autorelease pool's for one made with +token, are balanced
+    // by releases that don't look at it again, so the pool's reference is enough to reuse it.
+    for (int i = 0; i < n; i++) {
+        [CVectorGetObject(vector, i) prepareForReuse];
+    }
+
+    int kept;
+    os_unfair_lock_lock(&_lock);
+    kept = MIN(n, MAX(0, kMaximumPooledTokens - _returned.count));
+    for (int i = 0; i < kept; i++) {
+        CVectorAppend(&_returned, CVectorGet(vector, i));
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    for (int i = kept; i < n; i++) {
+        [CVectorGetObject(vector, i) release];
+    }
+}
+
+- (void)recycleToken:(VT100Token *)token {
+    CVector vector = {
+        .capacity = 1,
+        .elements = (void **)&token,
+        .count = 1
+    };
+    [self recycleTokensInVector:&vector];
+}
+
+@end
@@ -36,6 +36,7 @@ extern NSString *const iTermAdvancedSettingsDidChange;
 + (BOOL)acceptOSC7;
 + (double)activeUpdateCadence;
 + (int)adaptiveFrameRateThroughputThreshold;
++ (BOOL)adaptivePasteSpeed;
 + (BOOL)addNewTabAtEndOfTabs;
 + (BOOL)aggressiveBaseCharacterDetection;
 + (BOOL)aggressiveFocusFollowsMouse;
@@ -62,6 +63,9 @@ extern NSString *const iTermAdvancedSettingsDidChange;
 + (double)coloredSelectedTabOutlineStrength;
 + (double)coloredUnselectedTabTextProminence;
 + (double)compactMinimalTabBarHeight;
++ (BOOL)compactScrollback;
++ (BOOL)compressInstantReplay;
++ (BOOL)compressSessionLogs;
 + (BOOL)conservativeURLGuessing;
 + (BOOL)convertTabDragToWindowDragForSolitaryTabInCompactOrMinimalTheme;
 + (BOOL)copyWithStylesByDefault;
@@ -88,6 +92,7 @@ extern NSString *const iTermAdvancedSettingsDidChange;
 + (NSString *)downloadsDirectory;
 + (BOOL)drawBottomLineForHorizontalTabBar;
 + (BOOL)drawOutlineAroundCursor;
++ (BOOL)dropSessionLogOutputWhenBehind;
 + (BOOL)dwcLineCache;
 + (NSString *)dynamicProfilesPath;
 + (double)echoProbeDuration;
@@ -120,6 +125,7 @@ extern NSString *const iTermAdvancedSettingsDidChange;
 + (double)idleTimeSeconds;
 + (BOOL)ignoreHardNewlinesInURLs;
 + (BOOL)includePasteHistoryInAdvancedPaste;
++ (BOOL)indexScrollbackForSearch;
 + (BOOL)indicateBellsInDockBadgeLabel;
 + (double)indicatorFlashInitialAlpha;
 + (double)invalidateShadowTimesPerSecond;
@@ -132,6 +138,8 @@ extern NSString *const iTermAdvancedSettingsDidChange;
 + (BOOL)logRestorableStateSize;
 + (BOOL)lowFiCombiningMarks;
 + (int)maximumBytesToProvideToServices;
++ (int)maximumResidentScrollbackMegabytes;
++ (int)maximumSessionLogMegabytes;
 + (int)maxSemanticHistoryPrefixOrSuffix;
 + (double)metalSlowFrameRate;
 + (BOOL)middleClickClosesTab;
@@ -205,10 +213,12 @@ extern NSString *const iTermAdvancedSettingsDidChange;
 + (BOOL)restoreWindowsWithinScreens;
 + (BOOL)retinaInlineImages;
 + (BOOL)runJobsInServers;
++ (BOOL)saveScrollbackIncrementally;
 + (BOOL)saveToPasteHistoryWhenSecureInputEnabled;
 + (NSString *)searchCommand;
 + (BOOL)sensitiveScrollWheel;
 + (BOOL)serializeOpeningMultipleFullScreenWindows;
++ (int)sessionLogBufferMegabytes;
 + (double)shortLivedSessionDuration;
 + (BOOL)shouldSetLCTerminal;
 + (BOOL)showBlockBoundaries;
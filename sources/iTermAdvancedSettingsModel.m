@@ -327,6 +327,7 @@ DEFINE_BOOL(remapModifiersWithoutEventTap, NO, SECTION_GENERAL @"Disable remappi
 DEFINE_BOOL(alertsIndicateShortcuts, NO, SECTION_GENERAL @"Buttons in modal alerts indicate keyboard shortcuts.\nDo you miss Windows 95? I do.");
 DEFINE_BOOL(showHintsInSplitPaneMenuItems, NO, SECTION_GENERAL @"Show hints in split pane menu items to indicate horizontal vs vertical semantics.\nYou must restart iTerm2 after changing this setting for it to take effect.");
 DEFINE_BOOL(useOldStyleDropDownViews, NO, SECTION_GENERAL @"Use old-style find and paste progress indicator views.\nThis change will only affect new windows.");
+DEFINE_BOOL(indexScrollbackForSearch, YES, SECTION_GENERAL @"Index scrollback history to speed up Find.\nEach block of history keeps a small index of the text it contains so that searches can skip blocks that cannot match. This uses about 2 KB per 8,000 characters of history. You must restart iTerm2 for this setting to take effect.");
 DEFINE_BOOL(loadFromFindPasteboard, YES, SECTION_GENERAL @"Synchronize search queries across windows and applications.\nNormally, when you enter a search query in a Find field all find fields in all applications get updated to hold the same value. This is utter nonsense, and can be disabled by setting this preference to No.");
 DEFINE_STRING(dynamicProfilesPath, @"", SECTION_GENERAL @"Path to folder with dynamic profiles.\nWhen empty, ~/Library/Application Support/iTerm2/DynamicProfiles will be used. You must restart iTerm2 after modifying this setting.");
 DEFINE_STRING(gitSearchPath, @"", SECTION_GENERAL @"$PATH used when running git for the status bar component.\nChange this to use a custom install of git. You must restart iTerm2 for a change here to take effect.");
@@ -396,10 +397,18 @@ DEFINE_BOOL(bootstrapDaemon, YES, SECTION_SESSION @"Allow sessions to survive lo
 DEFINE_BOOL(killJobsInServersOnQuit, YES, SECTION_SESSION @"User-initiated Quit (⌘Q) of iTerm2 will kill all running jobs.\nApplies only when session restoration is on.");
 DEFINE_SETTABLE_BOOL(suppressRestartAnnouncement, SuppressRestartAnnouncement, NO, SECTION_SESSION @"Suppress the Restart Session offer.\nWhen a session terminates, it will offer to restart itself. Turn this on to suppress the offer permanently.");
 DEFINE_BOOL(showSessionRestoredBanner, YES, SECTION_SESSION @"When restoring a session without restoring a running job, draw a banner saying “Session Contents Restored” below the restored contents.");
+DEFINE_BOOL(compactScrollback, YES, SECTION_SESSION @"Store scrollback history compactly.\nCharacters are stored apart from their colors and styles, which are only recorded where they change. Lines are decoded again when they are displayed, searched, or copied.");
+DEFINE_BOOL(saveScrollbackIncrementally, YES, SECTION_SESSION @"Save all scrollback history for window restoration.\nHistory is written to a file in Application Support once, instead of being copied every time window state is saved, so it can all be restored. This only happens when window contents are restored at startup. Unlike the rest of the saved window state, the file is not encrypted. When off, only about 10,000 lines are saved.");
+DEFINE_INT(maximumResidentScrollbackMegabytes, 64, SECTION_SESSION @"Megabytes of scrollback history to keep in memory per session.\nOlder history is moved to a temporary file and read back from disk when it is needed. Set to 0 to keep all history in memory.");
+DEFINE_BOOL(compressInstantReplay, NO, SECTION_SESSION @"Compress instant replay frames.\nMore of a session's history fits in the instant replay buffer, at the cost of some CPU time when the screen is recorded.");
 DEFINE_STRING(autoLogFormat,
               @"\\(creationTimeString).\\(profileName).\\(termid).\\(iterm2.pid).\\(autoLogId).log",
               SECTION_SESSION @"Format for automatic session log filenames.\nSee the Badges documentation for supported substitutions.");
 DEFINE_BOOL(autologAppends, YES, SECTION_SESSION @"Automatic session logging appends to existing files.\nWhen set to No, the file will be overwritten instead.");
+DEFINE_BOOL(compressSessionLogs, NO, SECTION_SESSION @"Compress session logs with gzip.\n.gz is added to the names of log files. Logs can be read with zcat while they are being written.");
+DEFINE_INT(maximumSessionLogMegabytes, 0, SECTION_SESSION @"Start a new session log file after this many megabytes.\nThe old file is renamed with .1 before its extension, and up to five old files are kept. Set to 0 for no limit.");
+DEFINE_INT(sessionLogBufferMegabytes, 4, SECTION_SESSION @"Megabytes of output to buffer per session while its log is being written.\nIf the disk can't keep up, the session stops reading output until the log catches up.");
+DEFINE_BOOL(dropSessionLogOutputWhenBehind, NO, SECTION_SESSION @"Leave output out of session logs when the disk can't keep up.\nBy default the session waits for its log instead. When this is on, you'll be notified the first time a log is missing output.");
 DEFINE_BOOL(focusNewSplitPaneWithFocusFollowsMouse, YES, SECTION_SESSION @"When focus follows mouse is enabled, should new split panes automatically be focused?");
 DEFINE_BOOL(NoSyncSuppressRestartSessionConfirmationAlert, NO, SECTION_SESSION @"Suppress restart session confirmation alert.\nDon't ask for a confirmation when manually restarting a session.");
 
@@ -473,6 +482,7 @@ DEFINE_SETTABLE_BOOL(noSyncSuppressMissingProfileInArrangementWarning, NoSyncSup
 DEFINE_BOOL(trimWhitespaceOnCopy, YES, SECTION_PASTEBOARD @"Trim whitespace when copying to pasteboard.");
 DEFINE_INT(quickPasteBytesPerCall, 667, SECTION_PASTEBOARD @"Number of bytes to paste in each chunk when pasting normally.");
 DEFINE_FLOAT(quickPasteDelayBetweenCalls, 0.01530456, SECTION_PASTEBOARD @"Delay in seconds between chunks when pasting normally.")
+DEFINE_BOOL(adaptivePasteSpeed, YES, SECTION_PASTEBOARD @"Pace normal pastes by how fast the session takes input.\nChunks grow while the session keeps up and shrink when input backs up or it falls behind in echoing what was pasted. When off, or when a paste speed has been chosen in Paste Special, pastes use a fixed chunk size and delay.");
 DEFINE_INT(slowPasteBytesPerCall, 16, SECTION_PASTEBOARD @"Number of bytes to paste in each chunk when pasting slowly.");
 DEFINE_FLOAT(slowPasteDelayBetweenCalls, 0.125, SECTION_PASTEBOARD @"Delay in seconds between chunks when pasting slowly");
 DEFINE_BOOL(copyWithStylesByDefault, NO, SECTION_PASTEBOARD @"Copy to pasteboard on selection includes color and font style.");
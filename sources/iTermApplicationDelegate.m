@@ -51,6 +51,7 @@
 #import "iTermIntegerNumberFormatter.h"
 #import "iTermLaunchExperienceController.h"
 #import "iTermLaunchServices.h"
+#import "iTermLineBlockStore.h"
 #import "iTermLocalHostNameGuesser.h"
 #import "iTermLSOF.h"
 #import "iTermMenuBarObserver.h"
@@ -207,6 +208,7 @@ static BOOL hasBecomeActive = NO;
     BOOL _sparkleRestarting;  // Is Sparkle about to restart the app?
 
     BOOL _orphansAdopted;  // Have orphan servers been adopted?
+    BOOL _savedScrollbackSwept;  // Have unreferenced saved scrollback files been removed?
 
     NSArray<NSDictionary *> *_buriedSessionsState;
 
@@ -1290,6 +1292,14 @@ static BOOL hasBecomeActive = NO;
     } else {
         [self restoreBuriedSessionsState];
     }
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(savedScrollbackMayBeUnreferenced:)
+                                                 name:iTermDidDecodeWindowRestorableStateNotification
+                                               object:nil];
+    // Restoration may already be done.
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [self savedScrollbackMayBeUnreferenced:nil];
+    });
     if ([iTermAPIHelper isEnabled]) {
         [iTermAPIHelper sharedInstance];  // starts the server. Won't ask the user since it's enabled.
     }
@@ -1354,6 +1364,18 @@ static BOOL hasBecomeActive = NO;
     }
 }
 
+- (void)savedScrollbackMayBeUnreferenced:(NSNotification *)notification {
+    if (_savedScrollbackSwept ||
+        [PseudoTerminalRestorer willOpenWindows] ||
+        [[iTermController sharedInstance] numberOfDecodesPending] > 0) {
+        return;
+    }
+    // Every restored session has opened its saved scrollback by now, so any other file is left
+    // over from an earlier launch.
+    _savedScrollbackSwept = YES;
+    [iTermLineBlockStore removeUnreferencedFiles];
+}
+
 - (void)dynamicToolsDidChange:(NSNotification *)notification {
     [iTermToolbeltView populateMenu:toolbeltMenu];
 }
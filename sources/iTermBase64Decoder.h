@@ -0,0 +1,44 @@
+//
+//  iTermBase64Decoder.h
+//  iTerm2
+//
+//  Decodes base64 incrementally as it arrives from the terminal, so a file transfer holds only its
+//  decoded bytes (or, when it goes to a file, a small buffer of them) rather than all of its text.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface iTermBase64Decoder : NSObject
+
+// Bytes decoded so far, including any already written to the output file.
+@property (nonatomic, readonly) long long numberOfBytesDecoded;
+
+// YES once padding or a character outside the base64 alphabet has been seen. Line breaks and
+// spaces are skipped. Like apr_base64_decode, everything after the end is ignored.
+@property (nonatomic, readonly, getter=isFinished) BOOL finished;
+
+// The decoded bytes of a decoder created with -init. Complete after -finish.
+@property (nonatomic, readonly) NSData *data;
+
+// Decodes all of |string| at once. Returns nil if it holds no data.
++ (nullable NSData *)dataByDecodingString:(NSString *)string;
+
+// Decodes into memory.
+- (instancetype)init NS_DESIGNATED_INITIALIZER;
+
+// Decodes into a new file at |path|, replacing any file already there. Returns nil if the file
+// can't be created.
+- (nullable instancetype)initWithOutputPath:(NSString *)path NS_DESIGNATED_INITIALIZER;
+
+- (void)appendString:(NSString *)string;
+- (void)appendBytes:(const char *)bytes length:(size_t)length;
+
+// Decodes a trailing partial group, then flushes and closes the output file if there is one.
+// Returns NO if writing the file failed.
+- (BOOL)finish;
+
+@end
+
+NS_ASSUME_NONNULL_END
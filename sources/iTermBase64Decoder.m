@@ -0,0 +1,378 @@
+//
+//  iTermBase64Decoder.m
+//  iTerm2
+//
+
+#import "iTermBase64Decoder.h"
+
+#import "DebugLogging.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Decoded bytes are written to the output file in chunks of about this size.
+static const size_t kFileBufferSize = 1024 * 1024;
+
+// Values in the decoding table that aren't sextets.
+enum {
+    kSkip = 0x40,  // Line breaks and spaces.
+    kStop = 0x80   // Padding and everything else.
+};
+
+static uint8_t gDecodingTable[256];
+
+// Lookup tables for the vectorized decoders, indexed by one nibble of each character. They
+// implement the "pshufb with bitmask" method from Muła and Lemire's "Faster Base64 Encoding and
+// Decoding using AVX2 Instructions". A character is in the alphabet when its high nibble's bit in
+// kBitForHighNibble is set in kHighNibblesForLowNibble. Adding kShiftForHighNibble maps it to its
+// sextet, except that '/' needs 3 less than the rest of its row.
+static const uint8_t kHighNibblesForLowNibble[16] = {
+    0xa8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf0, 0x54, 0x50, 0x50, 0x50, 0x54
+};
+static const uint8_t kBitForHighNibble[16] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0, 0, 0, 0, 0, 0, 0, 0
+};
+static const int8_t kShiftForHighNibble[16] = {
+    0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+typedef struct {
+    // Sextets of an incomplete group, most recent in the low bits.
+    uint32_t accumulator;
+    int count;
+    BOOL stopped;
+} iTermBase64DecoderState;
+
+#if defined(__SSSE3__)
+// Decodes 16 characters into 12 bytes, storing 16 bytes at |output|. Returns NO without storing
+// anything if a character isn't in the alphabet.
+static inline BOOL iTermBase64DecodeVector(const uint8_t *input, uint8_t *output) {
+    const __m128i characters = _mm_loadu_si128((const __m128i *)input);
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+    const __m128i highNibbles = _mm_and_si128(_mm_srli_epi32(characters, 4), nibbleMask);
+    const __m128i lowNibbles = _mm_and_si128(characters, nibbleMask);
+    const __m128i allowed = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)kHighNibblesForLowNibble), lowNibbles);
+    const __m128i bits = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)kBitForHighNibble), highNibbles);
+    const __m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(allowed, bits), _mm_setzero_si128());
+    if (_mm_movemask_epi8(invalid)) {
+        return NO;
+    }
+    const __m128i slashes = _mm_cmpeq_epi8(characters, _mm_set1_epi8('/'));
+    const __m128i shift = _mm_add_epi8(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)kShiftForHighNibble), highNibbles),
+                                       _mm_and_si128(slashes, _mm_set1_epi8(-3)));
+    const __m128i sextets = _mm_add_epi8(characters, shift);
+    // Combine pairs of sextets into 12-bit values, then pairs of those into 24-bit values, and
+    // gather the three bytes of each in big-endian order.
+    const __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+    const __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    const __m128i bytes = _mm_shuffle_epi8(groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storeu_si128((__m128i *)output, bytes);
+    return YES;
+}
+
+static const size_t kVectorInputSize = 16;
+static const size_t kVectorOutputSize = 12;
+#elif defined(__aarch64__)
+static inline BOOL iTermBase64TranslateVector(uint8x16_t characters, uint8x16_t *sextets) {
+    const uint8x16_t highNibbles = vshrq_n_u8(characters, 4);
+    const uint8x16_t lowNibbles = vandq_u8(characters, vdupq_n_u8(0x0f));
+    const uint8x16_t valid = vtstq_u8(vqtbl1q_u8(vld1q_u8(kHighNibblesForLowNibble), lowNibbles),
+                                      vqtbl1q_u8(vld1q_u8(kBitForHighNibble), highNibbles));
+    if (vminvq_u8(valid) == 0) {
+        return NO;
+    }
+    const uint8x16_t slashes = vceqq_u8(characters, vdupq_n_u8('/'));
+    const uint8x16_t shift = vaddq_u8(vqtbl1q_u8(vld1q_u8((const uint8_t *)kShiftForHighNibble), highNibbles),
+                                      vandq_u8(slashes, vdupq_n_u8(0xfd)));
+    *sextets = vaddq_u8(characters, shift);
+    return YES;
+}
+
+// Decodes 64 characters into 48 bytes. Returns NO without storing anything if a character isn't
+// in the alphabet.
+static inline BOOL iTermBase64DecodeVector(const uint8_t *input, uint8_t *output) {
+    // Lane i of val[j] holds character j of group i.
+    const uint8x16x4_t characters = vld4q_u8(input);
+    uint8x16_t sextets[4];
+    for (int i = 0; i < 4; i++) {
+        if (!iTermBase64TranslateVector(characters.val[i], &sextets[i])) {
+            return NO;
+        }
+    }
+    uint8x16x3_t bytes;
+    bytes.val[0] = vorrq_u8(vshlq_n_u8(sextets[0], 2), vshrq_n_u8(sextets[1], 4));
+    bytes.val[1] = vorrq_u8(vshlq_n_u8(sextets[1], 4), vshrq_n_u8(sextets[2], 2));
+    bytes.val[2] = vorrq_u8(vshlq_n_u8(sextets[2], 6), sextets[3]);
+    vst3q_u8(output, bytes);
+    return YES;
+}
+
+static const size_t kVectorInputSize = 64;
+static const size_t kVectorOutputSize = 48;
+#endif
+
+// Output needed to decode |length| characters, including the slop the vector decoder may store
+// past the bytes it produces.
+static size_t iTermBase64MaximumDecodedLength(size_t length) {
+    return (length / 4 + 1) * 3 + 16;
+}
+
+// Decodes as much of |input| as possible into |output| and returns the number of bytes produced.
+static size_t iTermBase64Decode(iTermBase64DecoderState *state,
+                                const uint8_t *input,
+                                size_t length,
+                                uint8_t *output) {
+    const uint8_t *table = gDecodingTable;
+    uint8_t *out = output;
+    size_t i = 0;
+    while (i < length && !state->stopped) {
+        if (state->count == 0) {
+            // Fast paths for complete groups. Anything unusual, such as a line break, falls
+            // through to the one-character-at-a-time loop below.
+#if defined(__SSSE3__) || defined(__aarch64__)
+            while (length - i >= kVectorInputSize && iTermBase64DecodeVector(input + i, out)) {
+                i += kVectorInputSize;
+                out += kVectorOutputSize;
+            }
+#endif
+            while (length - i >= 4) {
+                const uint32_t a = table[input[i]];
+                const uint32_t b = table[input[i + 1]];
+                const uint32_t c = table[input[i + 2]];
+                const uint32_t d = table[input[i + 3]];
+                if ((a | b | c | d) & (kSkip | kStop)) {
+                    break;
+                }
+                const uint32_t group = (a << 18) | (b << 12) | (c << 6) | d;
+                out[0] = group >> 16;
+                out[1] = group >> 8;
+                out[2] = group;
+                out += 3;
+                i += 4;
+            }
+            if (i == length) {
+                break;
+            }
+        }
+        const uint8_t value = table[input[i++]];
+        if (value == kSkip) {
+            continue;
+        }
+        if (value == kStop) {
+            state->stopped = YES;
+            break;
+        }
+        state->accumulator = (state->accumulator << 6) | value;
+        if (++state->count == 4) {
+            out[0] = state->accumulator >> 16;
+            out[1] = state->accumulator >> 8;
+            out[2] = state->accumulator;
+            out += 3;
+            state->accumulator = 0;
+            state->count = 0;
+        }
+    }
+    return out - output;
+}
+
+// Decodes a trailing partial group the way apr_base64_decode does. Returns the number of bytes
+// produced, at most 2.
+static size_t iTermBase64DecodeFinish(iTermBase64DecoderState *state, uint8_t *output) {
+    size_t count = 0;
+    switch (state->count) {
+        case 2:
+            output[count++] = state->accumulator >> 4;
+            break;
+        case 3:
+            output[count++] = state->accumulator >> 10;
+            output[count++] = state->accumulator >> 2;
+            break;
+    }
+    state->accumulator = 0;
+    state->count = 0;
+    state->stopped = YES;
+    return count;
+}
+
+@implementation iTermBase64Decoder {
+    iTermBase64DecoderState _state;
+    uint8_t *_buffer;
+    size_t _length;
+    size_t _capacity;
+    // Output file, or -1 when decoding into memory.
+    int _fd;
+    NSString *_path;
+    BOOL _failed;
+    // Takes ownership of _buffer when an in-memory decoder finishes.
+    NSData *_finishedData;
+}
+
++ (void)initialize {
+    if (self == [iTermBase64Decoder class]) {
+        memset(gDecodingTable, kStop, sizeof(gDecodingTable));
+        const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; i++) {
+            gDecodingTable[(uint8_t)alphabet[i]] = i;
+        }
+        gDecodingTable['\r'] = kSkip;
+        gDecodingTable['\n'] = kSkip;
+        gDecodingTable[' '] = kSkip;
+        gDecodingTable['\t'] = kSkip;
+    }
+}
+
++ (NSData *)dataByDecodingString:(NSString *)string {
+    iTermBase64Decoder *decoder = [[[iTermBase64Decoder alloc] init] autorelease];
+    [decoder appendString:string];
+    [decoder finish];
+    if (decoder.numberOfBytesDecoded == 0) {
+        return nil;
+    }
+    return decoder.data;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _fd = -1;
+    }
+    return self;
+}
+
+- (instancetype)initWithOutputPath:(NSString *)path {
+    self = [super init];
+    if (self) {
+        _path = [path copy];
+        _fd = open(path.fileSystemRepresentation, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (_fd < 0) {
+            DLog(@"Failed to create %@: %s", path, strerror(errno));
+            [self release];
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_fd >= 0) {
+        close(_fd);
+    }
+    free(_buffer);
+    [_path release];
+    [_finishedData release];
+    [super dealloc];
+}
+
+#pragma mark - APIs
+
+- (BOOL)isFinished {
+    return _state.stopped;
+}
+
+- (NSData *)data {
+    return _finishedData ?: [NSData dataWithBytes:_buffer length:_length];
+}
+
+- (void)appendString:(NSString *)string {
+    if (_state.stopped) {
+        return;
+    }
+    // Base64 is ASCII, so there is usually an 8-bit representation to use without copying.
+    const char *ascii = CFStringGetCStringPtr((CFStringRef)string, kCFStringEncodingASCII);
+    if (ascii) {
+        [self appendBytes:ascii length:string.length];
+        return;
+    }
+    char chunk[4096];
+    NSRange remaining = NSMakeRange(0, string.length);
+    while (remaining.length > 0 && !_state.stopped) {
+        NSUInteger used = 0;
+        if (![string getBytes:chunk
+                    maxLength:sizeof(chunk)
+                   usedLength:&used
+                     encoding:NSASCIIStringEncoding
+                      options:0
+                        range:remaining
+               remainingRange:&remaining] || used == 0) {
+            // A character that isn't ASCII is not base64.
+            _state.stopped = YES;
+            break;
+        }
+        [self appendBytes:chunk length:used];
+    }
+}
+
+- (void)appendBytes:(const char *)bytes length:(size_t)length {
+    if (_state.stopped || length == 0) {
+        return;
+    }
+    [self reserve:iTermBase64MaximumDecodedLength(length)];
+    const size_t count = iTermBase64Decode(&_state, (const uint8_t *)bytes, length, _buffer + _length);
+    _length += count;
+    _numberOfBytesDecoded += count;
+    if (_fd >= 0 && _length >= kFileBufferSize) {
+        [self flush];
+    }
+}
+
+- (BOOL)finish {
+    if (_finishedData) {
+        return YES;
+    }
+    [self reserve:2];
+    const size_t count = iTermBase64DecodeFinish(&_state, _buffer + _length);
+    _length += count;
+    _numberOfBytesDecoded += count;
+    if (_fd >= 0) {
+        [self flush];
+        if (close(_fd)) {
+            DLog(@"Failed to close %@: %s", _path, strerror(errno));
+            _failed = YES;
+        }
+        _fd = -1;
+    } else if (!_path) {
+        _finishedData = [[NSData alloc] initWithBytesNoCopy:_buffer length:_length freeWhenDone:YES];
+        _buffer = NULL;
+        _length = 0;
+        _capacity = 0;
+    }
+    return !_failed;
+}
+
+#pragma mark - Private
+
+- (void)reserve:(size_t)count {
+    if (_capacity - _length >= count) {
+        return;
+    }
+    size_t capacity = MAX(_capacity * 2, 4096);
+    while (capacity - _length < count) {
+        capacity *= 2;
+    }
+    _buffer = realloc(_buffer, capacity);
+    _capacity = capacity;
+}
+
+- (void)flush {
+    size_t offset = 0;
+    while (offset < _length && !_failed) {
+        const ssize_t written = write(_fd, _buffer + offset, _length - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            DLog(@"Failed to write %@ bytes to %@: %s", @(_length - offset), _path, strerror(errno));
+            _failed = YES;
+            break;
+        }
+        offset += written;
+    }
+    _length = 0;
+}
+
+@end
@@ -0,0 +1,214 @@
+//
+//  iTermEventQueue.c
+//  iTerm2
+//
+
+#include "iTermEventQueue.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#else
+#include <sys/event.h>
+#include <sys/time.h>
+#endif
+
+// Events are fetched from the kernel in batches of this size.
+#define ITERM_EVENT_QUEUE_BATCH 64
+
+#if defined(__linux__)
+
+static uint64_t iTermEventQueuePack(int fd, uint32_t tag) {
+    return ((uint64_t)tag << 32) | (uint32_t)fd;
+}
+
+static int iTermEventQueueControl(int queue, int fd, uint32_t events, uint32_t tag) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.u64 = iTermEventQueuePack(fd, tag);
+    if (epoll_ctl(queue, EPOLL_CTL_ADD, fd, &event) == 0) {
+        return 0;
+    }
+    if (errno != EEXIST) {
+        return -1;
+    }
+    return epoll_ctl(queue, EPOLL_CTL_MOD, fd, &event);
+}
+
+static uint32_t iTermEventQueueEpollEvents(int filters) {
+    uint32_t events = 0;
+    if (filters & iTermEventQueueFilterRead) {
+        events |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (filters & iTermEventQueueFilterWrite) {
+        events |= EPOLLOUT;
+    }
+    return events;
+}
+
+int iTermEventQueueCreate(void) {
+    return epoll_create1(EPOLL_CLOEXEC);
+}
+
+int iTermEventQueueAddEdgeTriggered(int queue, int fd, int filters, uint32_t tag) {
+    return iTermEventQueueControl(queue, fd, iTermEventQueueEpollEvents(filters) | EPOLLET, tag);
+}
+
+int iTermEventQueueAddOneShot(int queue, int fd, int filters, uint32_t tag) {
+    return iTermEventQueueControl(queue, fd, iTermEventQueueEpollEvents(filters) | EPOLLONESHOT, tag);
+}
+
+int iTermEventQueueSetWriteInterest(int queue, int fd, uint32_t tag, int enabled) {
+    // epoll has one registration per fd, so modify it in place. EPOLLOUT is edge-triggered along
+    // with the read interest, but EPOLL_CTL_MOD reports a write edge if the fd is already writable.
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = iTermEventQueueEpollEvents(iTermEventQueueFilterRead) | EPOLLET;
+    if (enabled) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.u64 = iTermEventQueuePack(fd, tag);
+    return epoll_ctl(queue, EPOLL_CTL_MOD, fd, &event);
+}
+
+void iTermEventQueueRemove(int queue, int fd) {
+    struct epoll_event event;
+    epoll_ctl(queue, EPOLL_CTL_DEL, fd, &event);
+}
+
+int iTermEventQueueWait(int queue, iTermEventQueueEvent *events, int capacity, int timeoutMillis) {
+    struct epoll_event raw[ITERM_EVENT_QUEUE_BATCH];
+    if (capacity > ITERM_EVENT_QUEUE_BATCH) {
+        capacity = ITERM_EVENT_QUEUE_BATCH;
+    }
+    const int n = epoll_wait(queue, raw, capacity, timeoutMillis < 0 ? -1 : timeoutMillis);
+    for (int i = 0; i < n; i++) {
+        const uint32_t flags = raw[i].events;
+        events[i].fd = (int)(uint32_t)raw[i].data.u64;
+        events[i].tag = (uint32_t)(raw[i].data.u64 >> 32);
+        events[i].filters = 0;
+        if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+            events[i].filters |= iTermEventQueueFilterRead;
+        }
+        if (flags & EPOLLOUT) {
+            events[i].filters |= iTermEventQueueFilterWrite;
+        }
+        events[i].eof = (flags & (EPOLLHUP | EPOLLRDHUP)) != 0;
+        events[i].error = (flags & EPOLLERR) ? EIO : 0;
+    }
+    return n;
+}
+
+#else
+
+// Applies |count| changes. EV_RECEIPT makes the kernel report the outcome of every change as an
+// EV_ERROR event (with data 0 on success) rather than stopping at the first failure.
+static int iTermEventQueueApply(int queue, struct kevent *changes, int count) {
+    struct kevent receipts[2];
+    for (int i = 0; i < count; i++) {
+        changes[i].flags |= EV_RECEIPT;
+    }
+    const int n = kevent(queue, changes, count, receipts, count, NULL);
+    if (n < 0) {
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        if ((receipts[i].flags & EV_ERROR) && receipts[i].data != 0) {
+            errno = (int)receipts[i].data;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int iTermEventQueueAdd(int queue, int fd, int filters, uint32_t tag, unsigned short flags) {
+    struct kevent changes[2];
+    int count = 0;
+    if (filters & iTermEventQueueFilterRead) {
+        EV_SET(&changes[count++], fd, EVFILT_READ, EV_ADD | EV_ENABLE | flags, 0, 0, (void *)(uintptr_t)tag);
+    }
+    if (filters & iTermEventQueueFilterWrite) {
+        EV_SET(&changes[count++], fd, EVFILT_WRITE, EV_ADD | EV_ENABLE | flags, 0, 0, (void *)(uintptr_t)tag);
+    }
+    if (count == 0) {
+        return 0;
+    }
+    return iTermEventQueueApply(queue, changes, count);
+}
+
+int iTermEventQueueCreate(void) {
+    const int queue = kqueue();
+    if (queue >= 0) {
+        fcntl(queue, F_SETFD, fcntl(queue, F_GETFD) | FD_CLOEXEC);
+    }
+    return queue;
+}
+
+int iTermEventQueueAddEdgeTriggered(int queue, int fd, int filters, uint32_t tag) {
+    return iTermEventQueueAdd(queue, fd, filters, tag, EV_CLEAR);
+}
+
+int iTermEventQueueAddOneShot(int queue, int fd, int filters, uint32_t tag) {
+    return iTermEventQueueAdd(queue, fd, filters, tag, EV_ONESHOT);
+}
+
+int iTermEventQueueSetWriteInterest(int queue, int fd, uint32_t tag, int enabled) {
+    struct kevent change;
+    if (enabled) {
+        // Level-triggered so it fires right away if the fd became writable before this call.
+        EV_SET(&change, fd, EVFILT_WRITE, EV_ADD | EV_ENABLE | EV_ONESHOT, 0, 0, (void *)(uintptr_t)tag);
+        return iTermEventQueueApply(queue, &change, 1);
+    }
+    EV_SET(&change, fd, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
+    if (iTermEventQueueApply(queue, &change, 1) != 0 && errno != ENOENT) {
+        // ENOENT just means the one-shot registration already fired.
+        return -1;
+    }
+    return 0;
+}
+
+void iTermEventQueueRemove(int queue, int fd) {
+    // Deleting each filter separately so that a missing one doesn't prevent removal of the other.
+    struct kevent change;
+    EV_SET(&change, fd, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+    kevent(queue, &change, 1, NULL, 0, NULL);
+    EV_SET(&change, fd, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
+    kevent(queue, &change, 1, NULL, 0, NULL);
+}
+
+int iTermEventQueueWait(int queue, iTermEventQueueEvent *events, int capacity, int timeoutMillis) {
+    struct kevent raw[ITERM_EVENT_QUEUE_BATCH];
+    if (capacity > ITERM_EVENT_QUEUE_BATCH) {
+        capacity = ITERM_EVENT_QUEUE_BATCH;
+    }
+    struct timespec timeout = {
+        .tv_sec = timeoutMillis / 1000,
+        .tv_nsec = (timeoutMillis % 1000) * 1000000L
+    };
+    const int n = kevent(queue, NULL, 0, raw, capacity, timeoutMillis < 0 ? NULL : &timeout);
+    for (int i = 0; i < n; i++) {
+        events[i].fd = (int)raw[i].ident;
+        events[i].tag = (uint32_t)(uintptr_t)raw[i].udata;
+        events[i].filters = 0;
+        events[i].eof = (raw[i].flags & EV_EOF) != 0;
+        events[i].error = 0;
+        if (raw[i].flags & EV_ERROR) {
+            // The filter couldn't be applied (e.g., EBADF). |data| holds the errno value.
+            events[i].error = raw[i].data ? (int)raw[i].data : EIO;
+            continue;
+        }
+        if (raw[i].filter == EVFILT_READ) {
+            events[i].filters |= iTermEventQueueFilterRead;
+        } else if (raw[i].filter == EVFILT_WRITE) {
+            events[i].filters |= iTermEventQueueFilterWrite;
+        }
+    }
+    return n;
+}
+
+#endif
@@ -0,0 +1,58 @@
+//
+//  iTermEventQueue.h
+//  iTerm2
+//
+//  A thin wrapper around kqueue (or epoll on Linux) used by TaskNotifier in place of select().
+//  Registrations are persistent, so each wakeup costs O(active file descriptors) rather than
+//  O(registered file descriptors), and there is no FD_SETSIZE limit.
+//
+
+#ifndef __iTerm2__iTermEventQueue__
+#define __iTerm2__iTermEventQueue__
+
+#include <stdint.h>
+
+typedef enum {
+    iTermEventQueueFilterRead = 1 << 0,
+    iTermEventQueueFilterWrite = 1 << 1,
+} iTermEventQueueFilter;
+
+typedef struct {
+    int fd;
+    // The tag passed when the file descriptor was registered.
+    uint32_t tag;
+    // Bitmask of iTermEventQueueFilter values that fired.
+    int filters;
+    // Nonzero if the peer hung up. Reads may still return buffered data.
+    int eof;
+    // The errno value if the kernel reported an error for this registration (e.g., the fd was
+    // already closed), otherwise 0.
+    int error;
+} iTermEventQueueEvent;
+
+// Returns a new queue or -1 on failure. The queue is close-on-exec.
+int iTermEventQueueCreate(void);
+
+// Registers |fd| for |filters| until it is removed or closed. Events are edge-triggered: one is
+// delivered each time the fd *becomes* readable or writable, so the consumer must read or write
+// until EAGAIN before it can expect another. Returns 0 on success or -1 with errno set.
+int iTermEventQueueAddEdgeTriggered(int queue, int fd, int filters, uint32_t tag);
+
+// Registers |fd| for |filters| for a single level-triggered event. Re-adding an existing
+// registration rearms it. Returns 0 on success or -1 with errno set.
+int iTermEventQueueAddOneShot(int queue, int fd, int filters, uint32_t tag);
+
+// Turns a level-triggered write registration on or off for an fd that was added with
+// iTermEventQueueAddEdgeTriggered(..., iTermEventQueueFilterRead, ...). Use this only while a
+// write would block so that idle fds don't wake the queue every time their buffer drains.
+// Returns 0 on success or -1 with errno set.
+int iTermEventQueueSetWriteInterest(int queue, int fd, uint32_t tag, int enabled);
+
+// Removes all registrations for |fd|. It is not an error if there are none.
+void iTermEventQueueRemove(int queue, int fd);
+
+// Waits up to |timeoutMillis| for events (forever if negative) and fills in up to |capacity| of
+// them. Returns the number of events, or -1 with errno set.
+int iTermEventQueueWait(int queue, iTermEventQueueEvent *events, int capacity, int timeoutMillis);
+
+#endif /* defined(__iTerm2__iTermEventQueue__) */
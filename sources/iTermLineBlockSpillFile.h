@@ -0,0 +1,30 @@
+//
+//  iTermLineBlockSpillFile.h
+//  iTerm2
+//
+//  A scratch file that holds the characters of LineBlocks that haven't changed in a long time. A
+//  spilled block's characters are mapped back into memory from the file, so they cost no dirty
+//  memory and the kernel reads them back from disk when they're touched and drops them when memory
+//  is needed. The file is unlinked as soon as it's created so nothing is left behind by a crash.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface iTermLineBlockSpillFile : NSObject
+
+// Bytes currently spilled. Space is given back when the data returned by -spillBytes:length: is
+// freed, which may happen on any thread.
+@property (nonatomic, readonly) long long bytesSpilled;
+
+// Returns nil if the file can't be created.
+- (nullable instancetype)init NS_DESIGNATED_INITIALIZER;
+
+// Writes |length| bytes to the file and returns a copy-on-write mapping of them, or nil on
+// failure. The returned object keeps the file open.
+- (nullable NSData *)spillBytes:(const void *)bytes length:(size_t)length;
+
+@end
+
+NS_ASSUME_NONNULL_END
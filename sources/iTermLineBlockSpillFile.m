@@ -0,0 +1,167 @@
+//
+//  iTermLineBlockSpillFile.m
+//  iTerm2
+//
+
+#import "iTermLineBlockSpillFile.h"
+
+#import "DebugLogging.h"
+#include <fcntl.h>
+#include <os/lock.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Spills happen on the main thread, but a spill's data can be freed on any thread, so the
+// allocation state is guarded by _lock.
+@implementation iTermLineBlockSpillFile {
+    int _fd;
+    os_unfair_lock _lock;
+    long long _bytesSpilled;
+    // Offset where the next spill will go. Always a multiple of the page size so each spill can be
+    // mapped on its own.
+    long long _end;
+    // Page-aligned ranges given back by freed spills, keyed by offset, valued by length.
+    NSMutableDictionary<NSNumber *, NSNumber *> *_freeRanges;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        NSString *template = [NSTemporaryDirectory() stringByAppendingPathComponent:@"iTerm2-scrollback.XXXXXX"];
+        char *path = strdup(template.fileSystemRepresentation);
+        _fd = mkstemp(path);
+        if (_fd < 0) {
+            DLog(@"Failed to create spill file from template %s: %s", path, strerror(errno));
+            free(path);
+            [self release];
+            return nil;
+        }
+        unlink(path);
+        free(path);
+        fcntl(_fd, F_SETFD, FD_CLOEXEC);
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _freeRanges = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_fd >= 0) {
+        close(_fd);
+    }
+    [_freeRanges release];
+    [super dealloc];
+}
+
+- (long long)bytesSpilled {
+    os_unfair_lock_lock(&_lock);
+    const long long result = _bytesSpilled;
+    os_unfair_lock_unlock(&_lock);
+    return result;
+}
+
+- (NSData *)spillBytes:(const void *)bytes length:(size_t)length {
+    if (length == 0) {
+        return nil;
+    }
+    const long long pageSize = getpagesize();
+    const long long allocatedLength = (length + pageSize - 1) / pageSize * pageSize;
+    const long long offset = [self allocateRangeOfLength:allocatedLength];
+
+    size_t written = 0;
+    while (written < length) {
+        const ssize_t n = pwrite(_fd, (const char *)bytes + written, length - written, offset + written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            DLog(@"Failed to write %@ bytes to spill file: %s", @(length), strerror(errno));
+            [self freeRangeAtOffset:offset length:allocatedLength];
+            return nil;
+        }
+        written += n;
+    }
+
+    // Private so the owner can't modify the file through it; LineBlock copies the characters out
+    // before changing them anyway.
+    void *mapping = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, _fd, offset);
+    if (mapping == MAP_FAILED) {
+        DLog(@"Failed to map %@ bytes of spill file: %s", @(length), strerror(errno));
+        [self freeRangeAtOffset:offset length:allocatedLength];
+        return nil;
+    }
+    os_unfair_lock_lock(&_lock);
+    _bytesSpilled += length;
+    os_unfair_lock_unlock(&_lock);
+    return [[[NSData alloc] initWithBytesNoCopy:mapping
+                                         length:length
+                                    deallocator:^(void *bytes, NSUInteger length) {
+                                        munmap(bytes, length);
+                                        // The block retains self, which keeps the descriptor open.
+                                        [self didFreeSpillOfLength:length
+                                                            offset:offset
+                                                   allocatedLength:allocatedLength];
+                                    }] autorelease];
+}
+
+#pragma mark - Private
+
+// May be called on any thread.
+- (void)didFreeSpillOfLength:(long long)length
+                      offset:(long long)offset
+             allocatedLength:(long long)allocatedLength {
+    os_unfair_lock_lock(&_lock);
+    _bytesSpilled -= length;
+    os_unfair_lock_unlock(&_lock);
+    [self freeRangeAtOffset:offset length:allocatedLength];
+}
+
+- (long long)allocateRangeOfLength:(long long)length {
+    os_unfair_lock_lock(&_lock);
+    const long long offset = [self lockedAllocateRangeOfLength:length];
+    os_unfair_lock_unlock(&_lock);
+    return offset;
+}
+
+// Must hold _lock.
+- (long long)lockedAllocateRangeOfLength:(long long)length {
+    // First fit. Blocks are nearly all the same size so this rarely has to look far.
+    for (NSNumber *offsetNumber in _freeRanges) {
+        const long long available = [_freeRanges[offsetNumber] longLongValue];
+        if (available < length) {
+            continue;
+        }
+        const long long offset = offsetNumber.longLongValue;
+        [_freeRanges removeObjectForKey:offsetNumber];
+        if (available > length) {
+            _freeRanges[@(offset + length)] = @(available - length);
+        }
+        return offset;
+    }
+    const long long offset = _end;
+    _end += length;
+    return offset;
+}
+
+- (void)freeRangeAtOffset:(long long)offset length:(long long)length {
+#ifdef F_PUNCHHOLE
+    // Give the disk space back. Spilled blocks are freed oldest-first as scrollback is trimmed, so
+    // without this the file would only ever grow.
+    fpunchhole_t args = { 0 };
+    args.fp_offset = offset;
+    args.fp_length = length;
+    if (fcntl(_fd, F_PUNCHHOLE, &args) < 0) {
+        DLog(@"Failed to punch hole in spill file: %s", strerror(errno));
+    }
+#endif
+    os_unfair_lock_lock(&_lock);
+    if (offset + length == _end) {
+        _end = offset;
+        ftruncate(_fd, _end);
+    } else {
+        _freeRanges[@(offset)] = @(length);
+    }
+    os_unfair_lock_unlock(&_lock);
+}
+
+@end
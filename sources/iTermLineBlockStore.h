@@ -0,0 +1,70 @@
+//
+//  iTermLineBlockStore.h
+//  iTerm2
+//
+//  An append-only file of scrollback history for window restoration. A LineBlock that has filled up
+//  never changes again, so it is written here once and saved state refers to it by offset instead
+//  of embedding a copy of it every time state is saved. On restore the file is mapped into memory
+//  and blocks borrow their characters from the mapping, so history is only read from disk when it
+//  is touched.
+//
+//  Files hold unencrypted terminal contents, unlike the state AppKit saves, so stores are only
+//  created when window contents will be restored and the saveScrollbackIncrementally advanced
+//  setting is on.
+//
+
+#import <Foundation/Foundation.h>
+#include <sys/uio.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface iTermLineBlockStore : NSObject
+
+@property (nonatomic, readonly) NSString *path;
+
+// A store is read-only if another store in this process already has its file open for appending.
+@property (nonatomic, readonly, getter=isWritable) BOOL writable;
+
+// Size of the file in bytes.
+@property (nonatomic, readonly) long long fileSize;
+
+// Bytes of records used by the most recent save.
+@property (nonatomic, readonly) long long liveBytes;
+
+// Deletes files in the store directory that no live store refers to. Call once window restoration
+// has finished so that files left by earlier launches, or saved state that was never restored,
+// don't accumulate.
++ (void)removeUnreferencedFiles;
+
+// Opens an existing store. Returns nil if the file can't be read or isn't a store.
++ (nullable instancetype)storeWithContentsOfFile:(NSString *)path;
+
+// Creates a new, empty store with a unique name in Application Support.
+- (nullable instancetype)init;
+
+// Creates a new, empty store at |path|, replacing any file that's there.
+- (nullable instancetype)initWithPath:(NSString *)path NS_DESIGNATED_INITIALIZER;
+
+// Brackets one encoding of a line buffer. Records not used between these calls are garbage. When
+// most of the file is garbage, the next save starts a new file and writes every record again.
+- (void)beginSave;
+- (void)endSave;
+
+// Returns the offset of the record saved for |key|, or -1 if there is none.
+- (long long)offsetOfRecordWithKey:(long long)key;
+
+// Appends a record made of |count| buffers and returns its offset, or -1 on failure.
+- (long long)appendRecordWithKey:(long long)key
+                           parts:(const struct iovec *)parts
+                           count:(int)count;
+
+// Returns the bytes of a record in a file that was opened with +storeWithContentsOfFile:. The
+// returned object refers to the mapped file and does not copy it. Returns nil if out of bounds.
+- (nullable NSData *)dataAtOffset:(long long)offset length:(NSUInteger)length;
+
+// Remembers that a record read with -dataAtOffset:length: holds |key| so it isn't written again.
+- (void)adoptRecordAtOffset:(long long)offset length:(long long)length key:(long long)key;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,357 @@
+//
+//  iTermLineBlockStore.mm
+//  iTerm2
+//
+
+#import "iTermLineBlockStore.h"
+
+extern "C" {
+#import "DebugLogging.h"
+#import "NSFileManager+iTerm.h"
+#import "iTermApplicationDelegate.h"
+}
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+// Identifies the file format. Change it if the layout of a record changes.
+static const char kMagic[8] = { 'i', 'T', 'L', 'B', 'S', '0', '0', '1' };
+
+// Records start on a multiple of this so their contents are aligned when the file is mapped.
+static const long long kRecordAlignment = 8;
+
+// Files smaller than this aren't worth compacting.
+static const long long kMinimumSizeToCompact = 16 * 1024 * 1024;
+
+// Paths of files open for appending. Main thread only.
+static NSMutableSet<NSString *> *gWritablePaths;
+
+// Paths of all files that a live store refers to, including files replaced by compaction that
+// saved state may still name. Counted because a file can be open more than once. Main thread only.
+static NSCountedSet<NSString *> *gReferencedPaths;
+
+// Once the app begins terminating, files are kept so the next launch can restore from them.
+static BOOL gApplicationWillTerminate;
+
+namespace {
+struct iTermLineBlockStoreRecord {
+    long long offset;
+    long long length;
+    // The save that last used this record.
+    long long saveNumber;
+};
+}
+
+// Creates or truncates a file, writes the header, and returns a descriptor for appending to it.
+static int iTermLineBlockStoreCreateFile(NSString *path) {
+    const int fd = open(path.fileSystemRepresentation,
+                        O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC,
+                        0600);
+    if (fd < 0) {
+        DLog(@"Failed to create %@: %s", path, strerror(errno));
+        return -1;
+    }
+    if (write(fd, kMagic, sizeof(kMagic)) != sizeof(kMagic)) {
+        DLog(@"Failed to write header to %@: %s", path, strerror(errno));
+        close(fd);
+        unlink(path.fileSystemRepresentation);
+        return -1;
+    }
+    return fd;
+}
+
+@implementation iTermLineBlockStore {
+    int _fd;
+    // The file as it was when opened, mapped copy-on-write. nil for files created by this process.
+    NSData *_contents;
+    std::unordered_map<long long, iTermLineBlockStoreRecord> _records;
+    long long _saveNumber;
+    long long _liveBytesInCurrentSave;
+    BOOL _needsCompaction;
+    // The file that was replaced by the most recent compaction. Saved state that has not yet been
+    // written to disk may still refer to it, so it is kept until the next compaction replaces it,
+    // the store goes away, or the next launch finds it unreferenced.
+    NSString *_obsoletePath;
+    // Whether _path has been added to gReferencedPaths.
+    BOOL _referenced;
+}
+
++ (void)initialize {
+    if (self == [iTermLineBlockStore class]) {
+        gWritablePaths = [[NSMutableSet alloc] init];
+        gReferencedPaths = [[NSCountedSet alloc] init];
+        [[NSNotificationCenter defaultCenter] addObserverForName:iTermApplicationWillTerminate
+                                                          object:nil
+                                                           queue:nil
+                                                      usingBlock:^(NSNotification * _Nonnull note) {
+                                                          gApplicationWillTerminate = YES;
+                                                      }];
+    }
+}
+
++ (NSString *)directory {
+    return [[[NSFileManager defaultManager] applicationSupportDirectory] stringByAppendingPathComponent:@"SavedScrollback"];
+}
+
++ (NSString *)pathForNewStoreInDirectory:(NSString *)directory {
+    return [directory stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+}
+
++ (instancetype)storeWithContentsOfFile:(NSString *)path {
+    return [[[self alloc] initWithContentsOfFile:path] autorelease];
+}
+
+- (instancetype)init {
+    NSString *directory = [iTermLineBlockStore directory];
+    NSError *error = nil;
+    // History is stored unencrypted, so keep it private to the user.
+    if (![[NSFileManager defaultManager] createDirectoryAtPath:directory
+                                   withIntermediateDirectories:YES
+                                                    attributes:@{ NSFilePosixPermissions: @0700 }
+                                                         error:&error]) {
+        DLog(@"Failed to create %@: %@", directory, error);
+        [self release];
+        return nil;
+    }
+    return [self initWithPath:[iTermLineBlockStore pathForNewStoreInDirectory:directory]];
+}
+
++ (void)removeUnreferencedFiles {
+    NSString *directory = [iTermLineBlockStore directory];
+    NSArray<NSString *> *names = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:directory error:nil];
+    for (NSString *name in names) {
+        NSString *path = [directory stringByAppendingPathComponent:name];
+        if ([gReferencedPaths containsObject:path]) {
+            continue;
+        }
+        DLog(@"Remove unreferenced saved scrollback %@", path);
+        unlink(path.fileSystemRepresentation);
+    }
+}
+
+- (instancetype)initWithPath:(NSString *)path {
+    self = [super init];
+    if (self) {
+        _fd = -1;
+        _path = [path copy];
+        if ([gWritablePaths containsObject:path]) {
+            DLog(@"%@ is already open", path);
+            [self release];
+            return nil;
+        }
+        _fd = iTermLineBlockStoreCreateFile(path);
+        if (_fd < 0) {
+            [self release];
+            return nil;
+        }
+        _fileSize = sizeof(kMagic);
+        _writable = YES;
+        [gWritablePaths addObject:_path];
+        [gReferencedPaths addObject:_path];
+        _referenced = YES;
+    }
+    return self;
+}
+
+- (instancetype)initWithContentsOfFile:(NSString *)path {
+    self = [super init];
+    if (self) {
+        _fd = -1;
+        _path = [path copy];
+        const BOOL writable = ![gWritablePaths containsObject:path];
+        const int fd = open(path.fileSystemRepresentation, (writable ? (O_RDWR | O_APPEND) : O_RDONLY) | O_CLOEXEC);
+        if (fd < 0) {
+            DLog(@"Failed to open %@: %s", path, strerror(errno));
+            [self release];
+            return nil;
+        }
+        struct stat sb;
+        if (fstat(fd, &sb) || sb.st_size < (off_t)sizeof(kMagic)) {
+            DLog(@"Can't use %@: size is %@", path, @(sb.st_size));
+            close(fd);
+            [self release];
+            return nil;
+        }
+        // Private mappings are copy-on-write, so a stray write to a restored block can't reach the
+        // file.
+        void *bytes = mmap(NULL, sb.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (bytes == MAP_FAILED) {
+            DLog(@"Failed to map %@: %s", path, strerror(errno));
+            close(fd);
+            [self release];
+            return nil;
+        }
+        _contents = [[NSData alloc] initWithBytesNoCopy:bytes
+                                                 length:sb.st_size
+                                            deallocator:^(void *bytes, NSUInteger length) {
+                                                munmap(bytes, length);
+                                            }];
+        if (memcmp(bytes, kMagic, sizeof(kMagic))) {
+            DLog(@"%@ has the wrong header", path);
+            close(fd);
+            [self release];
+            return nil;
+        }
+        _fileSize = sb.st_size;
+        [gReferencedPaths addObject:_path];
+        _referenced = YES;
+        if (writable) {
+            _fd = fd;
+            _writable = YES;
+            [gWritablePaths addObject:_path];
+        } else {
+            close(fd);
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_fd >= 0) {
+        close(_fd);
+    }
+    if (_writable) {
+        [gWritablePaths removeObject:_path];
+        if (!gApplicationWillTerminate) {
+            // The session is gone so nothing will be restored from this file.
+            unlink(_path.fileSystemRepresentation);
+        }
+    }
+    if (_referenced) {
+        [gReferencedPaths removeObject:_path];
+    }
+    if (_obsoletePath && !gApplicationWillTerminate) {
+        [self removeObsoleteFile];
+    }
+    [_path release];
+    [_obsoletePath release];
+    [_contents release];
+    [super dealloc];
+}
+
+#pragma mark - APIs
+
+- (void)beginSave {
+    _saveNumber++;
+    _liveBytesInCurrentSave = 0;
+    if (_needsCompaction) {
+        _needsCompaction = NO;
+        [self startNewFile];
+    }
+}
+
+- (void)endSave {
+    _liveBytes = _liveBytesInCurrentSave;
+    if (_writable && _fileSize >= kMinimumSizeToCompact && _liveBytes * 2 < _fileSize) {
+        DLog(@"Only %@ of %@ bytes in %@ are in use. Will compact on next save.",
+             @(_liveBytes), @(_fileSize), _path);
+        _needsCompaction = YES;
+    }
+}
+
+- (long long)offsetOfRecordWithKey:(long long)key {
+    auto it = _records.find(key);
+    if (it == _records.end()) {
+        return -1;
+    }
+    [self recordWasUsed:&it->second];
+    return it->second.offset;
+}
+
+- (long long)appendRecordWithKey:(long long)key
+                           parts:(const struct iovec *)parts
+                           count:(int)count {
+    if (!_writable) {
+        return -1;
+    }
+    static char padding[kRecordAlignment];
+    const long long offset = (_fileSize + kRecordAlignment - 1) / kRecordAlignment * kRecordAlignment;
+    std::vector<struct iovec> iov;
+    iov.reserve(count + 1);
+    iov.push_back({ padding, (size_t)(offset - _fileSize) });
+    size_t expected = offset - _fileSize;
+    for (int i = 0; i < count; i++) {
+        iov.push_back(parts[i]);
+        expected += parts[i].iov_len;
+    }
+    const ssize_t written = writev(_fd, iov.data(), (int)iov.size());
+    if (written != (ssize_t)expected) {
+        DLog(@"Failed to append %@ bytes to %@: %s", @(expected), _path, strerror(errno));
+        // Remove any part of the record that was written so the next one goes in the right place.
+        if (ftruncate(_fd, _fileSize)) {
+            DLog(@"Failed to truncate %@: %s", _path, strerror(errno));
+        }
+        return -1;
+    }
+    _fileSize += expected;
+    iTermLineBlockStoreRecord record = { offset, _fileSize - offset, _saveNumber - 1 };
+    [self recordWasUsed:&record];
+    _records[key] = record;
+    return offset;
+}
+
+- (NSData *)dataAtOffset:(long long)offset length:(NSUInteger)length {
+    NSData *contents = _contents;
+    if (!contents || offset < 0 || offset > (long long)contents.length || length > contents.length - offset) {
+        return nil;
+    }
+    return [[[NSData alloc] initWithBytesNoCopy:(char *)contents.bytes + offset
+                                         length:length
+                                    deallocator:^(void *bytes, NSUInteger length) {
+                                        // The block retains the mapping until this is freed.
+                                        [contents self];
+                                    }] autorelease];
+}
+
+- (void)adoptRecordAtOffset:(long long)offset length:(long long)length key:(long long)key {
+    if (!_writable) {
+        return;
+    }
+    _records[key] = { offset, length, _saveNumber };
+}
+
+#pragma mark - Private
+
+- (void)recordWasUsed:(iTermLineBlockStoreRecord *)record {
+    if (record->saveNumber != _saveNumber) {
+        record->saveNumber = _saveNumber;
+        _liveBytesInCurrentSave += record->length;
+    }
+}
+
+- (void)startNewFile {
+    NSString *path = [iTermLineBlockStore pathForNewStoreInDirectory:[_path stringByDeletingLastPathComponent]];
+    const int fd = iTermLineBlockStoreCreateFile(path);
+    if (fd < 0) {
+        return;
+    }
+    DLog(@"Replace %@ with %@", _path, path);
+    close(_fd);
+    _fd = fd;
+    if (_obsoletePath) {
+        // Every save since the last compaction referred only to _path, and the state holding
+        // those saves has long since been written.
+        [self removeObsoleteFile];
+    }
+    [gWritablePaths removeObject:_path];
+    _obsoletePath = _path;
+    _path = [path copy];
+    [gWritablePaths addObject:_path];
+    [gReferencedPaths addObject:_path];
+    _fileSize = sizeof(kMagic);
+    _records.clear();
+    [_contents release];
+    _contents = nil;
+}
+
+- (void)removeObsoleteFile {
+    unlink(_obsoletePath.fileSystemRepresentation);
+    [gReferencedPaths removeObject:_obsoletePath];
+    [_obsoletePath release];
+    _obsoletePath = nil;
+}
+
+@end
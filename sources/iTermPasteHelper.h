@@ -48,6 +48,23 @@ extern const NSInteger iTermQuickPasteBytesPerCallDefaultValue;
 
 - (iTermVariableScope *)pasteHelperScope;
 
+@optional
+// Delegates that implement these get adaptive pastes, which are paced by how fast the session
+// takes input rather than by a fixed chunk size and delay. Pastes are adaptive only while
+// -pasteHelperCanWriteData returns YES, because otherwise the bytes don't pass through the task
+// whose counters are measured.
+
+// Bytes written that the session hasn't taken yet.
+- (NSUInteger)pasteHelperNumberOfBytesQueuedForWriting;
+
+// Total bytes the session has output.
+- (long long)pasteHelperNumberOfBytesRead;
+
+// Returns YES if encoded bytes can be written directly instead of going through
+// -pasteHelperWriteString:, which is needed for things like tmux and broadcast input.
+- (BOOL)pasteHelperCanWriteData;
+- (void)pasteHelperWriteData:(NSData *)data;
+
 @end
 
 @interface iTermPasteHelper : NSObject
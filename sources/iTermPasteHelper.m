@@ -40,6 +40,12 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
 
     // Paste from the head of this string from a timer until it's empty.
     NSMutableString *_buffer;
+
+    // Used instead of _buffer for adaptive bracketed pastes. The text is encoded once and
+    // written from _dataOffset on.
+    NSData *_data;
+    NSUInteger _dataOffset;
+
     NSTimer *_timer;
     iTermPasteViewManager *_pasteViewManager;
 }
@@ -67,6 +73,7 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
     [_eventQueue release];
     [_pasteContext release];
     [_buffer release];
+    [_data release];
     [_pasteViewManager release];
     if (_timer) {
         [_timer invalidate];
@@ -103,6 +110,8 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
     }
     [_buffer release];
     _buffer = [[NSMutableString alloc] init];
+    [_data release];
+    _data = nil;
     [self hidePasteIndicator];
 }
 
@@ -324,16 +333,44 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
         return;
     }
 
-    [_buffer appendString:pasteEvent.string];
+    const BOOL adaptive = [self shouldPasteEventAdaptively:pasteEvent];
+    if (adaptive && (pasteEvent.flags & kPasteFlagsBracket)) {
+        // Nothing in a bracketed paste runs until the end bracket arrives, so stream the whole
+        // thing as bytes instead of slicing a substring off the front for each chunk.
+        DLog(@"Encode bracketed paste for streaming");
+        [_data release];
+        _data = [[pasteEvent.string dataUsingEncoding:[_delegate pasteHelperEncoding]
+                                 allowLossyConversion:YES] retain];
+        _dataOffset = 0;
+    } else {
+        [_buffer appendString:pasteEvent.string];
+    }
     [self pasteWithBytePerCallPrefKey:pasteEvent.chunkKey
                          defaultValue:pasteEvent.defaultChunkSize
              delayBetweenCallsPrefKey:pasteEvent.delayKey
                          defaultValue:pasteEvent.defaultDelay
                        blockAtNewline:!!(pasteEvent.flags & kPasteFlagsCommands)
                              isUpload:pasteEvent.isUpload
+                             adaptive:adaptive
                              progress:pasteEvent.progress];
 }
 
+// Ordinary pastes are paced by back-pressure when the delegate can measure it. Pastes at a speed
+// the user chose, pastes that wait for the prompt after each line, and uploads keep fixed pacing.
+// So do pastes that don't go straight to the session's own task (tmux, broadcast input), since
+// its counters don't see them.
+- (BOOL)shouldPasteEventAdaptively:(PasteEvent *)pasteEvent {
+    return ([iTermAdvancedSettingsModel adaptivePasteSpeed] &&
+            [_delegate respondsToSelector:@selector(pasteHelperNumberOfBytesQueuedForWriting)] &&
+            [_delegate respondsToSelector:@selector(pasteHelperNumberOfBytesRead)] &&
+            [_delegate respondsToSelector:@selector(pasteHelperCanWriteData)] &&
+            [_delegate pasteHelperCanWriteData] &&
+            !pasteEvent.slow &&
+            !pasteEvent.isUpload &&
+            !(pasteEvent.flags & kPasteFlagsCommands) &&
+            [pasteEvent.chunkKey isEqualToString:@"QuickPasteBytesPerCall"]);
+}
+
 // Outputs 16 bytes every 125ms so that clients that don't buffer input can handle pasting large buffers.
 // Override the constants by setting defaults SlowPasteBytesPerCall and SlowPasteDelayBetweenCalls
 - (void)pasteSlowly:(NSString *)theString {
@@ -345,6 +382,7 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
                          defaultValue:0.125
                        blockAtNewline:NO
                              isUpload:NO
+                             adaptive:NO
                              progress:nil];
 }
 
@@ -360,6 +398,7 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
                          defaultValue:0.01
                        blockAtNewline:NO
                              isUpload:NO
+                             adaptive:NO
                              progress:nil];
 }
 
@@ -408,7 +447,7 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
 - (void)showPasteIndicatorInView:(NSView *)view
          statusBarViewController:(iTermStatusBarViewController *)statusBarViewController {
     _pasteViewManager.pasteContext = _pasteContext;
-    _pasteViewManager.bufferLength = _buffer.length;
+    _pasteViewManager.bufferLength = self.remainingLength;
     [_pasteViewManager startWithViewForDropdown:view
                         statusBarViewController:statusBarViewController];
 }
@@ -418,15 +457,52 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
 }
 
 - (void)updatePasteIndicator {
-    [_pasteViewManager setRemainingLength:_buffer.length];
+    [_pasteViewManager setRemainingLength:self.remainingLength];
+}
+
+// Bytes left to paste for bracketed pastes being streamed, UTF-16 code units otherwise.
+- (NSUInteger)remainingLength {
+    if (_data) {
+        return _data.length - _dataOffset;
+    }
+    return _buffer.length;
+}
+
+- (NSInteger)lengthOfNextChunk {
+    if (!_pasteContext.adaptive) {
+        return _pasteContext.bytesPerCall;
+    }
+    return [_pasteContext numberOfBytesToWriteWithBytesQueued:[_delegate pasteHelperNumberOfBytesQueuedForWriting]
+                                                    bytesRead:[_delegate pasteHelperNumberOfBytesRead]];
+}
+
+- (void)writeNextChunkOfDataWithLength:(NSInteger)maximumLength {
+    const NSUInteger length = MIN((NSUInteger)MAX(0, maximumLength), _data.length - _dataOffset);
+    if (length == 0) {
+        return;
+    }
+    // The delegate copies what it writes, so the chunk can point into _data.
+    NSData *chunk = [NSData dataWithBytesNoCopy:(char *)_data.bytes + _dataOffset
+                                         length:length
+                                   freeWhenDone:NO];
+    [_delegate pasteHelperWriteData:chunk];
+    _dataOffset += length;
+    _pasteContext.bytesWritten = _pasteContext.bytesWritten + length;
+    if (_pasteContext.progress) {
+        _pasteContext.progress(_pasteContext.bytesWritten);
+    }
 }
 
 - (void)pasteNextChunkAndScheduleTimer {
     DLog(@"pasteNextChunkAndScheduleTimer");
     BOOL block = NO;
+    const NSInteger chunkLength = [self lengthOfNextChunk];
+    if (_data) {
+        [self writeNextChunkOfDataWithLength:chunkLength];
+    }
     NSRange range;
     range.location = 0;
-    range.length = MIN(_pasteContext.bytesPerCall, [_buffer length]);
+    range.length = MIN(chunkLength, [_buffer length]);
     if (range.length > 0) {
         if (_pasteContext.blockAtNewline) {
             // If there is a newline in the range about to be pasted, only paste up to and including
@@ -450,7 +526,7 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
     [_buffer replaceCharactersInRange:range withString:@""];
 
     [self updatePasteIndicator];
-    if ([_buffer length] > 0) {
+    if (self.remainingLength > 0) {
         DLog(@"Schedule timer after %@", @(_pasteContext.delayBetweenCalls));
         [_pasteContext updateValues];
         if (!block) {
@@ -462,6 +538,8 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
     } else {
         DLog(@"Done pasting");
         _timer = nil;
+        [_data release];
+        _data = nil;
         [self hidePasteIndicator];
         [_pasteContext release];
         _pasteContext = nil;
@@ -495,6 +573,7 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
                        defaultValue:(float)delayBetweenCallsDefault
                      blockAtNewline:(BOOL)blockAtNewline
                            isUpload:(BOOL)isUpload
+                           adaptive:(BOOL)adaptive
                            progress:(void (^)(NSInteger))progress {
     [_pasteContext release];
     _pasteContext = [[PasteContext alloc] initWithBytesPerCallPrefKey:bytesPerCallKey
@@ -503,11 +582,12 @@ const NSInteger iTermQuickPasteBytesPerCallDefaultValue = 768;
                                                          defaultValue:delayBetweenCallsDefault];
     _pasteContext.blockAtNewline = blockAtNewline;
     _pasteContext.isUpload = isUpload;
+    _pasteContext.adaptive = adaptive;
     _pasteContext.progress = progress;
     const int kPasteBytesPerSecond = 10000;  // This is a wild-ass guess.
     const NSTimeInterval sumOfDelays =
-        _pasteContext.delayBetweenCalls * _buffer.length / _pasteContext.bytesPerCall;
-    const NSTimeInterval timeSpentWriting = _buffer.length / kPasteBytesPerSecond;
+        _pasteContext.delayBetweenCalls * self.remainingLength / _pasteContext.bytesPerCall;
+    const NSTimeInterval timeSpentWriting = self.remainingLength / kPasteBytesPerSecond;
     const NSTimeInterval kMinEstimatedPasteTimeToShowIndicator = 3;
     if (!isUpload) {
         if ((sumOfDelays + timeSpentWriting > kMinEstimatedPasteTimeToShowIndicator) ||
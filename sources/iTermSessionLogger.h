@@ -0,0 +1,75 @@
+//
+//  iTermSessionLogger.h
+//  iTerm2SharedARC
+//
+//  Writes a session's output to a log file without blocking the thread that reads it. Bytes are
+//  copied into a lock-free ring buffer and a private queue drains it with large writes, so a slow
+//  disk or network home directory delays only the log. If the buffer fills, the logger keeps what
+//  doesn't fit and reports that it is behind so the caller can stop reading until it catches up.
+//  Callers that would rather lose log output than slow down can have it dropped instead.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface iTermSessionLogger : NSObject
+
+// The file currently being written.
+@property (nonatomic, readonly) NSString *path;
+
+// Output is gzip compressed.
+@property (nonatomic, readonly) BOOL compressed;
+
+// When the current file has had this many bytes written to it, it is renamed to include ".1"
+// before its extension (older files move to ".2" and so on) and a new file is started. 0 means no
+// limit. Set this and numberOfOldFilesToKeep before logging anything.
+@property (nonatomic) long long maximumFileSize;
+
+// Rotated files beyond this many are deleted. 0 means the file is never rotated, like a
+// maximumFileSize of 0.
+@property (nonatomic) int numberOfOldFilesToKeep;
+
+// If set, output that doesn't fit in the buffer is left out of the log and counted. Otherwise it
+// is kept and isBehind is set until it has been written. Set this before logging anything.
+@property (nonatomic) BOOL dropsBytesWhenFull;
+
+// Called on a private queue when isBehind becomes false.
+@property (nullable, nonatomic, copy) void (^didCatchUp)(void);
+
+// Called the first time output is dropped, on an arbitrary thread.
+@property (nullable, nonatomic, copy) void (^didDropBytes)(void);
+
+// Output that didn't fit in the buffer is waiting to be written. Stop logging more until
+// didCatchUp is called, or this will grow without bound. May be read from any thread.
+@property (nonatomic, readonly, getter=isBehind) BOOL behind;
+
+// Counters. These may be read from any thread.
+
+// Bytes of output written to the log, before compression.
+@property (nonatomic, readonly) long long numberOfBytesLogged;
+// Bytes of output that were not logged because the buffer was full or the file couldn't be
+// written.
+@property (nonatomic, readonly) long long numberOfBytesDropped;
+
+// Opens the file for appending or truncates it. Returns nil if it can't be opened. |bufferSize| is
+// rounded up to a power of 2.
+- (nullable instancetype)initWithPath:(NSString *)path
+                               append:(BOOL)append
+                             compress:(BOOL)compress
+                           bufferSize:(NSUInteger)bufferSize NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+// Buffers bytes to be logged. Never blocks on the disk. It may be called from any thread, but only one thread
+// at a time.
+- (void)logBytes:(const char *)bytes length:(NSUInteger)length;
+
+// Waits until everything buffered so far has been written.
+- (void)flush;
+
+// Writes what's buffered and closes the file. Bytes logged afterwards are ignored.
+- (void)close;
+
+@end
+
+NS_ASSUME_NONNULL_END
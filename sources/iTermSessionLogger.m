@@ -0,0 +1,399 @@
+//
+//  iTermSessionLogger.m
+//  iTerm2SharedARC
+//
+
+#import "iTermSessionLogger.h"
+
+#import "DebugLogging.h"
+#import "iTermMalloc.h"
+
+#include <fcntl.h>
+#include <os/lock.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <zlib.h>
+
+static const NSUInteger kMinimumBufferSize = 4096;
+
+// Compressed output is collected in a buffer this big before it's written.
+static const size_t kDeflatedBufferSize = 256 * 1024;
+
+// Writes all of |parts|, retrying after partial writes. Modifies |parts|.
+static BOOL iTermSessionLoggerWriteFully(int fd, struct iovec *parts, int count) {
+    while (count > 0) {
+        const ssize_t written = writev(fd, parts, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return NO;
+        }
+        size_t remaining = written;
+        while (count > 0 && remaining >= parts[0].iov_len) {
+            remaining -= parts[0].iov_len;
+            parts++;
+            count--;
+        }
+        if (count > 0) {
+            parts[0].iov_base = (char *)parts[0].iov_base + remaining;
+            parts[0].iov_len -= remaining;
+        }
+    }
+    return YES;
+}
+
+@implementation iTermSessionLogger {
+    // A ring buffer of _capacity bytes, which is a power of 2.
+    char *_buffer;
+    size_t _capacity;
+
+    // Total bytes ever added to and removed from the buffer. Their difference is the number of
+    // bytes in it. Only -logBytes:length: changes _head and only _queue changes _tail.
+    _Atomic(unsigned long long) _head;
+    _Atomic(unsigned long long) _tail;
+
+    _Atomic(long long) _bytesLogged;
+    _Atomic(long long) _bytesDropped;
+    _Atomic(bool) _closed;
+    _Atomic(bool) _behind;
+    _Atomic(bool) _reportedDrop;
+
+    // Chunks that didn't fit in the ring buffer, when they aren't dropped. While this is non-empty
+    // new chunks are added here too so output stays in order. _queue removes a chunk only after it
+    // is written.
+    NSMutableArray<NSData *> *_overflow;
+    os_unfair_lock _overflowLock;
+
+    dispatch_queue_t _queue;
+
+    // Wakes _queue to drain the buffer. Signals that arrive while it is draining are coalesced
+    // into one, so a burst of output becomes a few big writes.
+    dispatch_source_t _source;
+
+    // The rest are used only on _queue.
+    int _fd;
+    // Bytes written to the current file, after compression.
+    long long _fileSize;
+    BOOL _streamInitialized;
+    z_stream _stream;
+    char *_deflated;
+}
+
+- (instancetype)initWithPath:(NSString *)path
+                      append:(BOOL)append
+                    compress:(BOOL)compress
+                  bufferSize:(NSUInteger)bufferSize {
+    self = [super init];
+    if (self) {
+        _path = [path copy];
+        _compressed = compress;
+        _numberOfOldFilesToKeep = 5;
+        _fd = -1;
+        _capacity = kMinimumBufferSize;
+        while (_capacity < bufferSize) {
+            _capacity *= 2;
+        }
+        _buffer = iTermMalloc(_capacity);
+        _overflow = [[NSMutableArray alloc] init];
+        _overflowLock = OS_UNFAIR_LOCK_INIT;
+        _queue = dispatch_queue_create("com.iterm2.session-logger", DISPATCH_QUEUE_SERIAL);
+
+        if (compress) {
+            // 16 more window bits asks for a gzip header and trailer.
+            if (deflateInit2(&_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                DLog(@"deflateInit2 failed");
+                return nil;
+            }
+            _streamInitialized = YES;
+            _deflated = iTermMalloc(kDeflatedBufferSize);
+        }
+        if (![self openFileAppending:append]) {
+            return nil;
+        }
+
+        // Create the source last so a failed init doesn't leave one running.
+        _source = dispatch_source_create(DISPATCH_SOURCE_TYPE_DATA_OR, 0, 0, _queue);
+        __weak __typeof(self) weakSelf = self;
+        dispatch_source_set_event_handler(_source, ^{
+            [weakSelf drain];
+        });
+        dispatch_resume(_source);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    // A drain in progress holds a strong reference, so none is running now and none will start.
+    if (_source) {
+        dispatch_source_cancel(_source);
+    }
+    [self drain];
+    [self closeFile];
+    if (_streamInitialized) {
+        deflateEnd(&_stream);
+    }
+    free(_buffer);
+    free(_deflated);
+}
+
+#pragma mark - APIs
+
+- (long long)numberOfBytesLogged {
+    return atomic_load_explicit(&_bytesLogged, memory_order_relaxed);
+}
+
+- (long long)numberOfBytesDropped {
+    return atomic_load_explicit(&_bytesDropped, memory_order_relaxed);
+}
+
+- (BOOL)isBehind {
+    return atomic_load_explicit(&_behind, memory_order_acquire);
+}
+
+- (void)logBytes:(const char *)bytes length:(NSUInteger)length {
+    if (length == 0 || atomic_load_explicit(&_closed, memory_order_relaxed)) {
+        return;
+    }
+    const unsigned long long head = atomic_load_explicit(&_head, memory_order_relaxed);
+    const unsigned long long tail = atomic_load_explicit(&_tail, memory_order_acquire);
+    // Only _queue changes _tail and it only grows, so this stays true once it is.
+    const BOOL fits = (_capacity - (head - tail) >= length);
+    if (!_dropsBytesWhenFull) {
+        os_unfair_lock_lock(&_overflowLock);
+        const BOOL overflowing = (!fits || _overflow.count > 0);
+        if (overflowing) {
+            [_overflow addObject:[NSData dataWithBytes:bytes length:length]];
+            atomic_store_explicit(&_behind, true, memory_order_release);
+        }
+        os_unfair_lock_unlock(&_overflowLock);
+        if (overflowing) {
+            dispatch_source_merge_data(_source, 1);
+            return;
+        }
+    } else if (!fits) {
+        // Drop the whole chunk rather than part of an escape sequence.
+        [self didDropBytes:length];
+        return;
+    }
+    const size_t offset = head & (_capacity - 1);
+    const size_t first = MIN(length, _capacity - offset);
+    memcpy(_buffer + offset, bytes, first);
+    memcpy(_buffer, bytes + first, length - first);
+    atomic_store_explicit(&_head, head + length, memory_order_release);
+    dispatch_source_merge_data(_source, 1);
+}
+
+- (void)flush {
+    dispatch_sync(_queue, ^{
+        [self drain];
+    });
+}
+
+- (void)close {
+    if (atomic_exchange(&_closed, true)) {
+        return;
+    }
+    dispatch_source_cancel(_source);
+    dispatch_sync(_queue, ^{
+        [self drain];
+        [self closeFile];
+    });
+    if (self.numberOfBytesDropped) {
+        DLog(@"Closed %@. %@ bytes were logged and %@ were dropped.",
+             _path, @(self.numberOfBytesLogged), @(self.numberOfBytesDropped));
+    }
+}
+
+#pragma mark - Private
+
+// Runs on _queue.
+- (void)drain {
+    BOOL wroteAnything = NO;
+    if (_fd < 0) {
+        // Nothing can be written, so don't hold up the reader.
+        [self discardBufferedBytes];
+        return;
+    }
+    while (_fd >= 0) {
+        const unsigned long long head = atomic_load_explicit(&_head, memory_order_acquire);
+        const unsigned long long tail = atomic_load_explicit(&_tail, memory_order_relaxed);
+        if (head == tail) {
+            NSData *chunk = [self firstOverflowChunk];
+            if (!chunk) {
+                break;
+            }
+            struct iovec part = { (void *)chunk.bytes, chunk.length };
+            if ([self writeParts:&part count:1]) {
+                atomic_fetch_add_explicit(&_bytesLogged, chunk.length, memory_order_relaxed);
+                wroteAnything = YES;
+            } else {
+                DLog(@"Failed to write %@ bytes to %@: %s", @(chunk.length), _path, strerror(errno));
+                [self didDropBytes:chunk.length];
+            }
+            [self removeFirstOverflowChunk];
+            [self rotateIfNeeded];
+            continue;
+        }
+        const size_t length = head - tail;
+        const size_t offset = tail & (_capacity - 1);
+        const size_t first = MIN(length, _capacity - offset);
+        struct iovec parts[2] = {
+            { _buffer + offset, first },
+            { _buffer, length - first }
+        };
+        if ([self writeParts:parts count:(length > first) ? 2 : 1]) {
+            atomic_fetch_add_explicit(&_bytesLogged, length, memory_order_relaxed);
+            wroteAnything = YES;
+        } else {
+            DLog(@"Failed to write %@ bytes to %@: %s", @(length), _path, strerror(errno));
+            [self didDropBytes:length];
+        }
+        atomic_store_explicit(&_tail, head, memory_order_release);
+        [self rotateIfNeeded];
+    }
+    if (_fd < 0) {
+        // Rotation failed to open a new file.
+        [self discardBufferedBytes];
+    }
+    if (wroteAnything && _compressed && _fd >= 0) {
+        // Make everything so far readable with zcat without waiting for the file to be closed.
+        [self deflateBytes:NULL length:0 flush:Z_SYNC_FLUSH];
+    }
+}
+
+- (NSData *)firstOverflowChunk {
+    os_unfair_lock_lock(&_overflowLock);
+    NSData *chunk = _overflow.firstObject;
+    os_unfair_lock_unlock(&_overflowLock);
+    return chunk;
+}
+
+- (void)removeFirstOverflowChunk {
+    os_unfair_lock_lock(&_overflowLock);
+    [_overflow removeObjectAtIndex:0];
+    const BOOL caughtUp = (_overflow.count == 0);
+    if (caughtUp) {
+        atomic_store_explicit(&_behind, false, memory_order_release);
+    }
+    os_unfair_lock_unlock(&_overflowLock);
+    if (caughtUp && _didCatchUp) {
+        _didCatchUp();
+    }
+}
+
+// Runs on _queue.
+- (void)discardBufferedBytes {
+    const unsigned long long head = atomic_load_explicit(&_head, memory_order_acquire);
+    const unsigned long long tail = atomic_load_explicit(&_tail, memory_order_relaxed);
+    if (head != tail) {
+        [self didDropBytes:head - tail];
+        atomic_store_explicit(&_tail, head, memory_order_release);
+    }
+    NSData *chunk;
+    while ((chunk = [self firstOverflowChunk])) {
+        [self didDropBytes:chunk.length];
+        [self removeFirstOverflowChunk];
+    }
+}
+
+- (void)didDropBytes:(NSUInteger)length {
+    atomic_fetch_add_explicit(&_bytesDropped, length, memory_order_relaxed);
+    if (_didDropBytes && !atomic_exchange(&_reportedDrop, true)) {
+        _didDropBytes();
+    }
+}
+
+- (BOOL)writeParts:(struct iovec *)parts count:(int)count {
+    if (!_compressed) {
+        size_t length = 0;
+        for (int i = 0; i < count; i++) {
+            length += parts[i].iov_len;
+        }
+        if (!iTermSessionLoggerWriteFully(_fd, parts, count)) {
+            return NO;
+        }
+        _fileSize += length;
+        return YES;
+    }
+    for (int i = 0; i < count; i++) {
+        if (![self deflateBytes:parts[i].iov_base length:parts[i].iov_len flush:Z_NO_FLUSH]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (BOOL)deflateBytes:(const char *)bytes length:(size_t)length flush:(int)flush {
+    _stream.next_in = (Bytef *)bytes;
+    _stream.avail_in = (uInt)length;
+    do {
+        _stream.next_out = (Bytef *)_deflated;
+        _stream.avail_out = kDeflatedBufferSize;
+        if (deflate(&_stream, flush) == Z_STREAM_ERROR) {
+            return NO;
+        }
+        struct iovec part = { _deflated, kDeflatedBufferSize - _stream.avail_out };
+        if (part.iov_len) {
+            if (!iTermSessionLoggerWriteFully(_fd, &part, 1)) {
+                return NO;
+            }
+            _fileSize += kDeflatedBufferSize - _stream.avail_out;
+        }
+    } while (_stream.avail_out == 0);
+    return YES;
+}
+
+- (BOOL)openFileAppending:(BOOL)append {
+    _fd = open(_path.fileSystemRepresentation,
+               O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC),
+               0644);
+    if (_fd < 0) {
+        DLog(@"Failed to open %@: %s", _path, strerror(errno));
+        return NO;
+    }
+    struct stat sb;
+    _fileSize = fstat(_fd, &sb) ? 0 : sb.st_size;
+    if (_streamInitialized) {
+        // Each file gets its own gzip member. Members appended to an existing file are still
+        // a valid gzip file.
+        deflateReset(&_stream);
+    }
+    return YES;
+}
+
+- (void)closeFile {
+    if (_fd < 0) {
+        return;
+    }
+    if (_compressed) {
+        [self deflateBytes:NULL length:0 flush:Z_FINISH];
+    }
+    close(_fd);
+    _fd = -1;
+}
+
+- (NSString *)pathForOldFile:(int)number {
+    NSString *extension = _path.pathExtension;
+    NSString *numbered = [[_path stringByDeletingPathExtension] stringByAppendingFormat:@".%d", number];
+    return extension.length ? [numbered stringByAppendingPathExtension:extension] : numbered;
+}
+
+- (void)rotateIfNeeded {
+    if (_maximumFileSize <= 0 || _numberOfOldFilesToKeep <= 0 || _fileSize < _maximumFileSize) {
+        // With no old files to keep, rotating would throw away everything logged so far.
+        return;
+    }
+    [self closeFile];
+    unlink([self pathForOldFile:_numberOfOldFilesToKeep].fileSystemRepresentation);
+    for (int i = _numberOfOldFilesToKeep - 1; i >= 1; i--) {
+        rename([self pathForOldFile:i].fileSystemRepresentation,
+               [self pathForOldFile:i + 1].fileSystemRepresentation);
+    }
+    rename(_path.fileSystemRepresentation, [self pathForOldFile:1].fileSystemRepresentation);
+    [self openFileAppending:NO];
+}
+
+@end
@@ -14,7 +14,6 @@
 #import "iTermURLStore.h"
 #import "NSStringITerm.h"
 #import "NSMutableAttributedString+iTerm.h"
-#import "RegexKitLite.h"
 #import "PreferencePanel.h"
 #import "SmartMatch.h"
 #import "SmartSelectionController.h"
@@ -31,6 +30,64 @@ static const int kNumCharsToSearchForDivider = 8;
 const NSInteger kReasonableMaximumWordLength = 1000;
 const NSInteger kLongMaximumWordLength = 100000;
 
+// A smart selection rule with its regex compiled. Rule sets are compiled once and cached, so a
+// click doesn't recompile every rule's regex.
+@interface iTermCompiledSmartSelectionRule : NSObject
+@property(nonatomic, readonly) NSDictionary *rule;
+// nil if the rule's regex is invalid.
+@property(nonatomic, readonly) NSRegularExpression *regex;
+@property(nonatomic, readonly) double precision;
+@property(nonatomic, readonly) BOOL hasActions;
+
++ (NSArray<iTermCompiledSmartSelectionRule *> *)compiledRules:(NSArray<NSDictionary *> *)rules;
+@end
+
+@implementation iTermCompiledSmartSelectionRule
+
++ (NSArray<iTermCompiledSmartSelectionRule *> *)compiledRules:(NSArray<NSDictionary *> *)rules {
+    static NSCache *cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [[NSCache alloc] init];
+        cache.countLimit = 16;
+    });
+    NSArray<iTermCompiledSmartSelectionRule *> *compiledRules = [cache objectForKey:rules];
+    if (!compiledRules) {
+        NSMutableArray<iTermCompiledSmartSelectionRule *> *array = [NSMutableArray arrayWithCapacity:rules.count];
+        for (NSDictionary *rule in rules) {
+            [array addObject:[[[iTermCompiledSmartSelectionRule alloc] initWithRule:rule] autorelease]];
+        }
+        compiledRules = array;
+        [cache setObject:compiledRules forKey:[[rules copy] autorelease]];
+    }
+    return compiledRules;
+}
+
+- (instancetype)initWithRule:(NSDictionary *)rule {
+    self = [super init];
+    if (self) {
+        _rule = [rule retain];
+        NSError *error = nil;
+        _regex = [[NSRegularExpression alloc] initWithPattern:[SmartSelectionController regexInRule:rule] ?: @""
+                                                      options:0
+                                                        error:&error];
+        if (!_regex) {
+            DLog(@"Smart selection rule %@ has an invalid regex: %@", rule, error);
+        }
+        _precision = [SmartSelectionController precisionInRule:rule];
+        _hasActions = [[SmartSelectionController actionsInRule:rule] count] > 0;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_rule release];
+    [_regex release];
+    [super dealloc];
+}
+
+@end
+
 @implementation iTermTextExtractor {
     VT100GridRange _logicalWindow;
 
@@ -655,71 +712,80 @@ const NSInteger kLongMaximumWordLength = 100000;
                                      coords:coords
                            ignoringNewlines:ignoringNewlines || [self hasLogicalWindow]];
 
-    NSArray* rulesArray = rules ?: [SmartSelectionController defaultRules];
-    const int numRules = [rulesArray count];
+    NSArray<iTermCompiledSmartSelectionRule *> *compiledRules =
+        [iTermCompiledSmartSelectionRule compiledRules:rules ?: [SmartSelectionController defaultRules]];
 
     NSMutableDictionary* matches = [NSMutableDictionary dictionaryWithCapacity:13];
     int numCoords = [coords count];
+    const NSUInteger textLength = [textWindow length];
 
     BOOL debug = [SmartSelectionController logDebugInfo];
     if (debug) {
         NSLog(@"Perform smart selection on text: %@", textWindow);
     }
-    for (int j = 0; j < numRules; j++) {
-        NSDictionary *rule = [rulesArray objectAtIndex:j];
-        if (actionRequired && [[SmartSelectionController actionsInRule:rule] count] == 0) {
+    for (iTermCompiledSmartSelectionRule *compiledRule in compiledRules) {
+        NSDictionary *rule = compiledRule.rule;
+        if (actionRequired && !compiledRule.hasActions) {
             DLog(@"Ignore smart selection rule because it has no action: %@", rule);
             continue;
         }
-        NSString *regex = [SmartSelectionController regexInRule:rule];
-        double precision = [SmartSelectionController precisionInRule:rule];
+        NSRegularExpression *regex = compiledRule.regex;
         if (debug) {
-            NSLog(@"Try regex %@", regex);
+            NSLog(@"Try regex %@", [SmartSelectionController regexInRule:rule]);
         }
-        for (int i = 0; i <= targetOffset; i++) {
-            NSString* substring = [textWindow substringWithRange:NSMakeRange(i, [textWindow length] - i)];
-            NSError* regexError = nil;
-            NSRange temp = [substring rangeOfRegex:regex
-                                           options:0
-                                           inRange:NSMakeRange(0, [substring length])
-                                           capture:0
-                                             error:&regexError];
-            if (temp.location != NSNotFound) {
-                if (i + temp.location <= targetOffset && i + temp.location + temp.length > targetOffset) {
-                    NSString* result = [substring substringWithRange:temp];
-                    double score = precision * (double) temp.length;
-                    SmartMatch* oldMatch = [matches objectForKey:result];
-                    if (!oldMatch || score > oldMatch.score) {
-                        SmartMatch* match = [[[SmartMatch alloc] init] autorelease];
-                        match.score = score;
-                        VT100GridCoord startCoord = [coords[i + temp.location] gridCoordValue];
-                        VT100GridCoord endCoord = [coords[MIN(numCoords - 1,
-                                                              i + temp.location + temp.length - 1)] gridCoordValue];
-                        endCoord = [self successorOfCoord:endCoord];
-                        match.startX = startCoord.x;
-                        match.absStartY = startCoord.y + [_dataSource totalScrollbackOverflow];
-                        match.endX = endCoord.x;
-                        match.absEndY = endCoord.y + [_dataSource totalScrollbackOverflow];
-                        match.rule = rule;
-                        match.components = [substring captureComponentsMatchedByRegex:regex
-                                                                              options:0
-                                                                                range:NSMakeRange(0, [substring length])
-                                                                                error:&regexError];
-                        [matches setObject:match forKey:result];
-
-                        if (debug) {
-                            NSLog(@"Regex matched. Add result %@ at %d,%lld -> %d,%lld with score %lf", result,
-                                  match.startX, match.absStartY, match.endX, match.absEndY,
-                                  match.score);
-                        }
-                    }
-                    i += temp.location + temp.length - 1;
-                } else {
-                    i += temp.location;
-                }
-            } else {
+        if (!regex) {
+            continue;
+        }
+        // Find the leftmost match that covers the click. A match that ends before the click may
+        // hide one that starts inside it (e.g., a stray quote before a quoted string), so search
+        // again from the character after where it starts. Searching a range behaves like
+        // searching a substring since ranges have anchoring, non-transparent bounds.
+        int i = 0;
+        while (i <= targetOffset) {
+            NSTextCheckingResult *result = [regex firstMatchInString:textWindow
+                                                             options:0
+                                                               range:NSMakeRange(i, textLength - i)];
+            if (!result) {
+                break;
+            }
+            const NSRange temp = result.range;
+            if (temp.location > targetOffset) {
                 break;
             }
+            if (NSMaxRange(temp) <= targetOffset) {
+                i = temp.location + 1;
+                continue;
+            }
+            NSString* matchedString = [textWindow substringWithRange:temp];
+            double score = compiledRule.precision * (double) temp.length;
+            SmartMatch* oldMatch = [matches objectForKey:matchedString];
+            if (!oldMatch || score > oldMatch.score) {
+                SmartMatch* match = [[[SmartMatch alloc] init] autorelease];
+                match.score = score;
+                VT100GridCoord startCoord = [coords[temp.location] gridCoordValue];
+                VT100GridCoord endCoord = [coords[MIN(numCoords - 1,
+                                                      NSMaxRange(temp) - 1)] gridCoordValue];
+                endCoord = [self successorOfCoord:endCoord];
+                match.startX = startCoord.x;
+                match.absStartY = startCoord.y + [_dataSource totalScrollbackOverflow];
+                match.endX = endCoord.x;
+                match.absEndY = endCoord.y + [_dataSource totalScrollbackOverflow];
+                match.rule = rule;
+                NSMutableArray *components = [NSMutableArray arrayWithCapacity:result.numberOfRanges];
+                for (NSUInteger k = 0; k < result.numberOfRanges; k++) {
+                    const NSRange captureRange = [result rangeAtIndex:k];
+                    [components addObject:captureRange.location == NSNotFound ? @"" : [textWindow substringWithRange:captureRange]];
+                }
+                match.components = components;
+                [matches setObject:match forKey:matchedString];
+
+                if (debug) {
+                    NSLog(@"Regex matched. Add result %@ at %d,%lld -> %d,%lld with score %lf", matchedString,
+                          match.startX, match.absStartY, match.endX, match.absEndY,
+                          match.score);
+                }
+            }
+            break;
         }
     }
 
@@ -0,0 +1,24 @@
+//
+//  iTermTokenExecutionScheduler.h
+//  iTerm2
+//
+//  Runs sessions' token execution on the main thread fairly. Each session's work is kept in its own
+//  FIFO and the scheduler takes one item from each session in turn, so a session that is flooding
+//  output can't push everyone else's work to the back of the main queue. A pass gives up the main
+//  thread after a short time budget so events and drawing get a chance to run between passes.
+//
+//  Token execution stays on the main thread, so a flooding session still takes main thread time;
+//  this only keeps it from taking all of it.
+//
+
+#import <Foundation/Foundation.h>
+
+@interface iTermTokenExecutionScheduler : NSObject
+
++ (instancetype)sharedInstance;
+
+// Arranges for |block| to run on the main thread. Blocks enqueued with the same |key| run in the
+// order they were enqueued. |key| is only compared by address; it is not retained. Thread-safe.
+- (void)enqueueBlock:(void (^)(void))block forKey:(const void *)key;
+
+@end
@@ -0,0 +1,131 @@
+//
+//  iTermTokenExecutionScheduler.m
+//  iTerm2
+//
+
+#import "iTermTokenExecutionScheduler.h"
+
+#import "DebugLogging.h"
+
+#import <os/lock.h>
+
+// How long one pass may keep the main thread before yielding to the run loop. Half a frame at
+// 60fps leaves room to handle events and draw.
+static const NSTimeInterval kMaximumPassDuration = 0.008;
+
+@implementation iTermTokenExecutionScheduler {
+    os_unfair_lock _lock;
+
+    // Everything below is guarded by _lock.
+
+    // Maps a key (as an NSValue holding a pointer) to its FIFO of blocks.
+    NSMutableDictionary<NSValue *, NSMutableArray *> *_queues;
+
+    // Keys with pending blocks, in the order they'll next be served.
+    NSMutableArray<NSValue *> *_readyKeys;
+
+    // Whether a pass is scheduled or running on the main queue.
+    BOOL _passScheduled;
+}
+
++ (instancetype)sharedInstance {
+    static dispatch_once_t onceToken;
+    static id instance;
+    dispatch_once(&onceToken, ^{
+        instance = [[self alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _queues = [[NSMutableDictionary alloc] init];
+        _readyKeys = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_queues release];
+    [_readyKeys release];
+    [super dealloc];
+}
+
+- (void)enqueueBlock:(void (^)(void))block forKey:(const void *)key {
+    NSValue *value = [NSValue valueWithPointer:key];
+    void (^copy)(void) = [block copy];
+    BOOL schedule = NO;
+
+    os_unfair_lock_lock(&_lock);
+    NSMutableArray *queue = _queues[value];
+    if (!queue) {
+        queue = [NSMutableArray array];
+        _queues[value] = queue;
+        [_readyKeys addObject:value];
+    }
+    [queue addObject:copy];
+    if (!_passScheduled) {
+        _passScheduled = YES;
+        schedule = YES;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    [copy release];
+    if (schedule) {
+        [self schedulePass];
+    }
+}
+
+#pragma mark - Private
+
+- (void)schedulePass {
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [self runPass];
+    });
+}
+
+// Removes and returns the next block to run, moving its key to the back of the line. Returns nil
+// and marks the scheduler idle if there's nothing to do.
+- (void (^)(void))dequeueBlock {
+    void (^block)(void) = nil;
+    os_unfair_lock_lock(&_lock);
+    if (_readyKeys.count == 0) {
+        _passScheduled = NO;
+    } else {
+        NSValue *key = [[_readyKeys.firstObject retain] autorelease];
+        [_readyKeys removeObjectAtIndex:0];
+        NSMutableArray *queue = _queues[key];
+        block = [[queue.firstObject retain] autorelease];
+        [queue removeObjectAtIndex:0];
+        if (queue.count) {
+            [_readyKeys addObject:key];
+        } else {
+            [_queues removeObjectForKey:key];
+        }
+    }
+    os_unfair_lock_unlock(&_lock);
+    return block;
+}
+
+- (void)runPass {
+    const NSTimeInterval deadline = [NSDate timeIntervalSinceReferenceDate] + kMaximumPassDuration;
+    while (YES) {
+        @autoreleasepool {
+            void (^block)(void) = [self dequeueBlock];
+            if (!block) {
+                return;
+            }
+            block();
+        }
+        if ([NSDate timeIntervalSinceReferenceDate] >= deadline) {
+            DLog(@"Token execution pass used its time budget; yielding the main thread");
+            // _passScheduled is still set so nobody else schedules a pass.
+            [self schedulePass];
+            return;
+        }
+    }
+}
+
+@end
@@ -0,0 +1,73 @@
+//
+//  iTermTriggerEvaluator.h
+//  iTerm2SharedARC
+//
+//  Runs a session's trigger regexes off the main thread. Lines are handed over as immutable
+//  iTermStringLine snapshots, matched in order on a private serial queue, and the matches come back
+//  to the main thread in the same order, where the triggers' actions are performed. Delivery goes
+//  through the token execution scheduler so a flood of matches shares the main thread's time budget
+//  with everything else instead of starving drawing.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class iTermStringLine;
+@class iTermTriggerEvaluator;
+@class iTermTriggerMatch;
+@class iTermTriggerMatcher;
+
+// The result of matching one line against a set of triggers.
+@interface iTermTriggerEvaluation : NSObject
+// The matcher in effect when the line was enqueued. Its triggers are the ones that were evaluated.
+@property (nonatomic, readonly) iTermTriggerMatcher *matcher;
+@property (nonatomic, readonly) iTermStringLine *stringLine;
+@property (nonatomic, readonly) long long lineNumber;
+@property (nonatomic, readonly) BOOL partialLine;
+// matches[i] holds the matches of matcher.triggers[i], which is empty if it didn't match.
+@property (nonatomic, readonly) NSArray<NSArray<iTermTriggerMatch *> *> *matches;
+@end
+
+@protocol iTermTriggerEvaluatorDelegate<NSObject>
+// Called on the main thread in the order lines were enqueued.
+- (void)triggerEvaluator:(iTermTriggerEvaluator *)evaluator didEvaluate:(iTermTriggerEvaluation *)evaluation;
+
+// Called on the main thread when the number of lines waiting crosses the high-water mark, and
+// again when it falls back to the low-water mark. The delegate should stop producing lines (e.g.,
+// by not reading more output) while backlogged.
+- (void)triggerEvaluator:(iTermTriggerEvaluator *)evaluator didChangeBacklogged:(BOOL)backlogged;
+@end
+
+@interface iTermTriggerEvaluator : NSObject
+
+@property (nonatomic, weak) id<iTermTriggerEvaluatorDelegate> delegate;
+
+// Lines are evaluated with the matcher that was set when they were enqueued.
+@property (nullable, nonatomic, strong) iTermTriggerMatcher *matcher;
+
+// Queue depths at which to become backlogged and to stop being backlogged.
+@property (nonatomic) NSInteger highWaterMark;
+@property (nonatomic) NSInteger lowWaterMark;
+
+// Counters. Main thread only.
+
+// Lines enqueued whose evaluations have not yet been delivered.
+@property (nonatomic, readonly) NSInteger queueDepth;
+// The largest queueDepth seen.
+@property (nonatomic, readonly) NSInteger maximumQueueDepth;
+// Lines whose evaluations have been delivered.
+@property (nonatomic, readonly) NSInteger numberOfLinesEvaluated;
+// Partial lines that were not evaluated when they arrived because of a backlog.
+@property (nonatomic, readonly) NSInteger numberOfPartialLinesDropped;
+@property (nonatomic, readonly) BOOL backlogged;
+
+// Main thread only. Partial lines are not queued while backlogged. Instead the most recent one is
+// kept and evaluated when the backlog clears, unless the complete line was enqueued by then.
+- (void)evaluateStringLine:(iTermStringLine *)stringLine
+                lineNumber:(long long)lineNumber
+               partialLine:(BOOL)partialLine;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,141 @@
+//
+//  iTermTriggerEvaluator.m
+//  iTerm2SharedARC
+//
+
+#import "iTermTriggerEvaluator.h"
+
+#import "DebugLogging.h"
+#import "ScreenChar.h"
+#import "Trigger.h"
+#import "iTermTokenExecutionScheduler.h"
+#import "iTermTriggerMatcher.h"
+
+// Once this many lines are waiting, output is throttled until the triggers catch up.
+static const NSInteger kDefaultHighWaterMark = 4096;
+static const NSInteger kDefaultLowWaterMark = 1024;
+
+@implementation iTermTriggerEvaluation
+
+- (instancetype)initWithMatcher:(iTermTriggerMatcher *)matcher
+                     stringLine:(iTermStringLine *)stringLine
+                     lineNumber:(long long)lineNumber
+                    partialLine:(BOOL)partialLine
+                        matches:(NSArray<NSArray<iTermTriggerMatch *> *> *)matches {
+    self = [super init];
+    if (self) {
+        _matcher = matcher;
+        _stringLine = stringLine;
+        _lineNumber = lineNumber;
+        _partialLine = partialLine;
+        _matches = matches;
+    }
+    return self;
+}
+
+@end
+
+@implementation iTermTriggerEvaluator {
+    dispatch_queue_t _queue;
+    // The most recent partial line dropped while backlogged. It is evaluated once the backlog
+    // clears unless a complete line was enqueued since, so an instant trigger on a line that never
+    // gets finished (like a password prompt) still fires.
+    iTermStringLine *_droppedPartialLine;
+    long long _droppedPartialLineNumber;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _queue = dispatch_queue_create("com.iterm2.trigger-evaluator", DISPATCH_QUEUE_SERIAL);
+        _highWaterMark = kDefaultHighWaterMark;
+        _lowWaterMark = kDefaultLowWaterMark;
+    }
+    return self;
+}
+
+- (void)evaluateStringLine:(iTermStringLine *)stringLine
+                lineNumber:(long long)lineNumber
+               partialLine:(BOOL)partialLine {
+    iTermTriggerMatcher *matcher = _matcher;
+    if (!matcher.triggers.count) {
+        return;
+    }
+    if (partialLine && _backlogged) {
+        DLog(@"Defer partial line %lld because the trigger evaluator is backlogged", lineNumber);
+        _numberOfPartialLinesDropped++;
+        _droppedPartialLine = stringLine;
+        _droppedPartialLineNumber = lineNumber;
+        return;
+    }
+    if (!partialLine) {
+        // The complete line supersedes any partial line that was waiting.
+        _droppedPartialLine = nil;
+    }
+    _queueDepth++;
+    _maximumQueueDepth = MAX(_maximumQueueDepth, _queueDepth);
+    if (!_backlogged && _queueDepth >= _highWaterMark) {
+        DLog(@"Trigger evaluator is backlogged with %@ lines", @(_queueDepth));
+        _backlogged = YES;
+        [self.delegate triggerEvaluator:self didChangeBacklogged:YES];
+    }
+    dispatch_async(_queue, ^{
+        iTermTriggerEvaluation *evaluation = [self evaluationOfStringLine:stringLine
+                                                               lineNumber:lineNumber
+                                                              partialLine:partialLine
+                                                                  matcher:matcher];
+        // The scheduler runs blocks with the same key in order, and this queue is serial, so
+        // evaluations are delivered in the order lines were enqueued.
+        [[iTermTokenExecutionScheduler sharedInstance] enqueueBlock:^{
+            [self deliverEvaluation:evaluation];
+        } forKey:(__bridge const void *)self];
+    });
+}
+
+#pragma mark - Private
+
+// Runs on _queue.
+- (iTermTriggerEvaluation *)evaluationOfStringLine:(iTermStringLine *)stringLine
+                                        lineNumber:(long long)lineNumber
+                                       partialLine:(BOOL)partialLine
+                                           matcher:(iTermTriggerMatcher *)matcher {
+    NSString *string = stringLine.stringValue;
+    NSIndexSet *candidates = [matcher indexesOfCandidateTriggersForString:string];
+    NSArray<Trigger *> *triggers = matcher.triggers;
+    NSMutableArray<NSArray<iTermTriggerMatch *> *> *matches = [NSMutableArray arrayWithCapacity:triggers.count];
+    for (NSUInteger i = 0; i < triggers.count; i++) {
+        @autoreleasepool {
+            if ([candidates containsIndex:i]) {
+                [matches addObject:[triggers[i] matchesInString:string partialLine:partialLine]];
+            } else {
+                [matches addObject:@[]];
+            }
+        }
+    }
+    return [[iTermTriggerEvaluation alloc] initWithMatcher:matcher
+                                                stringLine:stringLine
+                                                lineNumber:lineNumber
+                                               partialLine:partialLine
+                                                   matches:matches];
+}
+
+// Runs on the main thread.
+- (void)deliverEvaluation:(iTermTriggerEvaluation *)evaluation {
+    _queueDepth--;
+    _numberOfLinesEvaluated++;
+    [self.delegate triggerEvaluator:self didEvaluate:evaluation];
+    if (_backlogged && _queueDepth <= _lowWaterMark) {
+        DLog(@"Trigger evaluator caught up");
+        _backlogged = NO;
+        [self.delegate triggerEvaluator:self didChangeBacklogged:NO];
+        iTermStringLine *droppedPartialLine = _droppedPartialLine;
+        if (droppedPartialLine) {
+            _droppedPartialLine = nil;
+            [self evaluateStringLine:droppedPartialLine
+                          lineNumber:_droppedPartialLineNumber
+                         partialLine:YES];
+        }
+    }
+}
+
+@end
@@ -0,0 +1,35 @@
+//
+//  iTermTriggerMatcher.h
+//  iTerm2SharedARC
+//
+//  Finds the triggers that could possibly match a line without running each trigger's regex.
+//  Every trigger's regex is examined for a literal that any match must contain, and the literals
+//  of all the triggers are compiled into a single Aho-Corasick automaton. A line is scanned once
+//  and only the triggers whose literal appeared (plus those with no usable literal) need their
+//  regexes run.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class Trigger;
+
+@interface iTermTriggerMatcher : NSObject
+
+@property (nonatomic, readonly) NSArray<Trigger *> *triggers;
+
+// Returns the longest ASCII literal that every match of |regex| must contain, or nil if none can be
+// found. Sets *caseInsensitive if the regex (or part of it) ignores case. Exposed for testing.
++ (nullable NSString *)requiredLiteralInRegex:(NSString *)regex caseInsensitive:(BOOL *)caseInsensitive;
+
+- (instancetype)initWithTriggers:(NSArray<Trigger *> *)triggers NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+// Returns the indexes into -triggers of the triggers whose regex might match |string|. Any trigger
+// not in the set certainly does not match.
+- (NSIndexSet *)indexesOfCandidateTriggersForString:(NSString *)string;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,407 @@
+//
+//  iTermTriggerMatcher.mm
+//  iTerm2SharedARC
+//
+
+#import "iTermTriggerMatcher.h"
+
+#import "Trigger.h"
+
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace iTerm2 {
+    static bool IsASCIIAlphanumeric(unichar c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    static bool IsHexDigit(unichar c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    }
+
+    static bool IsOctalDigit(unichar c) {
+        return c >= '0' && c <= '7';
+    }
+
+    static bool IsDecimalDigit(unichar c) {
+        return c >= '0' && c <= '9';
+    }
+
+    static unichar FoldASCII(unichar c) {
+        return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    }
+
+    // Finds a literal that must appear in every match of an ICU regex. This only looks at the top
+    // level of the pattern: anything inside a group, a character class, or an escape that isn't a
+    // literal ends the current run of literal characters. It gives up on patterns with top-level
+    // alternation, \Q...\E quoting, or the x flag.
+    class RequiredLiteralFinder {
+        const std::vector<unichar> &_regex;
+        std::string _current;
+        std::string _best;
+        bool _caseInsensitive;
+        bool _extended;
+
+        void flush() {
+            if (_current.size() > _best.size()) {
+                _best = _current;
+            }
+            _current.clear();
+        }
+
+        // A quantifier that allows zero repetitions makes the preceding character optional.
+        void dropLastAndFlush() {
+            if (!_current.empty()) {
+                _current.pop_back();
+            }
+            flush();
+        }
+
+        void append(unichar c) {
+            if (c >= 0x80) {
+                flush();
+            } else {
+                _current.push_back(static_cast<char>(c));
+            }
+        }
+
+        size_t skipTo(size_t i, unichar terminator) const {
+            while (i < _regex.size() && _regex[i] != terminator) {
+                i++;
+            }
+            return i < _regex.size() ? i + 1 : std::string::npos;
+        }
+
+        size_t skipWhile(size_t i, size_t max, bool (*predicate)(unichar)) const {
+            for (size_t n = 0; n < max && i < _regex.size() && predicate(_regex[i]); n++) {
+                i++;
+            }
+            return i;
+        }
+
+        // |i| is the index of a backslash followed by a letter or digit. Returns the index after
+        // the escape.
+        size_t skipEscape(size_t i) const {
+            const unichar e = _regex[i + 1];
+            i += 2;
+            switch (e) {
+                case 'x':
+                    if (i < _regex.size() && _regex[i] == '{') {
+                        return skipTo(i, '}');
+                    }
+                    return skipWhile(i, 2, IsHexDigit);
+                case 'u':
+                    return skipWhile(i, 4, IsHexDigit);
+                case 'U':
+                    return skipWhile(i, 8, IsHexDigit);
+                case '0':
+                    return skipWhile(i, 3, IsOctalDigit);
+                case 'c':
+                    return i + 1;
+                case 'p':
+                case 'P':
+                case 'N':
+                    if (i < _regex.size() && _regex[i] == '{') {
+                        return skipTo(i, '}');
+                    }
+                    return i + 1;
+                case 'k':
+                    if (i < _regex.size() && _regex[i] == '<') {
+                        return skipTo(i, '>');
+                    }
+                    return i;
+                default:
+                    if (e >= '1' && e <= '9') {
+                        // Back reference.
+                        return skipWhile(i, SIZE_MAX, IsDecimalDigit);
+                    }
+                    return i;
+            }
+        }
+
+        // |i| is the index of a [. Returns the index after the matching ].
+        size_t skipClass(size_t i) const {
+            i++;
+            if (i < _regex.size() && _regex[i] == '^') {
+                i++;
+            }
+            if (i < _regex.size() && _regex[i] == ']') {
+                i++;
+            }
+            int depth = 1;
+            while (i < _regex.size()) {
+                const unichar c = _regex[i];
+                if (c == '\\') {
+                    i += 2;
+                    continue;
+                }
+                i++;
+                if (c == '[') {
+                    depth++;
+                } else if (c == ']' && --depth == 0) {
+                    return i;
+                }
+            }
+            return std::string::npos;
+        }
+
+        // |i| is the index of a (. Returns the index after the matching ). Notes any flags that
+        // are set along the way, since (?i) affects the rest of the pattern.
+        size_t skipGroup(size_t i) {
+            i++;
+            if (i < _regex.size() && _regex[i] == '?') {
+                i++;
+                if (i < _regex.size() && _regex[i] == '#') {
+                    return skipTo(i, ')');
+                }
+                while (i < _regex.size() && ((_regex[i] >= 'a' && _regex[i] <= 'z') || _regex[i] == '-')) {
+                    if (_regex[i] == 'i') {
+                        _caseInsensitive = true;
+                    } else if (_regex[i] == 'x') {
+                        _extended = true;
+                    }
+                    i++;
+                }
+            }
+            while (i < _regex.size()) {
+                const unichar c = _regex[i];
+                if (c == '\\') {
+                    i += 2;
+                } else if (c == '[') {
+                    i = skipClass(i);
+                } else if (c == '(') {
+                    i = skipGroup(i);
+                } else if (c == ')') {
+                    return i + 1;
+                } else {
+                    i++;
+                }
+                if (i == std::string::npos) {
+                    return i;
+                }
+            }
+            return std::string::npos;
+        }
+
+    public:
+        explicit RequiredLiteralFinder(const std::vector<unichar> &regex)
+            : _regex(regex), _caseInsensitive(false), _extended(false) { }
+
+        // Returns false if no literal is required.
+        bool find(std::string *literal, bool *caseInsensitive) {
+            size_t i = 0;
+            while (i < _regex.size()) {
+                const unichar c = _regex[i];
+                switch (c) {
+                    case '\\': {
+                        if (i + 1 >= _regex.size() || _regex[i + 1] == 'Q') {
+                            return false;
+                        }
+                        const unichar e = _regex[i + 1];
+                        if (IsASCIIAlphanumeric(e)) {
+                            flush();
+                            i = skipEscape(i);
+                        } else {
+                            append(e);
+                            i += 2;
+                        }
+                        break;
+                    }
+                    case '(':
+                        flush();
+                        i = skipGroup(i);
+                        break;
+                    case '[':
+                        flush();
+                        i = skipClass(i);
+                        break;
+                    case '|':
+                    case ')':
+                        return false;
+                    case '?':
+                    case '*':
+                        dropLastAndFlush();
+                        i++;
+                        break;
+                    case '{':
+                        dropLastAndFlush();
+                        i = skipTo(i, '}');
+                        break;
+                    case '+':
+                    case '.':
+                    case '^':
+                    case '$':
+                        flush();
+                        i++;
+                        break;
+                    default:
+                        append(c);
+                        i++;
+                        break;
+                }
+                if (i == std::string::npos || _extended) {
+                    return false;
+                }
+            }
+            flush();
+            if (_best.empty()) {
+                return false;
+            }
+            *literal = _best;
+            *caseInsensitive = _caseInsensitive;
+            return true;
+        }
+    };
+
+    // An Aho-Corasick automaton over case-folded ASCII, compiled to a DFA so scanning does one
+    // table lookup per character.
+    class LiteralAutomaton {
+        struct State {
+            int next[128];
+            int fail;
+            std::vector<int> outputs;
+
+            State() : fail(0) {
+                std::fill(next, next + 128, -1);
+            }
+        };
+        std::vector<State> _states;
+
+    public:
+        LiteralAutomaton() : _states(1) { }
+
+        void add(const std::string &literal, int identifier) {
+            int s = 0;
+            for (char ch : literal) {
+                const int c = FoldASCII(ch);
+                if (_states[s].next[c] < 0) {
+                    _states[s].next[c] = static_cast<int>(_states.size());
+                    _states.emplace_back();
+                }
+                s = _states[s].next[c];
+            }
+            _states[s].outputs.push_back(identifier);
+        }
+
+        void build() {
+            std::queue<int> queue;
+            for (int c = 0; c < 128; c++) {
+                const int child = _states[0].next[c];
+                if (child < 0) {
+                    _states[0].next[c] = 0;
+                } else {
+                    _states[child].fail = 0;
+                    queue.push(child);
+                }
+            }
+            while (!queue.empty()) {
+                const int s = queue.front();
+                queue.pop();
+                for (int c = 0; c < 128; c++) {
+                    const int child = _states[s].next[c];
+                    const int fallback = _states[_states[s].fail].next[c];
+                    if (child < 0) {
+                        _states[s].next[c] = fallback;
+                    } else {
+                        _states[child].fail = fallback;
+                        const std::vector<int> &inherited = _states[fallback].outputs;
+                        _states[child].outputs.insert(_states[child].outputs.end(),
+                                                      inherited.begin(),
+                                                      inherited.end());
+                        queue.push(child);
+                    }
+                }
+            }
+        }
+
+        // Sets (*found)[identifier] for each literal found. Non-ASCII characters can't be part of
+        // any literal. Returns true if any were seen.
+        bool scan(const unichar *chars, NSUInteger length, std::vector<bool> *found) const {
+            bool sawNonASCII = false;
+            int s = 0;
+            for (NSUInteger i = 0; i < length; i++) {
+                const unichar c = chars[i];
+                if (c >= 0x80) {
+                    sawNonASCII = true;
+                    s = 0;
+                    continue;
+                }
+                s = _states[s].next[FoldASCII(c)];
+                for (int identifier : _states[s].outputs) {
+                    (*found)[identifier] = true;
+                }
+            }
+            return sawNonASCII;
+        }
+    };
+}
+
+@implementation iTermTriggerMatcher {
+    iTerm2::LiteralAutomaton _automaton;
+    // Triggers that have no required literal. Their regexes must always be run.
+    NSMutableIndexSet *_unfilteredIndexes;
+    // ICU's case-insensitive matching lets some non-ASCII characters (e.g., KELVIN SIGN) match
+    // ASCII letters, so these are candidates for any line that isn't pure ASCII.
+    NSMutableIndexSet *_caseInsensitiveIndexes;
+}
+
++ (NSString *)requiredLiteralInRegex:(NSString *)regex caseInsensitive:(BOOL *)caseInsensitive {
+    std::vector<unichar> chars(regex.length);
+    [regex getCharacters:chars.data()];
+    std::string literal;
+    bool insensitive = false;
+    if (!iTerm2::RequiredLiteralFinder(chars).find(&literal, &insensitive)) {
+        return nil;
+    }
+    *caseInsensitive = insensitive;
+    return [NSString stringWithUTF8String:literal.c_str()];
+}
+
+- (instancetype)initWithTriggers:(NSArray<Trigger *> *)triggers {
+    self = [super init];
+    if (self) {
+        _triggers = [triggers copy];
+        _unfilteredIndexes = [NSMutableIndexSet indexSet];
+        _caseInsensitiveIndexes = [NSMutableIndexSet indexSet];
+        [_triggers enumerateObjectsUsingBlock:^(Trigger *trigger, NSUInteger i, BOOL *stop) {
+            BOOL caseInsensitive = NO;
+            NSString *literal = nil;
+            if (trigger.regex) {
+                literal = [iTermTriggerMatcher requiredLiteralInRegex:trigger.regex
+                                                      caseInsensitive:&caseInsensitive];
+            }
+            if (!literal) {
+                [self->_unfilteredIndexes addIndex:i];
+                return;
+            }
+            if (caseInsensitive) {
+                [self->_caseInsensitiveIndexes addIndex:i];
+            }
+            self->_automaton.add(literal.UTF8String, static_cast<int>(i));
+        }];
+        _automaton.build();
+    }
+    return self;
+}
+
+- (NSIndexSet *)indexesOfCandidateTriggersForString:(NSString *)string {
+    NSMutableIndexSet *result = [_unfilteredIndexes mutableCopy];
+    const NSUInteger length = string.length;
+    std::vector<unichar> chars(length);
+    [string getCharacters:chars.data()];
+    std::vector<bool> found(_triggers.count);
+    const bool sawNonASCII = _automaton.scan(chars.data(), length, &found);
+    for (size_t i = 0; i < found.size(); i++) {
+        if (found[i]) {
+            [result addIndex:i];
+        }
+    }
+    if (sawNonASCII) {
+        [result addIndexes:_caseInsensitiveIndexes];
+    }
+    return result;
+}
+
+@end
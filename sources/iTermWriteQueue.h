@@ -0,0 +1,32 @@
+//
+//  iTermWriteQueue.h
+//  iTerm2SharedARC
+//
+//  Bytes waiting to be written to a file descriptor. They are kept in a ring of fixed-size chunks
+//  so appending never moves what's already queued, and writing hands the chunks to writev() and
+//  frees the ones that were consumed instead of shifting the rest of the buffer down. Not thread
+//  safe; callers provide their own locking.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface iTermWriteQueue : NSObject
+
+// Number of bytes queued.
+@property (nonatomic, readonly) NSUInteger length;
+
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length;
+- (void)appendData:(NSData *)data;
+
+// Writes queued bytes to a non-blocking file descriptor until the queue is empty or a write would
+// block, in which case *wouldBlock is set to YES. Returns the number of bytes written, or -1 on an
+// error other than EAGAIN (errno says which). Bytes written before an error are removed.
+- (ssize_t)writeToFileDescriptor:(int)fd wouldBlock:(BOOL *)wouldBlock;
+
+- (void)removeAllBytes;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,153 @@
+//
+//  iTermWriteQueue.m
+//  iTerm2SharedARC
+//
+
+#import "iTermWriteQueue.h"
+
+#import "iTermMalloc.h"
+
+#include <sys/uio.h>
+
+static const size_t kChunkSize = 64 * 1024;
+
+// Most chunks to pass to one call to writev. A pty's buffer is much smaller than this many chunks.
+static const int kMaximumPartsPerWrite = 16;
+
+@implementation iTermWriteQueue {
+    // A ring of _chunkCapacity chunk pointers. The queue's chunks, oldest first, start at
+    // _firstChunk and wrap around.
+    char **_chunks;
+    int _chunkCapacity;
+    int _firstChunk;
+    int _numberOfChunks;
+
+    // Offset of the first unwritten byte in the first chunk.
+    size_t _readOffset;
+
+    // Number of bytes used in the last chunk.
+    size_t _writeOffset;
+
+    // A consumed chunk kept for reuse so steady traffic doesn't allocate.
+    char *_spareChunk;
+}
+
+- (void)dealloc {
+    [self removeAllBytes];
+    free(_spareChunk);
+    free(_chunks);
+}
+
+#pragma mark - APIs
+
+- (void)appendData:(NSData *)data {
+    [self appendBytes:data.bytes length:data.length];
+}
+
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length {
+    const char *source = bytes;
+    _length += length;
+    while (length > 0) {
+        if (_numberOfChunks == 0 || _writeOffset == kChunkSize) {
+            [self addChunk];
+        }
+        const size_t count = MIN(length, kChunkSize - _writeOffset);
+        memcpy([self chunkAtIndex:_numberOfChunks - 1] + _writeOffset, source, count);
+        _writeOffset += count;
+        source += count;
+        length -= count;
+    }
+}
+
+- (ssize_t)writeToFileDescriptor:(int)fd wouldBlock:(BOOL *)wouldBlock {
+    *wouldBlock = NO;
+    ssize_t total = 0;
+    while (_length > 0) {
+        struct iovec parts[kMaximumPartsPerWrite];
+        int count = 0;
+        for (int i = 0; i < _numberOfChunks && count < kMaximumPartsPerWrite; i++) {
+            const size_t start = (i == 0) ? _readOffset : 0;
+            const size_t end = (i == _numberOfChunks - 1) ? _writeOffset : kChunkSize;
+            parts[count].iov_base = [self chunkAtIndex:i] + start;
+            parts[count].iov_len = end - start;
+            count++;
+        }
+        const ssize_t written = writev(fd, parts, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN) {
+                *wouldBlock = YES;
+                return total;
+            }
+            return -1;
+        }
+        [self removeBytes:written];
+        total += written;
+    }
+    return total;
+}
+
+- (void)removeAllBytes {
+    while (_numberOfChunks > 0) {
+        [self removeFirstChunk];
+    }
+    _length = 0;
+    _readOffset = 0;
+    _writeOffset = 0;
+}
+
+#pragma mark - Private
+
+- (char *)chunkAtIndex:(int)i {
+    return _chunks[(_firstChunk + i) % _chunkCapacity];
+}
+
+- (void)addChunk {
+    if (_numberOfChunks == _chunkCapacity) {
+        // Unroll the ring into a bigger array.
+        const int newCapacity = MAX(4, _chunkCapacity * 2);
+        char **chunks = iTermMalloc(newCapacity * sizeof(char *));
+        for (int i = 0; i < _numberOfChunks; i++) {
+            chunks[i] = [self chunkAtIndex:i];
+        }
+        free(_chunks);
+        _chunks = chunks;
+        _chunkCapacity = newCapacity;
+        _firstChunk = 0;
+    }
+    char *chunk = _spareChunk ?: iTermMalloc(kChunkSize);
+    _spareChunk = NULL;
+    _chunks[(_firstChunk + _numberOfChunks) % _chunkCapacity] = chunk;
+    _numberOfChunks++;
+    _writeOffset = 0;
+}
+
+- (void)removeFirstChunk {
+    char *chunk = _chunks[_firstChunk];
+    if (_spareChunk) {
+        free(chunk);
+    } else {
+        _spareChunk = chunk;
+    }
+    _firstChunk = (_firstChunk + 1) % _chunkCapacity;
+    _numberOfChunks--;
+    _readOffset = 0;
+}
+
+- (void)removeBytes:(size_t)count {
+    _length -= count;
+    while (count > 0) {
+        const size_t end = (_numberOfChunks == 1) ? _writeOffset : kChunkSize;
+        const size_t available = end - _readOffset;
+        if (count < available) {
+            _readOffset += count;
+            return;
+        }
+        count -= available;
+        [self removeFirstChunk];
+    }
+}
+
+@end
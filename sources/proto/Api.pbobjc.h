@@ -134,7 +134,9 @@ CF_EXTERN_C_BEGIN
 @class ITMRestartSessionResponse;
 @class ITMSavedArrangementRequest;
 @class ITMSavedArrangementResponse;
+@class ITMScreenUpdateLine;
 @class ITMScreenUpdateNotification;
+@class ITMScreenUpdateRequest;
 @class ITMSelection;
 @class ITMSelectionRequest;
 @class ITMSelectionRequest_GetSelectionRequest;
@@ -3489,6 +3491,24 @@ typedef GPB_ENUM(ITMPromptMonitorRequest_FieldNumber) {
 
 @end
 
+#pragma mark - ITMScreenUpdateRequest
+
+typedef GPB_ENUM(ITMScreenUpdateRequest_FieldNumber) {
+  ITMScreenUpdateRequest_FieldNumber_IncludeContents = 1,
+};
+
+@interface ITMScreenUpdateRequest : GPBMessage
+
+/**
+ * If true, screen update notifications carry the lines that changed along with their contents,
+ * so there is no need to follow each one with a GetBufferRequest. Changes are coalesced so at
+ * most one notification is posted per frame.
+ **/
+@property(nonatomic, readwrite) BOOL includeContents;
+
+@property(nonatomic, readwrite) BOOL hasIncludeContents;
+@end
+
 #pragma mark - ITMNotificationRequest
 
 typedef GPB_ENUM(ITMNotificationRequest_FieldNumber) {
@@ -3501,6 +3521,7 @@ typedef GPB_ENUM(ITMNotificationRequest_FieldNumber) {
   ITMNotificationRequest_FieldNumber_ProfileChangeRequest = 7,
   ITMNotificationRequest_FieldNumber_KeystrokeFilterRequest = 8,
   ITMNotificationRequest_FieldNumber_PromptMonitorRequest = 9,
+  ITMNotificationRequest_FieldNumber_ScreenUpdateRequest = 10,
 };
 
 typedef GPB_ENUM(ITMNotificationRequest_Arguments_OneOfCase) {
@@ -3511,6 +3532,7 @@ typedef GPB_ENUM(ITMNotificationRequest_Arguments_OneOfCase) {
   ITMNotificationRequest_Arguments_OneOfCase_ProfileChangeRequest = 7,
   ITMNotificationRequest_Arguments_OneOfCase_KeystrokeFilterRequest = 8,
   ITMNotificationRequest_Arguments_OneOfCase_PromptMonitorRequest = 9,
+  ITMNotificationRequest_Arguments_OneOfCase_ScreenUpdateRequest = 10,
 };
 
 @interface ITMNotificationRequest : GPBMessage
@@ -3548,6 +3570,9 @@ typedef GPB_ENUM(ITMNotificationRequest_Arguments_OneOfCase) {
 
 @property(nonatomic, readwrite, strong, null_resettable) ITMPromptMonitorRequest *promptMonitorRequest;
 
+/** For NOTIFY_ON_SCREEN_UPDATE */
+@property(nonatomic, readwrite, strong, null_resettable) ITMScreenUpdateRequest *screenUpdateRequest;
+
 @end
 
 /**
@@ -3799,6 +3824,10 @@ typedef GPB_ENUM(ITMKeystrokeNotification_FieldNumber) {
 
 typedef GPB_ENUM(ITMScreenUpdateNotification_FieldNumber) {
   ITMScreenUpdateNotification_FieldNumber_Session = 1,
+  ITMScreenUpdateNotification_FieldNumber_Generation = 2,
+  ITMScreenUpdateNotification_FieldNumber_LinesArray = 3,
+  ITMScreenUpdateNotification_FieldNumber_Cursor = 4,
+  ITMScreenUpdateNotification_FieldNumber_FirstLineOnScreen = 5,
 };
 
 @interface ITMScreenUpdateNotification : GPBMessage
@@ -3807,6 +3836,48 @@ typedef GPB_ENUM(ITMScreenUpdateNotification_FieldNumber) {
 /** Test to see if @c session has been set. */
 @property(nonatomic, readwrite) BOOL hasSession;
 
+/**
+ * Increases by one with each notification that carries contents for this session. If a client
+ * sees a gap then it missed an update and should fetch the screen with a GetBufferRequest.
+ **/
+@property(nonatomic, readwrite) int64_t generation;
+
+@property(nonatomic, readwrite) BOOL hasGeneration;
+/** The lines that changed since the last notification. */
+@property(nonatomic, readwrite, strong, null_resettable) NSMutableArray<ITMScreenUpdateLine*> *linesArray;
+/** The number of items in @c linesArray without causing the array to be created. */
+@property(nonatomic, readonly) NSUInteger linesArray_Count;
+
+@property(nonatomic, readwrite, strong, null_resettable) ITMCoord *cursor;
+/** Test to see if @c cursor has been set. */
+@property(nonatomic, readwrite) BOOL hasCursor;
+
+/**
+ * The line number of the first line on the screen. Lines at or after it are on the screen and
+ * lines before it are in history.
+ **/
+@property(nonatomic, readwrite) int64_t firstLineOnScreen;
+
+@property(nonatomic, readwrite) BOOL hasFirstLineOnScreen;
+@end
+
+#pragma mark - ITMScreenUpdateLine
+
+typedef GPB_ENUM(ITMScreenUpdateLine_FieldNumber) {
+  ITMScreenUpdateLine_FieldNumber_LineNumber = 1,
+  ITMScreenUpdateLine_FieldNumber_Contents = 2,
+};
+
+@interface ITMScreenUpdateLine : GPBMessage
+
+/** The line number, numbered as in Coord.y. */
+@property(nonatomic, readwrite) int64_t lineNumber;
+
+@property(nonatomic, readwrite) BOOL hasLineNumber;
+@property(nonatomic, readwrite, strong, null_resettable) ITMLineContents *contents;
+/** Test to see if @c contents has been set. */
+@property(nonatomic, readwrite) BOOL hasContents;
+
 @end
 
 #pragma mark - ITMPromptNotificationPrompt
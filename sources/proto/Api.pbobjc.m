@@ -7910,6 +7910,48 @@ typedef struct ITMPromptMonitorRequest__storage_ {
 
 @end
 
+#pragma mark - ITMScreenUpdateRequest
+
+@implementation ITMScreenUpdateRequest
+
+@dynamic hasIncludeContents, includeContents;
+
+typedef struct ITMScreenUpdateRequest__storage_ {
+  uint32_t _has_storage_[1];
+} ITMScreenUpdateRequest__storage_;
+
+// This method is threadsafe because it is initially called
+// in +initialize for each subclass.
++ (GPBDescriptor *)descriptor {
+  static GPBDescriptor *descriptor = nil;
+  if (!descriptor) {
+    static GPBMessageFieldDescription fields[] = {
+      {
+        .name = "includeContents",
+        .dataTypeSpecific.className = NULL,
+        .number = ITMScreenUpdateRequest_FieldNumber_IncludeContents,
+        .hasIndex = 0,
+        .offset = 1,  // Stored in _has_storage_ to save space.
+        .flags = GPBFieldOptional,
+        .dataType = GPBDataTypeBool,
+      },
+    };
+    GPBDescriptor *localDescriptor =
+        [GPBDescriptor allocDescriptorForClass:[ITMScreenUpdateRequest class]
+                                     rootClass:[ITMApiRoot class]
+                                          file:ITMApiRoot_FileDescriptor()
+                                        fields:fields
+                                    fieldCount:(uint32_t)(sizeof(fields) / sizeof(GPBMessageFieldDescription))
+                                   storageSize:sizeof(ITMScreenUpdateRequest__storage_)
+                                         flags:GPBDescriptorInitializationFlag_None];
+    NSAssert(descriptor == nil, @"Startup recursed!");
+    descriptor = localDescriptor;
+  }
+  return descriptor;
+}
+
+@end
+
 #pragma mark - ITMNotificationRequest
 
 @implementation ITMNotificationRequest
@@ -7924,6 +7966,7 @@ typedef struct ITMPromptMonitorRequest__storage_ {
 @dynamic profileChangeRequest;
 @dynamic keystrokeFilterRequest;
 @dynamic promptMonitorRequest;
+@dynamic screenUpdateRequest;
 
 typedef struct ITMNotificationRequest__storage_ {
   uint32_t _has_storage_[2];
@@ -7935,6 +7978,7 @@ typedef struct ITMNotificationRequest__storage_ {
   ITMProfileChangeRequest *profileChangeRequest;
   ITMKeystrokeFilterRequest *keystrokeFilterRequest;
   ITMPromptMonitorRequest *promptMonitorRequest;
+  ITMScreenUpdateRequest *screenUpdateRequest;
 } ITMNotificationRequest__storage_;
 
 // This method is threadsafe because it is initially called
@@ -8033,6 +8077,16 @@ typedef struct ITMNotificationRequest__storage_ {
         .core.flags = GPBFieldOptional,
         .core.dataType = GPBDataTypeMessage,
       },
+      {
+        .defaultValue.valueMessage = nil,
+        .core.name = "screenUpdateRequest",
+        .core.dataTypeSpecific.className = GPBStringifySymbol(ITMScreenUpdateRequest),
+        .core.number = ITMNotificationRequest_FieldNumber_ScreenUpdateRequest,
+        .core.hasIndex = -1,
+        .core.offset = (uint32_t)offsetof(ITMNotificationRequest__storage_, screenUpdateRequest),
+        .core.flags = GPBFieldOptional,
+        .core.dataType = GPBDataTypeMessage,
+      },
     };
     GPBDescriptor *localDescriptor =
         [GPBDescriptor allocDescriptorForClass:[ITMNotificationRequest class]
@@ -8751,10 +8805,18 @@ typedef struct ITMKeystrokeNotification__storage_ {
 @implementation ITMScreenUpdateNotification
 
 @dynamic hasSession, session;
+@dynamic hasGeneration, generation;
+@dynamic linesArray, linesArray_Count;
+@dynamic hasCursor, cursor;
+@dynamic hasFirstLineOnScreen, firstLineOnScreen;
 
 typedef struct ITMScreenUpdateNotification__storage_ {
   uint32_t _has_storage_[1];
   NSString *session;
+  NSMutableArray *linesArray;
+  ITMCoord *cursor;
+  int64_t generation;
+  int64_t firstLineOnScreen;
 } ITMScreenUpdateNotification__storage_;
 
 // This method is threadsafe because it is initially called
@@ -8772,6 +8834,42 @@ typedef struct ITMScreenUpdateNotification__storage_ {
         .flags = GPBFieldOptional,
         .dataType = GPBDataTypeString,
       },
+      {
+        .name = "generation",
+        .dataTypeSpecific.className = NULL,
+        .number = ITMScreenUpdateNotification_FieldNumber_Generation,
+        .hasIndex = 1,
+        .offset = (uint32_t)offsetof(ITMScreenUpdateNotification__storage_, generation),
+        .flags = GPBFieldOptional,
+        .dataType = GPBDataTypeInt64,
+      },
+      {
+        .name = "linesArray",
+        .dataTypeSpecific.className = GPBStringifySymbol(ITMScreenUpdateLine),
+        .number = ITMScreenUpdateNotification_FieldNumber_LinesArray,
+        .hasIndex = GPBNoHasBit,
+        .offset = (uint32_t)offsetof(ITMScreenUpdateNotification__storage_, linesArray),
+        .flags = GPBFieldRepeated,
+        .dataType = GPBDataTypeMessage,
+      },
+      {
+        .name = "cursor",
+        .dataTypeSpecific.className = GPBStringifySymbol(ITMCoord),
+        .number = ITMScreenUpdateNotification_FieldNumber_Cursor,
+        .hasIndex = 2,
+        .offset = (uint32_t)offsetof(ITMScreenUpdateNotification__storage_, cursor),
+        .flags = GPBFieldOptional,
+        .dataType = GPBDataTypeMessage,
+      },
+      {
+        .name = "firstLineOnScreen",
+        .dataTypeSpecific.className = NULL,
+        .number = ITMScreenUpdateNotification_FieldNumber_FirstLineOnScreen,
+        .hasIndex = 3,
+        .offset = (uint32_t)offsetof(ITMScreenUpdateNotification__storage_, firstLineOnScreen),
+        .flags = GPBFieldOptional,
+        .dataType = GPBDataTypeInt64,
+      },
     };
     GPBDescriptor *localDescriptor =
         [GPBDescriptor allocDescriptorForClass:[ITMScreenUpdateNotification class]
@@ -8789,6 +8887,60 @@ typedef struct ITMScreenUpdateNotification__storage_ {
 
 @end
 
+#pragma mark - ITMScreenUpdateLine
+
+@implementation ITMScreenUpdateLine
+
+@dynamic hasLineNumber, lineNumber;
+@dynamic hasContents, contents;
+
+typedef struct ITMScreenUpdateLine__storage_ {
+  uint32_t _has_storage_[1];
+  ITMLineContents *contents;
+  int64_t lineNumber;
+} ITMScreenUpdateLine__storage_;
+
+// This method is threadsafe because it is initially called
+// in +initialize for each subclass.
++ (GPBDescriptor *)descriptor {
+  static GPBDescriptor *descriptor = nil;
+  if (!descriptor) {
+    static GPBMessageFieldDescription fields[] = {
+      {
+        .name = "lineNumber",
+        .dataTypeSpecific.className = NULL,
+        .number = ITMScreenUpdateLine_FieldNumber_LineNumber,
+        .hasIndex = 0,
+        .offset = (uint32_t)offsetof(ITMScreenUpdateLine__storage_, lineNumber),
+        .flags = GPBFieldOptional,
+        .dataType = GPBDataTypeInt64,
+      },
+      {
+        .name = "contents",
+        .dataTypeSpecific.className = GPBStringifySymbol(ITMLineContents),
+        .number = ITMScreenUpdateLine_FieldNumber_Contents,
+        .hasIndex = 1,
+        .offset = (uint32_t)offsetof(ITMScreenUpdateLine__storage_, contents),
+        .flags = GPBFieldOptional,
+        .dataType = GPBDataTypeMessage,
+      },
+    };
+    GPBDescriptor *localDescriptor =
+        [GPBDescriptor allocDescriptorForClass:[ITMScreenUpdateLine class]
+                                     rootClass:[ITMApiRoot class]
+                                          file:ITMApiRoot_FileDescriptor()
+                                        fields:fields
+                                    fieldCount:(uint32_t)(sizeof(fields) / sizeof(GPBMessageFieldDescription))
+                                   storageSize:sizeof(ITMScreenUpdateLine__storage_)
+                                         flags:GPBDescriptorInitializationFlag_None];
+    NSAssert(descriptor == nil, @"Startup recursed!");
+    descriptor = localDescriptor;
+  }
+  return descriptor;
+}
+
+@end
+
 #pragma mark - ITMPromptNotificationPrompt
 
 @implementation ITMPromptNotificationPrompt
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# Stress test for main-thread responsiveness while many sessions flood output.
+#
+# Opens a window with one idle session and N sessions that cat perf3.txt in a loop. Meanwhile it
+# repeatedly asks the idle session for a variable over the Python API. Those requests are answered
+# on the main thread, so their round-trip time is how long the main thread takes to get around to
+# new work: the same delay a keystroke or a redraw sees.
+#
+# Requires the iterm2 module and the Python API enabled in Prefs > General > Magic.
+#   ./flood_sessions.py [sessions=8] [seconds=20]
+
+import asyncio
+import os
+import sys
+import time
+
+import iterm2
+
+SESSIONS = int(sys.argv[1]) if len(sys.argv) > 1 else 8
+SECONDS = float(sys.argv[2]) if len(sys.argv) > 2 else 20
+PERF3 = os.path.join(os.path.dirname(os.path.abspath(__file__)), "perf3.txt")
+FLOOD = "/bin/sh -c 'while :; do cat \"%s\"; done'" % PERF3
+
+
+async def measure(session, seconds):
+    samples = []
+    deadline = time.monotonic() + seconds
+    while time.monotonic() < deadline:
+        start = time.monotonic()
+        await session.async_get_variable("columns")
+        samples.append((time.monotonic() - start) * 1000)
+        await asyncio.sleep(0.05)
+    return samples
+
+
+def report(name, samples):
+    samples = sorted(samples)
+    def pct(p):
+        return samples[min(len(samples) - 1, int(len(samples) * p))]
+    print("%-10s n=%-5d p50=%7.1fms p95=%7.1fms p99=%7.1fms max=%7.1fms" %
+          (name, len(samples), pct(0.5), pct(0.95), pct(0.99), samples[-1]))
+
+
+async def main(connection):
+    window = await iterm2.Window.async_create(connection)
+    idle = window.current_tab.current_session
+    report("idle", await measure(idle, min(5, SECONDS)))
+
+    for _ in range(SESSIONS):
+        await window.async_create_tab(command=FLOOD)
+    # Keep the idle session's tab selected so the flooding sessions are in the background.
+    await idle.async_activate()
+    await asyncio.sleep(1)
+    report("flooding", await measure(idle, SECONDS))
+
+    await window.async_close(force=True)
+
+iterm2.run_until_complete(main)
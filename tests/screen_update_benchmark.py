@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+# Compares the cost to a Python API client of following screen updates in N sessions.
+#
+# "ping" subscribes to bare screen update notifications and fetches the screen with a
+# GetBufferRequest after each one, which is what clients had to do before. "delta" subscribes with
+# include_contents so each notification carries the changed lines. For each mode it reports
+# updates/sec, bytes received per update, and the client's CPU time per update. Delta mode also
+# counts generation gaps, which would mean a notification was missed.
+#
+# The "progress" workload redraws one line in place, like a progress bar. The "scroll" workload
+# prints lines so the screen scrolls; every line moves, so a delta is about as big as the screen.
+#
+# Requires the iterm2 module and the Python API enabled in Prefs > General > Magic.
+#   ./screen_update_benchmark.py [sessions=16] [seconds=10]
+
+import asyncio
+import sys
+import time
+
+import iterm2
+
+SESSIONS = int(sys.argv[1]) if len(sys.argv) > 1 else 16
+SECONDS = float(sys.argv[2]) if len(sys.argv) > 2 else 10
+WORKLOADS = {
+    "progress": "/bin/sh -c 'i=0; while :; do i=$((i+1)); printf \"\\rprogress %d\" $i; sleep 0.01; done'",
+    "scroll": "/bin/sh -c 'i=0; while :; do i=$((i+1)); echo \"line $i\"; sleep 0.01; done'",
+}
+
+
+class Stats:
+    def __init__(self):
+        self.updates = 0
+        self.bytes = 0
+        self.gaps = 0
+        self.generations = {}
+
+
+async def follow(connection, sessions, include_contents, stats):
+    async def on_update(_connection, notification):
+        stats.updates += 1
+        stats.bytes += notification.ByteSize()
+        if include_contents:
+            last = stats.generations.get(notification.session)
+            if last is not None and notification.generation != last + 1:
+                stats.gaps += 1
+            stats.generations[notification.session] = notification.generation
+        else:
+            response = await iterm2.rpc.async_get_screen_contents(connection, notification.session, None)
+            stats.bytes += response.ByteSize()
+
+    tokens = []
+    for session in sessions:
+        tokens.append(await iterm2.notifications.async_subscribe_to_screen_update_notification(
+            connection, on_update, session.session_id, include_contents=include_contents))
+    cpu = time.process_time()
+    await asyncio.sleep(SECONDS)
+    cpu = time.process_time() - cpu
+    for token in tokens:
+        await iterm2.notifications.async_unsubscribe(connection, token)
+    return cpu
+
+
+async def main(connection):
+    for workload, command in WORKLOADS.items():
+        window = await iterm2.Window.async_create(connection, command=command)
+        sessions = [window.current_tab.current_session]
+        for _ in range(SESSIONS - 1):
+            tab = await window.async_create_tab(command=command)
+            sessions.append(tab.current_session)
+        await asyncio.sleep(1)
+
+        for mode, include_contents in (("ping", False), ("delta", True)):
+            stats = Stats()
+            cpu = await follow(connection, sessions, include_contents, stats)
+            n = max(1, stats.updates)
+            print("%-8s %-5s updates/s=%7.1f bytes/update=%8.0f cpu/update=%6.3fms gaps=%d" %
+                  (workload, mode, stats.updates / SECONDS, stats.bytes / n, cpu * 1000 / n, stats.gaps))
+
+        await window.async_close(force=True)
+
+iterm2.run_until_complete(main)
@@ -0,0 +1,92 @@
+// Benchmark for the run scanners in VT100StringParserSIMD.h.
+//
+// The parser splits its input into runs of printable ASCII, runs of non-ASCII bytes, and control
+// characters. This walks each input file the same way using the scalar and the vectorized scanners
+// and reports bytes/sec for both. It also checks that they agree.
+//
+// Build and run:
+//   c++ -O2 spam.cc -o spam && ./spam 20000 > /tmp/spam.txt
+//   cc -O2 -I../sources string_parser_benchmark.c -o spbench
+//   ./spbench /tmp/spam.txt UTF-8-demo.txt chinese.txt
+
+#include "VT100StringParserSIMD.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef int (*Scanner)(const unsigned char *, int);
+
+static double Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Returns the number of runs found so the compiler can't discard the work.
+static long Segment(const unsigned char *bytes, int length, Scanner printable, Scanner nonASCII) {
+    long runs = 0;
+    int i = 0;
+    while (i < length) {
+        int n;
+        if (bytes[i] >= 0x20 && bytes[i] <= 0x7f) {
+            n = printable(bytes + i, length - i);
+        } else if (bytes[i] >= 0x80) {
+            n = nonASCII(bytes + i, length - i);
+        } else {
+            n = 1;
+        }
+        i += n;
+        runs++;
+    }
+    return runs;
+}
+
+static double Measure(const unsigned char *bytes, int length, Scanner printable, Scanner nonASCII, long *runs) {
+    const int iterations = 200;
+    const double start = Now();
+    for (int i = 0; i < iterations; i++) {
+        *runs = Segment(bytes, length, printable, nonASCII);
+    }
+    return (double)length * iterations / (Now() - start);
+}
+
+int main(int argc, char *argv[]) {
+    for (int f = 1; f < argc; f++) {
+        FILE *file = fopen(argv[f], "rb");
+        if (!file) {
+            perror(argv[f]);
+            continue;
+        }
+        fseek(file, 0, SEEK_END);
+        const long length = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        unsigned char *bytes = malloc(length);
+        if (fread(bytes, 1, length, file) != (size_t)length) {
+            perror(argv[f]);
+            return 1;
+        }
+        fclose(file);
+
+        long scalarRuns = 0;
+        long vectorRuns = 0;
+        const double scalar = Measure(bytes, (int)length,
+                                      VT100CountPrintableASCIIBytesScalar,
+                                      VT100CountNonASCIIBytesScalar,
+                                      &scalarRuns);
+        const double vector = Measure(bytes, (int)length,
+                                      VT100CountPrintableASCIIBytes,
+                                      VT100CountNonASCIIBytes,
+                                      &vectorRuns);
+        printf("%-28s %9ld bytes %8ld runs  scalar %8.1f MB/s  vector %8.1f MB/s  %.2fx%s\n",
+               argv[f],
+               length,
+               scalarRuns,
+               scalar / 1e6,
+               vector / 1e6,
+               vector / scalar,
+               scalarRuns == vectorRuns ? "" : "  MISMATCH");
+        free(bytes);
+    }
+    return 0;
+}
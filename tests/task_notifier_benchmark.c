@@ -0,0 +1,207 @@
+// Benchmark for TaskNotifier's event backend.
+//
+// Registers N idle pipes plus one pipe that a writer thread spams with timestamped messages, then
+// compares a select() loop that rebuilds its fd_sets on every wakeup (what TaskNotifier used to do)
+// against the persistent, edge-triggered iTermEventQueue registrations it uses now.
+//
+// Build and run:
+//   cc -O2 -pthread -I../sources task_notifier_benchmark.c ../sources/iTermEventQueue.c -o tnbench
+//   ./tnbench [idle tasks=150] [messages=200000]
+
+#include "iTermEventQueue.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    int fd;
+    int count;
+} Writer;
+
+static uint64_t NowNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static double CPUSeconds(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+           usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+static void *WriterMain(void *arg) {
+    Writer *writer = arg;
+    for (int i = 0; i < writer->count; i++) {
+        uint64_t stamp = NowNanos();
+        while (write(writer->fd, &stamp, sizeof(stamp)) < 0 && errno == EAGAIN) {
+            usleep(10);
+        }
+        if (i % 64 == 0) {
+            // Give the reader a chance to block so wakeups are actually measured.
+            usleep(50);
+        }
+    }
+    close(writer->fd);
+    return NULL;
+}
+
+typedef struct {
+    uint64_t wakeups;
+    uint64_t messages;
+    uint64_t totalLatency;
+    uint64_t maxLatency;
+} Stats;
+
+// Returns 1 at end of file.
+static int Drain(int fd, Stats *stats) {
+    uint64_t buffer[512];
+    for (;;) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n == 0) {
+            return 1;
+        }
+        if (n < 0) {
+            return 0;
+        }
+        const uint64_t now = NowNanos();
+        for (size_t i = 0; i < n / sizeof(uint64_t); i++) {
+            const uint64_t latency = now - buffer[i];
+            stats->totalLatency += latency;
+            if (latency > stats->maxLatency) {
+                stats->maxLatency = latency;
+            }
+            stats->messages++;
+        }
+    }
+}
+
+static void RunSelect(const int *idle, unsigned int idleCount, int spam, Stats *stats) {
+    for (;;) {
+        // Rebuild everything on every spin, like TaskNotifier used to.
+        fd_set rfds, wfds, efds;
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        FD_ZERO(&efds);
+        int highfd = spam;
+        for (unsigned int i = 0; i < idleCount; i++) {
+            FD_SET(idle[i], &rfds);
+            FD_SET(idle[i], &efds);
+            if (idle[i] > highfd) {
+                highfd = idle[i];
+            }
+        }
+        FD_SET(spam, &rfds);
+        FD_SET(spam, &efds);
+        if (select(highfd + 1, &rfds, &wfds, &efds, NULL) <= 0) {
+            continue;
+        }
+        stats->wakeups++;
+        for (unsigned int i = 0; i < idleCount; i++) {
+            if (FD_ISSET(idle[i], &rfds)) {
+                Drain(idle[i], stats);
+            }
+        }
+        if (FD_ISSET(spam, &rfds) && Drain(spam, stats)) {
+            return;
+        }
+    }
+}
+
+static void RunEventQueue(const int *idle, unsigned int idleCount, int spam, Stats *stats) {
+    const int queue = iTermEventQueueCreate();
+    for (unsigned int i = 0; i < idleCount; i++) {
+        iTermEventQueueAddEdgeTriggered(queue, idle[i], iTermEventQueueFilterRead, 0);
+    }
+    iTermEventQueueAddEdgeTriggered(queue, spam, iTermEventQueueFilterRead, 1);
+    iTermEventQueueEvent events[64];
+    for (;;) {
+        const int n = iTermEventQueueWait(queue, events, 64, -1);
+        if (n <= 0) {
+            continue;
+        }
+        stats->wakeups++;
+        for (int i = 0; i < n; i++) {
+            if (Drain(events[i].fd, stats) && events[i].tag == 1) {
+                close(queue);
+                return;
+            }
+        }
+    }
+}
+
+static void Run(const char *name, unsigned int idleCount, int count, int useSelect) {
+    int *idle = calloc(idleCount * 2, sizeof(int));
+    for (unsigned int i = 0; i < idleCount; i++) {
+        if (pipe(idle + i * 2) != 0) {
+            perror("pipe");
+            exit(1);
+        }
+        fcntl(idle[i * 2], F_SETFL, O_NONBLOCK);
+    }
+    int *idleReaders = calloc(idleCount, sizeof(int));
+    for (unsigned int i = 0; i < idleCount; i++) {
+        idleReaders[i] = idle[i * 2];
+    }
+    int spam[2];
+    pipe(spam);
+    fcntl(spam[0], F_SETFL, O_NONBLOCK);
+    fcntl(spam[1], F_SETFL, O_NONBLOCK);
+
+    if (useSelect && (spam[1] >= FD_SETSIZE || idle[idleCount * 2 - 1] >= FD_SETSIZE)) {
+        printf("%-12s idle=%-5u n/a (exceeds FD_SETSIZE=%d)\n", name, idleCount, FD_SETSIZE);
+    } else {
+        Stats stats = { 0 };
+        Writer writer = { .fd = spam[1], .count = count };
+        const double cpuBefore = CPUSeconds();
+        const uint64_t start = NowNanos();
+        pthread_t thread;
+        pthread_create(&thread, NULL, WriterMain, &writer);
+        if (useSelect) {
+            RunSelect(idleReaders, idleCount, spam[0], &stats);
+        } else {
+            RunEventQueue(idleReaders, idleCount, spam[0], &stats);
+        }
+        pthread_join(thread, NULL);
+        const double wall = (NowNanos() - start) / 1e9;
+        // Includes the writer thread, which does the same work in both modes.
+        const double cpu = CPUSeconds() - cpuBefore;
+        printf("%-12s idle=%-5u wakeups=%-8llu mean latency=%7.2fus max latency=%8.2fus "
+               "cpu/wakeup=%6.2fus wall=%.2fs\n",
+               name,
+               idleCount,
+               (unsigned long long)stats.wakeups,
+               stats.messages ? stats.totalLatency / 1e3 / stats.messages : 0,
+               stats.maxLatency / 1e3,
+               stats.wakeups ? cpu * 1e6 / stats.wakeups : 0,
+               wall);
+    }
+    close(spam[0]);
+    for (unsigned int i = 0; i < idleCount * 2; i++) {
+        close(idle[i]);
+    }
+    free(idle);
+    free(idleReaders);
+}
+
+int main(int argc, char *argv[]) {
+    int idleCount = argc > 1 ? atoi(argv[1]) : 150;
+    if (idleCount < 1) {
+        idleCount = 1;
+    }
+    const int count = argc > 2 ? atoi(argv[2]) : 200000;
+    Run("select", idleCount, count, 1);
+    Run("event queue", idleCount, count, 0);
+    return 0;
+}